@@ -0,0 +1,152 @@
+// ===================================
+// Type Definitions
+// ===================================
+
+struct bench_result
+{
+    const char *Suite;
+    const char *Name;
+    const char *Variant;
+    sml_u64     Size;
+    sml_u32     Threads;
+    sml_f64     NsPerOp;
+};
+
+struct bench_timer
+{
+    std::chrono::steady_clock::time_point Start;
+};
+
+// ===================================
+// Global Variables
+// ===================================
+
+// NOTE: Written by the benchmarks so the optimizer cannot drop their work.
+static volatile sml_u64 BenchSink;
+
+// NOTE: Checks that exceeded their bound, the runner exits non-zero when set.
+static sml_u32 BenchFailures;
+
+// NOTE: Kept out of SmlMemory so recording results does not disturb the heap
+// the benchmarks are measuring.
+constexpr sml_u32   BenchMaxResults = 4096;
+static bench_result BenchResults[BenchMaxResults];
+static sml_u32      BenchResultCount;
+
+// ===================================
+// Helpers
+// ===================================
+
+static inline bench_timer
+Bench_StartTimer()
+{
+    bench_timer Timer = {};
+    Timer.Start = std::chrono::steady_clock::now();
+
+    return Timer;
+}
+
+static inline sml_f64
+Bench_ElapsedNs(bench_timer Timer)
+{
+    auto End     = std::chrono::steady_clock::now();
+    auto Elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(End -
+                                                                        Timer.Start);
+
+    return (sml_f64)Elapsed.count();
+}
+
+static void
+Bench_Report(const char *Suite, const char *Name, const char *Variant, sml_u64 Size,
+             sml_u32 Threads, sml_f64 NsPerOp)
+{
+    printf("%-10s %-24s %-16s %10llu %3u %12.3f ns/op\n", Suite, Name, Variant,
+           (unsigned long long)Size, Threads, NsPerOp);
+
+    if(BenchResultCount < BenchMaxResults)
+    {
+        bench_result *Result = BenchResults + BenchResultCount++;
+        Result->Suite   = Suite;
+        Result->Name    = Name;
+        Result->Variant = Variant;
+        Result->Size    = Size;
+        Result->Threads = Threads;
+        Result->NsPerOp = NsPerOp;
+    }
+}
+
+// NOTE: Names are string literals from the benchmarks, no escaping needed.
+
+static bool
+Bench_WriteCsv(const char *Path)
+{
+    FILE *File = fopen(Path, "w");
+    if(!File) return false;
+
+    fprintf(File, "suite,name,variant,size,threads,ns_per_op\n");
+
+    for(sml_u32 Idx = 0; Idx < BenchResultCount; Idx++)
+    {
+        bench_result *R = BenchResults + Idx;
+        fprintf(File, "%s,%s,%s,%llu,%u,%.4f\n", R->Suite, R->Name, R->Variant,
+                (unsigned long long)R->Size, R->Threads, R->NsPerOp);
+    }
+
+    fclose(File);
+    return true;
+}
+
+static bool
+Bench_WriteJson(const char *Path)
+{
+    FILE *File = fopen(Path, "w");
+    if(!File) return false;
+
+    fprintf(File, "[\n");
+
+    for(sml_u32 Idx = 0; Idx < BenchResultCount; Idx++)
+    {
+        bench_result *R = BenchResults + Idx;
+        fprintf(File, "  {\"suite\": \"%s\", \"name\": \"%s\", \"variant\": \"%s\", "
+                      "\"size\": %llu, \"threads\": %u, \"ns_per_op\": %.4f}%s\n",
+                R->Suite, R->Name, R->Variant, (unsigned long long)R->Size, R->Threads,
+                R->NsPerOp, (Idx + 1 < BenchResultCount) ? "," : "");
+    }
+
+    fprintf(File, "]\n");
+
+    fclose(File);
+    return true;
+}
+
+// NOTE: xorshift64, deterministic so runs on different machines do the same work.
+
+static inline sml_u64
+Bench_Random(sml_u64 *State)
+{
+    sml_u64 X = *State;
+    X ^= X << 13;
+    X ^= X >> 7;
+    X ^= X << 17;
+    *State = X;
+
+    return X;
+}
+
+// NOTE: Odd multiplier, so distinct indices give distinct keys.
+
+static inline sml_u32
+Bench_KeyFromIndex(sml_u32 Idx)
+{
+    return Idx * 0x9E3779B1u;
+}
+
+// NOTE: Repeats small sizes so every measurement covers roughly the same amount
+// of work.
+
+static inline sml_u32
+Bench_Repetitions(sml_u64 Count)
+{
+    sml_u64 Reps = (1 << 22) / (Count ? Count : 1);
+    return Reps ? (sml_u32)Reps : 1;
+}
@@ -0,0 +1,518 @@
+// ===================================
+// Type Definitions
+// ===================================
+
+struct bench_record
+{
+    sml_u64 A;
+    sml_u64 B;
+};
+
+// NOTE: Element counts. With 4 byte elements the working sets go from L1 (4KB)
+// to DRAM (64MB). Maps stop one step earlier, their overhead already puts them
+// well past the last level cache.
+static const sml_u32 BenchArraySizes[] = {1 << 10, 1 << 14, 1 << 18, 1 << 22, 1 << 24};
+static const sml_u32 BenchMapSizes[]   = {1 << 10, 1 << 14, 1 << 18, 1 << 22};
+static const sml_u32 BenchAllocCounts[] = {1 << 8, 1 << 12, 1 << 14};
+
+// ===================================
+// Internal Helpers
+// ===================================
+
+// NOTE: Random permutation of [0, Count), allocated outside SmlMemory.
+static sml_u32*
+BenchInt_Shuffled(sml_u32 Count, sml_u64 Seed)
+{
+    sml_u32 *Order = (sml_u32*)malloc(Count * sizeof(sml_u32));
+    for(sml_u32 Idx = 0; Idx < Count; Idx++) Order[Idx] = Idx;
+
+    sml_u64 State = Seed;
+    for(sml_u32 Idx = Count - 1; Idx > 0; Idx--)
+    {
+        sml_u32 Swap = (sml_u32)(Bench_Random(&State) % (Idx + 1));
+        sml_u32 Temp = Order[Idx];
+        Order[Idx]   = Order[Swap];
+        Order[Swap]  = Temp;
+    }
+
+    return Order;
+}
+
+// ===================================
+// Benchmarks
+// ===================================
+
+static void
+BenchInt_DynamicArray(sml_u32 Count)
+{
+    sml_u32 *Order = BenchInt_Shuffled(Count, 0x1234);
+    sml_u32  Reps  = Bench_Repetitions(Count);
+    sml_u64  Sum   = 0;
+    sml_f64  Ops   = (sml_f64)Count * Reps;
+
+    // Insertion
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            auto Array = dynamic_array<sml_u32>(0, false);
+            for(sml_u32 Idx = 0; Idx < Count; Idx++) Array.Push(Idx);
+
+            Sum += Array.Count;
+            Array.Free();
+        }
+        Bench_Report("array", "insert", "dynamic_array", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            std::vector<sml_u32> Array;
+            for(sml_u32 Idx = 0; Idx < Count; Idx++) Array.push_back(Idx);
+
+            Sum += Array.size();
+        }
+        Bench_Report("array", "insert", "std_vector", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    auto Array = dynamic_array<sml_u32>(Count, false);
+    for(sml_u32 Idx = 0; Idx < Count; Idx++) Array.Push(Idx);
+
+    std::vector<sml_u32> Vector(Array.Values, Array.Values + Count);
+
+    // Random access
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            for(sml_u32 Idx = 0; Idx < Count; Idx++) Sum += Array[Order[Idx]];
+        }
+        Bench_Report("array", "lookup_hit", "dynamic_array", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            for(sml_u32 Idx = 0; Idx < Count; Idx++) Sum += Vector[Order[Idx]];
+        }
+        Bench_Report("array", "lookup_hit", "std_vector", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    // Iteration
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            for(sml_u32 Value : Array) Sum += Value;
+        }
+        Bench_Report("array", "iterate", "dynamic_array", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            for(sml_u32 Value : Vector) Sum += Value;
+        }
+        Bench_Report("array", "iterate", "std_vector", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    Array.Free();
+    free(Order);
+
+    BenchSink = Sum;
+}
+
+static void
+BenchInt_Stack(sml_u32 Count)
+{
+    sml_u32 Reps = Bench_Repetitions(Count);
+    sml_u64 Sum  = 0;
+    sml_f64 Ops  = (sml_f64)Count * Reps;
+
+    // Push then pop everything back
+    {
+        auto Stack = stack<sml_u32>(8, true, false);
+
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            for(sml_u32 Idx = 0; Idx < Count; Idx++) Stack.Push(Idx);
+            while(!Stack.Empty()) Sum += Stack.Pop();
+        }
+        Bench_Report("stack", "push_pop", "stack", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+
+        Stack.Free();
+    }
+
+    {
+        std::vector<sml_u32> Stack;
+
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            for(sml_u32 Idx = 0; Idx < Count; Idx++) Stack.push_back(Idx);
+            while(!Stack.empty())
+            {
+                Sum += Stack.back();
+                Stack.pop_back();
+            }
+        }
+        Bench_Report("stack", "push_pop", "std_vector", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    BenchSink = Sum;
+}
+
+static void
+BenchInt_Hashmap(sml_u32 Count)
+{
+    sml_u32 *Order = BenchInt_Shuffled(Count, 0x5678);
+    sml_u32  Reps  = Bench_Repetitions(Count);
+    sml_u64  Sum   = 0;
+    sml_f64  Ops   = (sml_f64)Count * Reps;
+
+    // Insertion, growing from the smallest size like the engine does
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            auto Map = sml_hashmap<sml_u32, sml_u32>(0);
+            for(sml_u32 Idx = 0; Idx < Count; Idx++)
+            {
+                Map.Insert(Bench_KeyFromIndex(Idx), Idx);
+            }
+
+            Sum += Map.Count;
+            Map.Free();
+        }
+        Bench_Report("hashmap", "insert", "sml_hashmap", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            std::unordered_map<sml_u32, sml_u32> Map;
+            for(sml_u32 Idx = 0; Idx < Count; Idx++)
+            {
+                Map.emplace(Bench_KeyFromIndex(Idx), Idx);
+            }
+
+            Sum += Map.size();
+        }
+        Bench_Report("hashmap", "insert", "std_unordered", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    auto Map = sml_hashmap<sml_u32, sml_u32>(0);
+    std::unordered_map<sml_u32, sml_u32> StdMap;
+
+    for(sml_u32 Idx = 0; Idx < Count; Idx++)
+    {
+        Map.Insert(Bench_KeyFromIndex(Idx), Idx);
+        StdMap.emplace(Bench_KeyFromIndex(Idx), Idx);
+    }
+
+    // Lookup hit / miss
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            for(sml_u32 Idx = 0; Idx < Count; Idx++)
+            {
+                Sum += *Map.Find(Bench_KeyFromIndex(Order[Idx]));
+            }
+        }
+        Bench_Report("hashmap", "lookup_hit", "sml_hashmap", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            for(sml_u32 Idx = 0; Idx < Count; Idx++)
+            {
+                Sum += StdMap.find(Bench_KeyFromIndex(Order[Idx]))->second;
+            }
+        }
+        Bench_Report("hashmap", "lookup_hit", "std_unordered", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            for(sml_u32 Idx = 0; Idx < Count; Idx++)
+            {
+                Sum += Map.Find(Bench_KeyFromIndex(Count + Order[Idx])) != nullptr;
+            }
+        }
+        Bench_Report("hashmap", "lookup_miss", "sml_hashmap", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            for(sml_u32 Idx = 0; Idx < Count; Idx++)
+            {
+                Sum += StdMap.count(Bench_KeyFromIndex(Count + Order[Idx]));
+            }
+        }
+        Bench_Report("hashmap", "lookup_miss", "std_unordered", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    // Iteration: the map has no iterator, walk the metadata like a caller would.
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            sml_u32 BucketCount = Map.BucketCount();
+            for(sml_u32 Idx = 0; Idx < BucketCount; Idx++)
+            {
+                if(Map.MetaData[Idx] < Map.EmptyBucketTag) Sum += Map.Buckets[Idx].Value;
+            }
+        }
+        Bench_Report("hashmap", "iterate", "sml_hashmap", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            for(auto &Entry : StdMap) Sum += Entry.second;
+        }
+        Bench_Report("hashmap", "iterate", "std_unordered", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    // Removal, once: the maps are empty afterwards.
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Idx = 0; Idx < Count; Idx++)
+        {
+            Sum += Map.Remove(Bench_KeyFromIndex(Order[Idx]));
+        }
+        Bench_Report("hashmap", "remove", "sml_hashmap", Count, 1,
+                     Bench_ElapsedNs(Timer) / Count);
+    }
+
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Idx = 0; Idx < Count; Idx++)
+        {
+            Sum += StdMap.erase(Bench_KeyFromIndex(Order[Idx]));
+        }
+        Bench_Report("hashmap", "remove", "std_unordered", Count, 1,
+                     Bench_ElapsedNs(Timer) / Count);
+    }
+
+    Map.Free();
+    free(Order);
+
+    BenchSink = Sum;
+}
+
+static void
+BenchInt_SlotMap(sml_u32 Count)
+{
+    sml_u32 *Order   = BenchInt_Shuffled(Count, 0x9ABC);
+    sml_u32 *Handles = (sml_u32*)malloc(Count * sizeof(sml_u32));
+    sml_u64  Sum     = 0;
+
+    bench_record Record = {};
+
+    // NOTE: Slot maps are fixed size, so insertion and removal run once.
+    auto Slots = slot_map<bench_record, sml_u32>(Count, false, false);
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Idx = 0; Idx < Count; Idx++)
+        {
+            Record.A     = Idx;
+            Handles[Idx] = Slots.Emplace(Record);
+        }
+        Bench_Report("slot_map", "insert", "slot_map", Count, 1,
+                     Bench_ElapsedNs(Timer) / Count);
+    }
+
+    std::unordered_map<sml_u32, bench_record> StdMap;
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Idx = 0; Idx < Count; Idx++)
+        {
+            Record.A = Idx;
+            StdMap.emplace(Idx, Record);
+        }
+        Bench_Report("slot_map", "insert", "std_unordered", Count, 1,
+                     Bench_ElapsedNs(Timer) / Count);
+    }
+
+    sml_u32 Reps = Bench_Repetitions(Count);
+    sml_f64 Ops  = (sml_f64)Count * Reps;
+
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            for(sml_u32 Idx = 0; Idx < Count; Idx++) Sum += Slots[Handles[Order[Idx]]].A;
+        }
+        Bench_Report("slot_map", "lookup_hit", "slot_map", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            for(sml_u32 Idx = 0; Idx < Count; Idx++) Sum += StdMap[Order[Idx]].A;
+        }
+        Bench_Report("slot_map", "lookup_hit", "std_unordered", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            sml_u32 Slot = Slots.Head;
+            while(Slot != Slots.Invalid)
+            {
+                Sum += Slots.Data[Slot].A;
+                Slot = Slots.Next[Slot];
+            }
+        }
+        Bench_Report("slot_map", "iterate", "slot_map", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            for(auto &Entry : StdMap) Sum += Entry.second.A;
+        }
+        Bench_Report("slot_map", "iterate", "std_unordered", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Idx = 0; Idx < Count; Idx++) Slots.Remove(Handles[Order[Idx]]);
+        Bench_Report("slot_map", "remove", "slot_map", Count, 1,
+                     Bench_ElapsedNs(Timer) / Count);
+    }
+
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Idx = 0; Idx < Count; Idx++) Sum += StdMap.erase(Order[Idx]);
+        Bench_Report("slot_map", "remove", "std_unordered", Count, 1,
+                     Bench_ElapsedNs(Timer) / Count);
+    }
+
+    Slots.Free();
+    free(Handles);
+    free(Order);
+
+    BenchSink = Sum;
+}
+
+// NOTE: Allocates Count blocks of 16 to 512 bytes, frees them in random order
+// and allocates them again, which exercises the free-list path. Once all are
+// freed the blocks must have merged back into the push area, and the block
+// indices must not outgrow the peak block count.
+
+static void
+BenchInt_Memory(sml_u32 Count)
+{
+    sml_u32        *Order  = BenchInt_Shuffled(Count, 0xDEF0);
+    size_t         *Sizes  = (size_t*)malloc(Count * sizeof(size_t));
+    sml_heap_block *Blocks = (sml_heap_block*)malloc(Count * sizeof(sml_heap_block));
+    void          **Ptrs   = (void**)malloc(Count * sizeof(void*));
+
+    sml_u64 State = 0x42;
+    for(sml_u32 Idx = 0; Idx < Count; Idx++)
+    {
+        Sizes[Idx] = 16 + (Bench_Random(&State) % 497);
+    }
+
+    size_t  PushSize = SmlMemory.PushSize;
+    sml_u32 Indices  = SmlMemory.NextIdx;
+
+    const char *Phases[] = {"alloc", "free", "realloc_reuse"};
+
+    for(sml_u32 Phase = 0; Phase < 3; Phase++)
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Idx = 0; Idx < Count; Idx++)
+        {
+            sml_u32 Slot = Order[Idx];
+
+            if(Phase == 1) SmlMemory.Free(Blocks[Slot]);
+            else           Blocks[Slot] = SmlMemory.Allocate(Sizes[Slot]);
+        }
+        Bench_Report("memory", Phases[Phase], "sml_memory", Count, 1,
+                     Bench_ElapsedNs(Timer) / Count);
+
+        Timer = Bench_StartTimer();
+        for(sml_u32 Idx = 0; Idx < Count; Idx++)
+        {
+            sml_u32 Slot = Order[Idx];
+
+            if(Phase == 1) free(Ptrs[Slot]);
+            else           Ptrs[Slot] = malloc(Sizes[Slot]);
+        }
+        Bench_Report("memory", Phases[Phase], "malloc", Count, 1,
+                     Bench_ElapsedNs(Timer) / Count);
+    }
+
+    for(sml_u32 Idx = 0; Idx < Count; Idx++)
+    {
+        SmlMemory.Free(Blocks[Idx]);
+        free(Ptrs[Idx]);
+    }
+
+    // Every live block can leave one free block split off behind it.
+    if(SmlMemory.PushSize != PushSize || SmlMemory.NextIdx - Indices > Count * 2)
+    {
+        printf("memory: %u blocks left %zu bytes unmerged and took %u indices\n", Count,
+               SmlMemory.PushSize - PushSize, SmlMemory.NextIdx - Indices);
+        BenchFailures++;
+    }
+
+    free(Ptrs);
+    free(Blocks);
+    free(Sizes);
+    free(Order);
+}
+
+static void
+Bench_Memory()
+{
+    for(sml_u32 Count : BenchAllocCounts) BenchInt_Memory(Count);
+}
+
+static void
+Bench_DataStructures()
+{
+    for(sml_u32 Count : BenchArraySizes) BenchInt_DynamicArray(Count);
+    for(sml_u32 Count : BenchArraySizes) BenchInt_Stack(Count);
+    for(sml_u32 Count : BenchMapSizes)   BenchInt_Hashmap(Count);
+    for(sml_u32 Count : BenchMapSizes)   BenchInt_SlotMap(Count);
+}
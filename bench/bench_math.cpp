@@ -0,0 +1,991 @@
+// ===================================
+// Type Definitions
+// ===================================
+
+// NOTE:
+// 1) "math" measures ns per element. Dispatched kernels run once per ISA the
+//    CPU supports (scalar up to SmlCpu.Best), so one run compares every path.
+// 2) "accuracy" checks every path against a double precision reference and
+//    fails the run when an error bound is exceeded. Errors are in ULPs of the
+//    magnitude of the summed terms (sum of |a*b|), so cancellation in a dot
+//    product is not reported as a huge relative error.
+// 3) Dispatched SIMD paths must also match their scalar reference bit for bit.
+// 4) Ray kernels are only compared to the scalar Moller-Trumbore and slab tests.
+//    Most rays aim at a triangle or a box, some start inside a box or on one of
+//    its faces, some run along an axis, and some triangles are copies of an
+//    earlier one to check ties.
+
+struct bench_ulp_stats
+{
+    sml_f64 Max;
+    sml_f64 Sum;
+    sml_u64 Count;
+};
+
+struct bench_points
+{
+    sml_f32 *Xs, *Ys, *Zs;
+    sml_f32 *OutXs, *OutYs, *OutZs;
+    sml_f32 *Radii;
+    sml_f32 *ExtentXs, *ExtentYs, *ExtentZs;
+};
+
+static const sml_u32 BenchMathSizes[] = {1 << 8, 1 << 12, 1 << 16, 1 << 20};
+
+constexpr sml_u32 BenchAccuracyCount = 1 << 16;
+
+// NOTE: Bounds in ULPs. Each output is at most 4 products and 3 sums (or a
+// sqrt and a divide), a few ULPs of the term magnitude covers both.
+constexpr sml_f64 BenchUlp_Normalize = 2.0;
+constexpr sml_f64 BenchUlp_Dot       = 4.0;
+constexpr sml_f64 BenchUlp_Multiply  = 4.0;
+constexpr sml_f64 BenchUlp_Transform = 4.0;
+constexpr sml_f64 BenchUlp_Normals   = 6.0;
+
+// ===================================
+// Internal Helpers
+// ===================================
+
+static inline sml_f32
+BenchInt_RandomFloat(sml_u64 *State, sml_f32 Min, sml_f32 Max)
+{
+    sml_f64 Unit = (sml_f64)(Bench_Random(State) >> 11) * (1.0 / 9007199254740992.0);
+    return (sml_f32)(Min + (Max - Min) * Unit);
+}
+
+static inline sml_f64
+BenchInt_Ulps(sml_f32 Value, sml_f64 Reference, sml_f64 Magnitude)
+{
+    sml_f64 Scale = fabs(Reference) > Magnitude ? fabs(Reference) : Magnitude;
+    sml_f32 Base  = Scale > FLT_MIN ? (sml_f32)Scale : FLT_MIN;
+    sml_f64 Ulp   = (sml_f64)nextafterf(Base, INFINITY) - (sml_f64)Base;
+
+    return fabs((sml_f64)Value - Reference) / Ulp;
+}
+
+static inline void
+BenchInt_AddUlps(bench_ulp_stats *Stats, sml_f64 Ulps)
+{
+    if(Ulps > Stats->Max) Stats->Max = Ulps;
+
+    Stats->Sum += Ulps;
+    Stats->Count++;
+}
+
+static void
+BenchInt_CheckUlps(const char *Name, const char *Variant, bench_ulp_stats Stats,
+                   sml_f64 Limit)
+{
+    bool    Passed = Stats.Max <= Limit;
+    sml_f64 Mean   = Stats.Count ? Stats.Sum / (sml_f64)Stats.Count : 0.0;
+
+    printf("%-10s %-24s %-16s max %8.3f ulp  mean %8.4f ulp  limit %4.1f  %s\n",
+           "accuracy", Name, Variant, Stats.Max, Mean, Limit, Passed ? "ok" : "FAIL");
+
+    if(!Passed) ++BenchFailures;
+}
+
+static void
+BenchInt_CheckEqual(const char *Name, const char *Variant, bool Equal)
+{
+    printf("%-10s %-24s %-16s %s\n", "accuracy", Name, Variant,
+           Equal ? "matches scalar" : "FAIL: differs from scalar");
+
+    if(!Equal) ++BenchFailures;
+}
+
+static bench_points
+BenchInt_MakePoints(sml_u32 Count, sml_u64 Seed)
+{
+    bench_points Points = {};
+
+    sml_f32 **Arrays[] = {&Points.Xs, &Points.Ys, &Points.Zs, &Points.OutXs,
+                          &Points.OutYs, &Points.OutZs, &Points.Radii,
+                          &Points.ExtentXs, &Points.ExtentYs, &Points.ExtentZs};
+
+    for(sml_f32 **Array : Arrays) *Array = (sml_f32*)malloc(Count * sizeof(sml_f32));
+
+    sml_u64 State = Seed;
+    for(sml_u32 Idx = 0; Idx < Count; Idx++)
+    {
+        Points.Xs[Idx]       = BenchInt_RandomFloat(&State, -50.0f, 50.0f);
+        Points.Ys[Idx]       = BenchInt_RandomFloat(&State, -50.0f, 50.0f);
+        Points.Zs[Idx]       = BenchInt_RandomFloat(&State, -50.0f, 50.0f);
+        Points.Radii[Idx]    = BenchInt_RandomFloat(&State,   0.1f,  2.0f);
+        Points.ExtentXs[Idx] = BenchInt_RandomFloat(&State,   0.1f,  2.0f);
+        Points.ExtentYs[Idx] = BenchInt_RandomFloat(&State,   0.1f,  2.0f);
+        Points.ExtentZs[Idx] = BenchInt_RandomFloat(&State,   0.1f,  2.0f);
+    }
+
+    return Points;
+}
+
+static void
+BenchInt_FreePoints(bench_points *Points)
+{
+    sml_f32 *Arrays[] = {Points->Xs, Points->Ys, Points->Zs, Points->OutXs,
+                         Points->OutYs, Points->OutZs, Points->Radii,
+                         Points->ExtentXs, Points->ExtentYs, Points->ExtentZs};
+
+    for(sml_f32 *Array : Arrays) free(Array);
+}
+
+// NOTE: Logical element (Row, Col) is m(4 * Row + Col), stored column major.
+
+static inline sml_f32
+BenchInt_MatrixAt(const sml_matrix4 &M, sml_u32 Row, sml_u32 Col)
+{
+    return (&M.m0)[Col * 4 + Row];
+}
+
+static sml_matrix4
+BenchInt_RandomMatrix(sml_u64 *State)
+{
+    sml_matrix4 Result;
+
+    sml_f32 *Values = &Result.m0;
+    for(sml_u32 Idx = 0; Idx < 16; Idx++)
+    {
+        Values[Idx] = BenchInt_RandomFloat(State, -2.0f, 2.0f);
+    }
+
+    return Result;
+}
+
+static sml_frustum
+BenchInt_Frustum()
+{
+    sml_vector3 Eye     = sml_vector3(3.0f, 2.0f, -30.0f);
+    sml_vector3 Forward = SmlVec3_Normalize(sml_vector3(0.1f, -0.05f, 1.0f));
+    sml_vector3 Up      = sml_vector3(0.0f, 1.0f, 0.0f);
+    sml_vector3 Right   = SmlVec3_Normalize(SmlVec3_VectorProduct(Up, Forward));
+
+    sml_matrix4 View       = SmlMat4_LookAt(Eye, Right, Up, Forward);
+    sml_matrix4 Projection = SmlMat4_Perspective(70.0f, 16.0f / 9.0f);
+
+    return SmlFrustum_FromMatrix(SmlMat4_Multiply(Projection, View));
+}
+
+static sml_triangle_soup
+BenchInt_MakeTriangles(sml_u32 Count, sml_u64 Seed)
+{
+    sml_triangle_soup Soup(Count);
+
+    sml_u64 State = Seed;
+    for(sml_u32 Idx = 0; Idx < Count; Idx++)
+    {
+        sml_vector3 V0 = sml_vector3(BenchInt_RandomFloat(&State, -50.0f, 50.0f),
+                                     BenchInt_RandomFloat(&State, -50.0f, 50.0f),
+                                     BenchInt_RandomFloat(&State, -50.0f, 50.0f));
+        sml_vector3 V1 = V0 + sml_vector3(BenchInt_RandomFloat(&State, -4.0f, 4.0f),
+                                          BenchInt_RandomFloat(&State, -4.0f, 4.0f),
+                                          BenchInt_RandomFloat(&State, -4.0f, 4.0f));
+        sml_vector3 V2 = V0 + sml_vector3(BenchInt_RandomFloat(&State, -4.0f, 4.0f),
+                                          BenchInt_RandomFloat(&State, -4.0f, 4.0f),
+                                          BenchInt_RandomFloat(&State, -4.0f, 4.0f));
+
+        Soup.Set(Idx, V0, V1, V2);
+    }
+
+    return Soup;
+}
+
+// NOTE: Every third ray points anywhere, the others aim at Target.
+
+static sml_ray
+BenchInt_MakeRay(sml_u64 *State, sml_vector3 Target, sml_u32 Idx)
+{
+    sml_vector3 Origin = sml_vector3(BenchInt_RandomFloat(State, -60.0f, 60.0f),
+                                     BenchInt_RandomFloat(State, -60.0f, 60.0f),
+                                     BenchInt_RandomFloat(State, -60.0f, 60.0f));
+
+    if(Idx % 3 == 0)
+    {
+        Target = sml_vector3(BenchInt_RandomFloat(State, -60.0f, 60.0f),
+                             BenchInt_RandomFloat(State, -60.0f, 60.0f),
+                             BenchInt_RandomFloat(State, -60.0f, 60.0f));
+    }
+
+    sml_ray Ray;
+    Ray.Origin      = Origin;
+    Ray.Direction   = SmlVec3_Normalize(Target - Origin);
+    Ray.MaxDistance = 250.0f;
+
+    return Ray;
+}
+
+static inline sml_vector3
+BenchInt_Centroid(const sml_triangle_soup &Soup, sml_u32 Idx)
+{
+    sml_vector3 V0 = sml_vector3(Soup.V0Xs[Idx], Soup.V0Ys[Idx], Soup.V0Zs[Idx]);
+    sml_vector3 E1 = sml_vector3(Soup.E1Xs[Idx], Soup.E1Ys[Idx], Soup.E1Zs[Idx]);
+    sml_vector3 E2 = sml_vector3(Soup.E2Xs[Idx], Soup.E2Ys[Idx], Soup.E2Zs[Idx]);
+
+    return V0 + SmlVec3_Scale(E1 + E2, 1.0f / 3.0f);
+}
+
+// ===================================
+// Throughput
+// ===================================
+
+static void
+BenchInt_VectorOps(sml_u32 Count)
+{
+    sml_u32 Reps = Bench_Repetitions(Count);
+    sml_f64 Ops  = (sml_f64)Count * Reps;
+
+    sml_vector3 *Vec3s = (sml_vector3*)malloc(Count * sizeof(sml_vector3));
+    sml_vector4 *Vec4s = (sml_vector4*)malloc(Count * sizeof(sml_vector4));
+    sml_vector4 *Out   = (sml_vector4*)malloc(Count * sizeof(sml_vector4));
+
+    sml_u64 State = 0xbeef;
+    for(sml_u32 Idx = 0; Idx < Count; Idx++)
+    {
+        sml_f32 X = BenchInt_RandomFloat(&State, -10.0f, 10.0f);
+        sml_f32 Y = BenchInt_RandomFloat(&State, -10.0f, 10.0f);
+        sml_f32 Z = BenchInt_RandomFloat(&State, -10.0f, 10.0f);
+        sml_f32 W = BenchInt_RandomFloat(&State, -10.0f, 10.0f);
+
+        Vec3s[Idx] = sml_vector3(X, Y, Z);
+        Vec4s[Idx] = sml_vector4(X, Y, Z, W);
+    }
+
+    sml_f32 Sum = 0.0f;
+
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            for(sml_u32 Idx = 0; Idx < Count; Idx++)
+            {
+                Sum += SmlVec3_Normalize(Vec3s[Idx]).x;
+            }
+        }
+        Bench_Report("math", "vec3_normalize", "scalar", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            for(sml_u32 Idx = 0; Idx < Count; Idx++)
+            {
+                Out[Idx] = SmlVec4_Normalize(Vec4s[Idx]);
+            }
+            Sum += Out[Rep % Count].x;
+        }
+        Bench_Report("math", "vec4_normalize", "sse", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            for(sml_u32 Idx = 0; Idx < Count; Idx++)
+            {
+                Out[Idx] = SmlVec4_NormalizeScalar(Vec4s[Idx]);
+            }
+            Sum += Out[Rep % Count].x;
+        }
+        Bench_Report("math", "vec4_normalize", "scalar", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            for(sml_u32 Idx = 0; Idx + 1 < Count; Idx++)
+            {
+                Sum += SmlVec4_Dot(Vec4s[Idx], Vec4s[Idx + 1]);
+            }
+        }
+        Bench_Report("math", "vec4_dot", "sse", Count, 1, Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            for(sml_u32 Idx = 0; Idx + 1 < Count; Idx++)
+            {
+                Sum += SmlVec4_DotScalar(Vec4s[Idx], Vec4s[Idx + 1]);
+            }
+        }
+        Bench_Report("math", "vec4_dot", "scalar", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    BenchSink = BenchSink + (sml_u64)Sum;
+
+    free(Vec3s);
+    free(Vec4s);
+    free(Out);
+}
+
+static void
+BenchInt_MatrixOps(sml_u32 Count)
+{
+    sml_u32 Reps = Bench_Repetitions(Count);
+    sml_f64 Ops  = (sml_f64)Count * Reps;
+
+    sml_matrix4 *As  = (sml_matrix4*)malloc(Count * sizeof(sml_matrix4));
+    sml_matrix4 *Bs  = (sml_matrix4*)malloc(Count * sizeof(sml_matrix4));
+    sml_matrix4 *Out = (sml_matrix4*)malloc(Count * sizeof(sml_matrix4));
+
+    sml_transform *Transforms = (sml_transform*)malloc(Count * sizeof(sml_transform));
+
+    sml_u64 State = 0xcafe;
+    for(sml_u32 Idx = 0; Idx < Count; Idx++)
+    {
+        As[Idx] = BenchInt_RandomMatrix(&State);
+        Bs[Idx] = BenchInt_RandomMatrix(&State);
+
+        sml_vector3 Axis = sml_vector3(BenchInt_RandomFloat(&State, -1.0f, 1.0f),
+                                       BenchInt_RandomFloat(&State, -1.0f, 1.0f),
+                                       BenchInt_RandomFloat(&State, -1.0f, 1.0f));
+
+        Transforms[Idx].Translation = sml_vector4(BenchInt_RandomFloat(&State, -9, 9),
+                                                  BenchInt_RandomFloat(&State, -9, 9),
+                                                  BenchInt_RandomFloat(&State, -9, 9),
+                                                  0.0f);
+        Transforms[Idx].Rotation = SmlQuat_FromAxisAngle(Axis, (sml_f32)Idx);
+        Transforms[Idx].Scale    = sml_vector4(1.0f, 2.0f, 0.5f, 0.0f);
+    }
+
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            for(sml_u32 Idx = 0; Idx < Count; Idx++)
+            {
+                Out[Idx] = SmlMat4_Multiply(As[Idx], Bs[Idx]);
+            }
+        }
+        Bench_Report("math", "mat4_multiply", "sse", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            for(sml_u32 Idx = 0; Idx < Count; Idx++)
+            {
+                Out[Idx] = SmlMat4_MultiplyScalar(As[Idx], Bs[Idx]);
+            }
+        }
+        Bench_Report("math", "mat4_multiply", "scalar", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            SmlMat4_ComposeTRSBatch(Transforms, Out, Count);
+        }
+        Bench_Report("math", "compose_trs", "sse_batch", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    {
+        bench_timer Timer = Bench_StartTimer();
+        for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+        {
+            for(sml_u32 Idx = 0; Idx < Count; Idx++)
+            {
+                Out[Idx] = SmlMat4_ComposeTRS(Transforms[Idx]);
+            }
+        }
+        Bench_Report("math", "compose_trs", "single", Count, 1,
+                     Bench_ElapsedNs(Timer) / Ops);
+    }
+
+    BenchSink = BenchSink + (sml_u64)Out[Count / 2].m0;
+
+    free(As);
+    free(Bs);
+    free(Out);
+    free(Transforms);
+}
+
+static void
+BenchInt_Kernels(sml_u32 Count)
+{
+    sml_u32 Reps = Bench_Repetitions(Count);
+    sml_f64 Ops  = (sml_f64)Count * Reps;
+
+    bench_points P = BenchInt_MakePoints(Count, 0xf00d);
+
+    sml_u64     State = 0x5eed;
+    sml_matrix4 M     = BenchInt_RandomMatrix(&State);
+    sml_frustum F     = BenchInt_Frustum();
+
+    sml_sphere_bounds Spheres = {P.Xs, P.Ys, P.Zs, P.Radii};
+    sml_box_bounds    Boxes   = {P.Xs, P.Ys, P.Zs, P.ExtentXs, P.ExtentYs, P.ExtentZs};
+
+    sml_u8 *Mask = (sml_u8*)malloc((Count + 7) / 8);
+
+    for(sml_u32 Isa = SmlIsa_Scalar; Isa <= (sml_u32)SmlCpu.Best; Isa++)
+    {
+        const char *Variant = SmlIsaNames[Isa];
+
+        sml_transform_kernels Transform = SmlInt_BindTransformKernels((Sml_Isa)Isa);
+        sml_cull_kernels      Cull      = SmlInt_BindCullKernels((Sml_Isa)Isa);
+
+        {
+            bench_timer Timer = Bench_StartTimer();
+            for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+            {
+                sml_u32 Idx = Transform.Points(M, P.Xs, P.Ys, P.Zs, P.OutXs, P.OutYs,
+                                               P.OutZs, 0, Count);
+                SmlInt_TransformPointsScalar(M, P.Xs, P.Ys, P.Zs, P.OutXs, P.OutYs,
+                                             P.OutZs, Idx, Count);
+            }
+            Bench_Report("math", "transform_points", Variant, Count, 1,
+                         Bench_ElapsedNs(Timer) / Ops);
+        }
+
+        {
+            bench_timer Timer = Bench_StartTimer();
+            for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+            {
+                sml_u32 Idx = Transform.Normals(M, P.Xs, P.Ys, P.Zs, P.OutXs, P.OutYs,
+                                                P.OutZs, 0, Count);
+                SmlInt_TransformNormalsScalar(M, P.Xs, P.Ys, P.Zs, P.OutXs, P.OutYs,
+                                              P.OutZs, Idx, Count);
+            }
+            Bench_Report("math", "transform_normals", Variant, Count, 1,
+                         Bench_ElapsedNs(Timer) / Ops);
+        }
+
+        {
+            bench_timer Timer = Bench_StartTimer();
+            for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+            {
+                sml_u32 Idx = Cull.Spheres(F, Spheres, 0, Count, Mask);
+                SmlInt_CullSpheresScalar(F, Spheres, Idx, Count, Mask);
+            }
+            Bench_Report("math", "cull_spheres", Variant, Count, 1,
+                         Bench_ElapsedNs(Timer) / Ops);
+        }
+
+        {
+            bench_timer Timer = Bench_StartTimer();
+            for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+            {
+                sml_u32 Idx = Cull.Boxes(F, Boxes, 0, Count, Mask);
+                SmlInt_CullBoxesScalar(F, Boxes, Idx, Count, Mask);
+            }
+            Bench_Report("math", "cull_boxes", Variant, Count, 1,
+                         Bench_ElapsedNs(Timer) / Ops);
+        }
+    }
+
+    BenchSink = BenchSink + Mask[0] + (sml_u64)P.OutXs[0];
+
+    free(Mask);
+    BenchInt_FreePoints(&P);
+}
+
+// NOTE: One ray per repetition against every triangle or box, so ns per
+// element is the cost of one ray against one primitive.
+
+static void
+BenchInt_RayKernels(sml_u32 Count)
+{
+    sml_u32 Reps = Bench_Repetitions(Count);
+    sml_f64 Ops  = (sml_f64)Count * Reps;
+
+    bench_points      P    = BenchInt_MakePoints(Count, 0xfeed);
+    sml_triangle_soup Soup = BenchInt_MakeTriangles(Count, 0xfade);
+
+    sml_box_bounds Boxes = {P.Xs, P.Ys, P.Zs, P.ExtentXs, P.ExtentYs, P.ExtentZs};
+
+    sml_ray *Rays  = (sml_ray*)malloc(Reps * sizeof(sml_ray));
+    sml_u64  State = 0x7a7;
+
+    for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+    {
+        sml_u32 Target = (sml_u32)(Bench_Random(&State) % Count);
+        Rays[Rep]      = BenchInt_MakeRay(&State, BenchInt_Centroid(Soup, Target), Rep);
+    }
+
+    sml_u64 Hits = 0;
+
+    for(sml_u32 Isa = SmlIsa_Scalar; Isa <= (sml_u32)SmlCpu.Best; Isa++)
+    {
+        const char *Variant = SmlIsaNames[Isa];
+
+        sml_ray_kernels Kernels = SmlInt_BindRayKernels((Sml_Isa)Isa);
+
+        {
+            bench_timer Timer = Bench_StartTimer();
+            for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+            {
+                sml_ray_hit Best = SmlInt_RayMiss(Rays[Rep]);
+                sml_u32     Idx  = Kernels.Triangles(Rays[Rep], Soup, 0, Count, &Best);
+                SmlInt_RayTrianglesScalar(Rays[Rep], Soup, Idx, Count, &Best);
+
+                Hits += Best.Index;
+            }
+            Bench_Report("math", "ray_triangles", Variant, Count, 1,
+                         Bench_ElapsedNs(Timer) / Ops);
+        }
+
+        {
+            bench_timer Timer = Bench_StartTimer();
+            for(sml_u32 Rep = 0; Rep < Reps; Rep++)
+            {
+                const sml_ray &Ray    = Rays[Rep];
+                sml_vector3    InvDir = sml_vector3(1.0f / Ray.Direction.x,
+                                                    1.0f / Ray.Direction.y,
+                                                    1.0f / Ray.Direction.z);
+
+                sml_ray_hit Best = SmlInt_RayMiss(Ray);
+                sml_u32     Idx  = Kernels.Boxes(Ray, InvDir, Boxes, 0, Count, &Best);
+                SmlInt_RayBoxesScalar(Ray, InvDir, Boxes, Idx, Count, &Best);
+
+                Hits += Best.Index;
+            }
+            Bench_Report("math", "ray_boxes", Variant, Count, 1,
+                         Bench_ElapsedNs(Timer) / Ops);
+        }
+    }
+
+    BenchSink = BenchSink + Hits;
+
+    free(Rays);
+    Soup.Free();
+    BenchInt_FreePoints(&P);
+}
+
+// ===================================
+// Accuracy
+// ===================================
+
+static void
+BenchInt_VectorAccuracy()
+{
+    bench_ulp_stats Vec3Normalize = {}, Vec4Normalize = {}, Vec4NormalizeScalar = {};
+    bench_ulp_stats Vec4Dot = {}, Vec4DotScalar = {};
+
+    sml_u64 State = 0xacc0;
+    for(sml_u32 Idx = 0; Idx < BenchAccuracyCount; Idx++)
+    {
+        sml_f32 X = BenchInt_RandomFloat(&State, -100.0f, 100.0f);
+        sml_f32 Y = BenchInt_RandomFloat(&State, -100.0f, 100.0f);
+        sml_f32 Z = BenchInt_RandomFloat(&State, -100.0f, 100.0f);
+        sml_f32 W = BenchInt_RandomFloat(&State, -100.0f, 100.0f);
+
+        sml_vector4 A = sml_vector4(X, Y, Z, W);
+        sml_vector4 B = sml_vector4(W, X, -Y, Z);
+
+        // Normalize, unit length output so errors are in ULPs of 1.
+        {
+            sml_f64 Length3 = sqrt((sml_f64)X * X + (sml_f64)Y * Y + (sml_f64)Z * Z);
+            sml_f64 Length4 = sqrt(Length3 * Length3 + (sml_f64)W * W);
+
+            sml_vector3 N3  = SmlVec3_Normalize(sml_vector3(X, Y, Z));
+            sml_vector4 N4  = SmlVec4_Normalize(A);
+            sml_vector4 N4S = SmlVec4_NormalizeScalar(A);
+
+            sml_f32 In[4] = {X, Y, Z, W};
+            sml_f32 Out3[3] = {N3.x, N3.y, N3.z};
+
+            for(sml_u32 Lane = 0; Lane < 3; Lane++)
+            {
+                BenchInt_AddUlps(&Vec3Normalize,
+                                 BenchInt_Ulps(Out3[Lane], In[Lane] / Length3, 1.0));
+            }
+
+            for(sml_u32 Lane = 0; Lane < 4; Lane++)
+            {
+                sml_f64 Reference = In[Lane] / Length4;
+
+                BenchInt_AddUlps(&Vec4Normalize,
+                                 BenchInt_Ulps((&N4.x)[Lane], Reference, 1.0));
+                BenchInt_AddUlps(&Vec4NormalizeScalar,
+                                 BenchInt_Ulps((&N4S.x)[Lane], Reference, 1.0));
+            }
+        }
+
+        // Dot
+        {
+            sml_f64 Reference = 0.0, Magnitude = 0.0;
+            for(sml_u32 Lane = 0; Lane < 4; Lane++)
+            {
+                sml_f64 Term = (sml_f64)(&A.x)[Lane] * (sml_f64)(&B.x)[Lane];
+                Reference += Term;
+                Magnitude += fabs(Term);
+            }
+
+            sml_f32 Dot       = SmlVec4_Dot(A, B);
+            sml_f32 DotScalar = SmlVec4_DotScalar(A, B);
+
+            BenchInt_AddUlps(&Vec4Dot, BenchInt_Ulps(Dot, Reference, Magnitude));
+            BenchInt_AddUlps(&Vec4DotScalar,
+                             BenchInt_Ulps(DotScalar, Reference, Magnitude));
+        }
+    }
+
+    BenchInt_CheckUlps("vec3_normalize", "scalar", Vec3Normalize, BenchUlp_Normalize);
+    BenchInt_CheckUlps("vec4_normalize", "sse", Vec4Normalize, BenchUlp_Normalize);
+    BenchInt_CheckUlps("vec4_normalize", "scalar", Vec4NormalizeScalar,
+                       BenchUlp_Normalize);
+    BenchInt_CheckUlps("vec4_dot", "sse", Vec4Dot, BenchUlp_Dot);
+    BenchInt_CheckUlps("vec4_dot", "scalar", Vec4DotScalar, BenchUlp_Dot);
+}
+
+static void
+BenchInt_MatrixAccuracy()
+{
+    bench_ulp_stats Multiply = {}, MultiplyScalar = {};
+    bool            Identical = true;
+
+    sml_u64 State = 0xacc1;
+    for(sml_u32 Idx = 0; Idx < BenchAccuracyCount / 16; Idx++)
+    {
+        sml_matrix4 A = BenchInt_RandomMatrix(&State);
+        sml_matrix4 B = BenchInt_RandomMatrix(&State);
+
+        sml_matrix4 R  = SmlMat4_Multiply(A, B);
+        sml_matrix4 RS = SmlMat4_MultiplyScalar(A, B);
+
+        Identical = Identical && memcmp(&R, &RS, sizeof(sml_matrix4)) == 0;
+
+        for(sml_u32 Row = 0; Row < 4; Row++)
+        {
+            for(sml_u32 Col = 0; Col < 4; Col++)
+            {
+                sml_f64 Reference = 0.0, Magnitude = 0.0;
+                for(sml_u32 K = 0; K < 4; K++)
+                {
+                    sml_f64 Term = (sml_f64)BenchInt_MatrixAt(A, Row, K) *
+                                   (sml_f64)BenchInt_MatrixAt(B, K, Col);
+                    Reference += Term;
+                    Magnitude += fabs(Term);
+                }
+
+                BenchInt_AddUlps(&Multiply,
+                                 BenchInt_Ulps(BenchInt_MatrixAt(R, Row, Col),
+                                               Reference, Magnitude));
+                BenchInt_AddUlps(&MultiplyScalar,
+                                 BenchInt_Ulps(BenchInt_MatrixAt(RS, Row, Col),
+                                               Reference, Magnitude));
+            }
+        }
+    }
+
+    BenchInt_CheckUlps("mat4_multiply", "sse", Multiply, BenchUlp_Multiply);
+    BenchInt_CheckUlps("mat4_multiply", "scalar", MultiplyScalar, BenchUlp_Multiply);
+    BenchInt_CheckEqual("mat4_multiply", "sse", Identical);
+}
+
+static void
+BenchInt_KernelAccuracy()
+{
+    const sml_u32 Count = BenchAccuracyCount + 5;
+
+    bench_points P = BenchInt_MakePoints(Count, 0xacc2);
+
+    sml_u64     State = 0xacc3;
+    sml_matrix4 M     = BenchInt_RandomMatrix(&State);
+    sml_frustum F     = BenchInt_Frustum();
+
+    sml_sphere_bounds Spheres = {P.Xs, P.Ys, P.Zs, P.Radii};
+    sml_box_bounds    Boxes   = {P.Xs, P.Ys, P.Zs, P.ExtentXs, P.ExtentYs, P.ExtentZs};
+
+    sml_f32 *RefXs = (sml_f32*)malloc(Count * sizeof(sml_f32) * 3);
+    sml_f32 *RefYs = RefXs + Count;
+    sml_f32 *RefZs = RefYs + Count;
+
+    sml_u32 MaskBytes = (Count + 7) / 8;
+    sml_u8 *Mask      = (sml_u8*)malloc(MaskBytes * 2);
+    sml_u8 *RefMask   = Mask + MaskBytes;
+
+    for(sml_u32 Isa = SmlIsa_Scalar; Isa <= (sml_u32)SmlCpu.Best; Isa++)
+    {
+        const char *Variant = SmlIsaNames[Isa];
+
+        sml_transform_kernels Transform = SmlInt_BindTransformKernels((Sml_Isa)Isa);
+        sml_cull_kernels      Cull      = SmlInt_BindCullKernels((Sml_Isa)Isa);
+
+        // Points
+        {
+            sml_u32 Tail = Transform.Points(M, P.Xs, P.Ys, P.Zs, P.OutXs, P.OutYs,
+                                            P.OutZs, 0, Count);
+            SmlInt_TransformPointsScalar(M, P.Xs, P.Ys, P.Zs, P.OutXs, P.OutYs,
+                                         P.OutZs, Tail, Count);
+            SmlInt_TransformPointsScalar(M, P.Xs, P.Ys, P.Zs, RefXs, RefYs, RefZs,
+                                         0, Count);
+
+            bench_ulp_stats Stats = {};
+
+            const sml_f32 *Outs[3] = {P.OutXs, P.OutYs, P.OutZs};
+
+            for(sml_u32 Idx = 0; Idx < Count; Idx++)
+            {
+                sml_f64 In[4] = {P.Xs[Idx], P.Ys[Idx], P.Zs[Idx], 1.0};
+
+                for(sml_u32 Row = 0; Row < 3; Row++)
+                {
+                    sml_f64 Reference = 0.0, Magnitude = 0.0;
+                    for(sml_u32 K = 0; K < 4; K++)
+                    {
+                        sml_f64 Term = (sml_f64)BenchInt_MatrixAt(M, Row, K) * In[K];
+                        Reference += Term;
+                        Magnitude += fabs(Term);
+                    }
+
+                    BenchInt_AddUlps(&Stats,
+                                     BenchInt_Ulps(Outs[Row][Idx], Reference, Magnitude));
+                }
+            }
+
+            bool Equal = memcmp(P.OutXs, RefXs, Count * sizeof(sml_f32)) == 0 &&
+                         memcmp(P.OutYs, RefYs, Count * sizeof(sml_f32)) == 0 &&
+                         memcmp(P.OutZs, RefZs, Count * sizeof(sml_f32)) == 0;
+
+            BenchInt_CheckUlps("transform_points", Variant, Stats, BenchUlp_Transform);
+            BenchInt_CheckEqual("transform_points", Variant, Equal);
+        }
+
+        // Normals
+        {
+            sml_u32 Tail = Transform.Normals(M, P.Xs, P.Ys, P.Zs, P.OutXs, P.OutYs,
+                                             P.OutZs, 0, Count);
+            SmlInt_TransformNormalsScalar(M, P.Xs, P.Ys, P.Zs, P.OutXs, P.OutYs,
+                                          P.OutZs, Tail, Count);
+            SmlInt_TransformNormalsScalar(M, P.Xs, P.Ys, P.Zs, RefXs, RefYs, RefZs,
+                                          0, Count);
+
+            bench_ulp_stats Stats = {};
+
+            for(sml_u32 Idx = 0; Idx < Count; Idx++)
+            {
+                sml_f64 In[3] = {P.Xs[Idx], P.Ys[Idx], P.Zs[Idx]};
+                sml_f64 N[3];
+
+                for(sml_u32 Row = 0; Row < 3; Row++)
+                {
+                    N[Row] = 0.0;
+                    for(sml_u32 K = 0; K < 3; K++)
+                    {
+                        N[Row] += (sml_f64)BenchInt_MatrixAt(M, Row, K) * In[K];
+                    }
+                }
+
+                sml_f64 Length = sqrt(N[0] * N[0] + N[1] * N[1] + N[2] * N[2]);
+                if(Length == 0.0) continue;
+
+                // Unit length output, a component is at most 1 so use 1 as the
+                // magnitude to not weigh components near zero by their size.
+                BenchInt_AddUlps(&Stats, BenchInt_Ulps(P.OutXs[Idx], N[0] / Length, 1.0));
+                BenchInt_AddUlps(&Stats, BenchInt_Ulps(P.OutYs[Idx], N[1] / Length, 1.0));
+                BenchInt_AddUlps(&Stats, BenchInt_Ulps(P.OutZs[Idx], N[2] / Length, 1.0));
+            }
+
+            bool Equal = memcmp(P.OutXs, RefXs, Count * sizeof(sml_f32)) == 0 &&
+                         memcmp(P.OutYs, RefYs, Count * sizeof(sml_f32)) == 0 &&
+                         memcmp(P.OutZs, RefZs, Count * sizeof(sml_f32)) == 0;
+
+            BenchInt_CheckUlps("transform_normals", Variant, Stats, BenchUlp_Normals);
+            BenchInt_CheckEqual("transform_normals", Variant, Equal);
+        }
+
+        // Culling, a yes/no answer: compare to the scalar reference only.
+        {
+            sml_u32 Idx = Cull.Spheres(F, Spheres, 0, Count, Mask);
+            SmlInt_CullSpheresScalar(F, Spheres, Idx, Count, Mask);
+            SmlInt_CullSpheresScalar(F, Spheres, 0, Count, RefMask);
+
+            BenchInt_CheckEqual("cull_spheres", Variant,
+                                memcmp(Mask, RefMask, MaskBytes) == 0);
+
+            Idx = Cull.Boxes(F, Boxes, 0, Count, Mask);
+            SmlInt_CullBoxesScalar(F, Boxes, Idx, Count, Mask);
+            SmlInt_CullBoxesScalar(F, Boxes, 0, Count, RefMask);
+
+            BenchInt_CheckEqual("cull_boxes", Variant,
+                                memcmp(Mask, RefMask, MaskBytes) == 0);
+        }
+    }
+
+    free(RefXs);
+    free(Mask);
+    BenchInt_FreePoints(&P);
+}
+
+static void
+BenchInt_RayAccuracy()
+{
+    const sml_u32 Count    = 4096 + 5;
+    const sml_u32 RayCount = 4096;
+
+    bench_points      P    = BenchInt_MakePoints(Count, 0xacc4);
+    sml_triangle_soup Soup = BenchInt_MakeTriangles(Count, 0xacc5);
+
+    sml_box_bounds Boxes = {P.Xs, P.Ys, P.Zs, P.ExtentXs, P.ExtentYs, P.ExtentZs};
+
+    // Copies 3 and 8 triangles back, inside one group and across groups.
+    for(sml_u32 Idx = 8; Idx < Count; Idx += 16)
+    {
+        sml_u32 From = Idx % 32 == 8 ? Idx - 3 : Idx - 8;
+
+        sml_vector3 V0 = sml_vector3(Soup.V0Xs[From], Soup.V0Ys[From], Soup.V0Zs[From]);
+        sml_vector3 E1 = sml_vector3(Soup.E1Xs[From], Soup.E1Ys[From], Soup.E1Zs[From]);
+        sml_vector3 E2 = sml_vector3(Soup.E2Xs[From], Soup.E2Ys[From], Soup.E2Zs[From]);
+
+        Soup.Set(Idx, V0, V0 + E1, V0 + E2);
+    }
+
+    sml_ray *TriangleRays = (sml_ray*)malloc(RayCount * sizeof(sml_ray) * 2);
+    sml_ray *BoxRays      = TriangleRays + RayCount;
+
+    sml_u64 State = 0xacc6;
+    for(sml_u32 Idx = 0; Idx < RayCount; Idx++)
+    {
+        sml_u32     Target = (sml_u32)(Bench_Random(&State) % Count);
+        sml_vector3 Center = sml_vector3(P.Xs[Target], P.Ys[Target], P.Zs[Target]);
+
+        sml_vector3 Centroid = BenchInt_Centroid(Soup, Target);
+
+        TriangleRays[Idx] = BenchInt_MakeRay(&State, Centroid, Idx);
+        BoxRays[Idx]      = BenchInt_MakeRay(&State, Center, Idx);
+
+        // Inside a box, axis aligned, and along z from a face of the box so
+        // 0 * inf and an exit at distance 0 show up in the slabs.
+        sml_ray    &Ray = BoxRays[Idx];
+        sml_vector3 Min = Center - sml_vector3(P.ExtentXs[Target], P.ExtentYs[Target],
+                                               P.ExtentZs[Target]);
+        sml_vector3 Max = Center + sml_vector3(P.ExtentXs[Target], P.ExtentYs[Target],
+                                               P.ExtentZs[Target]);
+
+        switch(Idx % 8)
+        {
+            case 1: Ray.Origin = Center; break;
+            case 3: Ray.Origin = sml_vector3(Min.x, Center.y, Center.z); break;
+            case 4: Ray.Origin = sml_vector3(Max.x, Center.y, Center.z); break;
+            case 5: Ray.Origin = sml_vector3(Center.x, Center.y, Max.z); break;
+        }
+
+        if(Idx % 8 >= 2 && Idx % 8 <= 5) Ray.Direction = sml_vector3(0.0f, 0.0f, 1.0f);
+    }
+
+    sml_ray_hit *RefTriangles = (sml_ray_hit*)malloc(RayCount * sizeof(sml_ray_hit) * 2);
+    sml_ray_hit *RefBoxes     = RefTriangles + RayCount;
+
+    sml_u32 TriangleHits = 0, BoxHits = 0;
+
+    for(sml_u32 Idx = 0; Idx < RayCount; Idx++)
+    {
+        RefTriangles[Idx] = SmlRay_IntersectTrianglesScalar(TriangleRays[Idx], Soup);
+        RefBoxes[Idx]     = SmlRay_IntersectBoxesScalar(BoxRays[Idx], Boxes, Count);
+
+        TriangleHits += RefTriangles[Idx].Index != sml_ray_hit::Invalid;
+        BoxHits      += RefBoxes[Idx].Index != sml_ray_hit::Invalid;
+    }
+
+    printf("accuracy: rays hit in %u of %u triangle and %u of %u box queries\n",
+           TriangleHits, RayCount, BoxHits, RayCount);
+
+    for(sml_u32 Isa = SmlIsa_Scalar; Isa <= (sml_u32)SmlCpu.Best; Isa++)
+    {
+        const char *Variant = SmlIsaNames[Isa];
+
+        sml_ray_kernels Kernels = SmlInt_BindRayKernels((Sml_Isa)Isa);
+
+        bool TrianglesEqual = true, BoxesEqual = true;
+
+        for(sml_u32 Idx = 0; Idx < RayCount; Idx++)
+        {
+            const sml_ray &Ray  = TriangleRays[Idx];
+            sml_ray_hit    Best = SmlInt_RayMiss(Ray);
+
+            sml_u32 Tail = Kernels.Triangles(Ray, Soup, 0, Count, &Best);
+            SmlInt_RayTrianglesScalar(Ray, Soup, Tail, Count, &Best);
+
+            TrianglesEqual = TrianglesEqual &&
+                             memcmp(&Best, &RefTriangles[Idx], sizeof(sml_ray_hit)) == 0;
+        }
+
+        for(sml_u32 Idx = 0; Idx < RayCount; Idx++)
+        {
+            const sml_ray &Ray    = BoxRays[Idx];
+            sml_vector3    InvDir = sml_vector3(1.0f / Ray.Direction.x,
+                                                1.0f / Ray.Direction.y,
+                                                1.0f / Ray.Direction.z);
+
+            sml_ray_hit Best = SmlInt_RayMiss(Ray);
+
+            sml_u32 Tail = Kernels.Boxes(Ray, InvDir, Boxes, 0, Count, &Best);
+            SmlInt_RayBoxesScalar(Ray, InvDir, Boxes, Tail, Count, &Best);
+
+            BoxesEqual = BoxesEqual &&
+                         memcmp(&Best, &RefBoxes[Idx], sizeof(sml_ray_hit)) == 0;
+        }
+
+        BenchInt_CheckEqual("ray_triangles", Variant, TrianglesEqual);
+        BenchInt_CheckEqual("ray_boxes", Variant, BoxesEqual);
+    }
+
+    // The user API runs on the bound ISA. Line of sight must hit when the
+    // closest query does.
+    {
+        bool ClosestEqual = true, AnyEqual = true;
+
+        for(sml_u32 Idx = 0; Idx < RayCount; Idx++)
+        {
+            sml_ray_hit Triangle = SmlRay_IntersectTriangles(TriangleRays[Idx], Soup);
+            sml_ray_hit Box      = SmlRay_IntersectBoxes(BoxRays[Idx], Boxes, Count);
+
+            ClosestEqual = ClosestEqual &&
+                memcmp(&Triangle, &RefTriangles[Idx], sizeof(sml_ray_hit)) == 0 &&
+                memcmp(&Box, &RefBoxes[Idx], sizeof(sml_ray_hit)) == 0;
+
+            bool TriangleHit = RefTriangles[Idx].Index != sml_ray_hit::Invalid;
+            bool BoxHit      = RefBoxes[Idx].Index != sml_ray_hit::Invalid;
+
+            AnyEqual = AnyEqual &&
+                       SmlRay_AnyTriangle(TriangleRays[Idx], Soup) == TriangleHit &&
+                       SmlRay_AnyBox(BoxRays[Idx], Boxes, Count) == BoxHit;
+        }
+
+        BenchInt_CheckEqual("ray_closest", SmlIsaNames[SmlCpu.Isa], ClosestEqual);
+        BenchInt_CheckEqual("ray_any", SmlIsaNames[SmlCpu.Isa], AnyEqual);
+    }
+
+    free(TriangleRays);
+    free(RefTriangles);
+    Soup.Free();
+    BenchInt_FreePoints(&P);
+}
+
+// ===================================
+// Benchmarks
+// ===================================
+
+static void
+Bench_Math()
+{
+    printf("math: kernels bound to %s (best %s)\n", SmlIsaNames[SmlCpu.Isa],
+           SmlIsaNames[SmlCpu.Best]);
+
+    for(sml_u32 Count : BenchMathSizes) BenchInt_VectorOps(Count);
+    for(sml_u32 Count : BenchMathSizes) BenchInt_MatrixOps(Count);
+    for(sml_u32 Count : BenchMathSizes) BenchInt_Kernels(Count);
+    for(sml_u32 Count : BenchMathSizes) BenchInt_RayKernels(Count);
+}
+
+static void
+Bench_MathAccuracy()
+{
+    BenchInt_VectorAccuracy();
+    BenchInt_MatrixAccuracy();
+    BenchInt_KernelAccuracy();
+    BenchInt_RayAccuracy();
+}
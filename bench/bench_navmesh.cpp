@@ -0,0 +1,1644 @@
+// ===================================
+// Type Definitions
+// ===================================
+
+// NOTE:
+// 1) "navmesh" builds a nav mesh from a grid terrain and reports every stage in
+//    ns per input triangle. The terrain has rolling hills with steep pillars,
+//    which cut holes into the walkable area, and walls splitting it into
+//    several clusters.
+// 2) Everything is rebuilt from scratch every repetition, like an editor bake.
+//    The triangles of every polygon must cover exactly its area, a polygon
+//    overlapping itself covers more.
+// 3) "classify" runs the walkable classification alone, once per ISA the CPU
+//    supports. Every path must match the scalar normals and mask bit for bit.
+// 4) "adjacency" builds the walkable list with the edge hashmap and with the
+//    radix sort, both must give the same Across table.
+// 5) "weld" welds a triangle soup copy of the terrain (3 points per triangle,
+//    like an importer that splits every vertex), exact and with a tolerance.
+//    Every index must end on a point at the terrain position, and the unique
+//    point count must match the terrain's.
+// 6) "pathfind" runs FindPath between random piece centers of one nav polygon,
+//    with every area at cost 1 and with a quarter of the pieces 4 times as
+//    expensive. SmlMemory must look the same after the queries as before.
+//    "straight_path" runs the funnel on the default cost corridors, every path
+//    must run from the start to the end point, cross the corridor's portals
+//    in order and be no longer than the polyline through the portal midpoints,
+//    seen from above. On a grid with one pillar, two points that see each
+//    other must get the segment between them.
+// 7) "hierarchical" runs FindPath and FindPathHierarchical between far apart
+//    pieces of one nav polygon (the farthest of BenchPathCandidates), before
+//    and after a quarter of the pieces change area. Statuses must match, and
+//    on the first BenchCheapestQueries neither path may be cheaper than the
+//    cheapest corridor, found by an exact search over the portals. "hierarchy"
+//    reports the build and the dirty region update in ns per piece. After the
+//    mesh is rebuilt in place, UpdateNavHierarchy must rebuild every region.
+// 8) "path_service" feeds BenchServiceRequests requests to a nav_path_service,
+//    BenchServicePerFrame per frame with every fourth one between other points
+//    of the pieces of the one before, and reports the main thread time per
+//    request next to calling FindPath directly. Every result must match
+//    FindPath, a joined one only in status and, when FindPath finds the same
+//    corridor, in cost.
+// 9) "corridor" moves BenchCorridorAgents agents for BenchCorridorFrames frames
+//    toward targets that drift BenchCorridorDrift per frame, and compares a
+//    FindPath every frame with UpdateNavCorridor. Every corridor must link
+//    the agent's piece to the target's.
+// 10) "path_cache" runs BenchCacheQueries queries over BenchCacheRoutes routes,
+//    each from a random point of the route's start piece to one of its end
+//    piece, plus the funnel, with FindPath and with FindPathCached. Cached
+//    corridors must link the two pieces and cost what FindPath says when it
+//    finds the same corridor. A rebuilt mesh must empty the cache, and so
+//    must InvalidateNavPathCache after an area is written straight into a
+//    piece.
+// 11) Each size runs on 1, 2, 4 .. N threads (N = hardware threads, at least 2)
+//    for a scaling report. Every run must give the same polygons as the single
+//    threaded one, bit for bit, or the run fails. Each run also reports the
+//    share of the build spent holding the SmlMemory lock, and how many locks
+//    per build had to spin.
+
+struct bench_terrain
+{
+    sml_vector3 *Positions;
+    sml_u32     *Indices;
+    sml_u32      IdxCount;
+
+    sml_heap_block PositionsHeap;
+    sml_heap_block IndicesHeap;
+};
+
+// Cells per side, 2 triangles per cell, up to ~1M triangles.
+static const sml_u32 BenchNavMeshSizes[] = {64, 128, 256, 724};
+
+constexpr sml_f32 BenchNavMeshSlope = 45.0f;
+
+constexpr sml_u32 BenchPathQueries  = 1024;
+constexpr sml_u32 BenchPathCapacity = 4096;
+constexpr sml_u32 BenchPathMaxPoints = 1024;
+constexpr sml_u32 BenchPathCandidates = 16;
+constexpr sml_u32 BenchCheapestQueries = 64;
+
+constexpr sml_u32 BenchServiceRequests = 4096;
+constexpr sml_u32 BenchServicePerFrame = 256;
+constexpr sml_u32 BenchServiceCapacity = 1024;
+constexpr sml_u64 BenchServiceBudget   = 2000000;
+
+constexpr sml_u32 BenchCorridorAgents = 256;
+constexpr sml_u32 BenchCorridorFrames = 64;
+constexpr sml_f32 BenchCorridorDrift  = 0.1f;
+constexpr sml_f32 BenchCorridorSpeed  = 0.25f;
+
+constexpr sml_u32 BenchCacheRoutes  = 64;
+constexpr sml_u32 BenchCacheQueries = 4096;
+
+// ===================================
+// Internal Helpers
+// ===================================
+
+// NOTE: OnePillar gives a flat grid with a single pillar in the middle, one
+// polygon with one hole.
+
+static bench_terrain
+BenchInt_MakeTerrain(sml_u32 Cells, bool OnePillar = false)
+{
+    bench_terrain Terrain = {};
+
+    sml_u32 Side = Cells + 1;
+
+    Terrain.PositionsHeap = SmlMemory.Allocate(Side * Side * sizeof(sml_vector3));
+    Terrain.IndicesHeap   = SmlMemory.Allocate(Cells * Cells * 6 * sizeof(sml_u32));
+    Terrain.Positions     = (sml_vector3*)Terrain.PositionsHeap.Data;
+    Terrain.Indices       = (sml_u32*)Terrain.IndicesHeap.Data;
+
+    for(sml_u32 Z = 0; Z < Side; Z++)
+    {
+        for(sml_u32 X = 0; X < Side; X++)
+        {
+            sml_f32 Height = 0.25f * sinf(X * 0.05f) * cosf(Z * 0.07f);
+
+            // Pillars every 16 cells, walls every 128 cells.
+            if(X % 16 == 8 && Z % 16 == 8) Height += 10.0f;
+            if(X % 128 == 100)             Height += 10.0f;
+
+            if(OnePillar) Height = (X == Cells / 2 && Z == Cells / 2) ? 10.0f : 0.0f;
+
+            Terrain.Positions[Z * Side + X] = sml_vector3((sml_f32)X, Height, (sml_f32)Z);
+        }
+    }
+
+    // Wound so the normals point up.
+    sml_u32 *Index = Terrain.Indices;
+
+    for(sml_u32 Z = 0; Z < Cells; Z++)
+    {
+        for(sml_u32 X = 0; X < Cells; X++)
+        {
+            sml_u32 V00 = Z * Side + X;
+            sml_u32 V10 = V00 + 1;
+            sml_u32 V01 = V00 + Side;
+            sml_u32 V11 = V01 + 1;
+
+            *Index++ = V00; *Index++ = V01; *Index++ = V10;
+            *Index++ = V10; *Index++ = V01; *Index++ = V11;
+        }
+    }
+
+    Terrain.IdxCount = Cells * Cells * 6;
+
+    return Terrain;
+}
+
+// NOTE: Seen from above, like the nav polygons. Bridges add no area since both
+// sides of a cut cancel out.
+
+static bool
+BenchInt_AreasMatch(dynamic_array<SML::nav_poly> &Polygons)
+{
+    sml_f64 PolygonArea     = 0.0;
+    sml_f64 TriangulateArea = 0.0;
+
+    for(sml_u32 PolyIdx = 0; PolyIdx < Polygons.Count; PolyIdx++)
+    {
+        dynamic_array<sml_vector3> &Verts = Polygons[PolyIdx].Verts;
+        auto Points = dynamic_array<sml_vector2>(Verts.Count);
+
+        for(sml_u32 Idx = 0; Idx < Verts.Count; Idx++)
+        {
+            sml_vector3 A = Verts[Idx];
+            sml_vector3 B = Verts[(Idx + 1) % Verts.Count];
+
+            PolygonArea += 0.5 * ((sml_f64)A.x * B.z - (sml_f64)B.x * A.z);
+            Points.Push(sml_vector2(A.x, A.z));
+        }
+
+        auto Triangles = SmlInt_Triangulate(Points, SmlTriangulate_Monotone);
+
+        for(sml_u32 Idx = 0; Idx + 2 < Triangles.Count; Idx += 3)
+        {
+            sml_vector2 A = Points[Triangles[Idx + 0]];
+            sml_vector2 B = Points[Triangles[Idx + 1]];
+            sml_vector2 C = Points[Triangles[Idx + 2]];
+
+            TriangulateArea += 0.5 * fabs(((sml_f64)B.x - A.x) * ((sml_f64)C.y - A.y) -
+                                          ((sml_f64)C.x - A.x) * ((sml_f64)B.y - A.y));
+        }
+
+        if(Triangles.Values) Triangles.Free();
+        Points.Free();
+    }
+
+    bool Match = fabs(TriangulateArea - PolygonArea) <= 1e-4 * fabs(PolygonArea);
+
+    if(!Match)
+    {
+        printf("navmesh: triangles cover %.1f units^2, the polygons %.1f\n",
+               TriangulateArea, PolygonArea);
+    }
+
+    return Match;
+}
+
+static bool
+BenchInt_SamePolygons(dynamic_array<SML::nav_poly> &A, dynamic_array<SML::nav_poly> &B)
+{
+    if(A.Count != B.Count) return false;
+
+    for(sml_u32 Idx = 0; Idx < A.Count; Idx++)
+    {
+        auto &VertsA = A[Idx].Verts;
+        auto &VertsB = B[Idx].Verts;
+
+        if(VertsA.Count != VertsB.Count) return false;
+        if(memcmp(VertsA.Values, VertsB.Values, VertsA.Count * sizeof(sml_vector3)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void
+BenchInt_FreePolygons(dynamic_array<SML::nav_poly> &Polygons)
+{
+    for(sml_u32 Idx = 0; Idx < Polygons.Count; Idx++) Polygons[Idx].Verts.Free();
+
+    Polygons.Free();
+}
+
+static void
+BenchInt_Classify(bench_terrain *Terrain)
+{
+    sml_u32 TriCount  = Terrain->IdxCount / 3;
+    sml_u32 MaskBytes = (TriCount + 7) / 8;
+
+    sml_f32 Threshold = cosf(BenchNavMeshSlope * (3.14158265f / 180.0f));
+
+    size_t         SlotSize = TriCount * 3 * sizeof(sml_f32) + MaskBytes;
+    sml_heap_block Heap     = SmlMemory.Allocate(2 * SlotSize);
+
+    sml_f32 *Normals[2];
+    sml_u8  *Masks[2];
+
+    for(sml_u32 Idx = 0; Idx < 2; Idx++)
+    {
+        sml_u8 *Base = (sml_u8*)Heap.Data + Idx * SlotSize;
+
+        Normals[Idx] = (sml_f32*)Base;
+        Masks[Idx]   = Base + TriCount * 3 * sizeof(sml_f32);
+    }
+
+    sml_u32 Repetitions = Bench_Repetitions(TriCount);
+
+    for(sml_u32 Isa = SmlIsa_Scalar; Isa <= (sml_u32)SmlCpu.Best; Isa++)
+    {
+        sml_walkable_kernels Kernels = SmlInt_BindWalkableKernels((Sml_Isa)Isa);
+
+        // The scalar run is the reference, later ones land in the second slot.
+        sml_u32  Slot = Isa == SmlIsa_Scalar ? 0 : 1;
+        sml_f32 *NX   = Normals[Slot];
+        sml_f32 *NY   = NX + TriCount;
+        sml_f32 *NZ   = NY + TriCount;
+
+        bench_timer Timer = Bench_StartTimer();
+
+        for(sml_u32 Rep = 0; Rep < Repetitions; Rep++)
+        {
+            SmlInt_ClassifyTris(Kernels, Terrain->Positions, Terrain->Indices, TriCount,
+                                Threshold, NX, NY, NZ, Masks[Slot]);
+        }
+
+        sml_f64 Ns = Bench_ElapsedNs(Timer);
+
+        Bench_Report("navmesh", "classify", SmlIsaNames[Isa], TriCount, 1,
+                     Ns / ((sml_f64)TriCount * Repetitions));
+
+        if(Slot == 1)
+        {
+            bool Same = !memcmp(Normals[0], Normals[1], TriCount * 3 * sizeof(sml_f32)) &&
+                        !memcmp(Masks[0], Masks[1], MaskBytes);
+
+            if(!Same)
+            {
+                printf("navmesh: classify %s differs from scalar\n", SmlIsaNames[Isa]);
+                BenchFailures++;
+            }
+        }
+    }
+
+    SmlMemory.Free(Heap);
+}
+
+static void
+BenchInt_Adjacency(bench_terrain *Terrain)
+{
+    static const SmlAdjacency_Method Methods[]     = {SmlAdjacency_Hashmap,
+                                                      SmlAdjacency_Sort};
+    static const char               *MethodNames[] = {"hashmap", "radix_sort"};
+
+    sml_u32 TriCount    = Terrain->IdxCount / 3;
+    sml_u32 Repetitions = TriCount >= (1u << 20) ? 1 : TriCount >= (1u << 16) ? 3 : 20;
+
+    sml_walkable_list Reference = {};
+
+    for(sml_u32 MethodIdx = 0; MethodIdx < 2; MethodIdx++)
+    {
+        sml_f64 Ns = 0.0;
+
+        for(sml_u32 Rep = 0; Rep < Repetitions; Rep++)
+        {
+            bench_timer Timer = Bench_StartTimer();
+            sml_walkable_list List = SmlInt_BuildWalkableList(Terrain->Positions,
+                                                              Terrain->Indices,
+                                                              Terrain->IdxCount,
+                                                              BenchNavMeshSlope, 1,
+                                                              Methods[MethodIdx]);
+            Ns += Bench_ElapsedNs(Timer);
+
+            if(MethodIdx == 0 && Rep == 0)
+            {
+                Reference = List;
+                continue;
+            }
+
+            if(Rep == 0)
+            {
+                bool Same = List.Across.Count == Reference.Across.Count &&
+                            !memcmp(List.Across.Values, Reference.Across.Values,
+                                    List.Across.Count * sizeof(sml_tri));
+                if(!Same)
+                {
+                    printf("navmesh: %s adjacency differs from hashmap\n",
+                           MethodNames[MethodIdx]);
+                    BenchFailures++;
+                }
+            }
+
+            SmlInt_FreeWalkableList(&List);
+        }
+
+        Bench_Report("navmesh", "adjacency", MethodNames[MethodIdx], TriCount, 1,
+                     Ns / ((sml_f64)TriCount * Repetitions));
+    }
+
+    SmlInt_FreeWalkableList(&Reference);
+}
+
+static void
+BenchInt_Weld(bench_terrain *Terrain, sml_u32 Cells)
+{
+    static const sml_f32 Distances[] = {0.0f, 0.01f};
+    static const char   *Names[]     = {"exact", "quantized"};
+
+    sml_u32 PointCount  = Terrain->IdxCount;
+    sml_u32 TerrainSide = Cells + 1;
+
+    sml_heap_block Heap = SmlMemory.Allocate(PointCount * (sizeof(sml_vector3) +
+                                                           2 * sizeof(sml_u32)));
+
+    sml_vector3 *Soup    = (sml_vector3*)Heap.Data;
+    sml_u32     *Indices = (sml_u32*)(Soup + PointCount);
+    sml_u32     *Welded  = Indices + PointCount;
+
+    for(sml_u32 Idx = 0; Idx < PointCount; Idx++)
+    {
+        Soup[Idx]    = Terrain->Positions[Terrain->Indices[Idx]];
+        Indices[Idx] = Idx;
+    }
+
+    sml_u32 Repetitions = PointCount >= (1u << 21) ? 1 :
+                          PointCount >= (1u << 17) ? 3 : 20;
+
+    for(sml_u32 Mode = 0; Mode < 2; Mode++)
+    {
+        sml_u32     Unique = 0;
+        bench_timer Timer  = Bench_StartTimer();
+
+        for(sml_u32 Rep = 0; Rep < Repetitions; Rep++)
+        {
+            Unique = SML::WeldNavMeshVertices(Soup, PointCount, Indices, PointCount,
+                                              Welded, Distances[Mode], 1);
+        }
+
+        sml_f64 Ns = Bench_ElapsedNs(Timer);
+
+        Bench_Report("navmesh", "weld", Names[Mode], PointCount, 1,
+                     Ns / ((sml_f64)PointCount * Repetitions));
+
+        bool Same = Unique == TerrainSide * TerrainSide;
+
+        for(sml_u32 Idx = 0; Same && Idx < PointCount; Idx++)
+        {
+            Same = !memcmp(&Soup[Welded[Idx]], &Terrain->Positions[Terrain->Indices[Idx]],
+                           sizeof(sml_vector3));
+        }
+
+        if(!Same)
+        {
+            printf("navmesh: %s weld gave %u points, expected %u\n", Names[Mode], Unique,
+                   TerrainSide * TerrainSide);
+            BenchFailures++;
+        }
+    }
+
+    SmlMemory.Free(Heap);
+}
+
+static sml_vector3
+BenchInt_PieceCenter(SML::nav_convex_mesh *Mesh, sml_u32 PolyIdx)
+{
+    SML::nav_convex_poly Convex = Mesh->Polys[PolyIdx];
+    sml_vector3          Center = sml_vector3(0.0f, 0.0f, 0.0f);
+
+    for(sml_u32 Idx = 0; Idx < Convex.Count; Idx++)
+    {
+        Center += Mesh->Verts[Mesh->Indices[Convex.FirstIndex + Idx]];
+    }
+
+    return SmlVec3_Scale(Center, 1.0f / (sml_f32)Convex.Count);
+}
+
+// NOTE: Up to halfway from the center to a vertex, inside since pieces are convex.
+
+static sml_vector3
+BenchInt_PiecePoint(SML::nav_convex_mesh *Mesh, sml_u32 PolyIdx, sml_u64 *State)
+{
+    SML::nav_convex_poly Convex = Mesh->Polys[PolyIdx];
+    sml_vector3          Center = BenchInt_PieceCenter(Mesh, PolyIdx);
+
+    sml_u32     Corner = (sml_u32)(Bench_Random(State) % Convex.Count);
+    sml_vector3 Vert   = Mesh->Verts[Mesh->Indices[Convex.FirstIndex + Corner]];
+    sml_f32     T      = (sml_f32)(Bench_Random(State) % 1024) / 2048.0f;
+
+    return Center + SmlVec3_Scale(Vert - Center, T);
+}
+
+static sml_f32
+BenchInt_PlanarDistance(sml_vector3 A, sml_vector3 B)
+{
+    sml_f32 DX = B.x - A.x;
+    sml_f32 DZ = B.z - A.z;
+
+    return sqrtf(DX * DX + DZ * DZ);
+}
+
+// NOTE: Seen from above, with a little slack since corners sit exactly on
+// portal end points.
+
+static bool
+BenchInt_SegmentCrosses(sml_vector3 A, sml_vector3 B, sml_vector3 Left,
+                        sml_vector3 Right)
+{
+    constexpr sml_f32 Eps = 1e-4f;
+
+    sml_f32 SideL = SML::NavSignedArea(A, B, Left);
+    sml_f32 SideR = SML::NavSignedArea(A, B, Right);
+    sml_f32 SideA = SML::NavSignedArea(Left, Right, A);
+    sml_f32 SideB = SML::NavSignedArea(Left, Right, B);
+
+    bool Portal  = (SideL <= Eps && SideR >= -Eps) || (SideL >= -Eps && SideR <= Eps);
+    bool Segment = (SideA <= Eps && SideB >= -Eps) || (SideA >= -Eps && SideB <= Eps);
+
+    return Portal && Segment;
+}
+
+// NOTE: Pieces are convex, so a path crossing every portal of the corridor in
+// order stays inside the corridor. It also has to be no longer than the
+// polyline through the portal midpoints.
+
+static bool
+BenchInt_StraightPathValid(SML::nav_convex_mesh *Mesh, SML::nav_path *Path,
+                           sml_vector3 *Points, sml_u32 Count)
+{
+    sml_u32 Segment  = 0;
+    sml_f32 Midpoint = 0.0f;
+    sml_f32 Straight = 0.0f;
+
+    sml_vector3 Previous = Points[0];
+
+    for(sml_u32 Idx = 0; Idx + 1 < Path->Count; Idx++)
+    {
+        sml_vector3 Left, Right;
+        SML::NavPortalPoints(Mesh, Path->Polys[Idx], Path->Polys[Idx + 1], &Left, &Right);
+
+        while(Segment + 1 < Count &&
+              !BenchInt_SegmentCrosses(Points[Segment], Points[Segment + 1], Left, Right))
+        {
+            Segment++;
+        }
+
+        if(Segment + 1 >= Count) return false;
+
+        sml_vector3 Mid = SmlVec3_Scale(Left + Right, 0.5f);
+
+        Midpoint += BenchInt_PlanarDistance(Previous, Mid);
+        Previous  = Mid;
+    }
+
+    Midpoint += BenchInt_PlanarDistance(Previous, Points[Count - 1]);
+
+    for(sml_u32 Idx = 0; Idx + 1 < Count; Idx++)
+    {
+        Straight += BenchInt_PlanarDistance(Points[Idx], Points[Idx + 1]);
+    }
+
+    return Straight <= Midpoint * (1.0f + 1e-5f) + 1e-4f;
+}
+
+// NOTE: Dijkstra with the costs of NavSearch, but over the portals instead of
+// the pieces: node Idx stands in the middle of edge Idx of Mesh->Indices and
+// enters the piece across it. A piece entered through two portals is two
+// nodes, so the result is the cheapest corridor and no search may beat it.
+
+static sml_f32
+BenchInt_CheapestCost(SML::nav_convex_mesh *Mesh, SML::nav_query_filter *Filter,
+                      sml_u32 StartPoly, sml_vector3 Start, sml_u32 EndPoly,
+                      sml_vector3 End)
+{
+    typedef std::pair<sml_f32, sml_u32> bench_open;
+
+    sml_u32 EndNode = Mesh->Indices.Count;
+
+    std::vector<sml_vector3> Mids(EndNode);
+    std::vector<sml_f32>     Costs(EndNode + 1, FLT_MAX);
+
+    std::priority_queue<bench_open, std::vector<bench_open>, std::greater<bench_open>> Open;
+
+    for(sml_u32 PolyIdx = 0; PolyIdx < Mesh->Polys.Count; PolyIdx++)
+    {
+        SML::nav_convex_poly Convex  = Mesh->Polys[PolyIdx];
+        sml_u32             *Corners = Mesh->Indices.Values + Convex.FirstIndex;
+
+        for(sml_u32 Idx = 0; Idx < Convex.Count; Idx++)
+        {
+            sml_vector3 Edge = Mesh->Verts[Corners[Idx]] +
+                               Mesh->Verts[Corners[(Idx + 1) % Convex.Count]];
+
+            Mids[Convex.FirstIndex + Idx] = SmlVec3_Scale(Edge, 0.5f);
+        }
+    }
+
+    auto Relax = [&](sml_u32 Node, sml_f32 Cost)
+    {
+        if(Cost >= Costs[Node]) return;
+
+        Costs[Node] = Cost;
+        Open.push(bench_open(Cost, Node));
+    };
+
+    auto Leave = [&](sml_u32 Poly, sml_vector3 From, sml_f32 Cost)
+    {
+        SML::nav_convex_poly Convex   = Mesh->Polys[Poly];
+        sml_f32              AreaCost = Filter->AreaCosts[Convex.Area];
+
+        if(Poly == EndPoly) Relax(EndNode, Cost + SML::NavDistance(From, End) * AreaCost);
+
+        for(sml_u32 Idx = Convex.FirstIndex; Idx < Convex.FirstIndex + Convex.Count; Idx++)
+        {
+            sml_u32 Neighbor = Mesh->Neighbors[Idx];
+            if(Neighbor == SML::NavInvalidPoly) continue;
+            if(Filter->AreaCosts[Mesh->Polys[Neighbor].Area] <= 0.0f) continue;
+
+            Relax(Idx, Cost + SML::NavDistance(From, Mids[Idx]) * AreaCost);
+        }
+    };
+
+    Leave(StartPoly, Start, 0.0f);
+
+    while(!Open.empty())
+    {
+        bench_open Top = Open.top();
+        Open.pop();
+
+        if(Top.second == EndNode) return Top.first;
+        if(Top.first > Costs[Top.second]) continue;
+
+        Leave(Mesh->Neighbors[Top.second], Mids[Top.second], Top.first);
+    }
+
+    return FLT_MAX;
+}
+
+// NOTE: Slabs seen from above, Min and Max are (x, z).
+
+static bool
+BenchInt_SegmentHitsBox(sml_vector3 A, sml_vector3 B, sml_vector2 Min, sml_vector2 Max)
+{
+    sml_f32 Enter = 0.0f, Exit = 1.0f;
+
+    sml_f32 From[2] = {A.x, A.z};
+    sml_f32 Step[2] = {B.x - A.x, B.z - A.z};
+    sml_f32 Low[2]  = {Min.x, Min.y};
+    sml_f32 High[2] = {Max.x, Max.y};
+
+    for(sml_u32 Axis = 0; Axis < 2; Axis++)
+    {
+        if(Step[Axis] == 0.0f)
+        {
+            if(From[Axis] < Low[Axis] || From[Axis] > High[Axis]) return false;
+            continue;
+        }
+
+        sml_f32 T0 = (Low[Axis]  - From[Axis]) / Step[Axis];
+        sml_f32 T1 = (High[Axis] - From[Axis]) / Step[Axis];
+
+        Enter = fmaxf(Enter, fminf(T0, T1));
+        Exit  = fminf(Exit, fmaxf(T0, T1));
+    }
+
+    return Enter <= Exit;
+}
+
+// NOTE: The pillar only blocks the cells around its vertex, two points whose
+// segment misses them see each other and the straight path must be that
+// segment. Catches corridors that go around a hole bridge.
+
+static void
+BenchInt_PillarPaths()
+{
+    constexpr sml_u32 Cells = 32;
+
+    bench_terrain Terrain  = BenchInt_MakeTerrain(Cells, true);
+    auto          Polygons = SML::BuildNavMesh(Terrain.Positions, Terrain.Indices,
+                                               Terrain.IdxCount, BenchNavMeshSlope, 0.0f,
+                                               1);
+
+    SML::nav_convex_mesh  Mesh   = SML::BuildConvexNavMesh(Polygons.Values,
+                                                           Polygons.Count);
+    SML::nav_query        Query  = SML::CreateNavQuery(&Mesh);
+    SML::nav_query_filter Filter = SML::DefaultNavQueryFilter();
+
+    sml_heap_block Heap     = SmlMemory.Allocate(BenchPathMaxPoints * sizeof(sml_vector3) +
+                                                 BenchPathCapacity * sizeof(sml_u32));
+    sml_vector3   *Straight = (sml_vector3*)Heap.Data;
+
+    SML::nav_path Path = {};
+    Path.Polys    = (sml_u32*)(Straight + BenchPathMaxPoints);
+    Path.Capacity = BenchPathCapacity;
+
+    sml_vector2 PillarMin = sml_vector2(Cells / 2 - 1.05f, Cells / 2 - 1.05f);
+    sml_vector2 PillarMax = sml_vector2(Cells / 2 + 1.05f, Cells / 2 + 1.05f);
+
+    sml_u64 State   = 0xA0761D6478BD642Full;
+    sml_u32 InSight = 0;
+    sml_u32 Detours = 0;
+    sml_f32 Worst   = 0.0f;
+
+    for(sml_u32 Idx = 0; Idx < BenchPathQueries * 4; Idx++)
+    {
+        sml_f32 Coords[4];
+        for(sml_f32 &Coord : Coords)
+        {
+            Coord = (sml_f32)(Bench_Random(&State) % (Cells * 100)) / 100.0f;
+        }
+
+        sml_vector3 Start = sml_vector3(Coords[0], 0.0f, Coords[1]);
+        sml_vector3 End   = sml_vector3(Coords[2], 0.0f, Coords[3]);
+
+        if(BenchInt_SegmentHitsBox(Start, End, PillarMin, PillarMax)) continue;
+
+        InSight++;
+
+        sml_u32 Count = 0;
+        if(SML::FindPath(&Query, Start, End, &Filter, &Path) == SML::NavPath_Found)
+        {
+            Count = SML::FindStraightPath(&Mesh, &Path, Start, End, Straight,
+                                          BenchPathMaxPoints);
+        }
+
+        sml_f32 Length = 0.0f;
+        for(sml_u32 Point = 0; Point + 1 < Count; Point++)
+        {
+            Length += BenchInt_PlanarDistance(Straight[Point], Straight[Point + 1]);
+        }
+
+        sml_f32 Extra = Count ? Length - BenchInt_PlanarDistance(Start, End) : FLT_MAX;
+
+        if(Extra > 1e-3f) Detours++;
+        Worst = fmaxf(Worst, Extra);
+    }
+
+    printf("navmesh: one pillar, %u pieces: %u of %u point pairs in sight, %u "
+           "detours\n", Mesh.Polys.Count, InSight, BenchPathQueries * 4, Detours);
+
+    if(Detours)
+    {
+        printf("navmesh: straight paths around the pillar detour up to %.2f units\n",
+               Worst);
+        BenchFailures++;
+    }
+
+    SmlMemory.Free(Heap);
+    Query.Free();
+    Mesh.Free();
+    BenchInt_FreePolygons(Polygons);
+
+    SmlMemory.Free(Terrain.PositionsHeap);
+    SmlMemory.Free(Terrain.IndicesHeap);
+}
+
+static void
+BenchInt_FindPath(dynamic_array<SML::nav_poly> &Polygons, sml_u32 TriCount)
+{
+    static const char *Names[] = {"default_costs", "area_costs"};
+
+    SML::nav_convex_mesh Mesh  = SML::BuildConvexNavMesh(Polygons.Values, Polygons.Count);
+    SML::nav_query       Query = SML::CreateNavQuery(&Mesh);
+
+    size_t PointsSize = (BenchPathQueries * 2 + BenchPathMaxPoints) * sizeof(sml_vector3);
+
+    sml_heap_block Heap     = SmlMemory.Allocate(PointsSize +
+                                                 BenchPathCapacity * sizeof(sml_u32));
+    sml_vector3   *Points   = (sml_vector3*)Heap.Data;
+    sml_vector3   *Straight = Points + BenchPathQueries * 2;
+
+    SML::nav_path Path = {};
+    Path.Polys    = (sml_u32*)(Straight + BenchPathMaxPoints);
+    Path.Capacity = BenchPathCapacity;
+
+    sml_u64 State = 0x9E3779B97F4A7C15ull;
+
+    // Both ends on the same nav polygon, pieces of different ones never connect.
+    for(sml_u32 Idx = 0; Idx < BenchPathQueries; Idx++)
+    {
+        sml_u32 From = (sml_u32)(Bench_Random(&State) % Mesh.Polys.Count);
+        sml_u32 To   = (sml_u32)(Bench_Random(&State) % Mesh.Polys.Count);
+
+        while(Mesh.Polys[To].Source != Mesh.Polys[From].Source)
+        {
+            To = (sml_u32)(Bench_Random(&State) % Mesh.Polys.Count);
+        }
+
+        Points[Idx * 2 + 0] = BenchInt_PieceCenter(&Mesh, From);
+        Points[Idx * 2 + 1] = BenchInt_PieceCenter(&Mesh, To);
+    }
+
+    SML::nav_query_filter Filter = SML::DefaultNavQueryFilter();
+
+    for(sml_u32 Mode = 0; Mode < 2; Mode++)
+    {
+        if(Mode == 1)
+        {
+            for(sml_u32 PolyIdx = 0; PolyIdx < Mesh.Polys.Count; PolyIdx += 4)
+            {
+                Mesh.Polys[PolyIdx].Area = 1;
+            }
+
+            Filter.AreaCosts[1] = 4.0f;
+        }
+
+        sml_u32 Statuses[4] = {};
+        sml_u64 Pieces      = 0;
+
+        size_t  PushSize  = SmlMemory.PushSize;
+        sml_u32 FreeCount = SmlMemory.FreeCount;
+
+        bench_timer Timer = Bench_StartTimer();
+
+        for(sml_u32 Idx = 0; Idx < BenchPathQueries; Idx++)
+        {
+            auto Status = SML::FindPath(&Query, Points[Idx * 2], Points[Idx * 2 + 1],
+                                        &Filter, &Path);
+
+            Statuses[Status]++;
+            Pieces += Path.Count;
+        }
+
+        sml_f64 Ns = Bench_ElapsedNs(Timer);
+
+        Bench_Report("navmesh", "pathfind", Names[Mode], Mesh.Polys.Count, 1,
+                     Ns / BenchPathQueries);
+
+        printf("navmesh: %u triangles, %u pieces, %s: %u found, %u partial, "
+               "%.1f pieces per path\n", TriCount, Mesh.Polys.Count, Names[Mode],
+               Statuses[SML::NavPath_Found], Statuses[SML::NavPath_Partial],
+               (sml_f64)Pieces / BenchPathQueries);
+
+        if(Statuses[SML::NavPath_NoPoly] || Statuses[SML::NavPath_Truncated])
+        {
+            printf("navmesh: pathfind %s lost a query point or truncated a path\n",
+                   Names[Mode]);
+            BenchFailures++;
+        }
+
+        if(SmlMemory.PushSize != PushSize || SmlMemory.FreeCount != FreeCount)
+        {
+            printf("navmesh: pathfind %s allocated\n", Names[Mode]);
+            BenchFailures++;
+        }
+
+        if(Mode != 0) continue;
+
+        sml_f64 FunnelNs = 0.0;
+        sml_u64 Corners  = 0;
+        bool    Ends     = true;
+        sml_u32 Invalid  = 0;
+
+        for(sml_u32 Idx = 0; Idx < BenchPathQueries; Idx++)
+        {
+            sml_vector3 Start = Points[Idx * 2];
+            sml_vector3 End   = Points[Idx * 2 + 1];
+
+            SML::FindPath(&Query, Start, End, &Filter, &Path);
+
+            bench_timer FunnelTimer = Bench_StartTimer();
+            sml_u32     Count       = SML::FindStraightPath(&Mesh, &Path, Start, End,
+                                                            Straight, BenchPathMaxPoints);
+            FunnelNs += Bench_ElapsedNs(FunnelTimer);
+
+            Corners += Count;
+            sml_vector3 *Last = Straight + (Count ? Count - 1 : 0);
+
+            bool FromStart = Count > 0 && !memcmp(Straight, &Start, sizeof(Start));
+            bool ToEnd     = Count > 0 && !memcmp(Last, &End, sizeof(End));
+
+            Ends = Ends && FromStart && ToEnd;
+
+            if(Count && !BenchInt_StraightPathValid(&Mesh, &Path, Straight, Count))
+            {
+                Invalid++;
+            }
+        }
+
+        Bench_Report("navmesh", "straight_path", "funnel", Mesh.Polys.Count, 1,
+                     FunnelNs / BenchPathQueries);
+
+        printf("navmesh: %u pieces, %.1f points per straight path\n", Mesh.Polys.Count,
+               (sml_f64)Corners / BenchPathQueries);
+
+        if(!Ends)
+        {
+            printf("navmesh: straight path misses its start or end point\n");
+            BenchFailures++;
+        }
+
+        if(Invalid)
+        {
+            printf("navmesh: %u straight paths leave their corridor or are longer than "
+                   "its portal midpoints\n", Invalid);
+            BenchFailures++;
+        }
+    }
+
+    SmlMemory.Free(Heap);
+    Query.Free();
+    Mesh.Free();
+}
+
+static void
+BenchInt_FindPathHierarchical(dynamic_array<SML::nav_poly> &Polygons)
+{
+    static const char *Names[] = {"default_costs", "area_costs"};
+
+    SML::nav_convex_mesh Mesh = SML::BuildConvexNavMesh(Polygons.Values, Polygons.Count);
+
+    SML::nav_query_filter Filter     = SML::DefaultNavQueryFilter();
+    sml_u32               PieceCount = Mesh.Polys.Count;
+
+    Filter.AreaCosts[1] = 4.0f;
+
+    bench_timer BuildTimer = Bench_StartTimer();
+    SML::nav_hierarchy Hierarchy = SML::BuildNavHierarchy(&Mesh, &Filter);
+    sml_f64 BuildNs = Bench_ElapsedNs(BuildTimer);
+
+    SML::nav_query Query = SML::CreateNavQuery(&Mesh, &Hierarchy);
+
+    Bench_Report("navmesh", "hierarchy", "build", PieceCount, 1, BuildNs / PieceCount);
+
+    size_t PointsSize = BenchPathQueries * 2 * sizeof(sml_vector3);
+
+    sml_heap_block Heap   = SmlMemory.Allocate(PointsSize +
+                                               BenchPathCapacity * 2 * sizeof(sml_u32));
+    sml_vector3   *Points = (sml_vector3*)Heap.Data;
+
+    SML::nav_path Flat = {}, Coarse = {};
+    Flat.Polys      = (sml_u32*)(Points + BenchPathQueries * 2);
+    Flat.Capacity   = BenchPathCapacity;
+    Coarse.Polys    = Flat.Polys + BenchPathCapacity;
+    Coarse.Capacity = BenchPathCapacity;
+
+    sml_u64 State = 0x2545F4914F6CDD1Dull;
+
+    for(sml_u32 Idx = 0; Idx < BenchPathQueries; Idx++)
+    {
+        sml_u32     From     = (sml_u32)(Bench_Random(&State) % PieceCount);
+        sml_vector3 Start    = BenchInt_PieceCenter(&Mesh, From);
+        sml_vector3 End      = Start;
+        sml_f32     BestDist = 0.0f;
+
+        for(sml_u32 Candidate = 0; Candidate < BenchPathCandidates; Candidate++)
+        {
+            sml_u32 To = (sml_u32)(Bench_Random(&State) % PieceCount);
+            if(Mesh.Polys[To].Source != Mesh.Polys[From].Source) continue;
+
+            sml_vector3 Point = BenchInt_PieceCenter(&Mesh, To);
+            sml_vector3 Delta = Point - Start;
+            sml_f32     Dist  = SmlVec3_Dot(Delta, Delta);
+
+            if(Dist > BestDist)
+            {
+                End      = Point;
+                BestDist = Dist;
+            }
+        }
+
+        Points[Idx * 2 + 0] = Start;
+        Points[Idx * 2 + 1] = End;
+    }
+
+    for(sml_u32 Mode = 0; Mode < 2; Mode++)
+    {
+        if(Mode == 1)
+        {
+            for(sml_u32 PolyIdx = 0; PolyIdx < PieceCount; PolyIdx += 4)
+            {
+                SML::SetNavPolyArea(&Hierarchy, PolyIdx, 1);
+            }
+
+            bench_timer UpdateTimer = Bench_StartTimer();
+            sml_u32     Updated     = SML::UpdateNavHierarchy(&Hierarchy, &Query);
+            sml_f64     UpdateNs    = Bench_ElapsedNs(UpdateTimer);
+
+            Bench_Report("navmesh", "hierarchy", "update", PieceCount, 1,
+                         UpdateNs / PieceCount);
+
+            printf("navmesh: %u pieces, %u regions, %u entrances, %u regions updated\n",
+                   PieceCount, Hierarchy.Regions.Count, Hierarchy.Entrances.Count,
+                   Updated);
+        }
+
+        bench_timer FlatTimer = Bench_StartTimer();
+
+        for(sml_u32 Idx = 0; Idx < BenchPathQueries; Idx++)
+        {
+            SML::FindPath(&Query, Points[Idx * 2], Points[Idx * 2 + 1], &Filter, &Flat);
+        }
+
+        sml_f64 FlatNs = Bench_ElapsedNs(FlatTimer);
+
+        bench_timer CoarseTimer = Bench_StartTimer();
+
+        for(sml_u32 Idx = 0; Idx < BenchPathQueries; Idx++)
+        {
+            SML::FindPathHierarchical(&Query, Points[Idx * 2], Points[Idx * 2 + 1],
+                                      &Filter, &Coarse);
+        }
+
+        sml_f64 CoarseNs = Bench_ElapsedNs(CoarseTimer);
+
+        Bench_Report("navmesh", "pathfind_far", Names[Mode], PieceCount, 1,
+                     FlatNs / BenchPathQueries);
+        Bench_Report("navmesh", "hierarchical", Names[Mode], PieceCount, 1,
+                     CoarseNs / BenchPathQueries);
+
+        // Checked apart from the timing, both searches reuse the same nodes.
+        sml_f64 Ratio    = 0.0;
+        sml_f64 FlatOver = 0.0, CoarseOver = 0.0;
+        sml_u32 Mismatch = 0;
+
+        for(sml_u32 Idx = 0; Idx < BenchPathQueries; Idx++)
+        {
+            sml_vector3 Start = Points[Idx * 2];
+            sml_vector3 End   = Points[Idx * 2 + 1];
+
+            auto FlatStatus   = SML::FindPath(&Query, Start, End, &Filter, &Flat);
+            auto CoarseStatus = SML::FindPathHierarchical(&Query, Start, End, &Filter,
+                                                          &Coarse);
+
+            if(FlatStatus != CoarseStatus) Mismatch++;
+
+            Ratio += Flat.Cost > 0.0f ? Coarse.Cost / Flat.Cost : 1.0;
+
+            if(Idx >= BenchCheapestQueries || FlatStatus != SML::NavPath_Found) continue;
+
+            sml_f32 Cheapest = BenchInt_CheapestCost(&Mesh, &Filter, Flat.Polys[0], Start,
+                                                     Flat.Polys[Flat.Count - 1], End);
+
+            if(Flat.Cost   < Cheapest * 0.9999f) Mismatch++;
+            if(Coarse.Cost < Cheapest * 0.9999f) Mismatch++;
+
+            FlatOver   += Cheapest > 0.0f ? Flat.Cost / Cheapest : 1.0;
+            CoarseOver += Cheapest > 0.0f ? Coarse.Cost / Cheapest : 1.0;
+        }
+
+        printf("navmesh: %u pieces, %s: %.2fx faster, %.4f cost ratio, %.3fx and "
+               "%.3fx the cheapest corridor\n", PieceCount, Names[Mode],
+               FlatNs / CoarseNs, Ratio / BenchPathQueries,
+               FlatOver / BenchCheapestQueries, CoarseOver / BenchCheapestQueries);
+
+        if(Mismatch)
+        {
+            printf("navmesh: hierarchical %s differs from FindPath on %u queries\n",
+                   Names[Mode], Mismatch);
+            BenchFailures++;
+        }
+    }
+
+    // A mesh rebuilt in the same storage: the next update rebuilds the
+    // hierarchy and the query, then searches run on the new pieces.
+    Mesh.Free();
+    Mesh = SML::BuildConvexNavMesh(Polygons.Values, Polygons.Count);
+
+    sml_u32 Rebuilt  = SML::UpdateNavHierarchy(&Hierarchy, &Query);
+    sml_u32 Mismatch = 0;
+
+    for(sml_u32 Idx = 0; Idx < BenchCheapestQueries; Idx++)
+    {
+        sml_vector3 Start = Points[Idx * 2];
+        sml_vector3 End   = Points[Idx * 2 + 1];
+
+        auto FlatStatus   = SML::FindPath(&Query, Start, End, &Filter, &Flat);
+        auto CoarseStatus = SML::FindPathHierarchical(&Query, Start, End, &Filter,
+                                                      &Coarse);
+
+        if(FlatStatus != CoarseStatus) Mismatch++;
+    }
+
+    if(Hierarchy.Revision != Mesh.Revision || Rebuilt != Hierarchy.Regions.Count ||
+       Mismatch)
+    {
+        printf("navmesh: hierarchy not rebuilt with its mesh, %u of %u regions, %u "
+               "queries differ\n", Rebuilt, Hierarchy.Regions.Count, Mismatch);
+        BenchFailures++;
+    }
+
+    SmlMemory.Free(Heap);
+    Query.Free();
+    Hierarchy.Free();
+    Mesh.Free();
+}
+
+static void
+BenchInt_PathService(dynamic_array<SML::nav_poly> &Polygons)
+{
+    SML::nav_convex_mesh Mesh = SML::BuildConvexNavMesh(Polygons.Values, Polygons.Count);
+
+    SML::nav_query        Query      = SML::CreateNavQuery(&Mesh);
+    SML::nav_query_filter Filter     = SML::DefaultNavQueryFilter();
+    sml_u32               PieceCount = Mesh.Polys.Count;
+
+    size_t PointsSize  = BenchServiceRequests * 2 * sizeof(sml_vector3);
+    size_t HandlesSize = BenchServiceRequests * sizeof(SML::nav_path_handle);
+
+    sml_heap_block Heap    = SmlMemory.Allocate(PointsSize + HandlesSize +
+                                                BenchServiceCapacity * sizeof(sml_u32));
+    sml_vector3   *Points  = (sml_vector3*)Heap.Data;
+    auto          *Handles = (SML::nav_path_handle*)(Points + BenchServiceRequests * 2);
+
+    SML::nav_path Direct = {};
+    Direct.Polys    = (sml_u32*)(Handles + BenchServiceRequests);
+    Direct.Capacity = BenchServiceCapacity;
+
+    sml_u64 State = 0x9E3779B97F4A7C15ull;
+    sml_u32 From  = 0;
+    sml_u32 To    = 0;
+
+    for(sml_u32 Idx = 0; Idx < BenchServiceRequests; Idx++)
+    {
+        // Other points in the pieces of the request before, so it joins it.
+        if(Idx % 4 == 3)
+        {
+            Points[Idx * 2 + 0] = BenchInt_PiecePoint(&Mesh, From, &State);
+            Points[Idx * 2 + 1] = BenchInt_PiecePoint(&Mesh, To, &State);
+            continue;
+        }
+
+        From = (sml_u32)(Bench_Random(&State) % PieceCount);
+        To   = (sml_u32)(Bench_Random(&State) % PieceCount);
+
+        while(Mesh.Polys[To].Source != Mesh.Polys[From].Source)
+        {
+            To = (sml_u32)(Bench_Random(&State) % PieceCount);
+        }
+
+        Points[Idx * 2 + 0] = BenchInt_PieceCenter(&Mesh, From);
+        Points[Idx * 2 + 1] = BenchInt_PieceCenter(&Mesh, To);
+    }
+
+    bench_timer DirectTimer = Bench_StartTimer();
+
+    for(sml_u32 Idx = 0; Idx < BenchServiceRequests; Idx++)
+    {
+        SML::FindPath(&Query, Points[Idx * 2], Points[Idx * 2 + 1], &Filter, &Direct);
+    }
+
+    sml_f64 DirectNs = Bench_ElapsedNs(DirectTimer);
+
+    static SML::nav_path_service Service;
+    SML::CreateNavPathService(&Service, &Mesh, nullptr, BenchServiceRequests,
+                              BenchServiceCapacity, BenchServiceBudget);
+
+    sml_f64 MainNs    = 0.0;
+    sml_u32 Submitted = 0;
+    sml_u32 Finished  = 0;
+    sml_u32 Frames    = 0;
+
+    // A frame queues its requests, starts the workers, then leaves them the
+    // rest of the frame.
+    while(Finished < BenchServiceRequests)
+    {
+        bench_timer MainTimer = Bench_StartTimer();
+
+        for(sml_u32 Idx = 0; Idx < BenchServicePerFrame; Idx++)
+        {
+            if(Submitted == BenchServiceRequests) break;
+
+            sml_u32 Priority = Submitted % SML::NavPriority_Count;
+
+            Handles[Submitted] = SML::RequestNavPath(&Service, Points[Submitted * 2],
+                                                     Points[Submitted * 2 + 1], &Filter,
+                                                     (SML::NavRequest_Priority)Priority);
+            Submitted++;
+        }
+
+        SML::UpdateNavPathService(&Service);
+
+        MainNs += Bench_ElapsedNs(MainTimer);
+        Frames++;
+
+        std::this_thread::sleep_for(std::chrono::nanoseconds(BenchServiceBudget));
+
+        MainTimer = Bench_StartTimer();
+
+        SML::nav_path       Path   = {};
+        SML::NavPath_Status Status = SML::NavPath_Found;
+
+        while(Finished < Submitted &&
+              SML::PollNavPath(&Service, Handles[Finished], &Path, &Status) ==
+              SML::NavRequest_Done)
+        {
+            Finished++;
+        }
+
+        MainNs += Bench_ElapsedNs(MainTimer);
+    }
+
+    // Checked apart from the timing. A joined request gets the corridor of the
+    // one it joined, its cost must be FindPath's when FindPath finds the same
+    // whole corridor. A truncated one keeps the cost of the request it joined.
+    sml_u32 Mismatch = 0;
+    sml_u32 Compared = 0;
+
+    for(sml_u32 Idx = 0; Idx < BenchServiceRequests; Idx++)
+    {
+        SML::nav_path       Path   = {};
+        SML::NavPath_Status Status = SML::NavPath_Found;
+
+        SML::PollNavPath(&Service, Handles[Idx], &Path, &Status);
+        auto DirectStatus = SML::FindPath(&Query, Points[Idx * 2], Points[Idx * 2 + 1],
+                                          &Filter, &Direct);
+
+        bool Joined = Idx % 4 == 3;
+        bool Same   = Status == DirectStatus && Path.Count == Direct.Count &&
+                      !memcmp(Path.Polys, Direct.Polys, Path.Count * sizeof(sml_u32));
+
+        if(Same)
+        {
+            bool Whole = !Joined || Status == SML::NavPath_Found;
+
+            Compared += Joined && Whole;
+            if(Whole && Path.Cost != Direct.Cost) Mismatch++;
+        }
+        else if(!Joined || Status != DirectStatus)
+        {
+            Mismatch++;
+        }
+
+        SML::ReleaseNavPath(&Service, Handles[Idx]);
+    }
+
+    Bench_Report("navmesh", "path_service", "direct", PieceCount, 1,
+                 DirectNs / BenchServiceRequests);
+    Bench_Report("navmesh", "path_service", "main_thread", PieceCount,
+                 Service.WorkerCount, MainNs / BenchServiceRequests);
+
+    printf("navmesh: %u pieces, path service: %llu searches for %llu requests, "
+           "%u frames, %u of %llu joined corridors as FindPath's\n", PieceCount,
+           (unsigned long long)Service.Searches.load(),
+           (unsigned long long)Service.Requested, Frames, Compared,
+           (unsigned long long)Service.Joined);
+
+    if(Mismatch)
+    {
+        printf("navmesh: path service differs from FindPath on %u requests\n", Mismatch);
+        BenchFailures++;
+    }
+
+    SML::FreeNavPathService(&Service);
+    SmlMemory.Free(Heap);
+    Query.Free();
+    Mesh.Free();
+}
+
+static bool
+BenchInt_CorridorLinked(SML::nav_convex_mesh *Mesh, SML::nav_path *Path)
+{
+    for(sml_u32 Idx = 0; Idx + 1 < Path->Count; Idx++)
+    {
+        SML::nav_convex_poly Convex = Mesh->Polys[Path->Polys[Idx]];
+        bool                 Linked = false;
+
+        for(sml_u32 Edge = 0; Edge < Convex.Count; Edge++)
+        {
+            sml_u32 Across = Mesh->Neighbors[Convex.FirstIndex + Edge];
+            Linked         = Linked || Across == Path->Polys[Idx + 1];
+        }
+
+        if(!Linked) return false;
+    }
+
+    return true;
+}
+
+static void
+BenchInt_Corridor(dynamic_array<SML::nav_poly> &Polygons)
+{
+    static const char *Names[] = {"kept", "repaired", "replanned", "lost"};
+
+    SML::nav_convex_mesh Mesh = SML::BuildConvexNavMesh(Polygons.Values, Polygons.Count);
+
+    SML::nav_query        Query      = SML::CreateNavQuery(&Mesh);
+    SML::nav_query_filter Filter     = SML::DefaultNavQueryFilter();
+    sml_u32               PieceCount = Mesh.Polys.Count;
+
+    size_t AgentsSize  = BenchCorridorAgents * 2 * sizeof(sml_vector3);
+    size_t CorridorSize = BenchCorridorAgents * sizeof(SML::nav_corridor);
+
+    sml_heap_block Heap      = SmlMemory.Allocate(AgentsSize + CorridorSize +
+                                                  BenchPathCapacity * sizeof(sml_u32));
+    sml_vector3   *Agents    = (sml_vector3*)Heap.Data;
+    auto          *Corridors = (SML::nav_corridor*)(Agents + BenchCorridorAgents * 2);
+
+    SML::nav_path Fresh = {};
+    Fresh.Polys    = (sml_u32*)(Corridors + BenchCorridorAgents);
+    Fresh.Capacity = BenchPathCapacity;
+
+    sml_u64 State = 0xD1B54A32D192ED03ull;
+
+    for(sml_u32 Agent = 0; Agent < BenchCorridorAgents; Agent++)
+    {
+        sml_u32 From = (sml_u32)(Bench_Random(&State) % PieceCount);
+        sml_u32 To   = (sml_u32)(Bench_Random(&State) % PieceCount);
+
+        while(Mesh.Polys[To].Source != Mesh.Polys[From].Source)
+        {
+            To = (sml_u32)(Bench_Random(&State) % PieceCount);
+        }
+
+        Agents[Agent * 2 + 0] = BenchInt_PieceCenter(&Mesh, From);
+        Agents[Agent * 2 + 1] = BenchInt_PieceCenter(&Mesh, To);
+        Corridors[Agent]      = SML::CreateNavCorridor(BenchPathCapacity);
+    }
+
+    sml_f64 FreshNs   = 0.0;
+    sml_f64 UpdateNs  = 0.0;
+    sml_u32 Counts[4] = {};
+    sml_u32 Broken    = 0;
+
+    sml_u64 KeptPieces  = 0;
+    sml_u64 FreshPieces = 0;
+
+    for(sml_u32 Frame = 0; Frame < BenchCorridorFrames; Frame++)
+    {
+        for(sml_u32 Agent = 0; Agent < BenchCorridorAgents; Agent++)
+        {
+            sml_vector3 &Position = Agents[Agent * 2 + 0];
+            sml_vector3 &Target   = Agents[Agent * 2 + 1];
+
+            SML::nav_corridor *Corridor = Corridors + Agent;
+
+            // The target drifts, but stays on the mesh.
+            sml_f32     Angle  = (sml_f32)(Bench_Random(&State) % 65536) * 9.5874e-5f;
+            sml_vector3 Drift  = sml_vector3(cosf(Angle), 0.0f, sinf(Angle));
+            sml_vector3 Moved  = Target + SmlVec3_Scale(Drift, BenchCorridorDrift);
+
+            if(SML::FindNavPoly(&Query, Moved) != SML::NavInvalidPoly) Target = Moved;
+
+            bench_timer FreshTimer = Bench_StartTimer();
+            SML::FindPath(&Query, Position, Target, &Filter, &Fresh);
+            FreshNs += Bench_ElapsedNs(FreshTimer);
+
+            bench_timer UpdateTimer = Bench_StartTimer();
+            auto Update = SML::UpdateNavCorridor(Corridor, &Query, Position, Target,
+                                                 &Filter);
+            UpdateNs += Bench_ElapsedNs(UpdateTimer);
+
+            Counts[Update]++;
+
+            SML::nav_path *Path = &Corridor->Path;
+
+            sml_u32 Last = SML::NavInvalidPoly;
+            if(Path->Count) Last = Path->Polys[Path->Count - 1];
+
+            KeptPieces  += Path->Count;
+            FreshPieces += Fresh.Count;
+
+            bool Ends = Path->Count > 0 &&
+                        SML::ConvexPolyContains(&Mesh, Path->Polys[0], Position) &&
+                        (Corridor->Status != SML::NavPath_Found ||
+                         Last == SML::FindNavPoly(&Query, Target));
+
+            if(!Ends || !BenchInt_CorridorLinked(&Mesh, Path)) Broken++;
+
+            // Walk to the portal into the next piece, then to its center. Both legs
+            // stay inside a convex piece.
+            if(Path->Count < 2) continue;
+
+            sml_vector3 Left, Right;
+            SML::NavPortalPoints(&Mesh, Path->Polys[0], Path->Polys[1], &Left, &Right);
+
+            sml_vector3 Portal = SmlVec3_Scale(Left + Right, 0.5f);
+            sml_vector3 Aim    = Portal;
+
+            if(SML::NavSamePoint(Position, Portal))
+            {
+                Aim = BenchInt_PieceCenter(&Mesh, Path->Polys[1]);
+            }
+
+            sml_vector3 Step = Aim - Position;
+            sml_f32     Dist = sqrtf(SmlVec3_Dot(Step, Step));
+
+            if(Dist <= BenchCorridorSpeed) Position = Aim;
+            else Position = Position + SmlVec3_Scale(Step, BenchCorridorSpeed / Dist);
+        }
+    }
+
+    sml_u32 Updates = BenchCorridorAgents * BenchCorridorFrames;
+
+    Bench_Report("navmesh", "corridor", "findpath", PieceCount, 1, FreshNs / Updates);
+    Bench_Report("navmesh", "corridor", "update", PieceCount, 1, UpdateNs / Updates);
+
+    printf("navmesh: %u pieces, corridor: %.1fx less time than a FindPath per frame, "
+           "%.3f pieces per FindPath piece, %u %s, %u %s, %u %s, %u %s\n", PieceCount,
+           FreshNs / UpdateNs, (sml_f64)KeptPieces / (sml_f64)FreshPieces, Counts[0],
+           Names[0], Counts[1], Names[1], Counts[2], Names[2], Counts[3], Names[3]);
+
+    if(Broken)
+    {
+        printf("navmesh: %u corridor updates left a broken corridor\n", Broken);
+        BenchFailures++;
+    }
+
+    for(sml_u32 Agent = 0; Agent < BenchCorridorAgents; Agent++) Corridors[Agent].Free();
+
+    SmlMemory.Free(Heap);
+    Query.Free();
+    Mesh.Free();
+}
+
+// NOTE: Returns the total build time in ns per triangle. The polygons of the
+// last repetition are kept in Result for the determinism check.
+
+static void
+BenchInt_PathCache(dynamic_array<SML::nav_poly> &Polygons)
+{
+    SML::nav_convex_mesh Mesh = SML::BuildConvexNavMesh(Polygons.Values, Polygons.Count);
+
+    SML::nav_query        Query      = SML::CreateNavQuery(&Mesh);
+    SML::nav_query_filter Filter     = SML::DefaultNavQueryFilter();
+    sml_u32               PieceCount = Mesh.Polys.Count;
+
+    size_t PointsSize = BenchCacheQueries * 2 * sizeof(sml_vector3);
+    size_t PolysSize  = BenchPathCapacity * sizeof(sml_u32);
+
+    sml_heap_block Heap   = SmlMemory.Allocate(PointsSize + PolysSize * 2 +
+                                               BenchPathMaxPoints * sizeof(sml_vector3));
+    sml_vector3   *Points = (sml_vector3*)Heap.Data;
+
+    SML::nav_path Path = {};
+    Path.Polys    = (sml_u32*)(Points + BenchCacheQueries * 2);
+    Path.Capacity = BenchPathCapacity;
+
+    sml_vector3 *Straight = (sml_vector3*)(Path.Polys + BenchPathCapacity);
+
+    SML::nav_path Direct = {};
+    Direct.Polys    = (sml_u32*)(Straight + BenchPathMaxPoints);
+    Direct.Capacity = BenchPathCapacity;
+
+    sml_u32 Routes[BenchCacheRoutes * 2];
+    sml_u64 State = 0xD1B54A32D192ED03ull;
+
+    for(sml_u32 Idx = 0; Idx < BenchCacheRoutes; Idx++)
+    {
+        sml_u32 From = (sml_u32)(Bench_Random(&State) % PieceCount);
+        sml_u32 To   = (sml_u32)(Bench_Random(&State) % PieceCount);
+
+        while(Mesh.Polys[To].Source != Mesh.Polys[From].Source)
+        {
+            To = (sml_u32)(Bench_Random(&State) % PieceCount);
+        }
+
+        Routes[Idx * 2 + 0] = From;
+        Routes[Idx * 2 + 1] = To;
+    }
+
+    for(sml_u32 Idx = 0; Idx < BenchCacheQueries; Idx++)
+    {
+        sml_u32 Route = (sml_u32)(Bench_Random(&State) % BenchCacheRoutes);
+
+        Points[Idx * 2 + 0] = BenchInt_PiecePoint(&Mesh, Routes[Route * 2], &State);
+        Points[Idx * 2 + 1] = BenchInt_PiecePoint(&Mesh, Routes[Route * 2 + 1], &State);
+    }
+
+    bench_timer Timer = Bench_StartTimer();
+
+    for(sml_u32 Idx = 0; Idx < BenchCacheQueries; Idx++)
+    {
+        SML::FindPath(&Query, Points[Idx * 2], Points[Idx * 2 + 1], &Filter, &Path);
+        SML::FindStraightPath(&Mesh, &Path, Points[Idx * 2], Points[Idx * 2 + 1],
+                              Straight, BenchPathMaxPoints);
+    }
+
+    sml_f64 DirectNs = Bench_ElapsedNs(Timer);
+
+    SML::nav_path_cache Cache = SML::CreateNavPathCache(BenchCacheRoutes);
+
+    Timer = Bench_StartTimer();
+
+    for(sml_u32 Idx = 0; Idx < BenchCacheQueries; Idx++)
+    {
+        SML::FindPathCached(&Cache, &Query, Points[Idx * 2], Points[Idx * 2 + 1], &Filter,
+                            &Path);
+        SML::FindStraightPath(&Mesh, &Path, Points[Idx * 2], Points[Idx * 2 + 1],
+                              Straight, BenchPathMaxPoints);
+    }
+
+    sml_f64 CachedNs = Bench_ElapsedNs(Timer);
+
+    // Checked apart from the timing. A corridor FindPath also finds must come
+    // with the same cost.
+    sml_u32 Broken   = 0;
+    sml_u32 Compared = 0;
+    sml_u32 BadCost  = 0;
+
+    for(sml_u32 Idx = 0; Idx < BenchCacheQueries; Idx++)
+    {
+        sml_u32 From = SML::FindNavPoly(&Query, Points[Idx * 2]);
+        sml_u32 To   = SML::FindNavPoly(&Query, Points[Idx * 2 + 1]);
+
+        SML::NavPath_Status Status = SML::FindPathCached(&Cache, &Query, Points[Idx * 2],
+                                                         Points[Idx * 2 + 1], &Filter,
+                                                         &Path);
+
+        bool Valid = Status == SML::NavPath_Found && Path.Polys[0] == From &&
+                     Path.Polys[Path.Count - 1] == To &&
+                     BenchInt_CorridorLinked(&Mesh, &Path);
+
+        if(!Valid) Broken++;
+
+        SML::FindPath(&Query, Points[Idx * 2], Points[Idx * 2 + 1], &Filter, &Direct);
+
+        if(Direct.Count != Path.Count ||
+           memcmp(Direct.Polys, Path.Polys, Path.Count * sizeof(sml_u32)))
+        {
+            continue;
+        }
+
+        Compared++;
+        if(Direct.Cost != Path.Cost) BadCost++;
+    }
+
+    sml_u64 Hits   = Cache.Entries.Hits;
+    sml_u64 Misses = Cache.Entries.Misses;
+
+    // A rebuilt mesh, even in the same storage, must not see the old corridors.
+    Query.Free();
+    Mesh.Free();
+
+    Mesh  = SML::BuildConvexNavMesh(Polygons.Values, Polygons.Count);
+    Query = SML::CreateNavQuery(&Mesh);
+
+    SML::FindPathCached(&Cache, &Query, Points[0], Points[1], &Filter, &Path);
+
+    bool Invalidated = Cache.Invalidations == 1 && Cache.Entries.Count == 1;
+
+    // An area written straight into a piece keeps the revision, the caller
+    // invalidates by hand and the same query must search again.
+    sml_u64 MissesBefore = Cache.Entries.Misses;
+
+    Mesh.Polys[Path.Polys[0]].Area = 1;
+    SML::InvalidateNavPathCache(&Cache);
+    SML::FindPathCached(&Cache, &Query, Points[0], Points[1], &Filter, &Path);
+
+    bool Manual = Cache.Invalidations == 2 && Cache.Entries.Misses == MissesBefore + 1;
+
+    Bench_Report("navmesh", "path_cache", "findpath", PieceCount, 1,
+                 DirectNs / BenchCacheQueries);
+    Bench_Report("navmesh", "path_cache", "cached", PieceCount, 1,
+                 CachedNs / BenchCacheQueries);
+
+    printf("navmesh: %u pieces, path cache: %.1fx less time than FindPath, "
+           "%llu hits, %llu misses, %u of %u corridors as FindPath's\n", PieceCount,
+           DirectNs / CachedNs, (unsigned long long)Hits, (unsigned long long)Misses,
+           Compared, BenchCacheQueries);
+
+    if(Broken || BadCost || !Invalidated || !Manual)
+    {
+        printf("navmesh: path cache gave %u broken corridors, %u wrong costs%s%s\n",
+               Broken, BadCost, Invalidated ? "" : ", survived a rebuild",
+               Manual ? "" : ", survived InvalidateNavPathCache");
+        BenchFailures++;
+    }
+
+    Cache.Free();
+    SmlMemory.Free(Heap);
+    Query.Free();
+    Mesh.Free();
+}
+
+static sml_f64
+BenchInt_NavMeshBuild(bench_terrain *Terrain, sml_u32 Threads,
+                      dynamic_array<SML::nav_poly> *Result)
+{
+    sml_u32 TriCount = Terrain->IdxCount / 3;
+
+    sml_u32 Repetitions = TriCount >= (1u << 20) ? 1 : TriCount >= (1u << 16) ? 3 : 20;
+
+    sml_f64 WalkableNs = 0.0, ClustersNs = 0.0, LoopsNs = 0.0;
+
+    sml_u64 Locks     = SmlMemory.Locks;
+    sml_u64 Contended = SmlMemory.Contended;
+    sml_u64 Held      = SmlMemory.HeldCycles;
+    sml_u64 Start     = __rdtsc();
+
+    for(sml_u32 Rep = 0; Rep < Repetitions; Rep++)
+    {
+        bench_timer Timer = Bench_StartTimer();
+        sml_walkable_list List = SmlInt_BuildWalkableList(Terrain->Positions,
+                                                          Terrain->Indices,
+                                                          Terrain->IdxCount,
+                                                          BenchNavMeshSlope, Threads);
+        WalkableNs += Bench_ElapsedNs(Timer);
+
+        Timer = Bench_StartTimer();
+        auto Clusters = SmlInt_BuildPolygonClusters(&List, Threads);
+        ClustersNs += Bench_ElapsedNs(Timer);
+
+        Timer = Bench_StartTimer();
+        auto Polygons = SML::BuildNavPolygons(Clusters, &List, 0.0f, Threads);
+        LoopsNs += Bench_ElapsedNs(Timer);
+
+        if(Rep + 1 == Repetitions) *Result = Polygons;
+        else                       BenchInt_FreePolygons(Polygons);
+
+        for(sml_u32 Idx = 0; Idx < Clusters.Count; Idx++) Clusters[Idx].Free();
+
+        Clusters.Free();
+        SmlInt_FreeWalkableList(&List);
+    }
+
+    // The lock serializes its holders, so the share of the build it is held
+    // for bounds the speedup threads can give.
+    sml_f64 Share = (sml_f64)(SmlMemory.HeldCycles - Held) / (sml_f64)(__rdtsc() - Start);
+
+    printf("navmesh: %u triangles, %2u threads: allocator lock held %.2f%% of the "
+           "build (caps scaling at %.0fx), %llu locks, %llu contended\n", TriCount,
+           Threads, Share * 100.0, 1.0 / Share,
+           (unsigned long long)((SmlMemory.Locks - Locks) / Repetitions),
+           (unsigned long long)((SmlMemory.Contended - Contended) / Repetitions));
+
+    sml_f64 PerTri = 1.0 / ((sml_f64)TriCount * Repetitions);
+
+    Bench_Report("navmesh", "walkable_list", "auto", TriCount, Threads,
+                 WalkableNs * PerTri);
+    Bench_Report("navmesh", "clusters", "union_find", TriCount, Threads,
+                 ClustersNs * PerTri);
+    Bench_Report("navmesh", "boundary_loops", "hashed", TriCount, Threads,
+                 LoopsNs * PerTri);
+
+    sml_f64 TotalNs = (WalkableNs + ClustersNs + LoopsNs) * PerTri;
+    Bench_Report("navmesh", "build", "total", TriCount, Threads, TotalNs);
+
+    return TotalNs;
+}
+
+// ===================================
+// User API
+// ===================================
+
+static void
+Bench_NavMesh()
+{
+    sml_u32 MaxThreads = Sml_HardwareThreads();
+    if(MaxThreads < 2) MaxThreads = 2;
+
+    BenchInt_PillarPaths();
+
+    for(sml_u32 Cells : BenchNavMeshSizes)
+    {
+        bench_terrain Terrain  = BenchInt_MakeTerrain(Cells);
+        sml_u32       TriCount = Terrain.IdxCount / 3;
+
+        BenchInt_Classify(&Terrain);
+        BenchInt_Adjacency(&Terrain);
+        BenchInt_Weld(&Terrain, Cells);
+
+        dynamic_array<SML::nav_poly> Reference = {};
+        sml_f64                 SerialNs  = 0.0;
+
+        for(sml_u32 Threads = 1; ; Threads = Threads * 2 < MaxThreads ? Threads * 2 :
+                                                                        MaxThreads)
+        {
+            dynamic_array<SML::nav_poly> Polygons = {};
+            sml_f64 TotalNs = BenchInt_NavMeshBuild(&Terrain, Threads, &Polygons);
+
+            if(Threads == 1)
+            {
+                Reference = Polygons;
+                SerialNs  = TotalNs;
+
+                sml_u64 VertCount = 0;
+                for(sml_u32 Idx = 0; Idx < Polygons.Count; Idx++)
+                {
+                    VertCount += Polygons[Idx].Verts.Count;
+                }
+
+                printf("navmesh: %u triangles -> %u polygons, %llu boundary vertices\n",
+                       TriCount, Polygons.Count, (unsigned long long)VertCount);
+
+                if(!BenchInt_AreasMatch(Polygons)) BenchFailures++;
+            }
+            else
+            {
+                bool Same = BenchInt_SamePolygons(Reference, Polygons);
+                if(!Same) BenchFailures++;
+
+                printf("navmesh: %u triangles, %2u threads: %.2fx%s\n", TriCount, Threads,
+                       SerialNs / TotalNs, Same ? "" : ", OUTPUT DIFFERS FROM 1 THREAD");
+
+                BenchInt_FreePolygons(Polygons);
+            }
+
+            if(Threads == MaxThreads) break;
+        }
+
+        BenchInt_FindPath(Reference, TriCount);
+        BenchInt_FindPathHierarchical(Reference);
+        BenchInt_PathService(Reference);
+        BenchInt_Corridor(Reference);
+        BenchInt_PathCache(Reference);
+        BenchInt_FreePolygons(Reference);
+
+        SmlMemory.Free(Terrain.PositionsHeap);
+        SmlMemory.Free(Terrain.IndicesHeap);
+    }
+}
@@ -0,0 +1,166 @@
+// ===================================
+// Type Definitions
+// ===================================
+
+// NOTE: Baseline the lock-free queues are compared against.
+struct bench_mutex_queue
+{
+    std::mutex Lock;
+    sml_u64   *Values;
+    size_t     Mask;
+    size_t     Head;
+    size_t     Tail;
+
+    bool Push(const sml_u64 &Value)
+    {
+        std::lock_guard<std::mutex> Guard(this->Lock);
+        if(this->Tail - this->Head > this->Mask) return false;
+
+        this->Values[this->Tail++ & this->Mask] = Value;
+        return true;
+    }
+
+    bool Pop(sml_u64 *Out)
+    {
+        std::lock_guard<std::mutex> Guard(this->Lock);
+        if(this->Head == this->Tail) return false;
+
+        *Out = this->Values[this->Head++ & this->Mask];
+        return true;
+    }
+};
+
+// ===================================
+// Internal Helpers
+// ===================================
+
+constexpr sml_u32 BenchQueue_Capacity = 1024;
+
+// NOTE: With one thread the same thread pushes a batch then pops it back, which
+// measures the uncontended cost. Otherwise the threads are split in half between
+// producers and consumers.
+
+template<typename Q>
+static sml_f64
+BenchInt_RunQueue(Q *Queue, sml_u32 ThreadCount, sml_u64 ItemsPerProducer)
+{
+    if(ThreadCount == 1)
+    {
+        sml_u64     Sum   = 0;
+        bench_timer Timer = Bench_StartTimer();
+
+        for(sml_u64 Done = 0; Done < ItemsPerProducer; Done += BenchQueue_Capacity)
+        {
+            for(sml_u64 Idx = 0; Idx < BenchQueue_Capacity; Idx++) Queue->Push(Idx);
+
+            sml_u64 Value = 0;
+            while(Queue->Pop(&Value)) Sum += Value;
+        }
+
+        sml_f64 Elapsed = Bench_ElapsedNs(Timer);
+        BenchSink = Sum;
+
+        return Elapsed / (sml_f64)ItemsPerProducer;
+    }
+
+    sml_u32 Producers = ThreadCount / 2;
+    sml_u32 Consumers = ThreadCount - Producers;
+    sml_u64 Total     = ItemsPerProducer * Producers;
+
+    std::atomic<bool>    Go(false);
+    std::atomic<sml_u64> Consumed(0);
+    std::atomic<sml_u64> Sum(0);
+
+    std::thread Threads[64];
+    Sml_Assert(ThreadCount <= 64);
+
+    for(sml_u32 Idx = 0; Idx < Producers; Idx++)
+    {
+        Threads[Idx] = std::thread([&, Idx]()
+        {
+            while(!Go.load(std::memory_order_acquire)) std::this_thread::yield();
+
+            sml_u64 Base = Idx * ItemsPerProducer;
+            for(sml_u64 Item = 0; Item < ItemsPerProducer; Item++)
+            {
+                while(!Queue->Push(Base + Item)) std::this_thread::yield();
+            }
+        });
+    }
+
+    for(sml_u32 Idx = 0; Idx < Consumers; Idx++)
+    {
+        Threads[Producers + Idx] = std::thread([&]()
+        {
+            while(!Go.load(std::memory_order_acquire)) std::this_thread::yield();
+
+            sml_u64 LocalSum = 0;
+            sml_u64 Value    = 0;
+
+            while(Consumed.load(std::memory_order_relaxed) < Total)
+            {
+                if(Queue->Pop(&Value))
+                {
+                    LocalSum += Value;
+                    Consumed.fetch_add(1, std::memory_order_relaxed);
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+
+            Sum.fetch_add(LocalSum);
+        });
+    }
+
+    bench_timer Timer = Bench_StartTimer();
+    Go.store(true, std::memory_order_release);
+
+    for(sml_u32 Idx = 0; Idx < ThreadCount; Idx++) Threads[Idx].join();
+
+    sml_f64 Elapsed = Bench_ElapsedNs(Timer);
+
+    sml_u64 Expected = (Total * (Total - 1)) / 2;
+    Sml_Assert(Sum.load() == Expected);
+
+    return Elapsed / (sml_f64)Total;
+}
+
+// ===================================
+// Benchmarks
+// ===================================
+
+static void
+Bench_Queues()
+{
+    const sml_u32 ThreadCounts[] = {1, 2, 4, 8, 16, 32};
+    const sml_u64 Items          = 1 << 18;
+
+    for(sml_u32 Threads : ThreadCounts)
+    {
+        auto Mpmc = mpmc_queue<sml_u64>(BenchQueue_Capacity);
+        sml_f64 MpmcNs = BenchInt_RunQueue(&Mpmc, Threads, Items / Threads + 1);
+        Bench_Report("queue", "push_pop", "mpmc", BenchQueue_Capacity, Threads, MpmcNs);
+        Mpmc.Free();
+
+        bench_mutex_queue MutexQueue;
+        sml_heap_block    MutexHeap = SmlMemory.Allocate(BenchQueue_Capacity *
+                                                         sizeof(sml_u64));
+        MutexQueue.Values = (sml_u64*)MutexHeap.Data;
+        MutexQueue.Mask   = BenchQueue_Capacity - 1;
+        MutexQueue.Head   = 0;
+        MutexQueue.Tail   = 0;
+
+        sml_f64 MutexNs = BenchInt_RunQueue(&MutexQueue, Threads, Items / Threads + 1);
+        Bench_Report("queue", "push_pop", "std_mutex", BenchQueue_Capacity, Threads,
+                     MutexNs);
+        SmlMemory.Free(MutexHeap);
+    }
+
+    // NOTE: The SPSC ring only supports one producer and one consumer.
+    auto Spsc = spsc_queue<sml_u64>(BenchQueue_Capacity);
+    Bench_Report("queue", "push_pop", "spsc", BenchQueue_Capacity, 2,
+                 BenchInt_RunQueue(&Spsc, 2, Items));
+    Spsc.Free();
+}
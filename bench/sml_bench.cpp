@@ -0,0 +1,135 @@
+// Standalone benchmark runner, built as its own unity build.
+//
+// MSVC: cl /O2 /std:c++17 /EHsc /I.. sml_bench.cpp
+// GCC : g++ -O2 -std=c++17 -I.. sml_bench.cpp -o sml_bench -lpthread
+//
+// Usage: sml_bench [--csv path] [--json path] [suite...]
+//        No suite runs all of them. Suites: memory, data, queue, math, accuracy,
+//        navmesh.
+//        SML_FORCE_ISA=<isa> binds the engine's math kernels to a lower ISA.
+
+// NOTE: The DRAM sized runs need more than the editor's default heap. The
+// navmesh suite reports how long builds hold the allocator lock.
+#define SML_HEAP_SIZE Sml_Megabytes((size_t)1536)
+#define SML_MEMORY_STATS
+
+#include "../sml_base.cpp"
+
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <queue>
+#include <unordered_map>
+#include <cfloat>
+
+// CPU features
+#include "../platform/sml_cpu.cpp"
+
+// Memory
+#include "../memory/sml_stack_memory.cpp"
+
+// Data structures
+#include "../data_structures/sml_dynamic_array.cpp"
+#include "../data_structures/sml_stack.cpp"
+#include "../data_structures/sml_hashmap.cpp"
+#include "../data_structures/sml_slot_map.cpp"
+#include "../data_structures/sml_lru_cache.cpp"
+
+// Threading
+#include "../threading/sml_mpmc_queue.cpp"
+#include "../threading/sml_spsc_queue.cpp"
+#include "../threading/sml_parallel_for.cpp"
+
+// Math
+#include "../math/vector.cpp"
+#include "../math/matrix.cpp"
+#include "../math/batch_transform.cpp"
+#include "../math/quaternion.cpp"
+#include "../math/frustum.cpp"
+#include "../math/geometry.cpp"
+#include "../math/intersection.cpp"
+
+// Spatial
+#include "../spatial/sml_nav_mesh.cpp"
+#include "../spatial/sml_nav_corridor.cpp"
+#include "../spatial/sml_nav_path_service.cpp"
+#include "../spatial/sml_nav_path_cache.cpp"
+
+// Benchmarks
+#include "bench_common.cpp"
+#include "bench_data_structures.cpp"
+#include "bench_queues.cpp"
+#include "bench_math.cpp"
+#include "bench_navmesh.cpp"
+
+struct bench_suite
+{
+    const char *Name;
+    void      (*Run)();
+};
+
+static const bench_suite BenchSuites[] =
+{
+    {"memory", Bench_Memory        },
+    {"data"  , Bench_DataStructures},
+    {"queue" , Bench_Queues        },
+    {"math"  , Bench_Math          },
+    {"accuracy", Bench_MathAccuracy},
+    {"navmesh", Bench_NavMesh      },
+};
+
+int main(int ArgCount, char **Args)
+{
+    const char *CsvPath       = nullptr;
+    const char *JsonPath      = nullptr;
+    bool        SuiteSelected = false;
+
+    for(int ArgIdx = 1; ArgIdx < ArgCount; ArgIdx++)
+    {
+        if(strcmp(Args[ArgIdx], "--csv") == 0 && ArgIdx + 1 < ArgCount)
+        {
+            CsvPath = Args[++ArgIdx];
+        }
+        else if(strcmp(Args[ArgIdx], "--json") == 0 && ArgIdx + 1 < ArgCount)
+        {
+            JsonPath = Args[++ArgIdx];
+        }
+        else
+        {
+            SuiteSelected = true;
+        }
+    }
+
+    for(const bench_suite &Suite : BenchSuites)
+    {
+        bool Selected = !SuiteSelected;
+
+        for(int ArgIdx = 1; ArgIdx < ArgCount; ArgIdx++)
+        {
+            if(strcmp(Args[ArgIdx], Suite.Name) == 0) Selected = true;
+        }
+
+        if(Selected) Suite.Run();
+    }
+
+    if(CsvPath && !Bench_WriteCsv(CsvPath))
+    {
+        fprintf(stderr, "Could not write %s\n", CsvPath);
+        return 1;
+    }
+
+    if(JsonPath && !Bench_WriteJson(JsonPath))
+    {
+        fprintf(stderr, "Could not write %s\n", JsonPath);
+        return 1;
+    }
+
+    if(BenchFailures)
+    {
+        fprintf(stderr, "%u accuracy checks failed\n", BenchFailures);
+        return 1;
+    }
+
+    return 0;
+}
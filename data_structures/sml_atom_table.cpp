@@ -0,0 +1,196 @@
+// ===================================
+// Type Definitions
+// ===================================
+
+// NOTE: Atom 0 is always the empty string, so zero-initialized records
+// (memset, = {}) hold a valid name.
+
+enum class sml_atom : sml_u32 {};
+
+constexpr sml_atom SmlAtom_None = sml_atom(0);
+
+struct sml_atom_entry
+{
+    const char *String;
+    sml_u32     Length;
+    sml_u32     NextSameHash;
+    sml_u64     Hash;
+};
+
+struct sml_atom_table
+{
+    // Core-data
+    dynamic_array<sml_atom_entry> Entries;
+    sml_hashmap<sml_u64, sml_u32> HashToAtom;
+
+    // String arena
+    sml_u8 *ArenaBase;
+    size_t  ArenaSize;
+    size_t  ArenaCapacity;
+
+    static constexpr sml_u32 Invalid       = sml_u32(-1);
+    static constexpr sml_u32 InitialCount  = 1024;
+    static constexpr size_t  ArenaPageSize = Sml_Kilobytes(64);
+};
+
+// ===================================
+// Global Variables
+// ===================================
+
+static sml_atom_table SmlAtoms;
+
+// ===================================
+// Internal Helpers
+// ===================================
+
+static void
+SmlInt_EnsureAtomTable()
+{
+    if(SmlAtoms.Entries.Values) return;
+
+    SmlAtoms.Entries    = dynamic_array<sml_atom_entry>(SmlAtoms.InitialCount);
+    SmlAtoms.HashToAtom = sml_hashmap<sml_u64, sml_u32>(SmlAtoms.InitialCount);
+
+    SmlAtoms.ArenaBase     = nullptr;
+    SmlAtoms.ArenaSize     = 0;
+    SmlAtoms.ArenaCapacity = 0;
+
+    sml_atom_entry Empty = {};
+    Empty.String       = "";
+    Empty.Length       = 0;
+    Empty.NextSameHash = SmlAtoms.Invalid;
+    Empty.Hash         = XXH64("", 0, 0);
+
+    SmlAtoms.Entries.Push(Empty);
+    SmlAtoms.HashToAtom.Insert(Empty.Hash, 0);
+}
+
+// NOTE: Pages are never returned to SmlMemory, atoms live for the whole program.
+
+static const char*
+SmlInt_AtomArenaPush(const char *String, sml_u32 Length)
+{
+    size_t Needed = size_t(Length) + 1;
+
+    if(SmlAtoms.ArenaSize + Needed > SmlAtoms.ArenaCapacity)
+    {
+        size_t PageSize = SmlAtoms.ArenaPageSize;
+        if(Needed > PageSize) PageSize = Needed;
+
+        sml_heap_block Page = SmlMemory.Allocate(PageSize);
+
+        SmlAtoms.ArenaBase     = (sml_u8*)Page.Data;
+        SmlAtoms.ArenaSize     = 0;
+        SmlAtoms.ArenaCapacity = PageSize;
+    }
+
+    char *Result = (char*)(SmlAtoms.ArenaBase + SmlAtoms.ArenaSize);
+    memcpy(Result, String, Length);
+    Result[Length] = '\0';
+
+    SmlAtoms.ArenaSize += Needed;
+
+    return Result;
+}
+
+static sml_u32
+SmlInt_FindAtom(const char *String, sml_u32 Length, sml_u64 Hash)
+{
+    sml_u32 *First = SmlAtoms.HashToAtom.Find(Hash);
+    if(!First) return SmlAtoms.Invalid;
+
+    sml_u32 Idx = *First;
+    while(Idx != SmlAtoms.Invalid)
+    {
+        sml_atom_entry *Entry = SmlAtoms.Entries.Values + Idx;
+
+        if(Entry->Length == Length && memcmp(Entry->String, String, Length) == 0)
+        {
+            return Idx;
+        }
+
+        Idx = Entry->NextSameHash;
+    }
+
+    return SmlAtoms.Invalid;
+}
+
+// ===================================
+// User API
+// ===================================
+
+static sml_atom
+SmlAtom_Intern(const char *String, sml_u32 Length)
+{
+    SmlInt_EnsureAtomTable();
+
+    sml_u64 Hash = XXH64(String, Length, 0);
+    sml_u32 Idx  = SmlInt_FindAtom(String, Length, Hash);
+
+    if(Idx == SmlAtoms.Invalid)
+    {
+        sml_atom_entry Entry = {};
+        Entry.String       = SmlInt_AtomArenaPush(String, Length);
+        Entry.Length       = Length;
+        Entry.Hash         = Hash;
+        Entry.NextSameHash = SmlAtoms.Invalid;
+
+        Idx = SmlAtoms.Entries.Count;
+
+        sml_u32 *First = SmlAtoms.HashToAtom.Find(Hash);
+        if(First)
+        {
+            // Hash collision on a different string: chain it behind the first one.
+            Entry.NextSameHash = *First;
+            *First             = Idx;
+        }
+        else
+        {
+            SmlAtoms.HashToAtom.Insert(Hash, Idx);
+        }
+
+        SmlAtoms.Entries.Push(Entry);
+    }
+
+    return sml_atom(Idx);
+}
+
+static sml_atom
+SmlAtom_Intern(const char *String)
+{
+    return SmlAtom_Intern(String, sml_u32(strlen(String)));
+}
+
+// NOTE: Returns SmlAtom_None when the string was never interned. Useful to
+// compare against existing names without growing the table.
+
+static sml_atom
+SmlAtom_Find(const char *String)
+{
+    SmlInt_EnsureAtomTable();
+
+    sml_u32 Length = sml_u32(strlen(String));
+    sml_u32 Idx    = SmlInt_FindAtom(String, Length, XXH64(String, Length, 0));
+
+    return Idx == SmlAtoms.Invalid ? SmlAtom_None : sml_atom(Idx);
+}
+
+static const char*
+SmlAtom_String(sml_atom Atom)
+{
+    if(!SmlAtoms.Entries.Values) return "";
+
+    Sml_Assert(sml_u32(Atom) < SmlAtoms.Entries.Count);
+
+    return SmlAtoms.Entries.Values[sml_u32(Atom)].String;
+}
+
+static sml_u32
+SmlAtom_Length(sml_atom Atom)
+{
+    if(!SmlAtoms.Entries.Values) return 0;
+
+    Sml_Assert(sml_u32(Atom) < SmlAtoms.Entries.Count);
+
+    return SmlAtoms.Entries.Values[sml_u32(Atom)].Length;
+}
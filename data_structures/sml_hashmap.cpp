@@ -19,9 +19,13 @@ inline constexpr bool has_equal_op = has_equal<T>::value;
 static inline
 sml_u32 ctz32(sml_u32 x)
 {
+#if defined(_MSC_VER)
     unsigned long Index;
     _BitScanForward(&Index, x);
     return (sml_u32)Index;
+#else
+    return (sml_u32)__builtin_ctz(x);
+#endif
 }
 
 
@@ -32,11 +36,13 @@ struct sml_hashmap_entry
     V Value;
 };
 
-// BUG:
-// 1) Does not ever resize. Which means if it's too filled, it will loop to infinity.
-//    We should track a filled % and resize when it is reached. Wheter we keep
-//    the fully hashed value or not should be decided or parametrized. Also, hashmap
-//    O(N) as it grows.
+// NOTE:
+// 1) Grows (or rehashes in place) once live + deleted buckets reach 7/8 of the
+//    capacity, so probing always finds an empty lane. Pointers returned by Get
+//    and Find are invalidated by any insertion that triggers a grow.
+// 2) Removing from a group that still has an empty lane frees the bucket, since
+//    no probe sequence could have walked past that group. Otherwise the bucket
+//    is tombstoned until the next rehash.
 
 // WARN:
 // 1) For some reasons, concepts produce the most god-awful error messages ever. Well
@@ -54,19 +60,23 @@ struct sml_hashmap
     sml_hashmap_entry<K, V> *Buckets;
     sml_u32                  GroupCount;
 
+    // Fill tracking
+    sml_u32 Count;
+    sml_u32 Deleted;
+
     sml_heap_block BucketHeap;
     sml_heap_block MetaDataHeap;
 
     static constexpr uint32_t BucketGroupSize   = 16;
     static constexpr uint8_t  EmptyBucketTag    = 0x80;
+    static constexpr uint8_t  DeletedBucketTag  = 0xFE;
+    static constexpr uint32_t Invalid           = uint32_t(-1);
 
     sml_hashmap<K, V>(){};
     sml_hashmap<K, V>(sml_u32 InitialCount)
     {
         if(InitialCount == 0) InitialCount = 8;
 
-        this->GroupCount = InitialCount;
-
         this->GroupCount = InitialCount;
         if ((this->GroupCount & (this->GroupCount - 1)) != 0)
         {
@@ -75,7 +85,105 @@ struct sml_hashmap
             this->GroupCount = Pow2;
         }
 
-        sml_u32 BucketCount          = this->GroupCount * this->BucketGroupSize;
+        this->AllocateGroups();
+    }
+
+    inline sml_u32 BucketCount()
+    {
+        return this->GroupCount * this->BucketGroupSize;
+    }
+
+    V& Get(K Key)
+    {
+        sml_u64 HashedValue = XXH64(&Key, sizeof(Key), 0);
+        sml_u32 Index       = this->FindIndex(Key, HashedValue);
+
+        if(Index == this->Invalid)
+        {
+            Index = this->InsertNew(Key, HashedValue);
+        }
+
+        return this->Buckets[Index].Value;
+    }
+
+    // NOTE: Unlike Get, this does not insert the key when it is missing.
+
+    V* Find(K Key)
+    {
+        sml_u64 HashedValue = XXH64(&Key, sizeof(Key), 0);
+        sml_u32 Index       = this->FindIndex(Key, HashedValue);
+
+        return Index == this->Invalid ? nullptr : &this->Buckets[Index].Value;
+    }
+
+    void Insert(K Key, V Value)
+    {
+        sml_u64 HashedValue = XXH64(&Key, sizeof(Key), 0);
+        sml_u32 Index       = this->FindIndex(Key, HashedValue);
+
+        if(Index == this->Invalid)
+        {
+            Index = this->InsertNew(Key, HashedValue);
+            this->Buckets[Index].Value = Value;
+        }
+    }
+
+    bool Remove(K Key)
+    {
+        sml_u64 HashedValue = XXH64(&Key, sizeof(Key), 0);
+        sml_u32 Index       = this->FindIndex(Key, HashedValue);
+
+        if(Index == this->Invalid) return false;
+
+        sml_u32 GroupIndex = Index / this->BucketGroupSize;
+        sml_u8 *Meta       = this->MetaData + (GroupIndex * this->BucketGroupSize);
+
+        __m128i MetaVector  = _mm_loadu_si128((__m128i*)Meta);
+        __m128i EmptyVector = _mm_set1_epi8((char)this->EmptyBucketTag);
+        sml_i32 MaskEmpty   = _mm_movemask_epi8(_mm_cmpeq_epi8(MetaVector,
+                                                               EmptyVector));
+
+        if(MaskEmpty)
+        {
+            this->MetaData[Index] = this->EmptyBucketTag;
+        }
+        else
+        {
+            this->MetaData[Index] = this->DeletedBucketTag;
+            ++this->Deleted;
+        }
+
+        memset(&this->Buckets[Index], 0, sizeof(sml_hashmap_entry<K, V>));
+        --this->Count;
+
+        return true;
+    }
+
+    void Reset()
+    {
+        memset(this->Buckets , 0, this->BucketCount() * sizeof(sml_hashmap_entry<K, V>));
+        memset(this->MetaData, this->EmptyBucketTag, this->BucketCount());
+
+        this->Count   = 0;
+        this->Deleted = 0;
+    }
+
+    void Free()
+    {
+        SmlMemory.Free(this->BucketHeap);
+        SmlMemory.Free(this->MetaDataHeap);
+
+        this->Buckets  = nullptr;
+        this->MetaData = nullptr;
+    }
+
+    // ===================================
+    // Internal Helpers
+    // ===================================
+
+    void AllocateGroups()
+    {
+        sml_u32 BucketCount          = this->BucketCount();
         size_t  BucketAllocationSize = BucketCount * sizeof(sml_hashmap_entry<K, V>);
 
         this->BucketHeap = SmlMemory.Allocate(BucketAllocationSize);
@@ -84,117 +192,128 @@ struct sml_hashmap
         this->MetaDataHeap = SmlMemory.Allocate(BucketCount * sizeof(sml_u8));
         this->MetaData     = (sml_u8*)this->MetaDataHeap.Data;
 
+        this->Count   = 0;
+        this->Deleted = 0;
+
         memset(this->Buckets, 0, BucketCount * sizeof(sml_hashmap_entry<K, V>));
         memset(this->MetaData, this->EmptyBucketTag, BucketCount * sizeof(sml_u8));
     }
 
-    V& Get(K Key)
+    sml_u32 FindIndex(K &Key, sml_u64 HashedValue)
     {
         sml_u32 ProbeCount = 0;
-        sml_u64 HashedValue = XXH64(&Key, sizeof(Key), 0);
-        sml_u32 GroupIndex  = HashedValue & (this->GroupCount - 1);
+        sml_u32 GroupIndex = HashedValue & (this->GroupCount - 1);
+        sml_u8  Tag        = (HashedValue & 0x7F);
 
-        while(true)
+        __m128i TagVector   = _mm_set1_epi8(Tag);
+        __m128i EmptyVector = _mm_set1_epi8((char)this->EmptyBucketTag);
+
+        while(ProbeCount < this->GroupCount)
         {
             sml_u8 *Meta = this->MetaData + (GroupIndex * this->BucketGroupSize);
-            sml_u8  Tag  = (HashedValue & 0x7F);
-
-            Sml_Assert(Tag < this->EmptyBucketTag);
 
             __m128i MetaVector = _mm_loadu_si128((__m128i*)Meta);
-            __m128i TagVector  = _mm_set1_epi8(Tag);
 
             sml_i32 Mask = _mm_movemask_epi8(_mm_cmpeq_epi8(MetaVector, TagVector));
 
             while(Mask)
             {
-                sml_i32 Lane  = (i32)ctz32(Mask);
+                sml_i32 Lane  = (sml_i32)ctz32(Mask);
                 sml_u32 Index = (GroupIndex * this->BucketGroupSize) + Lane;
 
-                sml_hashmap_entry<K, V> *Entry = this->Buckets + Index;
-                if(Entry->Key == Key)
+                if(this->Buckets[Index].Key == Key)
                 {
-                    return Entry->Value;
+                    return Index;
                 }
 
                 Mask &= Mask - 1;
             }
 
-            __m128i EmptyVector = _mm_set1_epi8(this->EmptyBucketTag);
-            sml_i32 MaskEmpty   = _mm_movemask_epi8(_mm_cmpeq_epi8(MetaVector,
-                                                                   EmptyVector));
-
-            // NOTE: Not really clear what we should do.
+            sml_i32 MaskEmpty = _mm_movemask_epi8(_mm_cmpeq_epi8(MetaVector,
+                                                                 EmptyVector));
             if(MaskEmpty)
             {
-                sml_i32 Lane = ctz32(MaskEmpty);
-                sml_u32 Index = (GroupIndex * this->BucketGroupSize) + Lane;
-
-                sml_hashmap_entry<K, V>* Entry = this->Buckets + Index;
-                Entry->Key = Key;
-
-                Meta[Lane] = Tag;
-
-                return Entry->Value;
+                return this->Invalid;
             }
 
+            // NOTE: Triangular probing visits every group once for power of 2 counts.
             ProbeCount++;
-            GroupIndex = (GroupIndex+(ProbeCount*ProbeCount))&(this->GroupCount-1);
+            GroupIndex = (GroupIndex + ProbeCount) & (this->GroupCount - 1);
         }
+
+        return this->Invalid;
     }
 
-    void Insert(K Key, V Value)
+    // NOTE: Assumes the key is not in the map.
+
+    sml_u32 InsertNew(K &Key, sml_u64 HashedValue)
     {
-        sml_u32 ProbeCount  = 0;
-        sml_u64 HashedValue = XXH64(&Key, sizeof(Key), 0);
-        sml_u32 GroupIndex  = HashedValue & (this->GroupCount - 1);
+        sml_u32 MaxFill = (this->BucketCount() / 8) * 7;
+        if(this->Count + this->Deleted + 1 > MaxFill)
+        {
+            // Mostly tombstones: rehash in place instead of doubling.
+            bool Grow = (this->Count + 1) * 2 > MaxFill;
+            this->Rehash(Grow ? this->GroupCount * 2 : this->GroupCount);
+        }
+
+        sml_u32 ProbeCount = 0;
+        sml_u32 GroupIndex = HashedValue & (this->GroupCount - 1);
+        sml_u8  Tag        = (HashedValue & 0x7F);
+
+        Sml_Assert(Tag < this->EmptyBucketTag);
+
+        __m128i EmptyVector = _mm_set1_epi8((char)this->EmptyBucketTag);
 
         while(true)
         {
             sml_u8 *Meta = this->MetaData + (GroupIndex * this->BucketGroupSize);
-            sml_u8  Tag  = (HashedValue & 0x7F);
-
-            Sml_Assert(Tag < this->EmptyBucketTag);
 
             __m128i MetaVector = _mm_loadu_si128((__m128i*)Meta);
-            __m128i TagVector  = _mm_set1_epi8(Tag);
-
-            sml_i32 Mask = _mm_movemask_epi8(_mm_cmpeq_epi8(MetaVector, TagVector));
-
-            while(Mask)
+            sml_i32 MaskEmpty  = _mm_movemask_epi8(_mm_cmpeq_epi8(MetaVector,
+                                                                  EmptyVector));
+            if(MaskEmpty)
             {
-                sml_i32 Lane  = (i32)ctz32(Mask);
+                sml_i32 Lane  = (sml_i32)ctz32(MaskEmpty);
                 sml_u32 Index = (GroupIndex * this->BucketGroupSize) + Lane;
 
-                sml_hashmap_entry<K, V> *Entry = this->Buckets + Index;
-                if(Entry->Key == Key)
-                {
-                    return;
-                }
+                this->Buckets[Index].Key = Key;
+                Meta[Lane]               = Tag;
 
-                Mask &= Mask - 1;
+                ++this->Count;
+
+                return Index;
             }
 
-            __m128i EmptyVector = _mm_set1_epi8(this->EmptyBucketTag);
-            sml_i32 MaskEmpty   = _mm_movemask_epi8(_mm_cmpeq_epi8(MetaVector,
-                                                                   EmptyVector));
+            ProbeCount++;
+            GroupIndex = (GroupIndex + ProbeCount) & (this->GroupCount - 1);
+        }
+    }
+
+    void Rehash(sml_u32 NewGroupCount)
+    {
+        sml_u8                  *OldMeta      = this->MetaData;
+        sml_hashmap_entry<K, V> *OldBuckets   = this->Buckets;
+        sml_heap_block           OldBucketHeap = this->BucketHeap;
+        sml_heap_block           OldMetaHeap   = this->MetaDataHeap;
+        sml_u32                  OldCount      = this->BucketCount();
 
-            if(MaskEmpty)
-            {
-                sml_i32 Lane  = ctz32(MaskEmpty);
-                sml_u32 Index = (GroupIndex * this->BucketGroupSize) + Lane;
+        this->GroupCount = NewGroupCount;
+        this->AllocateGroups();
 
-                sml_hashmap_entry<K, V> *Entry = this->Buckets + Index;
-                Entry->Key   = Key;
-                Entry->Value = Value;
+        for(sml_u32 Idx = 0; Idx < OldCount; Idx++)
+        {
+            if(OldMeta[Idx] < this->EmptyBucketTag)
+            {
+                sml_hashmap_entry<K, V> *Old = OldBuckets + Idx;
 
-                Meta[Lane] = Tag;
+                sml_u64 HashedValue = XXH64(&Old->Key, sizeof(K), 0);
+                sml_u32 Index       = this->InsertNew(Old->Key, HashedValue);
 
-                return;
+                this->Buckets[Index].Value = Old->Value;
             }
-
-            ProbeCount++;
-            GroupIndex = (GroupIndex+(ProbeCount*ProbeCount))&(this->GroupCount-1);
         }
+
+        SmlMemory.Free(OldBucketHeap);
+        SmlMemory.Free(OldMetaHeap);
     }
 };
@@ -0,0 +1,273 @@
+#include <type_traits> // static type checking
+
+// ===================================
+// Type Definitions
+// ===================================
+
+template<typename K, typename V>
+struct lru_cache_node
+{
+    K       Key;
+    V       Value;
+    size_t  Size;
+    sml_u32 Prev;
+    sml_u32 Next;
+};
+
+// NOTE:
+// 1) Nodes live in one pooled array and are linked by index, most recently used
+//    at the head. The hashmap maps a key to its node, so Get/Put/Evict are O(1).
+// 2) Entries are bounded both by count (the pool size) and by the sum of the
+//    sizes given to Put. A ByteBudget of 0 only bounds the count.
+// 3) OnEvict is called for every entry leaving the cache (eviction, Remove,
+//    replacement by Put, Clear) so owners can free their sml_heap_blocks.
+
+template<typename K, typename V>
+struct lru_cache
+{
+    static_assert(std::is_trivially_copyable<V>::value,
+                  "lru_cache<K, V> requires V to be trivially copyable");
+
+    using evict_callback = void(*)(K &Key, V &Value, void *UserData);
+
+    // Core-data
+    lru_cache_node<K, V> *Nodes;
+    sml_u32               Capacity;
+    sml_u32               Count;
+
+    // Recency-list
+    sml_u32 Head;
+    sml_u32 Tail;
+    sml_u32 FreeHead;
+
+    // Lookup
+    sml_hashmap<K, sml_u32> Lookup;
+
+    // Budget
+    size_t ByteBudget;
+    size_t ByteSize;
+
+    // Eviction
+    evict_callback OnEvict;
+    void          *UserData;
+
+    // Heap
+    sml_heap_block NodeHeap;
+
+    // Stats
+    sml_u64 Hits;
+    sml_u64 Misses;
+    sml_u64 Evictions;
+
+    static constexpr sml_u32 Invalid = sml_u32(-1);
+
+    lru_cache(){};
+    lru_cache(sml_u32 MaxCount, size_t ByteBudget, evict_callback OnEvict = nullptr,
+              void *UserData = nullptr)
+    {
+        if(MaxCount == 0) MaxCount = 8;
+
+        this->Capacity = MaxCount;
+        this->Count    = 0;
+
+        size_t NodesSize = this->Capacity * sizeof(lru_cache_node<K, V>);
+
+        this->NodeHeap = SmlMemory.Allocate(NodesSize);
+        this->Nodes    = (lru_cache_node<K, V>*)this->NodeHeap.Data;
+
+        memset(this->Nodes, 0, NodesSize);
+
+        this->Head     = this->Invalid;
+        this->Tail     = this->Invalid;
+        this->FreeHead = 0;
+
+        for(sml_u32 Idx = 0; Idx < this->Capacity; Idx++)
+        {
+            this->Nodes[Idx].Next = (Idx + 1 < this->Capacity) ? Idx + 1 : this->Invalid;
+        }
+
+        // NOTE: Keeps the map at most half full with a full cache.
+        this->Lookup = sml_hashmap<K, sml_u32>((this->Capacity * 2) / 16);
+
+        this->ByteBudget = ByteBudget;
+        this->ByteSize   = 0;
+
+        this->OnEvict  = OnEvict;
+        this->UserData = UserData;
+
+        this->Hits      = 0;
+        this->Misses    = 0;
+        this->Evictions = 0;
+    }
+
+    // Returns the value and marks it as most recently used.
+    V* Get(K Key)
+    {
+        sml_u32 *NodeIdx = this->Lookup.Find(Key);
+        if(!NodeIdx)
+        {
+            ++this->Misses;
+            return nullptr;
+        }
+
+        ++this->Hits;
+
+        this->Unlink(*NodeIdx);
+        this->LinkFront(*NodeIdx);
+
+        return &this->Nodes[*NodeIdx].Value;
+    }
+
+    // Returns the value without touching the recency order or the stats.
+    V* Peek(K Key)
+    {
+        sml_u32 *NodeIdx = this->Lookup.Find(Key);
+        return NodeIdx ? &this->Nodes[*NodeIdx].Value : nullptr;
+    }
+
+    V& Put(K Key, V Value, size_t Size)
+    {
+        sml_u32 *Existing = this->Lookup.Find(Key);
+        if(Existing)
+        {
+            sml_u32 NodeIdx = *Existing;
+            lru_cache_node<K, V> *Node = this->Nodes + NodeIdx;
+
+            if(this->OnEvict) this->OnEvict(Node->Key, Node->Value, this->UserData);
+
+            this->ByteSize -= Node->Size;
+            this->ByteSize += Size;
+
+            Node->Value = Value;
+            Node->Size  = Size;
+
+            this->Unlink(NodeIdx);
+            this->LinkFront(NodeIdx);
+            this->EnforceBudget();
+
+            return Node->Value;
+        }
+
+        if(this->FreeHead == this->Invalid)
+        {
+            this->EvictLeastRecent();
+        }
+
+        sml_u32 NodeIdx = this->FreeHead;
+        lru_cache_node<K, V> *Node = this->Nodes + NodeIdx;
+
+        this->FreeHead = Node->Next;
+
+        Node->Key   = Key;
+        Node->Value = Value;
+        Node->Size  = Size;
+
+        this->LinkFront(NodeIdx);
+        this->Lookup.Insert(Key, NodeIdx);
+
+        this->ByteSize += Size;
+        ++this->Count;
+
+        this->EnforceBudget();
+
+        return Node->Value;
+    }
+
+    bool Remove(K Key)
+    {
+        sml_u32 *NodeIdx = this->Lookup.Find(Key);
+        if(!NodeIdx) return false;
+
+        this->Release(*NodeIdx);
+
+        return true;
+    }
+
+    bool EvictLeastRecent()
+    {
+        if(this->Tail == this->Invalid) return false;
+
+        this->Release(this->Tail);
+        ++this->Evictions;
+
+        return true;
+    }
+
+    void Clear()
+    {
+        while(this->Head != this->Invalid)
+        {
+            this->Release(this->Head);
+        }
+    }
+
+    void Free()
+    {
+        this->Clear();
+
+        this->Lookup.Free();
+        SmlMemory.Free(this->NodeHeap);
+
+        this->Nodes = nullptr;
+    }
+
+    // ===================================
+    // Internal Helpers
+    // ===================================
+
+    // NOTE: Never evicts the most recent entry, even when it alone is over budget.
+    void EnforceBudget()
+    {
+        if(this->ByteBudget == 0) return;
+
+        while(this->ByteSize > this->ByteBudget && this->Tail != this->Head)
+        {
+            this->EvictLeastRecent();
+        }
+    }
+
+    void Release(sml_u32 NodeIdx)
+    {
+        lru_cache_node<K, V> *Node = this->Nodes + NodeIdx;
+
+        if(this->OnEvict) this->OnEvict(Node->Key, Node->Value, this->UserData);
+
+        this->Lookup.Remove(Node->Key);
+        this->Unlink(NodeIdx);
+
+        this->ByteSize -= Node->Size;
+        --this->Count;
+
+        memset(Node, 0, sizeof(lru_cache_node<K, V>));
+
+        Node->Next     = this->FreeHead;
+        this->FreeHead = NodeIdx;
+    }
+
+    void Unlink(sml_u32 NodeIdx)
+    {
+        lru_cache_node<K, V> *Node = this->Nodes + NodeIdx;
+
+        Node->Prev == this->Invalid ? this->Head = Node->Next :
+                                      this->Nodes[Node->Prev].Next = Node->Next;
+
+        Node->Next == this->Invalid ? this->Tail = Node->Prev :
+                                      this->Nodes[Node->Next].Prev = Node->Prev;
+
+        Node->Prev = this->Invalid;
+        Node->Next = this->Invalid;
+    }
+
+    void LinkFront(sml_u32 NodeIdx)
+    {
+        lru_cache_node<K, V> *Node = this->Nodes + NodeIdx;
+
+        Node->Prev = this->Invalid;
+        Node->Next = this->Head;
+
+        if(this->Head != this->Invalid) this->Nodes[this->Head].Prev = NodeIdx;
+        this->Head = NodeIdx;
+
+        if(this->Tail == this->Invalid) this->Tail = NodeIdx;
+    }
+};
@@ -107,10 +107,10 @@ struct slot_map
             F NextSlot = this->Next[Idx];
 
             PrevSlot == this->Invalid ? this->Head = NextSlot :
-                                        this->Prev[NextSlot] = PrevSlot;
+                                        this->Next[PrevSlot] = NextSlot;
 
             NextSlot == this->Invalid ? this->Tail = PrevSlot :
-                                        this->Next[PrevSlot] = NextSlot;
+                                        this->Prev[NextSlot] = PrevSlot;
 
             memset(this->Data + Idx, 0, sizeof(D));
         }
@@ -134,6 +134,16 @@ struct slot_map
         }
     }
 
+    inline void Free()
+    {
+        SmlMemory.Free(this->DataHeap);
+        SmlMemory.Free(this->FreeListHeap);
+        SmlMemory.Free(this->ActiveListHeap);
+
+        this->Data     = nullptr;
+        this->FreeList = nullptr;
+    }
+
     D& operator[](F Idx) noexcept
     { 
         return this->Data[Idx]; 
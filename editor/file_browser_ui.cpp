@@ -51,7 +51,7 @@ SmlIntEditor_DrawEntry(file_browser_ui *Editor, sml_u32 Idx)
         Flags |= ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
     }
 
-    bool NodeOpen = TreeNodeEx(File->Name, Flags);
+    bool NodeOpen = TreeNodeEx(SmlAtom_String(File->Name), Flags);
     bool Hovered  = IsItemHovered();
 
     if(BeginDragDropSource())
@@ -200,7 +200,7 @@ SmlEditor_FileBrowser(file_browser_ui *Editor)
             {
                 auto *Folder = Editor->FileTree.Values + NodeIdx;
 
-                if(Button(Folder->Name))
+                if(Button(SmlAtom_String(Folder->Name)))
                 {
                     SmlIntEditor_HandleClickOnHistory(Editor, NodeIdx);
                 }
@@ -213,7 +213,7 @@ SmlEditor_FileBrowser(file_browser_ui *Editor)
             }
 
             auto* Folder = Editor->FileTree.Values + Editor->ActiveFolderIdx;
-            if (Button(Folder->Name))
+            if (Button(SmlAtom_String(Folder->Name)))
             {
                 SmlIntEditor_HandleClickOnHistory(Editor, NodeIdx);
             }
@@ -222,7 +222,7 @@ SmlEditor_FileBrowser(file_browser_ui *Editor)
         {
             auto  Idx    = Editor->ActiveFolderIdx;
             auto* Folder = Editor->FileTree.Values + Idx;
-            if (Button(Folder->Name))
+            if (Button(SmlAtom_String(Folder->Name)))
             {
                 SmlIntEditor_HandleClickOnHistory(Editor, Idx);
             }
@@ -58,7 +58,7 @@ SmlEditor_MeshUI(mesh_editor *Editor)
                 while (Idx != slot_map<mesh_record, u32>::Invalid)
                 {
                     auto* Rec = SmlMeshes.Data + Idx;
-                    if (Selectable(Rec->Name, false))
+                    if (Selectable(SmlAtom_String(Rec->Name), false))
                     {
                         Editor->ActiveMesh = SmlMeshes.Data + Idx;
                     }
@@ -83,7 +83,7 @@ SmlEditor_MeshUI(mesh_editor *Editor)
                     TableSetColumnIndex(0);
                         Text("Name");
                     TableSetColumnIndex(1);
-                        Text(Act->Name);
+                        TextUnformatted(SmlAtom_String(Act->Name));
 
                     TableNextRow();
                     TableSetColumnIndex(0);
@@ -0,0 +1,333 @@
+// ===================================
+// Type Definitions
+// ===================================
+
+// NOTE:
+// 1) Structure-of-arrays in and out, so one register holds the same component
+//    of 8 (AVX2) or 4 (SSE) points, picked from SmlCpu.Isa at startup. The
+//    tail goes through the scalar reference.
+// 2) Input and output arrays may be the same (in place transform).
+// 3) Points only use the affine part of the matrix (w = 1, bottom row ignored),
+//    use SmlMat4_Transform for projective matrices.
+// 4) Normals use the upper 3x3 and are renormalized. Pass the normal matrix
+//    (inverse transpose) when the transform has a non-uniform scale.
+// 5) Every path does the same mul/add sequence without FMA, so the SIMD
+//    results match the scalar reference.
+
+// ===================================
+// Scalar reference
+// ===================================
+
+static sml_u32
+SmlInt_TransformPointsScalar(const sml_matrix4 &M,
+                             const sml_f32 *Xs, const sml_f32 *Ys, const sml_f32 *Zs,
+                             sml_f32 *OutXs, sml_f32 *OutYs, sml_f32 *OutZs,
+                             sml_u32 Start, sml_u32 Count)
+{
+    for(sml_u32 Idx = Start; Idx < Count; Idx++)
+    {
+        sml_f32 X = Xs[Idx];
+        sml_f32 Y = Ys[Idx];
+        sml_f32 Z = Zs[Idx];
+
+        OutXs[Idx] = (((M.m0 * X) + (M.m1 * Y)) + (M.m2  * Z)) + M.m3;
+        OutYs[Idx] = (((M.m4 * X) + (M.m5 * Y)) + (M.m6  * Z)) + M.m7;
+        OutZs[Idx] = (((M.m8 * X) + (M.m9 * Y)) + (M.m10 * Z)) + M.m11;
+    }
+
+    return Count;
+}
+
+static sml_u32
+SmlInt_TransformNormalsScalar(const sml_matrix4 &M,
+                              const sml_f32 *Xs, const sml_f32 *Ys, const sml_f32 *Zs,
+                              sml_f32 *OutXs, sml_f32 *OutYs, sml_f32 *OutZs,
+                              sml_u32 Start, sml_u32 Count)
+{
+    for(sml_u32 Idx = Start; Idx < Count; Idx++)
+    {
+        sml_f32 X = Xs[Idx];
+        sml_f32 Y = Ys[Idx];
+        sml_f32 Z = Zs[Idx];
+
+        sml_f32 NX = ((M.m0 * X) + (M.m1 * Y)) + (M.m2  * Z);
+        sml_f32 NY = ((M.m4 * X) + (M.m5 * Y)) + (M.m6  * Z);
+        sml_f32 NZ = ((M.m8 * X) + (M.m9 * Y)) + (M.m10 * Z);
+
+        sml_f32 LengthSquared = ((NX * NX) + (NY * NY)) + (NZ * NZ);
+
+        if(LengthSquared > 0.0f)
+        {
+            sml_f32 Length = sqrtf(LengthSquared);
+
+            NX = NX / Length;
+            NY = NY / Length;
+            NZ = NZ / Length;
+        }
+        else
+        {
+            NX = NY = NZ = 0.0f;
+        }
+
+        OutXs[Idx] = NX;
+        OutYs[Idx] = NY;
+        OutZs[Idx] = NZ;
+    }
+
+    return Count;
+}
+
+static void
+SmlMat4_TransformPointsScalar(const sml_matrix4 &M,
+                              const sml_f32 *Xs, const sml_f32 *Ys, const sml_f32 *Zs,
+                              sml_f32 *OutXs, sml_f32 *OutYs, sml_f32 *OutZs,
+                              sml_u32 Count)
+{
+    SmlInt_TransformPointsScalar(M, Xs, Ys, Zs, OutXs, OutYs, OutZs, 0, Count);
+}
+
+static void
+SmlMat4_TransformNormalsScalar(const sml_matrix4 &M,
+                               const sml_f32 *Xs, const sml_f32 *Ys, const sml_f32 *Zs,
+                               sml_f32 *OutXs, sml_f32 *OutYs, sml_f32 *OutZs,
+                               sml_u32 Count)
+{
+    SmlInt_TransformNormalsScalar(M, Xs, Ys, Zs, OutXs, OutYs, OutZs, 0, Count);
+}
+
+// ===================================
+// SSE (4 wide)
+// ===================================
+
+static sml_u32
+SmlInt_TransformPoints4(const sml_matrix4 &M,
+                        const sml_f32 *Xs, const sml_f32 *Ys, const sml_f32 *Zs,
+                        sml_f32 *OutXs, sml_f32 *OutYs, sml_f32 *OutZs,
+                        sml_u32 Start, sml_u32 Count)
+{
+    __m128 M0 = _mm_set1_ps(M.m0), M1 = _mm_set1_ps(M.m1);
+    __m128 M2 = _mm_set1_ps(M.m2), M3 = _mm_set1_ps(M.m3);
+    __m128 M4 = _mm_set1_ps(M.m4), M5 = _mm_set1_ps(M.m5);
+    __m128 M6 = _mm_set1_ps(M.m6), M7 = _mm_set1_ps(M.m7);
+    __m128 M8 = _mm_set1_ps(M.m8), M9 = _mm_set1_ps(M.m9);
+    __m128 M10 = _mm_set1_ps(M.m10), M11 = _mm_set1_ps(M.m11);
+
+    sml_u32 Idx = Start;
+    for(; Idx + 4 <= Count; Idx += 4)
+    {
+        __m128 X = _mm_loadu_ps(Xs + Idx);
+        __m128 Y = _mm_loadu_ps(Ys + Idx);
+        __m128 Z = _mm_loadu_ps(Zs + Idx);
+
+        __m128 RX = _mm_add_ps(_mm_mul_ps(M0, X), _mm_mul_ps(M1, Y));
+        __m128 RY = _mm_add_ps(_mm_mul_ps(M4, X), _mm_mul_ps(M5, Y));
+        __m128 RZ = _mm_add_ps(_mm_mul_ps(M8, X), _mm_mul_ps(M9, Y));
+
+        RX = _mm_add_ps(_mm_add_ps(RX, _mm_mul_ps(M2 , Z)), M3);
+        RY = _mm_add_ps(_mm_add_ps(RY, _mm_mul_ps(M6 , Z)), M7);
+        RZ = _mm_add_ps(_mm_add_ps(RZ, _mm_mul_ps(M10, Z)), M11);
+
+        _mm_storeu_ps(OutXs + Idx, RX);
+        _mm_storeu_ps(OutYs + Idx, RY);
+        _mm_storeu_ps(OutZs + Idx, RZ);
+    }
+
+    return Idx;
+}
+
+static sml_u32
+SmlInt_TransformNormals4(const sml_matrix4 &M,
+                         const sml_f32 *Xs, const sml_f32 *Ys, const sml_f32 *Zs,
+                         sml_f32 *OutXs, sml_f32 *OutYs, sml_f32 *OutZs,
+                         sml_u32 Start, sml_u32 Count)
+{
+    __m128 M0 = _mm_set1_ps(M.m0), M1 = _mm_set1_ps(M.m1), M2  = _mm_set1_ps(M.m2);
+    __m128 M4 = _mm_set1_ps(M.m4), M5 = _mm_set1_ps(M.m5), M6  = _mm_set1_ps(M.m6);
+    __m128 M8 = _mm_set1_ps(M.m8), M9 = _mm_set1_ps(M.m9), M10 = _mm_set1_ps(M.m10);
+
+    __m128 Zero = _mm_setzero_ps();
+
+    sml_u32 Idx = Start;
+    for(; Idx + 4 <= Count; Idx += 4)
+    {
+        __m128 X = _mm_loadu_ps(Xs + Idx);
+        __m128 Y = _mm_loadu_ps(Ys + Idx);
+        __m128 Z = _mm_loadu_ps(Zs + Idx);
+
+        __m128 NX = _mm_add_ps(_mm_mul_ps(M0, X), _mm_mul_ps(M1, Y));
+        __m128 NY = _mm_add_ps(_mm_mul_ps(M4, X), _mm_mul_ps(M5, Y));
+        __m128 NZ = _mm_add_ps(_mm_mul_ps(M8, X), _mm_mul_ps(M9, Y));
+
+        NX = _mm_add_ps(NX, _mm_mul_ps(M2 , Z));
+        NY = _mm_add_ps(NY, _mm_mul_ps(M6 , Z));
+        NZ = _mm_add_ps(NZ, _mm_mul_ps(M10, Z));
+
+        __m128 LengthSquared = _mm_add_ps(_mm_mul_ps(NX, NX), _mm_mul_ps(NY, NY));
+        LengthSquared        = _mm_add_ps(LengthSquared, _mm_mul_ps(NZ, NZ));
+
+        __m128 NonZero = _mm_cmpgt_ps(LengthSquared, Zero);
+        __m128 Length  = _mm_sqrt_ps(LengthSquared);
+
+        _mm_storeu_ps(OutXs + Idx, _mm_and_ps(_mm_div_ps(NX, Length), NonZero));
+        _mm_storeu_ps(OutYs + Idx, _mm_and_ps(_mm_div_ps(NY, Length), NonZero));
+        _mm_storeu_ps(OutZs + Idx, _mm_and_ps(_mm_div_ps(NZ, Length), NonZero));
+    }
+
+    return Idx;
+}
+
+// ===================================
+// AVX2 (8 wide)
+// ===================================
+
+SML_TARGET_AVX2 static sml_u32
+SmlInt_TransformPoints8(const sml_matrix4 &M,
+                        const sml_f32 *Xs, const sml_f32 *Ys, const sml_f32 *Zs,
+                        sml_f32 *OutXs, sml_f32 *OutYs, sml_f32 *OutZs,
+                        sml_u32 Start, sml_u32 Count)
+{
+    __m256 M0 = _mm256_set1_ps(M.m0), M1 = _mm256_set1_ps(M.m1);
+    __m256 M2 = _mm256_set1_ps(M.m2), M3 = _mm256_set1_ps(M.m3);
+    __m256 M4 = _mm256_set1_ps(M.m4), M5 = _mm256_set1_ps(M.m5);
+    __m256 M6 = _mm256_set1_ps(M.m6), M7 = _mm256_set1_ps(M.m7);
+    __m256 M8 = _mm256_set1_ps(M.m8), M9 = _mm256_set1_ps(M.m9);
+    __m256 M10 = _mm256_set1_ps(M.m10), M11 = _mm256_set1_ps(M.m11);
+
+    sml_u32 Idx = Start;
+    for(; Idx + 8 <= Count; Idx += 8)
+    {
+        __m256 X = _mm256_loadu_ps(Xs + Idx);
+        __m256 Y = _mm256_loadu_ps(Ys + Idx);
+        __m256 Z = _mm256_loadu_ps(Zs + Idx);
+
+        __m256 RX = _mm256_add_ps(_mm256_mul_ps(M0, X), _mm256_mul_ps(M1, Y));
+        __m256 RY = _mm256_add_ps(_mm256_mul_ps(M4, X), _mm256_mul_ps(M5, Y));
+        __m256 RZ = _mm256_add_ps(_mm256_mul_ps(M8, X), _mm256_mul_ps(M9, Y));
+
+        RX = _mm256_add_ps(_mm256_add_ps(RX, _mm256_mul_ps(M2 , Z)), M3);
+        RY = _mm256_add_ps(_mm256_add_ps(RY, _mm256_mul_ps(M6 , Z)), M7);
+        RZ = _mm256_add_ps(_mm256_add_ps(RZ, _mm256_mul_ps(M10, Z)), M11);
+
+        _mm256_storeu_ps(OutXs + Idx, RX);
+        _mm256_storeu_ps(OutYs + Idx, RY);
+        _mm256_storeu_ps(OutZs + Idx, RZ);
+    }
+
+    return Idx;
+}
+
+SML_TARGET_AVX2 static sml_u32
+SmlInt_TransformNormals8(const sml_matrix4 &M,
+                         const sml_f32 *Xs, const sml_f32 *Ys, const sml_f32 *Zs,
+                         sml_f32 *OutXs, sml_f32 *OutYs, sml_f32 *OutZs,
+                         sml_u32 Start, sml_u32 Count)
+{
+    __m256 M0 = _mm256_set1_ps(M.m0), M1 = _mm256_set1_ps(M.m1);
+    __m256 M2 = _mm256_set1_ps(M.m2), M4 = _mm256_set1_ps(M.m4);
+    __m256 M5 = _mm256_set1_ps(M.m5), M6 = _mm256_set1_ps(M.m6);
+    __m256 M8 = _mm256_set1_ps(M.m8), M9 = _mm256_set1_ps(M.m9);
+    __m256 M10 = _mm256_set1_ps(M.m10);
+
+    __m256 Zero = _mm256_setzero_ps();
+
+    sml_u32 Idx = Start;
+    for(; Idx + 8 <= Count; Idx += 8)
+    {
+        __m256 X = _mm256_loadu_ps(Xs + Idx);
+        __m256 Y = _mm256_loadu_ps(Ys + Idx);
+        __m256 Z = _mm256_loadu_ps(Zs + Idx);
+
+        __m256 NX = _mm256_add_ps(_mm256_mul_ps(M0, X), _mm256_mul_ps(M1, Y));
+        __m256 NY = _mm256_add_ps(_mm256_mul_ps(M4, X), _mm256_mul_ps(M5, Y));
+        __m256 NZ = _mm256_add_ps(_mm256_mul_ps(M8, X), _mm256_mul_ps(M9, Y));
+
+        NX = _mm256_add_ps(NX, _mm256_mul_ps(M2 , Z));
+        NY = _mm256_add_ps(NY, _mm256_mul_ps(M6 , Z));
+        NZ = _mm256_add_ps(NZ, _mm256_mul_ps(M10, Z));
+
+        __m256 LengthSquared = _mm256_add_ps(_mm256_mul_ps(NX, NX),
+                                             _mm256_mul_ps(NY, NY));
+        LengthSquared        = _mm256_add_ps(LengthSquared, _mm256_mul_ps(NZ, NZ));
+
+        __m256 NonZero = _mm256_cmp_ps(LengthSquared, Zero, _CMP_GT_OQ);
+        __m256 Length  = _mm256_sqrt_ps(LengthSquared);
+
+        NX = _mm256_and_ps(_mm256_div_ps(NX, Length), NonZero);
+        NY = _mm256_and_ps(_mm256_div_ps(NY, Length), NonZero);
+        NZ = _mm256_and_ps(_mm256_div_ps(NZ, Length), NonZero);
+
+        _mm256_storeu_ps(OutXs + Idx, NX);
+        _mm256_storeu_ps(OutYs + Idx, NY);
+        _mm256_storeu_ps(OutZs + Idx, NZ);
+    }
+
+    return Idx;
+}
+
+// ===================================
+// Dispatch
+// ===================================
+
+using sml_transform_kernel = sml_u32 (*)(const sml_matrix4 &M,
+                                         const sml_f32 *Xs, const sml_f32 *Ys,
+                                         const sml_f32 *Zs, sml_f32 *OutXs,
+                                         sml_f32 *OutYs, sml_f32 *OutZs,
+                                         sml_u32 Start, sml_u32 Count);
+
+struct sml_transform_kernels
+{
+    sml_transform_kernel Points;
+    sml_transform_kernel Normals;
+};
+
+static sml_transform_kernels
+SmlInt_BindTransformKernels(Sml_Isa Isa)
+{
+    sml_transform_kernels Kernels = {};
+
+    if(Isa >= SmlIsa_AVX2)
+    {
+        Kernels.Points  = SmlInt_TransformPoints8;
+        Kernels.Normals = SmlInt_TransformNormals8;
+    }
+    else if(Isa >= SmlIsa_SSE2)
+    {
+        Kernels.Points  = SmlInt_TransformPoints4;
+        Kernels.Normals = SmlInt_TransformNormals4;
+    }
+    else
+    {
+        Kernels.Points  = SmlInt_TransformPointsScalar;
+        Kernels.Normals = SmlInt_TransformNormalsScalar;
+    }
+
+    return Kernels;
+}
+
+static auto SmlTransformKernels = SmlInt_BindTransformKernels(SmlCpu.Isa);
+
+// ===================================
+// User API
+// ===================================
+
+static void
+SmlMat4_TransformPoints(const sml_matrix4 &M,
+                        const sml_f32 *Xs, const sml_f32 *Ys, const sml_f32 *Zs,
+                        sml_f32 *OutXs, sml_f32 *OutYs, sml_f32 *OutZs, sml_u32 Count)
+{
+    sml_u32 Idx = SmlTransformKernels.Points(M, Xs, Ys, Zs, OutXs, OutYs, OutZs,
+                                             0, Count);
+
+    SmlInt_TransformPointsScalar(M, Xs, Ys, Zs, OutXs, OutYs, OutZs, Idx, Count);
+}
+
+static void
+SmlMat4_TransformNormals(const sml_matrix4 &M,
+                         const sml_f32 *Xs, const sml_f32 *Ys, const sml_f32 *Zs,
+                         sml_f32 *OutXs, sml_f32 *OutYs, sml_f32 *OutZs, sml_u32 Count)
+{
+    sml_u32 Idx = SmlTransformKernels.Normals(M, Xs, Ys, Zs, OutXs, OutYs, OutZs,
+                                              0, Count);
+
+    SmlInt_TransformNormalsScalar(M, Xs, Ys, Zs, OutXs, OutYs, OutZs, Idx, Count);
+}
@@ -0,0 +1,561 @@
+// ===================================
+// Type Definitions
+// ===================================
+
+// NOTE:
+// 1) Planes are (a, b, c, d) with a*x + b*y + c*z + d >= 0 inside, normalized
+//    so d is a distance. Extracted from a D3D style (z in [0, 1]) matrix.
+// 2) Bounds are structure-of-arrays, boxes as center + half extents. Culling
+//    writes one bit per object (bit i of byte i / 8, set when visible) or the
+//    compacted indices of the visible objects.
+// 3) Tests are conservative: objects touching a plane are kept, and large
+//    boxes near a frustum corner can pass while being outside.
+// 4) Same mul/add order on every path without FMA, so the SIMD masks match the
+//    scalar reference.
+
+enum Frustum_Plane
+{
+    FrustumPlane_Left,
+    FrustumPlane_Right,
+    FrustumPlane_Bottom,
+    FrustumPlane_Top,
+    FrustumPlane_Near,
+    FrustumPlane_Far,
+
+    FrustumPlane_Count,
+};
+
+struct sml_frustum
+{
+    sml_vector4 Planes[FrustumPlane_Count];
+};
+
+struct sml_sphere_bounds
+{
+    const sml_f32 *Xs;
+    const sml_f32 *Ys;
+    const sml_f32 *Zs;
+    const sml_f32 *Radii;
+
+    sml_sphere_bounds Offset(sml_u32 By) const
+    {
+        return {this->Xs + By, this->Ys + By, this->Zs + By, this->Radii + By};
+    }
+};
+
+struct sml_box_bounds
+{
+    const sml_f32 *Xs;
+    const sml_f32 *Ys;
+    const sml_f32 *Zs;
+    const sml_f32 *ExtentXs;
+    const sml_f32 *ExtentYs;
+    const sml_f32 *ExtentZs;
+
+    sml_box_bounds Offset(sml_u32 By) const
+    {
+        return {this->Xs + By, this->Ys + By, this->Zs + By,
+                this->ExtentXs + By, this->ExtentYs + By, this->ExtentZs + By};
+    }
+};
+
+// ===================================
+// Internal Helpers
+// ===================================
+
+static inline __m128
+SmlInt_NormalizePlane(__m128 Plane)
+{
+    __m128 MaskW  = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+    __m128 Normal = _mm_and_ps(Plane, MaskW);
+    __m128 Length = _mm_sqrt_ps(SmlInt_HorizontalAdd(_mm_mul_ps(Normal, Normal)));
+
+    return _mm_div_ps(Plane, Length);
+}
+
+// NOTE: Appends Base + bit index for every set bit, returns the new count.
+
+static sml_u32
+SmlInt_CompactMask(const sml_u8 *Mask, sml_u32 Count, sml_u32 Base,
+                   sml_u32 *OutIndices, sml_u32 OutCount)
+{
+    sml_u32 ByteCount = (Count + 7) / 8;
+
+    for(sml_u32 ByteIdx = 0; ByteIdx < ByteCount; ByteIdx++)
+    {
+        sml_u32 Bits = Mask[ByteIdx];
+
+        while(Bits)
+        {
+            OutIndices[OutCount++] = Base + (ByteIdx * 8) + ctz32(Bits);
+            Bits &= Bits - 1;
+        }
+    }
+
+    return OutCount;
+}
+
+// ===================================
+// Planes
+// ===================================
+
+// NOTE: Gribb/Hartmann, the planes are sums and differences of the matrix rows.
+
+static sml_frustum
+SmlFrustum_FromMatrix(const sml_matrix4 &ViewProjection)
+{
+    sml_matrix4 Rows = SmlMat4_Transpose(ViewProjection);
+
+    __m128 Row0 = Rows.Columns[0];
+    __m128 Row1 = Rows.Columns[1];
+    __m128 Row2 = Rows.Columns[2];
+    __m128 Row3 = Rows.Columns[3];
+
+    __m128 Planes[FrustumPlane_Count];
+    Planes[FrustumPlane_Left]   = _mm_add_ps(Row3, Row0);
+    Planes[FrustumPlane_Right]  = _mm_sub_ps(Row3, Row0);
+    Planes[FrustumPlane_Bottom] = _mm_add_ps(Row3, Row1);
+    Planes[FrustumPlane_Top]    = _mm_sub_ps(Row3, Row1);
+    Planes[FrustumPlane_Near]   = Row2;
+    Planes[FrustumPlane_Far]    = _mm_sub_ps(Row3, Row2);
+
+    sml_frustum Result;
+
+    for(sml_u32 Idx = 0; Idx < FrustumPlane_Count; Idx++)
+    {
+        Result.Planes[Idx] = sml_vector4(SmlInt_NormalizePlane(Planes[Idx]));
+    }
+
+    return Result;
+}
+
+// ===================================
+// Scalar reference
+// ===================================
+
+// NOTE: Start is a multiple of 8, the mask bytes from Start on are overwritten.
+
+static sml_u32
+SmlInt_CullSpheresScalar(const sml_frustum &Frustum, const sml_sphere_bounds &Spheres,
+                         sml_u32 Start, sml_u32 Count, sml_u8 *OutMask)
+{
+    for(sml_u32 Idx = Start; Idx < Count; Idx++)
+    {
+        if((Idx & 7) == 0) OutMask[Idx >> 3] = 0;
+
+        sml_f32 X      = Spheres.Xs[Idx];
+        sml_f32 Y      = Spheres.Ys[Idx];
+        sml_f32 Z      = Spheres.Zs[Idx];
+        sml_f32 Radius = Spheres.Radii[Idx];
+
+        bool Visible = true;
+
+        for(sml_u32 PlaneIdx = 0; PlaneIdx < FrustumPlane_Count; PlaneIdx++)
+        {
+            const sml_vector4 &P = Frustum.Planes[PlaneIdx];
+
+            sml_f32 Distance = (((P.x * X) + (P.y * Y)) + (P.z * Z)) + P.w;
+            Visible = Visible && (Distance >= -Radius);
+        }
+
+        if(Visible) OutMask[Idx >> 3] |= (sml_u8)(1u << (Idx & 7));
+    }
+
+    return Count;
+}
+
+static sml_u32
+SmlInt_CullBoxesScalar(const sml_frustum &Frustum, const sml_box_bounds &Boxes,
+                       sml_u32 Start, sml_u32 Count, sml_u8 *OutMask)
+{
+    for(sml_u32 Idx = Start; Idx < Count; Idx++)
+    {
+        if((Idx & 7) == 0) OutMask[Idx >> 3] = 0;
+
+        sml_f32 X  = Boxes.Xs[Idx];
+        sml_f32 Y  = Boxes.Ys[Idx];
+        sml_f32 Z  = Boxes.Zs[Idx];
+        sml_f32 EX = Boxes.ExtentXs[Idx];
+        sml_f32 EY = Boxes.ExtentYs[Idx];
+        sml_f32 EZ = Boxes.ExtentZs[Idx];
+
+        bool Visible = true;
+
+        for(sml_u32 PlaneIdx = 0; PlaneIdx < FrustumPlane_Count; PlaneIdx++)
+        {
+            const sml_vector4 &P = Frustum.Planes[PlaneIdx];
+
+            // Projected radius of the box on the plane normal.
+            sml_f32 Radius = ((fabsf(P.x) * EX) + (fabsf(P.y) * EY)) + (fabsf(P.z) * EZ);
+
+            sml_f32 Distance = (((P.x * X) + (P.y * Y)) + (P.z * Z)) + P.w;
+
+            Visible = Visible && (Distance >= -Radius);
+        }
+
+        if(Visible) OutMask[Idx >> 3] |= (sml_u8)(1u << (Idx & 7));
+    }
+
+    return Count;
+}
+
+static void
+SmlFrustum_CullSpheresMaskScalar(const sml_frustum &Frustum,
+                                 const sml_sphere_bounds &Spheres, sml_u32 Count,
+                                 sml_u8 *OutMask)
+{
+    SmlInt_CullSpheresScalar(Frustum, Spheres, 0, Count, OutMask);
+}
+
+static void
+SmlFrustum_CullBoxesMaskScalar(const sml_frustum &Frustum, const sml_box_bounds &Boxes,
+                               sml_u32 Count, sml_u8 *OutMask)
+{
+    SmlInt_CullBoxesScalar(Frustum, Boxes, 0, Count, OutMask);
+}
+
+// ===================================
+// SSE (2 x 4 wide)
+// ===================================
+
+// NOTE: 8 objects per iteration as two halves, so every iteration fills one
+// mask byte like the AVX2 path.
+
+static sml_u32
+SmlInt_CullSpheres4(const sml_frustum &Frustum, const sml_sphere_bounds &Spheres,
+                    sml_u32 Start, sml_u32 Count, sml_u8 *OutMask)
+{
+    __m128 PX[FrustumPlane_Count], PY[FrustumPlane_Count];
+    __m128 PZ[FrustumPlane_Count], PW[FrustumPlane_Count];
+
+    for(sml_u32 PlaneIdx = 0; PlaneIdx < FrustumPlane_Count; PlaneIdx++)
+    {
+        const sml_vector4 &P = Frustum.Planes[PlaneIdx];
+
+        PX[PlaneIdx] = _mm_set1_ps(P.x);
+        PY[PlaneIdx] = _mm_set1_ps(P.y);
+        PZ[PlaneIdx] = _mm_set1_ps(P.z);
+        PW[PlaneIdx] = _mm_set1_ps(P.w);
+    }
+
+    __m128 SignBit = _mm_set1_ps(-0.0f);
+
+    sml_u32 Idx = Start;
+    for(; Idx + 8 <= Count; Idx += 8)
+    {
+        sml_u32 Bits = 0;
+
+        for(sml_u32 Half = 0; Half < 8; Half += 4)
+        {
+            __m128 X         = _mm_loadu_ps(Spheres.Xs + Idx + Half);
+            __m128 Y         = _mm_loadu_ps(Spheres.Ys + Idx + Half);
+            __m128 Z         = _mm_loadu_ps(Spheres.Zs + Idx + Half);
+            __m128 Radius    = _mm_loadu_ps(Spheres.Radii + Idx + Half);
+            __m128 NegRadius = _mm_xor_ps(Radius, SignBit);
+
+            __m128 Visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+            for(sml_u32 PlaneIdx = 0; PlaneIdx < FrustumPlane_Count; PlaneIdx++)
+            {
+                __m128 Distance = _mm_mul_ps(PX[PlaneIdx], X);
+                Distance        = _mm_add_ps(Distance, _mm_mul_ps(PY[PlaneIdx], Y));
+                Distance        = _mm_add_ps(Distance, _mm_mul_ps(PZ[PlaneIdx], Z));
+                Distance        = _mm_add_ps(Distance, PW[PlaneIdx]);
+
+                Visible = _mm_and_ps(Visible, _mm_cmpge_ps(Distance, NegRadius));
+            }
+
+            Bits |= (sml_u32)_mm_movemask_ps(Visible) << Half;
+        }
+
+        OutMask[Idx >> 3] = (sml_u8)Bits;
+    }
+
+    return Idx;
+}
+
+static sml_u32
+SmlInt_CullBoxes4(const sml_frustum &Frustum, const sml_box_bounds &Boxes,
+                  sml_u32 Start, sml_u32 Count, sml_u8 *OutMask)
+{
+    __m128 PX[FrustumPlane_Count], PY[FrustumPlane_Count];
+    __m128 PZ[FrustumPlane_Count], PW[FrustumPlane_Count];
+
+    for(sml_u32 PlaneIdx = 0; PlaneIdx < FrustumPlane_Count; PlaneIdx++)
+    {
+        const sml_vector4 &P = Frustum.Planes[PlaneIdx];
+
+        PX[PlaneIdx] = _mm_set1_ps(P.x);
+        PY[PlaneIdx] = _mm_set1_ps(P.y);
+        PZ[PlaneIdx] = _mm_set1_ps(P.z);
+        PW[PlaneIdx] = _mm_set1_ps(P.w);
+    }
+
+    __m128 SignBit = _mm_set1_ps(-0.0f);
+
+    sml_u32 Idx = Start;
+    for(; Idx + 8 <= Count; Idx += 8)
+    {
+        sml_u32 Bits = 0;
+
+        for(sml_u32 Half = 0; Half < 8; Half += 4)
+        {
+            __m128 X  = _mm_loadu_ps(Boxes.Xs       + Idx + Half);
+            __m128 Y  = _mm_loadu_ps(Boxes.Ys       + Idx + Half);
+            __m128 Z  = _mm_loadu_ps(Boxes.Zs       + Idx + Half);
+            __m128 EX = _mm_loadu_ps(Boxes.ExtentXs + Idx + Half);
+            __m128 EY = _mm_loadu_ps(Boxes.ExtentYs + Idx + Half);
+            __m128 EZ = _mm_loadu_ps(Boxes.ExtentZs + Idx + Half);
+
+            __m128 Visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+            for(sml_u32 PlaneIdx = 0; PlaneIdx < FrustumPlane_Count; PlaneIdx++)
+            {
+                __m128 AbsX = _mm_andnot_ps(SignBit, PX[PlaneIdx]);
+                __m128 AbsY = _mm_andnot_ps(SignBit, PY[PlaneIdx]);
+                __m128 AbsZ = _mm_andnot_ps(SignBit, PZ[PlaneIdx]);
+
+                __m128 Radius = _mm_mul_ps(AbsX, EX);
+                Radius        = _mm_add_ps(Radius, _mm_mul_ps(AbsY, EY));
+                Radius        = _mm_add_ps(Radius, _mm_mul_ps(AbsZ, EZ));
+
+                __m128 Distance = _mm_mul_ps(PX[PlaneIdx], X);
+                Distance        = _mm_add_ps(Distance, _mm_mul_ps(PY[PlaneIdx], Y));
+                Distance        = _mm_add_ps(Distance, _mm_mul_ps(PZ[PlaneIdx], Z));
+                Distance        = _mm_add_ps(Distance, PW[PlaneIdx]);
+
+                __m128 NegRadius = _mm_xor_ps(Radius, SignBit);
+
+                Visible = _mm_and_ps(Visible, _mm_cmpge_ps(Distance, NegRadius));
+            }
+
+            Bits |= (sml_u32)_mm_movemask_ps(Visible) << Half;
+        }
+
+        OutMask[Idx >> 3] = (sml_u8)Bits;
+    }
+
+    return Idx;
+}
+
+// ===================================
+// AVX2 (8 wide)
+// ===================================
+
+SML_TARGET_AVX2 static sml_u32
+SmlInt_CullSpheres8(const sml_frustum &Frustum, const sml_sphere_bounds &Spheres,
+                    sml_u32 Start, sml_u32 Count, sml_u8 *OutMask)
+{
+    __m256 PX[FrustumPlane_Count], PY[FrustumPlane_Count];
+    __m256 PZ[FrustumPlane_Count], PW[FrustumPlane_Count];
+
+    for(sml_u32 PlaneIdx = 0; PlaneIdx < FrustumPlane_Count; PlaneIdx++)
+    {
+        const sml_vector4 &P = Frustum.Planes[PlaneIdx];
+
+        PX[PlaneIdx] = _mm256_set1_ps(P.x);
+        PY[PlaneIdx] = _mm256_set1_ps(P.y);
+        PZ[PlaneIdx] = _mm256_set1_ps(P.z);
+        PW[PlaneIdx] = _mm256_set1_ps(P.w);
+    }
+
+    __m256 SignBit = _mm256_set1_ps(-0.0f);
+
+    sml_u32 Idx = Start;
+    for(; Idx + 8 <= Count; Idx += 8)
+    {
+        __m256 X         = _mm256_loadu_ps(Spheres.Xs + Idx);
+        __m256 Y         = _mm256_loadu_ps(Spheres.Ys + Idx);
+        __m256 Z         = _mm256_loadu_ps(Spheres.Zs + Idx);
+        __m256 NegRadius = _mm256_xor_ps(_mm256_loadu_ps(Spheres.Radii + Idx), SignBit);
+
+        __m256 Visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+        for(sml_u32 PlaneIdx = 0; PlaneIdx < FrustumPlane_Count; PlaneIdx++)
+        {
+            __m256 Distance = _mm256_mul_ps(PX[PlaneIdx], X);
+            Distance        = _mm256_add_ps(Distance, _mm256_mul_ps(PY[PlaneIdx], Y));
+            Distance        = _mm256_add_ps(Distance, _mm256_mul_ps(PZ[PlaneIdx], Z));
+            Distance        = _mm256_add_ps(Distance, PW[PlaneIdx]);
+
+            __m256 Inside = _mm256_cmp_ps(Distance, NegRadius, _CMP_GE_OQ);
+            Visible       = _mm256_and_ps(Visible, Inside);
+        }
+
+        OutMask[Idx >> 3] = (sml_u8)_mm256_movemask_ps(Visible);
+    }
+
+    return Idx;
+}
+
+SML_TARGET_AVX2 static sml_u32
+SmlInt_CullBoxes8(const sml_frustum &Frustum, const sml_box_bounds &Boxes,
+                  sml_u32 Start, sml_u32 Count, sml_u8 *OutMask)
+{
+    __m256 PX[FrustumPlane_Count], PY[FrustumPlane_Count];
+    __m256 PZ[FrustumPlane_Count], PW[FrustumPlane_Count];
+
+    __m256 SignBit = _mm256_set1_ps(-0.0f);
+
+    for(sml_u32 PlaneIdx = 0; PlaneIdx < FrustumPlane_Count; PlaneIdx++)
+    {
+        const sml_vector4 &P = Frustum.Planes[PlaneIdx];
+
+        PX[PlaneIdx] = _mm256_set1_ps(P.x);
+        PY[PlaneIdx] = _mm256_set1_ps(P.y);
+        PZ[PlaneIdx] = _mm256_set1_ps(P.z);
+        PW[PlaneIdx] = _mm256_set1_ps(P.w);
+    }
+
+    sml_u32 Idx = Start;
+    for(; Idx + 8 <= Count; Idx += 8)
+    {
+        __m256 X  = _mm256_loadu_ps(Boxes.Xs       + Idx);
+        __m256 Y  = _mm256_loadu_ps(Boxes.Ys       + Idx);
+        __m256 Z  = _mm256_loadu_ps(Boxes.Zs       + Idx);
+        __m256 EX = _mm256_loadu_ps(Boxes.ExtentXs + Idx);
+        __m256 EY = _mm256_loadu_ps(Boxes.ExtentYs + Idx);
+        __m256 EZ = _mm256_loadu_ps(Boxes.ExtentZs + Idx);
+
+        __m256 Visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+        for(sml_u32 PlaneIdx = 0; PlaneIdx < FrustumPlane_Count; PlaneIdx++)
+        {
+            __m256 AbsX = _mm256_andnot_ps(SignBit, PX[PlaneIdx]);
+            __m256 AbsY = _mm256_andnot_ps(SignBit, PY[PlaneIdx]);
+            __m256 AbsZ = _mm256_andnot_ps(SignBit, PZ[PlaneIdx]);
+
+            __m256 Radius = _mm256_mul_ps(AbsX, EX);
+            Radius        = _mm256_add_ps(Radius, _mm256_mul_ps(AbsY, EY));
+            Radius        = _mm256_add_ps(Radius, _mm256_mul_ps(AbsZ, EZ));
+
+            __m256 Distance = _mm256_mul_ps(PX[PlaneIdx], X);
+            Distance        = _mm256_add_ps(Distance, _mm256_mul_ps(PY[PlaneIdx], Y));
+            Distance        = _mm256_add_ps(Distance, _mm256_mul_ps(PZ[PlaneIdx], Z));
+            Distance        = _mm256_add_ps(Distance, PW[PlaneIdx]);
+
+            __m256 NegRadius = _mm256_xor_ps(Radius, SignBit);
+
+            __m256 Inside = _mm256_cmp_ps(Distance, NegRadius, _CMP_GE_OQ);
+            Visible       = _mm256_and_ps(Visible, Inside);
+        }
+
+        OutMask[Idx >> 3] = (sml_u8)_mm256_movemask_ps(Visible);
+    }
+
+    return Idx;
+}
+
+// ===================================
+// Dispatch
+// ===================================
+
+using sml_cull_spheres_kernel = sml_u32 (*)(const sml_frustum &Frustum,
+                                            const sml_sphere_bounds &Spheres,
+                                            sml_u32 Start, sml_u32 Count,
+                                            sml_u8 *OutMask);
+
+using sml_cull_boxes_kernel = sml_u32 (*)(const sml_frustum &Frustum,
+                                          const sml_box_bounds &Boxes,
+                                          sml_u32 Start, sml_u32 Count,
+                                          sml_u8 *OutMask);
+
+struct sml_cull_kernels
+{
+    sml_cull_spheres_kernel Spheres;
+    sml_cull_boxes_kernel   Boxes;
+};
+
+static sml_cull_kernels
+SmlInt_BindCullKernels(Sml_Isa Isa)
+{
+    sml_cull_kernels Kernels = {};
+
+    if(Isa >= SmlIsa_AVX2)
+    {
+        Kernels.Spheres = SmlInt_CullSpheres8;
+        Kernels.Boxes   = SmlInt_CullBoxes8;
+    }
+    else if(Isa >= SmlIsa_SSE2)
+    {
+        Kernels.Spheres = SmlInt_CullSpheres4;
+        Kernels.Boxes   = SmlInt_CullBoxes4;
+    }
+    else
+    {
+        Kernels.Spheres = SmlInt_CullSpheresScalar;
+        Kernels.Boxes   = SmlInt_CullBoxesScalar;
+    }
+
+    return Kernels;
+}
+
+static auto SmlCullKernels = SmlInt_BindCullKernels(SmlCpu.Isa);
+
+// ===================================
+// User API
+// ===================================
+
+// NOTE: OutMask holds (Count + 7) / 8 bytes, bits past Count are 0.
+
+static void
+SmlFrustum_CullSpheresMask(const sml_frustum &Frustum, const sml_sphere_bounds &Spheres,
+                           sml_u32 Count, sml_u8 *OutMask)
+{
+    sml_u32 Idx = SmlCullKernels.Spheres(Frustum, Spheres, 0, Count, OutMask);
+
+    SmlInt_CullSpheresScalar(Frustum, Spheres, Idx, Count, OutMask);
+}
+
+static void
+SmlFrustum_CullBoxesMask(const sml_frustum &Frustum, const sml_box_bounds &Boxes,
+                         sml_u32 Count, sml_u8 *OutMask)
+{
+    sml_u32 Idx = SmlCullKernels.Boxes(Frustum, Boxes, 0, Count, OutMask);
+
+    SmlInt_CullBoxesScalar(Frustum, Boxes, Idx, Count, OutMask);
+}
+
+// NOTE: Writes the visible indices in ascending order and returns how many.
+// OutIndices must hold Count entries. Works in chunks so the mask stays on
+// the stack.
+
+static sml_u32
+SmlFrustum_CullSpheres(const sml_frustum &Frustum, const sml_sphere_bounds &Spheres,
+                       sml_u32 Count, sml_u32 *OutIndices)
+{
+    constexpr sml_u32 ChunkSize = 1024;
+
+    sml_u8  Mask[ChunkSize / 8];
+    sml_u32 Visible = 0;
+
+    for(sml_u32 Base = 0; Base < Count; Base += ChunkSize)
+    {
+        sml_u32 ChunkCount = (Count - Base) < ChunkSize ? (Count - Base) : ChunkSize;
+
+        SmlFrustum_CullSpheresMask(Frustum, Spheres.Offset(Base), ChunkCount, Mask);
+        Visible = SmlInt_CompactMask(Mask, ChunkCount, Base, OutIndices, Visible);
+    }
+
+    return Visible;
+}
+
+static sml_u32
+SmlFrustum_CullBoxes(const sml_frustum &Frustum, const sml_box_bounds &Boxes,
+                     sml_u32 Count, sml_u32 *OutIndices)
+{
+    constexpr sml_u32 ChunkSize = 1024;
+
+    sml_u8  Mask[ChunkSize / 8];
+    sml_u32 Visible = 0;
+
+    for(sml_u32 Base = 0; Base < Count; Base += ChunkSize)
+    {
+        sml_u32 ChunkCount = (Count - Base) < ChunkSize ? (Count - Base) : ChunkSize;
+
+        SmlFrustum_CullBoxesMask(Frustum, Boxes.Offset(Base), ChunkCount, Mask);
+        Visible = SmlInt_CompactMask(Mask, ChunkCount, Base, OutIndices, Visible);
+    }
+
+    return Visible;
+}
@@ -6,18 +6,32 @@
 // Type Definitions
 // ===================================
 
+// NOTE:
+// 1) Fan is only correct for convex polygons.
+// 2) Monotone handles any simple polygon in O(n log n): a plane sweep splits it
+//    into y-monotone pieces, each triangulated in linear time. Inputs the sweep
+//    cannot handle (repeated or collinear points, touching edges) are detected
+//    and go through EarClip instead.
+// 3) EarClip is O(n^2) worst case, a grid over the reflex vertices keeps each
+//    ear test local.
+// 4) Output has the winding of the input polygon, either one is accepted.
+
 enum SmlTriangulate_Method
 {
     SmlTriangulate_Fan,
+    SmlTriangulate_Monotone,
+    SmlTriangulate_EarClip,
 };
 
 using sml_tri   = sml_u32;
 using sml_edge  = sml_u32;
 using sml_point = sml_u32;
 
+// NOTE: Positions stay in sml_walkable_list::Positions, a walkable triangle
+// only keeps its points and its unit normal.
+
 struct sml_walkable_tri
 {
-    sml_vector3 v0, v1, v2;
     sml_point   Points[3];
     sml_vector3 Normal;
 };
@@ -32,6 +46,9 @@ struct sml_tri_edge
     }
 };
 
+// NOTE: Count keeps counting past 2 on non-manifold edges, only the first two
+// triangles are stored.
+
 struct sml_edge_tris
 {
     sml_tri Tris[2];
@@ -44,6 +61,101 @@ struct sml_neighbor_tris
     sml_u32 Count;
 };
 
+// NOTE: Edge to triangles map, split over SmlEdgeShardCount hashmaps by the top
+// bits of the key hash so each shard can be filled by its own thread.
+
+constexpr sml_u32 SmlEdgeShardBits  = 4;
+constexpr sml_u32 SmlEdgeShardCount = 1 << SmlEdgeShardBits;
+
+struct sml_edge_map
+{
+    sml_hashmap<sml_tri_edge, sml_edge_tris> Shards[SmlEdgeShardCount];
+
+    static inline sml_u32 ShardOf(sml_tri_edge Key)
+    {
+        return (sml_u32)(XXH64(&Key, sizeof(Key), 0) >> (64 - SmlEdgeShardBits));
+    }
+
+    sml_edge_tris* Find(sml_tri_edge Key)
+    {
+        return this->Shards[ShardOf(Key)].Find(Key);
+    }
+
+    void Free()
+    {
+        for(sml_u32 Idx = 0; Idx < SmlEdgeShardCount; Idx++) this->Shards[Idx].Free();
+    }
+};
+
+struct sml_edge_record
+{
+    sml_tri_edge Key;
+    sml_tri      Tri;
+    sml_u32      Shard;
+};
+
+// NOTE:
+// 1) Welding maps every point to the lowest point index of its cell. Points are
+//    rounded to the nearest multiple of CellSize, so two points closer than
+//    CellSize can still land in neighbouring cells when they straddle a cell
+//    border. CellSize 0 only welds points at the exact same position.
+// 2) Points are bucketed by shard in index order and every shard fills its own
+//    hashmap, so the remap is the same for any thread count.
+
+constexpr sml_u32 SmlWeldShardBits  = 4;
+constexpr sml_u32 SmlWeldShardCount = 1 << SmlWeldShardBits;
+
+struct sml_weld_cell
+{
+    sml_u32 X, Y, Z;
+
+    bool operator==(const sml_weld_cell &Cell) const noexcept
+    {
+        return (Cell.X == X && Cell.Y == Y && Cell.Z == Z);
+    }
+};
+
+struct sml_weld_record
+{
+    sml_weld_cell Cell;
+    sml_point     Point;
+    sml_u32       Shard;
+};
+
+// NOTE:
+// 1) Every build stage takes a thread count (0 = all hardware threads) and
+//    splits its input in SmlNavChunkSize triangle chunks. Chunking does not
+//    depend on the thread count and every chunk writes its own output range,
+//    so the result is the same for any number of threads.
+// 2) Walkable keeps the input triangle order, clusters list their triangles in
+//    ascending order and are ordered by their first triangle.
+
+constexpr sml_u32 SmlNavChunkSize = 16384;
+
+constexpr sml_tri SmlInvalidTri = 0xFFFFFFFF;
+
+// NOTE:
+// 1) Hashmap inserts every edge in the sharded edge map and looks it up again.
+//    Sort packs (edge, triangle, corner) in a 64 bit key, radix sorts the keys
+//    and pairs triangles with a linear scan. Both give the same adjacency.
+// 2) Auto sorts from SmlAdjacencySortMinTris walkable triangles on. Below that
+//    the fixed cost of the radix histograms is larger than hashing. Meshes
+//    whose keys do not fit in 64 bits always use the hashmap.
+// 3) An edge is shared when exactly two different triangles use it.
+//    Non-manifold edges (3 or more) connect nothing, like the border.
+
+enum SmlAdjacency_Method
+{
+    SmlAdjacency_Auto,
+    SmlAdjacency_Hashmap,
+    SmlAdjacency_Sort,
+};
+
+constexpr sml_u32 SmlAdjacencySortMinTris = 256;
+
+constexpr sml_u32 SmlRadixBits    = 11;
+constexpr sml_u32 SmlRadixBuckets = 1 << SmlRadixBits;
+
 struct sml_walkable_list
 {
     // List of triangles considered walkable
@@ -56,13 +168,64 @@ struct sml_walkable_list
     sml_vector3 *Positions;
     sml_u32     *Indices;
 
-    // Map of an edge to a list of triangles that have this mesh
-    sml_hashmap<sml_tri_edge, sml_edge_tris> EdgeToTris;
+    // Triangle across edge Points[E] -> Points[E + 1] of walkable triangle T is
+    // Across[T * 3 + E], SmlInvalidTri on the border
+    dynamic_array<sml_tri> Across;
 
     // Other meta-data
     sml_f32 SlopeThresold;
 };
 
+enum Sml_SweepVertex
+{
+    SmlSweep_Start,
+    SmlSweep_End,
+    SmlSweep_Split,
+    SmlSweep_Merge,
+    SmlSweep_Regular,
+};
+
+struct sml_sweep_key
+{
+    sml_f32 y, x;
+    sml_u32 Index;
+};
+
+struct sml_half_edge
+{
+    sml_point From, To;
+    sml_u32   Next;
+    sml_u32   Slot;
+    sml_f32   Angle;
+};
+
+struct sml_triangulator
+{
+    // Counter-clockwise copy of the input and the input index of each point.
+    sml_vector2 *Points;
+    sml_u32     *Map;
+    sml_u32      Count;
+    bool         Flip;
+
+    sml_u32 *Indices;
+    sml_u32  IndexCount;
+
+    sml_heap_block Heap;
+    sml_u8        *At;
+    sml_u8        *End;
+
+    template <typename T>
+    T* Scratch(sml_u32 ElementCount)
+    {
+        T *Result = (T*)this->At;
+        this->At += (ElementCount * sizeof(T) + 15) & ~(size_t)15;
+
+        Sml_Assert(this->At <= this->End);
+
+        return Result;
+    }
+};
+
 // ===================================
 // Internal Helpers
 // ===================================
@@ -94,163 +257,1920 @@ SmlInt_SignedArea(sml_vector2 *A, sml_vector2 *B, sml_vector2 *C)
     return SignedArea;
 }
 
-static sml_walkable_list
-SmlInt_BuildWalkableList(sml_vector3 *Positions, sml_u32 *Indices, sml_u32 IdxCount,
-                         sml_f32 SlopeDeg)
+// Vertex welding
+// ===================================
+
+static inline sml_u32
+SmlInt_WeldCoord(sml_f32 Value, sml_f32 InvCellSize)
 {
-    sml_walkable_list List = {};
-    List.Positions = Positions;
-    List.Indices   = Indices;
+    if(InvCellSize == 0.0f)
+    {
+        // Exact mode keys on the bits, -0 and +0 are the same position.
+        if(Value == 0.0f) return 0;
 
-    sml_u32 TriCount = IdxCount / 3;
-    List.Walkable    = dynamic_array<sml_walkable_tri>(TriCount);
+        sml_u32 Bits;
+        memcpy(&Bits, &Value, sizeof(Bits));
 
-    List.SlopeThresold = cosf(SlopeDeg * (3.14158265f / 180.0f));
+        return Bits;
+    }
 
-    for(sml_u32 TriIdx = 0; TriIdx < TriCount; TriIdx++)
+    sml_f32 Cell = floorf(Value * InvCellSize + 0.5f);
+
+    // Far out points share the last cell instead of overflowing the cast.
+    if(Cell < -1073741824.0f) Cell = -1073741824.0f;
+    if(Cell >  1073741824.0f) Cell =  1073741824.0f;
+
+    return (sml_u32)(sml_i32)Cell;
+}
+
+// NOTE: Writes the canonical point of every point in [0, PointCount) to Remap
+// and returns how many canonical points there are.
+
+static sml_u32
+SmlInt_WeldPoints(sml_vector3 *Positions, sml_u32 PointCount, sml_f32 CellSize,
+                  sml_point *Remap, sml_u32 ThreadCount)
+{
+    sml_f32 InvCellSize = CellSize > 0.0f ? 1.0f / CellSize : 0.0f;
+    sml_u32 ChunkCount  = SmlInt_ChunkCount(PointCount, SmlNavChunkSize);
+
+    auto Records   = dynamic_array<sml_weld_record>(PointCount, false);
+    auto Bucketed  = dynamic_array<sml_weld_record>(PointCount, false);
+    auto Histogram = dynamic_array<sml_u32>(ChunkCount * SmlWeldShardCount + 1);
+
+    Sml_ParallelFor(PointCount, SmlNavChunkSize, ThreadCount,
+    [&](sml_u32 Begin, sml_u32 End, sml_u32 ChunkIdx)
     {
-        sml_walkable_tri Tri  = {};
-        sml_u32          Base = TriIdx * 3;
+        sml_u32 *Counts = Histogram.Values + ChunkIdx * SmlWeldShardCount;
+
+        for(sml_point Point = Begin; Point < End; Point++)
+        {
+            sml_weld_record Record = {};
+            Record.Cell.X = SmlInt_WeldCoord(Positions[Point].x, InvCellSize);
+            Record.Cell.Y = SmlInt_WeldCoord(Positions[Point].y, InvCellSize);
+            Record.Cell.Z = SmlInt_WeldCoord(Positions[Point].z, InvCellSize);
+            Record.Point  = Point;
+            Record.Shard  = (sml_u32)(XXH64(&Record.Cell, sizeof(Record.Cell), 0) >>
+                                      (64 - SmlWeldShardBits));
 
-        Tri.Points[0] = Indices[Base + 0];
-        Tri.Points[1] = Indices[Base + 1];
-        Tri.Points[2] = Indices[Base + 2];
+            Records[Point] = Record;
+            Counts[Record.Shard]++;
+        }
+    });
 
-        Tri.v0 = Positions[Tri.Points[0]];
-        Tri.v1 = Positions[Tri.Points[1]];
-        Tri.v2 = Positions[Tri.Points[2]];
+    sml_hashmap<sml_weld_cell, sml_u32> Maps[SmlWeldShardCount];
 
-        sml_vector3 EdgeVec0 = Tri.v1 - Tri.v0;
-        sml_vector3 EdgeVec1 = Tri.v2 - Tri.v0;
+    sml_u32 ShardStarts[SmlWeldShardCount + 1] = {};
+    sml_u32 ShardUnique[SmlWeldShardCount]     = {};
 
-        Tri.Normal = SmlVec3_Normalize(SmlVec3_VectorProduct(EdgeVec0, EdgeVec1));
+    for(sml_u32 Shard = 0; Shard < SmlWeldShardCount; Shard++)
+    {
+        ShardStarts[Shard + 1] = ShardStarts[Shard];
 
-        if(Tri.Normal.y > List.SlopeThresold)
+        for(sml_u32 ChunkIdx = 0; ChunkIdx < ChunkCount; ChunkIdx++)
         {
-            List.Walkable.Push(Tri);
+            sml_u32 &Count = Histogram[ChunkIdx * SmlWeldShardCount + Shard];
+            sml_u32  Start = ShardStarts[Shard + 1];
+
+            ShardStarts[Shard + 1] += Count;
+            Count                   = Start;
         }
+
+        // Sized for every point in its own cell, so the map never grows.
+        sml_u32 ShardPoints = ShardStarts[Shard + 1] - ShardStarts[Shard];
+        Maps[Shard] = sml_hashmap<sml_weld_cell, sml_u32>(ShardPoints / 14 + 1);
     }
 
-    sml_u32 EdgeCnt = List.Walkable.Count * 3;
-    List.EdgeToTris = sml_hashmap<sml_tri_edge, sml_edge_tris>(EdgeCnt);
+    Sml_ParallelFor(PointCount, SmlNavChunkSize, ThreadCount,
+    [&](sml_u32 Begin, sml_u32 End, sml_u32 ChunkIdx)
+    {
+        sml_u32 *Offsets = Histogram.Values + ChunkIdx * SmlWeldShardCount;
+
+        for(sml_point Point = Begin; Point < End; Point++)
+        {
+            Bucketed[Offsets[Records[Point].Shard]++] = Records[Point];
+        }
+    });
 
-    for(sml_u32 TriIdx = 0; TriIdx < List.Walkable.Count; TriIdx++)
+    Sml_ParallelFor(SmlWeldShardCount, 1, ThreadCount,
+    [&](sml_u32 Shard, sml_u32, sml_u32)
     {
-        sml_walkable_tri Tri = List.Walkable[TriIdx];
+        auto &Map = Maps[Shard];
 
-        for(sml_u32 EdgeIdx = 0; EdgeIdx < 3; EdgeIdx++)
+        for(sml_u32 Idx = ShardStarts[Shard]; Idx < ShardStarts[Shard + 1]; Idx++)
         {
-            sml_tri_edge Edge = SmlInt_MakeEdgeKey(EdgeIdx, Tri.Points);
+            sml_weld_record &Record = Bucketed[Idx];
+
+            // Canonical point + 1, zero the first time the cell is seen.
+            sml_u32 &Canonical = Map.Get(Record.Cell);
+
+            if(Canonical == 0)
+            {
+                Canonical = Record.Point + 1;
+                ShardUnique[Shard]++;
+            }
 
-            auto &Triangles = List.EdgeToTris.Get(Edge);
-            Triangles.Tris[Triangles.Count++] = TriIdx;
+            Remap[Record.Point] = Canonical - 1;
         }
+
+        Map.Free();
+    });
+
+    Records.Free();
+    Bucketed.Free();
+    Histogram.Free();
+
+    sml_u32 Unique = 0;
+    for(sml_u32 Shard = 0; Shard < SmlWeldShardCount; Shard++)
+    {
+        Unique += ShardUnique[Shard];
     }
 
-    List.Neighbors = dynamic_array<sml_neighbor_tris>(List.Walkable.Count);
+    return Unique;
+}
+
+// Walkable classification
+// ===================================
+
+// NOTE:
+// 1) Kernels take Count triangles (Indices holds 3 per triangle) and write the
+//    unit normals as structure-of-arrays plus one mask bit per triangle (bit i
+//    of byte i / 8, set when Normal.y > Threshold). Start is a multiple of 8,
+//    the mask bytes from Start on are overwritten.
+// 2) SIMD paths gather the positions and use the scalar reference's mul/sub
+//    order without FMA, so normals and masks match it bit for bit.
+// 3) Degenerate triangles get a zero normal, like SmlVec3_Normalize.
 
-    for (sml_u32 TriIdx = 0; TriIdx < List.Walkable.Count; ++TriIdx)
+static sml_u32
+SmlInt_ClassifyTrisScalar(const sml_vector3 *Positions, const sml_u32 *Indices,
+                          sml_u32 Start, sml_u32 Count, sml_f32 Threshold,
+                          sml_f32 *OutNX, sml_f32 *OutNY, sml_f32 *OutNZ,
+                          sml_u8 *OutMask)
+{
+    for(sml_u32 Idx = Start; Idx < Count; Idx++)
     {
-        sml_walkable_tri Tri = List.Walkable[TriIdx];
+        if((Idx & 7) == 0) OutMask[Idx >> 3] = 0;
+
+        sml_vector3 V0 = Positions[Indices[Idx * 3 + 0]];
+        sml_vector3 V1 = Positions[Indices[Idx * 3 + 1]];
+        sml_vector3 V2 = Positions[Indices[Idx * 3 + 2]];
+
+        sml_vector3 Normal = SmlVec3_Normalize(SmlVec3_VectorProduct(V1 - V0, V2 - V0));
+
+        OutNX[Idx] = Normal.x;
+        OutNY[Idx] = Normal.y;
+        OutNZ[Idx] = Normal.z;
+
+        if(Normal.y > Threshold) OutMask[Idx >> 3] |= (sml_u8)(1u << (Idx & 7));
+    }
+
+    return Count;
+}
+
+// NOTE: SSE2 has no gather, the 4 wide halves are filled with scalar loads.
+
+static inline void
+SmlInt_GatherTris4(const sml_vector3 *Positions, const sml_u32 *Indices, sml_u32 Corner,
+                   __m128 *X, __m128 *Y, __m128 *Z)
+{
+    const sml_vector3 &A = Positions[Indices[0 * 3 + Corner]];
+    const sml_vector3 &B = Positions[Indices[1 * 3 + Corner]];
+    const sml_vector3 &C = Positions[Indices[2 * 3 + Corner]];
+    const sml_vector3 &D = Positions[Indices[3 * 3 + Corner]];
 
-        sml_neighbor_tris Neighbors = {};
+    *X = _mm_setr_ps(A.x, B.x, C.x, D.x);
+    *Y = _mm_setr_ps(A.y, B.y, C.y, D.y);
+    *Z = _mm_setr_ps(A.z, B.z, C.z, D.z);
+}
+
+static sml_u32
+SmlInt_ClassifyTris4(const sml_vector3 *Positions, const sml_u32 *Indices,
+                     sml_u32 Start, sml_u32 Count, sml_f32 Threshold,
+                     sml_f32 *OutNX, sml_f32 *OutNY, sml_f32 *OutNZ, sml_u8 *OutMask)
+{
+    __m128 Limit = _mm_set1_ps(Threshold);
+    __m128 One   = _mm_set1_ps(1.0f);
+    __m128 Zero  = _mm_setzero_ps();
+
+    sml_u32 Idx = Start;
+    for(; Idx + 8 <= Count; Idx += 8)
+    {
+        sml_u32 Bits = 0;
 
-        for (sml_u32 EdgeIdx = 0; EdgeIdx < 3; EdgeIdx++)
+        for(sml_u32 Half = 0; Half < 8; Half += 4)
         {
-            sml_tri_edge Edge = SmlInt_MakeEdgeKey(EdgeIdx, Tri.Points);
+            const sml_u32 *Tris = Indices + (Idx + Half) * 3;
 
-            auto &Triangles = List.EdgeToTris.Get(Edge);
-            if (Triangles.Count == 2)
-            {
-                sml_tri SharedTri = 
-                    (Triangles.Tris[0] == TriIdx ? Triangles.Tris[1] :
-                                                   Triangles.Tris[0]);
-                Neighbors.Tris[Neighbors.Count++] = SharedTri;
-            }
+            __m128 X0, Y0, Z0, X1, Y1, Z1, X2, Y2, Z2;
+            SmlInt_GatherTris4(Positions, Tris, 0, &X0, &Y0, &Z0);
+            SmlInt_GatherTris4(Positions, Tris, 1, &X1, &Y1, &Z1);
+            SmlInt_GatherTris4(Positions, Tris, 2, &X2, &Y2, &Z2);
+
+            __m128 AX = _mm_sub_ps(X1, X0), AY = _mm_sub_ps(Y1, Y0);
+            __m128 AZ = _mm_sub_ps(Z1, Z0);
+            __m128 BX = _mm_sub_ps(X2, X0), BY = _mm_sub_ps(Y2, Y0);
+            __m128 BZ = _mm_sub_ps(Z2, Z0);
+
+            __m128 CX = _mm_sub_ps(_mm_mul_ps(AY, BZ), _mm_mul_ps(AZ, BY));
+            __m128 CY = _mm_sub_ps(_mm_mul_ps(AZ, BX), _mm_mul_ps(AX, BZ));
+            __m128 CZ = _mm_sub_ps(_mm_mul_ps(AX, BY), _mm_mul_ps(AY, BX));
+
+            __m128 LengthSq = _mm_mul_ps(CX, CX);
+            LengthSq        = _mm_add_ps(LengthSq, _mm_mul_ps(CY, CY));
+            LengthSq        = _mm_add_ps(LengthSq, _mm_mul_ps(CZ, CZ));
+
+            __m128 Valid     = _mm_cmpgt_ps(LengthSq, Zero);
+            __m128 InvLength = _mm_div_ps(One, _mm_sqrt_ps(LengthSq));
+
+            __m128 NX = _mm_and_ps(_mm_mul_ps(CX, InvLength), Valid);
+            __m128 NY = _mm_and_ps(_mm_mul_ps(CY, InvLength), Valid);
+            __m128 NZ = _mm_and_ps(_mm_mul_ps(CZ, InvLength), Valid);
+
+            _mm_storeu_ps(OutNX + Idx + Half, NX);
+            _mm_storeu_ps(OutNY + Idx + Half, NY);
+            _mm_storeu_ps(OutNZ + Idx + Half, NZ);
+
+            Bits |= (sml_u32)_mm_movemask_ps(_mm_cmpgt_ps(NY, Limit)) << Half;
         }
 
-        List.Neighbors.Push(Neighbors);
+        OutMask[Idx >> 3] = (sml_u8)Bits;
     }
 
-    return List;
+    return Idx;
 }
 
-static dynamic_array<dynamic_array<sml_tri>>
-SmlInt_BuildPolygonClusters(sml_walkable_list *List)
+SML_TARGET_AVX2 static sml_u32
+SmlInt_ClassifyTris8(const sml_vector3 *Positions, const sml_u32 *Indices,
+                     sml_u32 Start, sml_u32 Count, sml_f32 Threshold,
+                     sml_f32 *OutNX, sml_f32 *OutNY, sml_f32 *OutNZ, sml_u8 *OutMask)
 {
-    auto Visited  = dynamic_array<bool>(List->Walkable.Count);
-    auto Clusters = dynamic_array<dynamic_array<sml_tri>>(0);
-    auto Stack    = stack<sml_tri>(0);
+    const sml_f32 *Floats = (const sml_f32*)Positions;
 
-    for(sml_u32 TriIdx = 0; TriIdx < List->Walkable.Count; TriIdx++)
+    __m256i Stride = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+    __m256  Limit  = _mm256_set1_ps(Threshold);
+    __m256  One    = _mm256_set1_ps(1.0f);
+    __m256  Zero   = _mm256_setzero_ps();
+
+    sml_u32 Idx = Start;
+    for(; Idx + 8 <= Count; Idx += 8)
+    {
+        const int *Tris = (const int*)(Indices + Idx * 3);
+
+        // Point index times 3 is the offset of its x in Floats.
+        __m256i P0 = _mm256_i32gather_epi32(Tris + 0, Stride, 4);
+        __m256i P1 = _mm256_i32gather_epi32(Tris + 1, Stride, 4);
+        __m256i P2 = _mm256_i32gather_epi32(Tris + 2, Stride, 4);
+
+        P0 = _mm256_add_epi32(P0, _mm256_add_epi32(P0, P0));
+        P1 = _mm256_add_epi32(P1, _mm256_add_epi32(P1, P1));
+        P2 = _mm256_add_epi32(P2, _mm256_add_epi32(P2, P2));
+
+        __m256 X0 = _mm256_i32gather_ps(Floats + 0, P0, 4);
+        __m256 Y0 = _mm256_i32gather_ps(Floats + 1, P0, 4);
+        __m256 Z0 = _mm256_i32gather_ps(Floats + 2, P0, 4);
+        __m256 X1 = _mm256_i32gather_ps(Floats + 0, P1, 4);
+        __m256 Y1 = _mm256_i32gather_ps(Floats + 1, P1, 4);
+        __m256 Z1 = _mm256_i32gather_ps(Floats + 2, P1, 4);
+        __m256 X2 = _mm256_i32gather_ps(Floats + 0, P2, 4);
+        __m256 Y2 = _mm256_i32gather_ps(Floats + 1, P2, 4);
+        __m256 Z2 = _mm256_i32gather_ps(Floats + 2, P2, 4);
+
+        __m256 AX = _mm256_sub_ps(X1, X0), AY = _mm256_sub_ps(Y1, Y0);
+        __m256 AZ = _mm256_sub_ps(Z1, Z0);
+        __m256 BX = _mm256_sub_ps(X2, X0), BY = _mm256_sub_ps(Y2, Y0);
+        __m256 BZ = _mm256_sub_ps(Z2, Z0);
+
+        __m256 CX = _mm256_sub_ps(_mm256_mul_ps(AY, BZ), _mm256_mul_ps(AZ, BY));
+        __m256 CY = _mm256_sub_ps(_mm256_mul_ps(AZ, BX), _mm256_mul_ps(AX, BZ));
+        __m256 CZ = _mm256_sub_ps(_mm256_mul_ps(AX, BY), _mm256_mul_ps(AY, BX));
+
+        __m256 LengthSq = _mm256_mul_ps(CX, CX);
+        LengthSq        = _mm256_add_ps(LengthSq, _mm256_mul_ps(CY, CY));
+        LengthSq        = _mm256_add_ps(LengthSq, _mm256_mul_ps(CZ, CZ));
+
+        __m256 Valid     = _mm256_cmp_ps(LengthSq, Zero, _CMP_GT_OQ);
+        __m256 InvLength = _mm256_div_ps(One, _mm256_sqrt_ps(LengthSq));
+
+        // Masked after the multiply, so degenerate triangles get +0 like scalar.
+        __m256 NX = _mm256_and_ps(_mm256_mul_ps(CX, InvLength), Valid);
+        __m256 NY = _mm256_and_ps(_mm256_mul_ps(CY, InvLength), Valid);
+        __m256 NZ = _mm256_and_ps(_mm256_mul_ps(CZ, InvLength), Valid);
+
+        _mm256_storeu_ps(OutNX + Idx, NX);
+        _mm256_storeu_ps(OutNY + Idx, NY);
+        _mm256_storeu_ps(OutNZ + Idx, NZ);
+
+        OutMask[Idx >> 3] = (sml_u8)_mm256_movemask_ps(_mm256_cmp_ps(NY, Limit,
+                                                                     _CMP_GT_OQ));
+    }
+
+    return Idx;
+}
+
+using sml_classify_tris_kernel = sml_u32 (*)(const sml_vector3 *Positions,
+                                             const sml_u32 *Indices,
+                                             sml_u32 Start, sml_u32 Count,
+                                             sml_f32 Threshold, sml_f32 *OutNX,
+                                             sml_f32 *OutNY, sml_f32 *OutNZ,
+                                             sml_u8 *OutMask);
+
+struct sml_walkable_kernels
+{
+    sml_classify_tris_kernel Classify;
+};
+
+static sml_walkable_kernels
+SmlInt_BindWalkableKernels(Sml_Isa Isa)
+{
+    sml_walkable_kernels Kernels = {};
+
+    if(Isa >= SmlIsa_AVX2)
+    {
+        Kernels.Classify = SmlInt_ClassifyTris8;
+    }
+    else if(Isa >= SmlIsa_SSE2)
+    {
+        Kernels.Classify = SmlInt_ClassifyTris4;
+    }
+    else
+    {
+        Kernels.Classify = SmlInt_ClassifyTrisScalar;
+    }
+
+    return Kernels;
+}
+
+static auto SmlWalkableKernels = SmlInt_BindWalkableKernels(SmlCpu.Isa);
+
+static void
+SmlInt_ClassifyTris(const sml_walkable_kernels &Kernels, const sml_vector3 *Positions,
+                    const sml_u32 *Indices, sml_u32 Count, sml_f32 Threshold,
+                    sml_f32 *OutNX, sml_f32 *OutNY, sml_f32 *OutNZ, sml_u8 *OutMask)
+{
+    sml_u32 Idx = Kernels.Classify(Positions, Indices, 0, Count, Threshold,
+                                   OutNX, OutNY, OutNZ, OutMask);
+
+    SmlInt_ClassifyTrisScalar(Positions, Indices, Idx, Count, Threshold,
+                              OutNX, OutNY, OutNZ, OutMask);
+}
+
+// Adjacency
+// ===================================
+
+// NOTE: Records are bucketed by shard in triangle order, then every shard fills
+// its own hashmap, so the stored triangles are in ascending order.
+
+static void
+SmlInt_BuildAdjacencyHashmap(sml_walkable_list *List, sml_u32 ThreadCount)
+{
+    sml_u32 WalkableCount = List->Walkable.Count;
+    sml_u32 EdgeCnt       = WalkableCount * 3;
+    sml_u32 ChunkCount    = SmlInt_ChunkCount(WalkableCount, SmlNavChunkSize);
+
+    sml_edge_map EdgeToTris = {};
+
+    auto Records   = dynamic_array<sml_edge_record>(EdgeCnt, false);
+    auto Bucketed  = dynamic_array<sml_edge_record>(EdgeCnt, false);
+    auto Histogram = dynamic_array<sml_u32>(ChunkCount * SmlEdgeShardCount + 1);
+
+    Sml_ParallelFor(WalkableCount, SmlNavChunkSize, ThreadCount,
+    [&](sml_u32 Begin, sml_u32 End, sml_u32 ChunkIdx)
+    {
+        sml_u32 *Counts = Histogram.Values + ChunkIdx * SmlEdgeShardCount;
+
+        for(sml_u32 TriIdx = Begin; TriIdx < End; TriIdx++)
+        {
+            for(sml_u32 EdgeIdx = 0; EdgeIdx < 3; EdgeIdx++)
+            {
+                sml_edge_record Record = {};
+                Record.Key   = SmlInt_MakeEdgeKey(EdgeIdx, List->Walkable[TriIdx].Points);
+                Record.Tri   = TriIdx;
+                Record.Shard = sml_edge_map::ShardOf(Record.Key);
+
+                Records[TriIdx * 3 + EdgeIdx] = Record;
+                Counts[Record.Shard]++;
+            }
+        }
+    });
+
+    sml_u32 ShardStarts[SmlEdgeShardCount + 1] = {};
+
+    for(sml_u32 Shard = 0; Shard < SmlEdgeShardCount; Shard++)
     {
-        if(Visited[TriIdx]) continue;
+        ShardStarts[Shard + 1] = ShardStarts[Shard];
+
+        for(sml_u32 ChunkIdx = 0; ChunkIdx < ChunkCount; ChunkIdx++)
+        {
+            sml_u32 &Count = Histogram[ChunkIdx * SmlEdgeShardCount + Shard];
+            sml_u32  Start = ShardStarts[Shard + 1];
+
+            ShardStarts[Shard + 1] += Count;
+            Count                   = Start;
+        }
 
-        auto Cluster = dynamic_array<sml_tri>(0);
+        // Sized in groups of 16 buckets, every edge but the border ones is shared.
+        sml_u32 ShardEdges = ShardStarts[Shard + 1] - ShardStarts[Shard];
+        EdgeToTris.Shards[Shard] =
+            sml_hashmap<sml_tri_edge, sml_edge_tris>(ShardEdges / 14 + 1);
+    }
 
-        Stack.Push(TriIdx);
-        Visited[TriIdx] = true;
+    Sml_ParallelFor(WalkableCount, SmlNavChunkSize, ThreadCount,
+    [&](sml_u32 Begin, sml_u32 End, sml_u32 ChunkIdx)
+    {
+        sml_u32 *Offsets = Histogram.Values + ChunkIdx * SmlEdgeShardCount;
 
-        while(!Stack.Empty())
+        for(sml_u32 RecordIdx = Begin * 3; RecordIdx < End * 3; RecordIdx++)
         {
-            sml_tri Current = Stack.Pop();
-            Cluster.Push(Current);
+            Bucketed[Offsets[Records[RecordIdx].Shard]++] = Records[RecordIdx];
+        }
+    });
+
+    Sml_ParallelFor(SmlEdgeShardCount, 1, ThreadCount,
+    [&](sml_u32 Shard, sml_u32, sml_u32)
+    {
+        auto &Map = EdgeToTris.Shards[Shard];
 
-            auto Neighbors = List->Neighbors[Current];
-            auto Normal    = List->Walkable[Current].Normal;
+        for(sml_u32 Idx = ShardStarts[Shard]; Idx < ShardStarts[Shard + 1]; Idx++)
+        {
+            auto &Triangles = Map.Get(Bucketed[Idx].Key);
 
-            for(sml_u32 NIdx = 0; NIdx < Neighbors.Count; NIdx++)
+            if(Triangles.Count < 2) Triangles.Tris[Triangles.Count] = Bucketed[Idx].Tri;
+            Triangles.Count++;
+        }
+    });
+
+    Records.Free();
+    Bucketed.Free();
+    Histogram.Free();
+
+    Sml_ParallelFor(WalkableCount, SmlNavChunkSize, ThreadCount,
+    [&](sml_u32 Begin, sml_u32 End, sml_u32)
+    {
+        for(sml_u32 TriIdx = Begin; TriIdx < End; TriIdx++)
+        {
+            for(sml_u32 EdgeIdx = 0; EdgeIdx < 3; EdgeIdx++)
             {
-                sml_tri Neighbor = Neighbors.Tris[NIdx];
+                sml_point   *Points = List->Walkable[TriIdx].Points;
+                sml_tri_edge Edge   = SmlInt_MakeEdgeKey(EdgeIdx, Points);
 
-                if(Visited[Neighbor]) continue;
+                auto   *Triangles = EdgeToTris.Find(Edge);
+                sml_tri Tri0      = Triangles->Tris[0];
+                sml_tri Tri1      = Triangles->Tris[1];
 
-                auto NeighborNormal = List->Walkable[Neighbor].Normal;
-                if(SmlVec3_Dot(Normal, NeighborNormal) >= List->SlopeThresold)
-                {
-                    Visited[Neighbor] = true;
-                    Stack.Push(Neighbor);
-                }
+                if(Triangles->Count != 2 || Tri0 == Tri1) continue;
+
+                List->Across[TriIdx * 3 + EdgeIdx] = Tri0 == TriIdx ? Tri1 : Tri0;
+            }
+        }
+    });
+
+    EdgeToTris.Free();
+}
+
+// NOTE: LSD radix sort on the low Bits bits of Keys, SmlRadixBits per pass.
+// Passes where every key has the same digit are skipped. Chunks scatter in
+// order, so the sort is stable and the same on any thread count. Returns the
+// buffer holding the result, Keys or Scratch.
+
+static sml_u64*
+SmlInt_RadixSort(sml_u64 *Keys, sml_u64 *Scratch, sml_u32 Count, sml_u32 Bits,
+                 sml_u32 ThreadCount)
+{
+    sml_u32 ChunkCount = SmlInt_ChunkCount(Count, SmlNavChunkSize);
+    auto    Histogram  = dynamic_array<sml_u32>(ChunkCount * SmlRadixBuckets + 1, false);
+
+    for(sml_u32 Shift = 0; Shift < Bits; Shift += SmlRadixBits)
+    {
+        memset(Histogram.Values, 0, ChunkCount * SmlRadixBuckets * sizeof(sml_u32));
+
+        Sml_ParallelFor(Count, SmlNavChunkSize, ThreadCount,
+        [&](sml_u32 Begin, sml_u32 End, sml_u32 ChunkIdx)
+        {
+            sml_u32 *Counts = Histogram.Values + ChunkIdx * SmlRadixBuckets;
+
+            for(sml_u32 Idx = Begin; Idx < End; Idx++)
+            {
+                Counts[(Keys[Idx] >> Shift) & (SmlRadixBuckets - 1)]++;
+            }
+        });
+
+        // Digit-major prefix sum, chunk offsets within each digit.
+        sml_u32 Total   = 0;
+        bool    Trivial = false;
+
+        for(sml_u32 Digit = 0; Digit < SmlRadixBuckets; Digit++)
+        {
+            sml_u32 DigitStart = Total;
+
+            for(sml_u32 ChunkIdx = 0; ChunkIdx < ChunkCount; ChunkIdx++)
+            {
+                sml_u32 &Slot  = Histogram[ChunkIdx * SmlRadixBuckets + Digit];
+                sml_u32  Start = Total;
+
+                Total += Slot;
+                Slot   = Start;
             }
+
+            if(Total - DigitStart == Count) Trivial = true;
         }
 
-        Clusters.Push(Cluster);
+        if(Trivial) continue;
+
+        Sml_ParallelFor(Count, SmlNavChunkSize, ThreadCount,
+        [&](sml_u32 Begin, sml_u32 End, sml_u32 ChunkIdx)
+        {
+            sml_u32 *Offsets = Histogram.Values + ChunkIdx * SmlRadixBuckets;
+
+            for(sml_u32 Idx = Begin; Idx < End; Idx++)
+            {
+                sml_u64 Key = Keys[Idx];
+                Scratch[Offsets[(Key >> Shift) & (SmlRadixBuckets - 1)]++] = Key;
+            }
+        });
+
+        sml_u64 *Temp = Keys;
+        Keys          = Scratch;
+        Scratch       = Temp;
     }
 
-    Visited.Free();
-    Stack.Free();
+    Histogram.Free();
 
-    return Clusters;
+    return Keys;
 }
 
-// WARN:
-// 1) Is there a way to estime the amount of indices needed given a Polygon count?
+static inline sml_u32
+SmlInt_BitCount(sml_u64 Value)
+{
+    sml_u32 Bits = 0;
+    while(Value >> Bits) Bits++;
 
-static dynamic_array<sml_u32>
-SmlInt_Triangulate(dynamic_array<sml_vector2> Polygon, SmlTriangulate_Method Method)
+    return Bits;
+}
+
+// NOTE: Key layout, high to low: edge (low point, high point), triangle,
+// corner (2 bits). Sorting groups the users of an edge by ascending triangle.
+// Returns false when the key does not fit in 64 bits.
+
+static bool
+SmlInt_BuildAdjacencySort(sml_walkable_list *List, sml_u32 ThreadCount)
 {
-    auto IdxList = dynamic_array<sml_u32>(0);
+    sml_u32 WalkableCount = List->Walkable.Count;
+    sml_u32 EdgeCnt       = WalkableCount * 3;
+    sml_u32 ChunkCount    = SmlInt_ChunkCount(WalkableCount, SmlNavChunkSize);
 
-    switch(Method)
-    {
+    auto ChunkMax = dynamic_array<sml_u32>(ChunkCount + 1);
 
-    case SmlTriangulate_Fan:
+    Sml_ParallelFor(WalkableCount, SmlNavChunkSize, ThreadCount,
+    [&](sml_u32 Begin, sml_u32 End, sml_u32 ChunkIdx)
     {
-        for(sml_u32 Idx = 1; Idx + 1 < Polygon.Count; Idx++)
+        sml_u32 Max = 0;
+
+        for(sml_u32 TriIdx = Begin; TriIdx < End; TriIdx++)
         {
-            IdxList.Push(0);
-            IdxList.Push(Idx);
-            IdxList.Push(Idx + 1);
+            sml_point *Points = List->Walkable[TriIdx].Points;
+
+            for(sml_u32 Corner = 0; Corner < 3; Corner++)
+            {
+                if(Points[Corner] > Max) Max = Points[Corner];
+            }
         }
-    } break;
 
-    default:
-        Sml_Assert(!"Invalid triangulation method.");
-        break;
+        ChunkMax[ChunkIdx] = Max;
+    });
 
+    sml_u32 MaxPoint = 0;
+    for(sml_u32 ChunkIdx = 0; ChunkIdx < ChunkCount; ChunkIdx++)
+    {
+        if(ChunkMax[ChunkIdx] > MaxPoint) MaxPoint = ChunkMax[ChunkIdx];
     }
 
-    Sml_Assert(IdxList.Count % 3 == 0);
+    ChunkMax.Free();
 
-    return IdxList;
+    sml_u32 PointBits = SmlInt_BitCount(MaxPoint);
+    sml_u32 TriBits   = SmlInt_BitCount(WalkableCount);
+    sml_u32 KeyBits   = 2 * PointBits + TriBits + 2;
+
+    if(KeyBits > 64) return false;
+
+    sml_u32 EdgeShift = TriBits + 2;
+
+    sml_heap_block KeyHeap = SmlMemory.Allocate(2 * (size_t)EdgeCnt * sizeof(sml_u64));
+
+    sml_u64 *Keys    = (sml_u64*)KeyHeap.Data;
+    sml_u64 *Scratch = Keys + EdgeCnt;
+
+    Sml_ParallelFor(WalkableCount, SmlNavChunkSize, ThreadCount,
+    [&](sml_u32 Begin, sml_u32 End, sml_u32)
+    {
+        for(sml_u32 TriIdx = Begin; TriIdx < End; TriIdx++)
+        {
+            for(sml_u32 EdgeIdx = 0; EdgeIdx < 3; EdgeIdx++)
+            {
+                sml_point   *Points = List->Walkable[TriIdx].Points;
+                sml_tri_edge Edge   = SmlInt_MakeEdgeKey(EdgeIdx, Points);
+
+                sml_u64 Key = ((sml_u64)Edge.Point0 << PointBits) | Edge.Point1;
+                Key         = (Key << EdgeShift) | ((sml_u64)TriIdx << 2) | EdgeIdx;
+
+                Keys[TriIdx * 3 + EdgeIdx] = Key;
+            }
+        }
+    });
+
+    sml_u64 *Sorted = SmlInt_RadixSort(Keys, Scratch, EdgeCnt, KeyBits, ThreadCount);
+
+    // A chunk owns the runs starting in it, a run may end past the chunk.
+    Sml_ParallelFor(EdgeCnt, SmlNavChunkSize, ThreadCount,
+    [&](sml_u32 Begin, sml_u32 End, sml_u32)
+    {
+        sml_u32 Idx = Begin;
+
+        while(Idx > 0 && Idx < End && (Sorted[Idx] >> EdgeShift) ==
+                                      (Sorted[Idx - 1] >> EdgeShift))
+        {
+            Idx++;
+        }
+
+        while(Idx < End)
+        {
+            sml_u64 Edge = Sorted[Idx] >> EdgeShift;
+            sml_u32 Last = Idx + 1;
+
+            while(Last < EdgeCnt && (Sorted[Last] >> EdgeShift) == Edge) Last++;
+
+            if(Last - Idx == 2)
+            {
+                sml_u32 A = (sml_u32)(Sorted[Idx]     & (((sml_u64)1 << EdgeShift) - 1));
+                sml_u32 B = (sml_u32)(Sorted[Idx + 1] & (((sml_u64)1 << EdgeShift) - 1));
+
+                if((A >> 2) != (B >> 2))
+                {
+                    // A >> 2 is the triangle, A & 3 its corner, A is the edge slot.
+                    List->Across[(A >> 2) * 3 + (A & 3)] = B >> 2;
+                    List->Across[(B >> 2) * 3 + (B & 3)] = A >> 2;
+                }
+            }
+
+            Idx = Last;
+        }
+    });
+
+    SmlMemory.Free(KeyHeap);
+
+    return true;
+}
+
+static void
+SmlInt_FreeWalkableList(sml_walkable_list *List)
+{
+    List->Walkable.Free();
+    List->Neighbors.Free();
+    List->Across.Free();
+}
+
+// Walkable list
+// ===================================
+
+static sml_walkable_list
+SmlInt_BuildWalkableList(sml_vector3 *Positions, sml_u32 *Indices, sml_u32 IdxCount,
+                         sml_f32 SlopeDeg, sml_u32 ThreadCount = 1,
+                         SmlAdjacency_Method Method = SmlAdjacency_Auto)
+{
+    sml_walkable_list List = {};
+    List.Positions = Positions;
+    List.Indices   = Indices;
+
+    sml_u32 TriCount = IdxCount / 3;
+    List.Walkable    = dynamic_array<sml_walkable_tri>(TriCount, false);
+
+    List.SlopeThresold = cosf(SlopeDeg * (3.14158265f / 180.0f));
+
+    // Classification, each chunk compacts its walkable triangles in place.
+    sml_u32 ChunkCount  = SmlInt_ChunkCount(TriCount, SmlNavChunkSize);
+    auto    ChunkCounts = dynamic_array<sml_u32>(ChunkCount + 1);
+
+    Sml_ParallelFor(TriCount, SmlNavChunkSize, ThreadCount,
+    [&](sml_u32 Begin, sml_u32 End, sml_u32 ChunkIdx)
+    {
+        constexpr sml_u32 BlockSize = 1024;
+
+        alignas(32) sml_f32 NX[BlockSize], NY[BlockSize], NZ[BlockSize];
+        sml_u8              Mask[BlockSize / 8];
+
+        sml_walkable_tri *Out = List.Walkable.Values + Begin;
+
+        for(sml_u32 Block = Begin; Block < End; Block += BlockSize)
+        {
+            sml_u32 BlockCount = End - Block < BlockSize ? End - Block : BlockSize;
+
+            SmlInt_ClassifyTris(SmlWalkableKernels, Positions, Indices + Block * 3,
+                                BlockCount, List.SlopeThresold, NX, NY, NZ, Mask);
+
+            for(sml_u32 ByteIdx = 0; ByteIdx < (BlockCount + 7) / 8; ByteIdx++)
+            {
+                sml_u32 Bits = Mask[ByteIdx];
+
+                while(Bits)
+                {
+                    sml_u32 Idx  = ByteIdx * 8 + ctz32(Bits);
+                    sml_u32 Base = (Block + Idx) * 3;
+
+                    Out->Points[0] = Indices[Base + 0];
+                    Out->Points[1] = Indices[Base + 1];
+                    Out->Points[2] = Indices[Base + 2];
+                    Out->Normal    = sml_vector3(NX[Idx], NY[Idx], NZ[Idx]);
+                    Out++;
+
+                    Bits &= Bits - 1;
+                }
+            }
+        }
+
+        ChunkCounts[ChunkIdx] = (sml_u32)(Out - (List.Walkable.Values + Begin));
+    });
+
+    // Chunks only move down, in order, so no chunk is overwritten before it moved.
+    for(sml_u32 ChunkIdx = 0; ChunkIdx < ChunkCount; ChunkIdx++)
+    {
+        memmove(List.Walkable.Values + List.Walkable.Count,
+                List.Walkable.Values + ChunkIdx * SmlNavChunkSize,
+                ChunkCounts[ChunkIdx] * sizeof(sml_walkable_tri));
+
+        List.Walkable.Count += ChunkCounts[ChunkIdx];
+    }
+
+    ChunkCounts.Free();
+
+    List.Across = dynamic_array<sml_tri>(List.Walkable.Count * 3, false);
+    List.Across.Count = List.Walkable.Count * 3;
+
+    memset(List.Across.Values, 0xFF, List.Across.Count * sizeof(sml_tri));
+
+    if(Method == SmlAdjacency_Auto)
+    {
+        Method = List.Walkable.Count >= SmlAdjacencySortMinTris ? SmlAdjacency_Sort :
+                                                                  SmlAdjacency_Hashmap;
+    }
+
+    if(Method != SmlAdjacency_Sort || !SmlInt_BuildAdjacencySort(&List, ThreadCount))
+    {
+        SmlInt_BuildAdjacencyHashmap(&List, ThreadCount);
+    }
+
+    sml_u32 WalkableCount = List.Walkable.Count;
+    List.Neighbors        = dynamic_array<sml_neighbor_tris>(WalkableCount);
+
+    Sml_ParallelFor(WalkableCount, SmlNavChunkSize, ThreadCount,
+    [&](sml_u32 Begin, sml_u32 End, sml_u32)
+    {
+        for(sml_u32 TriIdx = Begin; TriIdx < End; TriIdx++)
+        {
+            sml_neighbor_tris Neighbors = {};
+
+            for(sml_u32 EdgeIdx = 0; EdgeIdx < 3; EdgeIdx++)
+            {
+                sml_tri Other = List.Across[TriIdx * 3 + EdgeIdx];
+
+                if(Other != SmlInvalidTri) Neighbors.Tris[Neighbors.Count++] = Other;
+            }
+
+            List.Neighbors[TriIdx] = Neighbors;
+        }
+    });
+
+    List.Neighbors.Count = WalkableCount;
+
+    return List;
+}
+
+// NOTE: Lock-free union-find. A root is always linked under a smaller root, so
+// parents only decrease and the root of a set is its smallest triangle,
+// whichever thread linked first.
+
+static sml_u32
+SmlInt_FindRoot(std::atomic<sml_u32> *Parents, sml_u32 Idx)
+{
+    for(;;)
+    {
+        sml_u32 Parent = Parents[Idx].load(std::memory_order_relaxed);
+        if(Parent == Idx) return Idx;
+
+        sml_u32 Grand = Parents[Parent].load(std::memory_order_relaxed);
+
+        // Path halving, losing the race only leaves a longer path.
+        if(Grand != Parent)
+        {
+            sml_u32 Expected = Parent;
+            Parents[Idx].compare_exchange_weak(Expected, Grand,
+                                               std::memory_order_relaxed);
+        }
+
+        Idx = Grand;
+    }
+}
+
+static void
+SmlInt_Union(std::atomic<sml_u32> *Parents, sml_u32 A, sml_u32 B)
+{
+    for(;;)
+    {
+        A = SmlInt_FindRoot(Parents, A);
+        B = SmlInt_FindRoot(Parents, B);
+
+        if(A == B) return;
+
+        if(A < B)
+        {
+            sml_u32 Temp = A;
+            A            = B;
+            B            = Temp;
+        }
+
+        sml_u32 Expected = A;
+        if(Parents[A].compare_exchange_strong(Expected, B, std::memory_order_relaxed))
+        {
+            return;
+        }
+    }
+}
+
+// NOTE: Neighbors whose normals are within the slope threshold of each other
+// end up in the same cluster, the connected components of that graph.
+
+static dynamic_array<dynamic_array<sml_tri>>
+SmlInt_BuildPolygonClusters(sml_walkable_list *List, sml_u32 ThreadCount = 1)
+{
+    sml_u32 TriCount = List->Walkable.Count;
+
+    auto  ParentHeap = SmlMemory.Allocate(TriCount * sizeof(std::atomic<sml_u32>));
+    auto *Parents    = (std::atomic<sml_u32>*)ParentHeap.Data;
+
+    Sml_ParallelFor(TriCount, SmlNavChunkSize, ThreadCount,
+    [&](sml_u32 Begin, sml_u32 End, sml_u32)
+    {
+        for(sml_u32 TriIdx = Begin; TriIdx < End; TriIdx++)
+        {
+            Parents[TriIdx].store(TriIdx, std::memory_order_relaxed);
+        }
+    });
+
+    Sml_ParallelFor(TriCount, SmlNavChunkSize, ThreadCount,
+    [&](sml_u32 Begin, sml_u32 End, sml_u32)
+    {
+        for(sml_u32 TriIdx = Begin; TriIdx < End; TriIdx++)
+        {
+            auto Neighbors = List->Neighbors[TriIdx];
+            auto Normal    = List->Walkable[TriIdx].Normal;
+
+            for(sml_u32 NIdx = 0; NIdx < Neighbors.Count; NIdx++)
+            {
+                sml_tri Neighbor = Neighbors.Tris[NIdx];
+
+                if(Neighbor < TriIdx) continue;
+
+                auto NeighborNormal = List->Walkable[Neighbor].Normal;
+                if(SmlVec3_Dot(Normal, NeighborNormal) >= List->SlopeThresold)
+                {
+                    SmlInt_Union(Parents, TriIdx, Neighbor);
+                }
+            }
+        }
+    });
+
+    auto Roots = dynamic_array<sml_u32>(TriCount, false);
+
+    Sml_ParallelFor(TriCount, SmlNavChunkSize, ThreadCount,
+    [&](sml_u32 Begin, sml_u32 End, sml_u32)
+    {
+        for(sml_u32 TriIdx = Begin; TriIdx < End; TriIdx++)
+        {
+            Roots[TriIdx] = SmlInt_FindRoot(Parents, TriIdx);
+        }
+    });
+
+    SmlMemory.Free(ParentHeap);
+
+    // Roots come before the rest of their set, so one pass numbers the clusters.
+    auto ClusterOf = dynamic_array<sml_u32>(TriCount, false);
+    auto Sizes     = dynamic_array<sml_u32>(0);
+
+    for(sml_u32 TriIdx = 0; TriIdx < TriCount; TriIdx++)
+    {
+        if(Roots[TriIdx] == TriIdx)
+        {
+            ClusterOf[TriIdx] = Sizes.Count;
+            Sizes.Push(0);
+        }
+        else
+        {
+            ClusterOf[TriIdx] = ClusterOf[Roots[TriIdx]];
+        }
+
+        Sizes[ClusterOf[TriIdx]]++;
+    }
+
+    auto Clusters = dynamic_array<dynamic_array<sml_tri>>(Sizes.Count);
+
+    for(sml_u32 ClusterIdx = 0; ClusterIdx < Sizes.Count; ClusterIdx++)
+    {
+        Clusters.Push(dynamic_array<sml_tri>(Sizes[ClusterIdx], false));
+    }
+
+    for(sml_u32 TriIdx = 0; TriIdx < TriCount; TriIdx++)
+    {
+        auto &Cluster = Clusters[ClusterOf[TriIdx]];
+        Cluster.Values[Cluster.Count++] = TriIdx;
+    }
+
+    Roots.Free();
+    ClusterOf.Free();
+    Sizes.Free();
+
+    return Clusters;
+}
+
+// Triangulation
+// ===================================
+
+// NOTE: A simple polygon with N vertices has exactly N - 2 triangles.
+
+static inline sml_u32
+SmlInt_TriangulateIndexCount(sml_u32 VertexCount)
+{
+    return VertexCount >= 3 ? (VertexCount - 2) * 3 : 0;
+}
+
+// NOTE: Sweep order, top to bottom then left to right. Ties on equal points go
+// to the index so the order is total.
+
+static inline bool
+SmlInt_IsAbove(const sml_vector2 &A, const sml_vector2 &B)
+{
+    return A.y > B.y || (A.y == B.y && A.x < B.x);
+}
+
+static int
+SmlInt_CompareSweepKeys(const void *Left, const void *Right)
+{
+    const sml_sweep_key *A = (const sml_sweep_key*)Left;
+    const sml_sweep_key *B = (const sml_sweep_key*)Right;
+
+    if(A->y != B->y) return A->y > B->y ? -1 : 1;
+    if(A->x != B->x) return A->x < B->x ? -1 : 1;
+
+    return A->Index < B->Index ? -1 : (A->Index > B->Index);
+}
+
+static int
+SmlInt_CompareHalfEdges(const void *Left, const void *Right)
+{
+    const sml_half_edge *A = (const sml_half_edge*)Left;
+    const sml_half_edge *B = (const sml_half_edge*)Right;
+
+    if(A->From  != B->From)  return A->From  < B->From  ? -1 : 1;
+    if(A->Angle != B->Angle) return A->Angle < B->Angle ? -1 : 1;
+
+    return A->To < B->To ? -1 : (A->To > B->To);
+}
+
+static inline void
+SmlInt_EmitTriangle(sml_triangulator *Tri, sml_u32 A, sml_u32 B, sml_u32 C)
+{
+    if(Tri->IndexCount + 3 > SmlInt_TriangulateIndexCount(Tri->Count)) return;
+
+    if(SmlInt_SignedArea(Tri->Points + A, Tri->Points + B, Tri->Points + C) < 0.0f)
+    {
+        sml_u32 Temp = B;
+        B = C;
+        C = Temp;
+    }
+
+    sml_u32 *Out = Tri->Indices + Tri->IndexCount;
+
+    Out[0] = Tri->Map[A];
+    Out[1] = Tri->Map[Tri->Flip ? C : B];
+    Out[2] = Tri->Map[Tri->Flip ? B : C];
+
+    Tri->IndexCount += 3;
+}
+
+// NOTE: X of edge (Edge, Edge + 1) at the height of the sweep line. Horizontal
+// edges only live in the status between their two end points, use the start.
+
+static inline sml_f32
+SmlInt_SweepEdgeX(sml_triangulator *Tri, sml_u32 Edge, sml_f32 y)
+{
+    sml_vector2 A = Tri->Points[Edge];
+    sml_vector2 B = Tri->Points[(Edge + 1) % Tri->Count];
+
+    if(A.y == B.y) return A.x;
+
+    return A.x + (y - A.y) * (B.x - A.x) / (B.y - A.y);
+}
+
+// NOTE: The status holds the edges cut by the sweep line with the interior on
+// their right, sorted left to right. Edges never cross so the order holds
+// between events. Returns how many edges are strictly left of Point.
+
+static sml_u32
+SmlInt_SweepLowerBound(sml_triangulator *Tri, sml_u32 *Status, sml_u32 StatusCount,
+                       sml_vector2 Point)
+{
+    sml_u32 Low  = 0;
+    sml_u32 High = StatusCount;
+
+    while(Low < High)
+    {
+        sml_u32 Mid = (Low + High) / 2;
+
+        if(SmlInt_SweepEdgeX(Tri, Status[Mid], Point.y) < Point.x) Low  = Mid + 1;
+        else                                                        High = Mid;
+    }
+
+    return Low;
+}
+
+static bool
+SmlInt_SweepRemove(sml_triangulator *Tri, sml_u32 *Status, sml_u32 *StatusCount,
+                   sml_u32 Edge, sml_vector2 Point)
+{
+    // The edge ends at Point, search outward from where that x sorts.
+    sml_u32 Count = *StatusCount;
+    sml_u32 Start = SmlInt_SweepLowerBound(Tri, Status, Count, Point);
+
+    for(sml_u32 Offset = 0; Offset < Count; Offset++)
+    {
+        sml_u32 Candidates[2] = {Start + Offset, Start - 1 - Offset};
+
+        for(sml_u32 Pos : Candidates)
+        {
+            if(Pos >= Count || Status[Pos] != Edge) continue;
+
+            memmove(Status + Pos, Status + Pos + 1, (Count - Pos - 1) * sizeof(sml_u32));
+            *StatusCount = Count - 1;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void
+SmlInt_SweepInsert(sml_triangulator *Tri, sml_u32 *Status, sml_u32 *StatusCount,
+                   sml_u32 Edge)
+{
+    sml_u32 Count = *StatusCount;
+    sml_u32 Pos   = SmlInt_SweepLowerBound(Tri, Status, Count, Tri->Points[Edge]);
+
+    memmove(Status + Pos + 1, Status + Pos, (Count - Pos) * sizeof(sml_u32));
+    Status[Pos]  = Edge;
+    *StatusCount = Count + 1;
+}
+
+// NOTE: Plane sweep of de Berg et al. Adds the diagonals removing every split
+// and merge vertex, which leaves y-monotone pieces. Returns the diagonal count
+// or ~0u on inputs it cannot handle.
+
+static sml_u32
+SmlInt_MonotoneDiagonals(sml_triangulator *Tri, sml_u32 *Diagonals)
+{
+    sml_u32      Count  = Tri->Count;
+    sml_vector2 *Points = Tri->Points;
+
+    sml_sweep_key *Keys    = Tri->Scratch<sml_sweep_key>(Count);
+    sml_u8        *Types   = Tri->Scratch<sml_u8>(Count);
+    sml_u32       *Helpers = Tri->Scratch<sml_u32>(Count);
+    sml_u32       *Status  = Tri->Scratch<sml_u32>(Count);
+
+    for(sml_u32 Idx = 0; Idx < Count; Idx++)
+    {
+        sml_u32 Prev = (Idx + Count - 1) % Count;
+        sml_u32 Next = (Idx + 1) % Count;
+
+        bool PrevAbove = SmlInt_IsAbove(Points[Prev], Points[Idx]);
+        bool NextAbove = SmlInt_IsAbove(Points[Next], Points[Idx]);
+        bool Convex    = SmlInt_SignedArea(Points + Prev, Points + Idx,
+                                           Points + Next) > 0.0f;
+
+        if(Points[Prev].x == Points[Idx].x && Points[Prev].y == Points[Idx].y) return ~0u;
+
+        if(!PrevAbove && !NextAbove)
+        {
+            Types[Idx] = Convex ? SmlSweep_Start : SmlSweep_Split;
+        }
+        else if(PrevAbove && NextAbove)
+        {
+            Types[Idx] = Convex ? SmlSweep_End : SmlSweep_Merge;
+        }
+        else
+        {
+            Types[Idx] = SmlSweep_Regular;
+        }
+
+        Keys[Idx] = {Points[Idx].y, Points[Idx].x, Idx};
+    }
+
+    qsort(Keys, Count, sizeof(sml_sweep_key), SmlInt_CompareSweepKeys);
+
+    sml_u32 StatusCount   = 0;
+    sml_u32 DiagonalCount = 0;
+
+    auto AddDiagonal = [&](sml_u32 From, sml_u32 To)
+    {
+        Diagonals[DiagonalCount * 2 + 0] = From;
+        Diagonals[DiagonalCount * 2 + 1] = To;
+        DiagonalCount++;
+    };
+
+    // A merge vertex left as helper is connected to the next vertex below it.
+    auto ResolveMerge = [&](sml_u32 Vertex, sml_u32 Edge)
+    {
+        if(Types[Helpers[Edge]] == SmlSweep_Merge) AddDiagonal(Vertex, Helpers[Edge]);
+    };
+
+    for(sml_u32 KeyIdx = 0; KeyIdx < Count; KeyIdx++)
+    {
+        sml_u32     Vertex = Keys[KeyIdx].Index;
+        sml_u32     Prev   = (Vertex + Count - 1) % Count;
+        sml_vector2 Point  = Points[Vertex];
+
+        // Edge directly left of Vertex, needed by split, merge and regular
+        // vertices with the interior on their left.
+        auto LeftEdge = [&]() -> sml_u32
+        {
+            sml_u32 Pos = SmlInt_SweepLowerBound(Tri, Status, StatusCount, Point);
+            return Pos > 0 ? Status[Pos - 1] : ~0u;
+        };
+
+        switch(Types[Vertex])
+        {
+
+        case SmlSweep_Start:
+        {
+            SmlInt_SweepInsert(Tri, Status, &StatusCount, Vertex);
+            Helpers[Vertex] = Vertex;
+        } break;
+
+        case SmlSweep_End:
+        {
+            ResolveMerge(Vertex, Prev);
+            if(!SmlInt_SweepRemove(Tri, Status, &StatusCount, Prev, Point)) return ~0u;
+        } break;
+
+        case SmlSweep_Split:
+        {
+            sml_u32 Left = LeftEdge();
+            if(Left == ~0u) return ~0u;
+
+            AddDiagonal(Vertex, Helpers[Left]);
+            Helpers[Left] = Vertex;
+
+            SmlInt_SweepInsert(Tri, Status, &StatusCount, Vertex);
+            Helpers[Vertex] = Vertex;
+        } break;
+
+        case SmlSweep_Merge:
+        {
+            ResolveMerge(Vertex, Prev);
+            if(!SmlInt_SweepRemove(Tri, Status, &StatusCount, Prev, Point)) return ~0u;
+
+            sml_u32 Left = LeftEdge();
+            if(Left == ~0u) return ~0u;
+
+            ResolveMerge(Vertex, Left);
+            Helpers[Left] = Vertex;
+        } break;
+
+        case SmlSweep_Regular:
+        {
+            // Going down the boundary, the interior is on the right.
+            if(SmlInt_IsAbove(Points[Prev], Point))
+            {
+                ResolveMerge(Vertex, Prev);
+                if(!SmlInt_SweepRemove(Tri, Status, &StatusCount, Prev, Point))
+                {
+                    return ~0u;
+                }
+
+                SmlInt_SweepInsert(Tri, Status, &StatusCount, Vertex);
+                Helpers[Vertex] = Vertex;
+            }
+            else
+            {
+                sml_u32 Left = LeftEdge();
+                if(Left == ~0u) return ~0u;
+
+                ResolveMerge(Vertex, Left);
+                Helpers[Left] = Vertex;
+            }
+        } break;
+
+        }
+    }
+
+    return DiagonalCount;
+}
+
+// NOTE: Face is counter-clockwise and y-monotone. Walks both chains from the
+// top in sweep order and cuts off every triangle it can with a stack.
+
+static bool
+SmlInt_TriangulateMonotonePiece(sml_triangulator *Tri, sml_u32 *Face, sml_u32 Count,
+                                sml_u32 *Sorted, sml_u8 *Sides, sml_u32 *Stack)
+{
+    sml_vector2 *Points = Tri->Points;
+
+    if(Count < 3) return false;
+
+    sml_u32 Top = 0, Bottom = 0;
+    for(sml_u32 Idx = 1; Idx < Count; Idx++)
+    {
+        if(SmlInt_IsAbove(Points[Face[Idx]], Points[Face[Top]]))    Top    = Idx;
+        if(SmlInt_IsAbove(Points[Face[Bottom]], Points[Face[Idx]])) Bottom = Idx;
+    }
+
+    // Counter-clockwise from the top goes down the left chain (side 0).
+    sml_u32 Left  = (Top + 1) % Count;
+    sml_u32 Right = (Top + Count - 1) % Count;
+
+    Sorted[0] = Face[Top];
+    Sides[0]  = 0;
+
+    for(sml_u32 Idx = 1; Idx + 1 < Count; Idx++)
+    {
+        bool TakeLeft = Right == Bottom ||
+                        (Left != Bottom &&
+                         SmlInt_IsAbove(Points[Face[Left]], Points[Face[Right]]));
+
+        if(TakeLeft)
+        {
+            Sorted[Idx] = Face[Left];
+            Sides[Idx]  = 0;
+            Left        = (Left + 1) % Count;
+        }
+        else
+        {
+            Sorted[Idx] = Face[Right];
+            Sides[Idx]  = 1;
+            Right       = (Right + Count - 1) % Count;
+        }
+    }
+
+    Sorted[Count - 1] = Face[Bottom];
+
+    sml_u32 StackCount = 0;
+    Stack[StackCount++] = 0;
+    Stack[StackCount++] = 1;
+
+    for(sml_u32 Idx = 2; Idx + 1 < Count; Idx++)
+    {
+        if(Sides[Idx] != Sides[Stack[StackCount - 1]])
+        {
+            while(StackCount > 1)
+            {
+                SmlInt_EmitTriangle(Tri, Sorted[Idx], Sorted[Stack[StackCount - 1]],
+                                    Sorted[Stack[StackCount - 2]]);
+                StackCount--;
+            }
+
+            StackCount = 0;
+            Stack[StackCount++] = Idx - 1;
+            Stack[StackCount++] = Idx;
+        }
+        else
+        {
+            sml_u32 Last = Stack[--StackCount];
+
+            while(StackCount > 0)
+            {
+                sml_vector2 *Current   = Points + Sorted[Idx];
+                sml_vector2 *Previous  = Points + Sorted[Last];
+                sml_vector2 *Candidate = Points + Sorted[Stack[StackCount - 1]];
+
+                // The diagonal is inside when the chain turns toward the
+                // interior at Previous.
+                sml_f32 Turn = Sides[Idx] == 0 ?
+                               SmlInt_SignedArea(Candidate, Previous, Current) :
+                               SmlInt_SignedArea(Current, Previous, Candidate);
+
+                if(Turn <= 0.0f) break;
+
+                SmlInt_EmitTriangle(Tri, Sorted[Idx], Sorted[Last],
+                                    Sorted[Stack[StackCount - 1]]);
+
+                Last = Stack[--StackCount];
+            }
+
+            Stack[StackCount++] = Last;
+            Stack[StackCount++] = Idx;
+        }
+    }
+
+    while(StackCount > 1)
+    {
+        SmlInt_EmitTriangle(Tri, Sorted[Count - 1], Sorted[Stack[StackCount - 1]],
+                            Sorted[Stack[StackCount - 2]]);
+        StackCount--;
+    }
+
+    return true;
+}
+
+static bool
+SmlInt_TriangulateMonotone(sml_triangulator *Tri)
+{
+    sml_u32      Count  = Tri->Count;
+    sml_vector2 *Points = Tri->Points;
+
+    // Every event adds at most 2 diagonals.
+    sml_u32 *Diagonals     = Tri->Scratch<sml_u32>(Count * 4);
+    sml_u32  DiagonalCount = SmlInt_MonotoneDiagonals(Tri, Diagonals);
+
+    if(DiagonalCount == ~0u) return false;
+
+    // Half-edges of the pieces: the boundary (Idx -> Idx + 1) and both sides of
+    // each diagonal. Around each vertex they are sorted by angle from its
+    // boundary edge, so walking a piece is a lookup in that order.
+    sml_u32        EdgeCount = Count + DiagonalCount * 2;
+    sml_half_edge *Edges     = Tri->Scratch<sml_half_edge>(EdgeCount);
+    sml_u32       *Order     = Tri->Scratch<sml_u32>(EdgeCount);
+    sml_u32       *Offsets   = Tri->Scratch<sml_u32>(Count + 1);
+    sml_u8        *Visited   = Tri->Scratch<sml_u8>(EdgeCount);
+
+    for(sml_u32 Idx = 0; Idx < EdgeCount; Idx++)
+    {
+        sml_half_edge *Edge = Edges + Idx;
+
+        if(Idx < Count)
+        {
+            Edge->From = Idx;
+            Edge->To   = (Idx + 1) % Count;
+        }
+        else
+        {
+            sml_u32 Diagonal = (Idx - Count) / 2;
+            sml_u32 Side     = (Idx - Count) % 2;
+
+            Edge->From = Diagonals[Diagonal * 2 + Side];
+            Edge->To   = Diagonals[Diagonal * 2 + 1 - Side];
+        }
+
+        sml_vector2 Origin    = Points[Edge->From];
+        sml_vector2 Reference = Points[(Edge->From + 1) % Count];
+        sml_vector2 Target    = Points[Edge->To];
+
+        sml_f32 RX = Reference.x - Origin.x, RY = Reference.y - Origin.y;
+        sml_f32 TX = Target.x    - Origin.x, TY = Target.y    - Origin.y;
+
+        Edge->Angle = Idx < Count ? 0.0f : atan2f(RX * TY - RY * TX, RX * TX + RY * TY);
+        if(Edge->Angle < 0.0f) Edge->Angle += 2.0f * F_PI;
+
+        Edge->Next = Idx;
+        Visited[Idx] = 0;
+    }
+
+    // Sort a copy to get the angular order, then point each edge at its slot.
+    sml_half_edge *SortedEdges = Tri->Scratch<sml_half_edge>(EdgeCount);
+    memcpy(SortedEdges, Edges, EdgeCount * sizeof(sml_half_edge));
+
+    for(sml_u32 Idx = 0; Idx < EdgeCount; Idx++) SortedEdges[Idx].Next = Idx;
+
+    qsort(SortedEdges, EdgeCount, sizeof(sml_half_edge), SmlInt_CompareHalfEdges);
+
+    memset(Offsets, 0, (Count + 1) * sizeof(sml_u32));
+
+    for(sml_u32 Slot = 0; Slot < EdgeCount; Slot++)
+    {
+        sml_u32 Idx = SortedEdges[Slot].Next;
+
+        Order[Slot]     = Idx;
+        Edges[Idx].Slot = Slot;
+
+        Offsets[Edges[Idx].From + 1]++;
+    }
+
+    for(sml_u32 Idx = 0; Idx < Count; Idx++) Offsets[Idx + 1] += Offsets[Idx];
+
+    // The next edge of the piece left of U -> V is the one after V -> U going
+    // clockwise around V. The boundary edge into V comes in at the end of the
+    // interior wedge, so it continues with the last edge leaving V.
+    for(sml_u32 Idx = 0; Idx < EdgeCount; Idx++)
+    {
+        sml_u32 Vertex = Edges[Idx].To;
+
+        if(Idx < Count)
+        {
+            Edges[Idx].Next = Order[Offsets[Vertex + 1] - 1];
+        }
+        else
+        {
+            sml_u32 Twin = Count + ((Idx - Count) ^ 1);
+            sml_u32 Slot = Edges[Twin].Slot;
+
+            if(Slot == Offsets[Vertex]) return false;
+
+            Edges[Idx].Next = Order[Slot - 1];
+        }
+    }
+
+    sml_u32 *Face   = Tri->Scratch<sml_u32>(Count);
+    sml_u32 *Sorted = Tri->Scratch<sml_u32>(Count);
+    sml_u8  *Sides  = Tri->Scratch<sml_u8>(Count);
+    sml_u32 *Stack  = Tri->Scratch<sml_u32>(Count);
+
+    for(sml_u32 Start = 0; Start < EdgeCount; Start++)
+    {
+        if(Visited[Start]) continue;
+
+        sml_u32 FaceCount = 0;
+        sml_u32 Edge      = Start;
+
+        do
+        {
+            if(Visited[Edge] || FaceCount == Count) return false;
+
+            Visited[Edge]     = 1;
+            Face[FaceCount++] = Edges[Edge].From;
+            Edge              = Edges[Edge].Next;
+        } while(Edge != Start);
+
+        if(!SmlInt_TriangulateMonotonePiece(Tri, Face, FaceCount, Sorted, Sides, Stack))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// NOTE: Reflex vertices are bucketed in a grid over the polygon bounds. Only
+// reflex vertices can be inside an ear, and a vertex never turns reflex once
+// convex, so a vertex leaves the grid by clearing its flag.
+
+static void
+SmlInt_TriangulateEarClip(sml_triangulator *Tri)
+{
+    sml_u32      Count  = Tri->Count;
+    sml_vector2 *Points = Tri->Points;
+
+    sml_u32 *Prev   = Tri->Scratch<sml_u32>(Count);
+    sml_u32 *Next   = Tri->Scratch<sml_u32>(Count);
+    sml_u8  *Reflex = Tri->Scratch<sml_u8>(Count);
+
+    sml_u32     ReflexCount = 0;
+    sml_vector2 Min         = Points[0];
+    sml_vector2 Max         = Points[0];
+
+    for(sml_u32 Idx = 0; Idx < Count; Idx++)
+    {
+        Prev[Idx] = (Idx + Count - 1) % Count;
+        Next[Idx] = (Idx + 1) % Count;
+
+        Reflex[Idx] = SmlInt_SignedArea(Points + Prev[Idx], Points + Idx,
+                                        Points + Next[Idx]) <= 0.0f;
+        ReflexCount += Reflex[Idx];
+
+        Min.x = fminf(Min.x, Points[Idx].x); Min.y = fminf(Min.y, Points[Idx].y);
+        Max.x = fmaxf(Max.x, Points[Idx].x); Max.y = fmaxf(Max.y, Points[Idx].y);
+    }
+
+    sml_u32 CellsPerAxis = (sml_u32)sqrtf((sml_f32)ReflexCount) + 1;
+    sml_u32 CellCount    = CellsPerAxis * CellsPerAxis;
+    sml_f32 CellScaleX   = CellsPerAxis / fmaxf(Max.x - Min.x, 1e-6f);
+    sml_f32 CellScaleY   = CellsPerAxis / fmaxf(Max.y - Min.y, 1e-6f);
+
+    auto CellOf = [&](sml_f32 Value, sml_f32 Origin, sml_f32 Scale) -> sml_u32
+    {
+        sml_i32 Cell = (sml_i32)((Value - Origin) * Scale);
+        return (sml_u32)(Cell < 0 ? 0 : (Cell >= (sml_i32)CellsPerAxis ?
+                                         (sml_i32)CellsPerAxis - 1 : Cell));
+    };
+
+    sml_u32 *CellStart = Tri->Scratch<sml_u32>(CellCount + 1);
+    sml_u32 *CellItems = Tri->Scratch<sml_u32>(ReflexCount + 1);
+
+    memset(CellStart, 0, (CellCount + 1) * sizeof(sml_u32));
+
+    for(sml_u32 Idx = 0; Idx < Count; Idx++)
+    {
+        if(!Reflex[Idx]) continue;
+
+        sml_u32 Cell = CellOf(Points[Idx].y, Min.y, CellScaleY) * CellsPerAxis +
+                       CellOf(Points[Idx].x, Min.x, CellScaleX);
+        CellStart[Cell + 1]++;
+    }
+
+    for(sml_u32 Cell = 0; Cell < CellCount; Cell++)
+    {
+        CellStart[Cell + 1] += CellStart[Cell];
+    }
+
+    for(sml_u32 Idx = 0; Idx < Count; Idx++)
+    {
+        if(!Reflex[Idx]) continue;
+
+        sml_u32 Cell = CellOf(Points[Idx].y, Min.y, CellScaleY) * CellsPerAxis +
+                       CellOf(Points[Idx].x, Min.x, CellScaleX);
+
+        // Filled back to front, so CellStart[Cell + 1] ends up at the first item.
+        CellItems[--CellStart[Cell + 1]] = Idx;
+    }
+
+    for(sml_u32 Cell = 0; Cell < CellCount; Cell++) CellStart[Cell] = CellStart[Cell + 1];
+    CellStart[CellCount] = ReflexCount;
+
+    auto IsEar = [&](sml_u32 Vertex) -> bool
+    {
+        if(Reflex[Vertex]) return false;
+
+        sml_u32      P = Prev[Vertex], N = Next[Vertex];
+        sml_vector2 *A = Points + P, *B = Points + Vertex, *C = Points + N;
+
+        sml_u32 MinX = CellOf(fminf(A->x, fminf(B->x, C->x)), Min.x, CellScaleX);
+        sml_u32 MaxX = CellOf(fmaxf(A->x, fmaxf(B->x, C->x)), Min.x, CellScaleX);
+        sml_u32 MinY = CellOf(fminf(A->y, fminf(B->y, C->y)), Min.y, CellScaleY);
+        sml_u32 MaxY = CellOf(fmaxf(A->y, fmaxf(B->y, C->y)), Min.y, CellScaleY);
+
+        for(sml_u32 CellY = MinY; CellY <= MaxY; CellY++)
+        {
+            for(sml_u32 CellX = MinX; CellX <= MaxX; CellX++)
+            {
+                sml_u32 Cell = CellY * CellsPerAxis + CellX;
+
+                for(sml_u32 Item = CellStart[Cell]; Item < CellStart[Cell + 1]; Item++)
+                {
+                    sml_u32      Other = CellItems[Item];
+                    sml_vector2 *Q     = Points + Other;
+
+                    if(!Reflex[Other] || Other == P || Other == N) continue;
+
+                    // Duplicated points, where a hole is bridged to the outline.
+                    bool OnCorner = (Q->x == A->x && Q->y == A->y) ||
+                                    (Q->x == B->x && Q->y == B->y) ||
+                                    (Q->x == C->x && Q->y == C->y);
+                    if(OnCorner) continue;
+
+                    if(SmlInt_SignedArea(A, B, Q) >= 0.0f &&
+                       SmlInt_SignedArea(B, C, Q) >= 0.0f &&
+                       SmlInt_SignedArea(C, A, Q) >= 0.0f)
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+
+        return true;
+    };
+
+    sml_u32 Remaining = Count;
+    sml_u32 Vertex    = 0;
+    sml_u32 Misses    = 0;
+
+    while(Remaining > 3)
+    {
+        // A full loop without an ear only happens on degenerate input, clip
+        // anyway so the index count stays N - 2 triangles.
+        if(IsEar(Vertex) || Misses >= Remaining)
+        {
+            sml_u32 P = Prev[Vertex], N = Next[Vertex];
+
+            SmlInt_EmitTriangle(Tri, P, Vertex, N);
+
+            Next[P] = N;
+            Prev[N] = P;
+
+            Reflex[Vertex] = 0;
+            Remaining--;
+            Misses = 0;
+
+            sml_u32 Neighbors[2] = {P, N};
+            for(sml_u32 Neighbor : Neighbors)
+            {
+                if(Reflex[Neighbor] &&
+                   SmlInt_SignedArea(Points + Prev[Neighbor], Points + Neighbor,
+                                     Points + Next[Neighbor]) > 0.0f)
+                {
+                    Reflex[Neighbor] = 0;
+                }
+            }
+
+            Vertex = P;
+        }
+        else
+        {
+            Vertex = Next[Vertex];
+            Misses++;
+        }
+    }
+
+    SmlInt_EmitTriangle(Tri, Prev[Vertex], Vertex, Next[Vertex]);
+}
+
+// NOTE: The triangles must cover the polygon without overlap: their areas sum
+// to the polygon area. Catches a sweep that went wrong on degenerate input.
+
+static bool
+SmlInt_ValidateTriangles(const sml_vector2 *Polygon, sml_u32 *Indices, sml_u32 Count,
+                         sml_f64 PolygonArea)
+{
+    sml_f64 Area = 0.0;
+
+    for(sml_u32 Idx = 0; Idx + 2 < Count; Idx += 3)
+    {
+        sml_vector2 A = Polygon[Indices[Idx + 0]];
+        sml_vector2 B = Polygon[Indices[Idx + 1]];
+        sml_vector2 C = Polygon[Indices[Idx + 2]];
+
+        Area += fabs(((sml_f64)B.x - A.x) * ((sml_f64)C.y - A.y) -
+                     ((sml_f64)B.y - A.y) * ((sml_f64)C.x - A.x));
+    }
+
+    return fabs(Area - PolygonArea) <= 1e-4 * PolygonArea + 1e-9;
+}
+
+// NOTE: Writes up to SmlInt_TriangulateIndexCount(Count) indices into
+// OutIndices and returns how many were written.
+
+static sml_u32
+SmlInt_Triangulate(const sml_vector2 *Polygon, sml_u32 Count, sml_u32 *OutIndices,
+                   SmlTriangulate_Method Method)
+{
+    if(Count < 3) return 0;
+
+    sml_u32 IndexCount = 0;
+
+    switch(Method)
+    {
+
+    case SmlTriangulate_Fan:
+    {
+        for(sml_u32 Idx = 1; Idx + 1 < Count; Idx++)
+        {
+            OutIndices[IndexCount++] = 0;
+            OutIndices[IndexCount++] = Idx;
+            OutIndices[IndexCount++] = Idx + 1;
+        }
+    } break;
+
+    case SmlTriangulate_Monotone:
+    case SmlTriangulate_EarClip:
+    {
+        // Twice the signed area, positive when counter-clockwise.
+        sml_f64 Area = 0.0;
+        for(sml_u32 Idx = 0; Idx < Count; Idx++)
+        {
+            sml_vector2 A = Polygon[Idx];
+            sml_vector2 B = Polygon[(Idx + 1) % Count];
+
+            Area += (sml_f64)A.x * B.y - (sml_f64)B.x * A.y;
+        }
+
+        sml_triangulator Tri = {};
+        Tri.Count   = Count;
+        Tri.Flip    = Area < 0.0;
+        Tri.Indices = OutIndices;
+
+        // Upper bound of what the scratch arrays take, see the Scratch calls.
+        size_t Bytes = (size_t)Count * (2 * sizeof(sml_half_edge) * 5 + 128) + 512;
+
+        Tri.Heap = SmlMemory.Allocate(Bytes);
+        Tri.At   = (sml_u8*)Tri.Heap.Data;
+        Tri.End  = Tri.At + Bytes;
+
+        Tri.Points = Tri.Scratch<sml_vector2>(Count);
+        Tri.Map    = Tri.Scratch<sml_u32>(Count);
+
+        for(sml_u32 Idx = 0; Idx < Count; Idx++)
+        {
+            Tri.Map[Idx]    = Tri.Flip ? Count - 1 - Idx : Idx;
+            Tri.Points[Idx] = Polygon[Tri.Map[Idx]];
+        }
+
+        sml_u8 *Base = Tri.At;
+
+        bool Done = false;
+        if(Method == SmlTriangulate_Monotone)
+        {
+            Done = SmlInt_TriangulateMonotone(&Tri) &&
+                   Tri.IndexCount == SmlInt_TriangulateIndexCount(Count) &&
+                   SmlInt_ValidateTriangles(Polygon, OutIndices, Tri.IndexCount,
+                                            fabs(Area));
+        }
+
+        if(!Done)
+        {
+            Tri.IndexCount = 0;
+            Tri.At         = Base;
+
+            SmlInt_TriangulateEarClip(&Tri);
+        }
+
+        IndexCount = Tri.IndexCount;
+
+        SmlMemory.Free(Tri.Heap);
+    } break;
+
+    default:
+        Sml_Assert(!"Invalid triangulation method.");
+        break;
+
+    }
+
+    Sml_Assert(IndexCount % 3 == 0);
+
+    return IndexCount;
+}
+
+static dynamic_array<sml_u32>
+SmlInt_Triangulate(dynamic_array<sml_vector2> Polygon, SmlTriangulate_Method Method)
+{
+    auto IdxList = dynamic_array<sml_u32>(SmlInt_TriangulateIndexCount(Polygon.Count));
+
+    IdxList.Count = SmlInt_Triangulate(Polygon.Values, Polygon.Count, IdxList.Values,
+                                       Method);
+
+    return IdxList;
+}
+
+// Loop simplification
+// ===================================
+
+struct sml_loop_range
+{
+    sml_u32 First, Last;
+};
+
+// NOTE: Below this fraction of the span, a vertex counts as lying on it.
+constexpr sml_f32 SmlCollinearTolerance = 1e-4f;
+
+static inline sml_f32
+SmlInt_SegmentDistanceSq(sml_vector3 Point, sml_vector3 A, sml_vector3 B)
+{
+    sml_vector3 Segment  = B - A;
+    sml_vector3 ToPoint  = Point - A;
+    sml_f32     LengthSq = SmlVec3_Dot(Segment, Segment);
+
+    sml_f32 T = LengthSq > 0.0f ? SmlVec3_Dot(ToPoint, Segment) / LengthSq : 0.0f;
+    T = fminf(fmaxf(T, 0.0f), 1.0f);
+
+    sml_vector3 Offset = ToPoint - SmlVec3_Scale(Segment, T);
+
+    return SmlVec3_Dot(Offset, Offset);
+}
+
+// NOTE: Point is on the segment AB, not past either end. Spikes going back
+// along the same line are kept.
+
+static inline bool
+SmlInt_IsCollinear(const sml_vector3 *Positions, sml_point A, sml_point Point,
+                   sml_point B)
+{
+    sml_vector3 Span      = Positions[B] - Positions[A];
+    sml_f32     Tolerance = SmlCollinearTolerance * SmlCollinearTolerance *
+                            SmlVec3_Dot(Span, Span);
+
+    return SmlInt_SegmentDistanceSq(Positions[Point], Positions[A],
+                                    Positions[B]) <= Tolerance;
+}
+
+// NOTE: Removes, in place, the vertices of a closed loop that lie on the
+// segment between their neighbors. Linear, each vertex is popped once.
+
+static sml_u32
+SmlInt_RemoveCollinear(const sml_vector3 *Positions, sml_point *Loop, sml_u32 Count)
+{
+    sml_u32 Kept = 0;
+
+    for(sml_u32 Idx = 0; Idx < Count; Idx++)
+    {
+        while(Kept >= 2 && SmlInt_IsCollinear(Positions, Loop[Kept - 2], Loop[Kept - 1],
+                                              Loop[Idx]))
+        {
+            Kept--;
+        }
+
+        Loop[Kept++] = Loop[Idx];
+    }
+
+    // The seam between the last and the first vertex.
+    while(Kept > 3)
+    {
+        if(SmlInt_IsCollinear(Positions, Loop[Kept - 2], Loop[Kept - 1], Loop[0]))
+        {
+            Kept--;
+        }
+        else if(SmlInt_IsCollinear(Positions, Loop[Kept - 1], Loop[0], Loop[1]))
+        {
+            memmove(Loop, Loop + 1, (Kept - 1) * sizeof(sml_point));
+            Kept--;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    return Kept;
+}
+
+// NOTE:
+// 1) Closed loop Douglas-Peucker. The first vertex and the one farthest from it
+//    split the loop in two chains, each is then refined until every dropped
+//    vertex is within MaxError (world units) of the simplified outline.
+// 2) Collinear vertices go first, so MaxError = 0 only does that lossless pass.
+// 3) Rewrites Loop in place and returns the new count, at least 3 vertices are
+//    kept when the loop had them.
+
+static sml_u32
+SmlInt_SimplifyLoop(const sml_vector3 *Positions, sml_point *Loop, sml_u32 Count,
+                    sml_f32 MaxError)
+{
+    Count = SmlInt_RemoveCollinear(Positions, Loop, Count);
+
+    if(MaxError <= 0.0f || Count <= 3) return Count;
+
+    sml_u32 Far     = 0;
+    sml_f32 FarDist = 0.0f;
+
+    for(sml_u32 Idx = 1; Idx < Count; Idx++)
+    {
+        sml_vector3 Offset = Positions[Loop[Idx]] - Positions[Loop[0]];
+        sml_f32     Dist   = SmlVec3_Dot(Offset, Offset);
+
+        if(Dist > FarDist)
+        {
+            Far     = Idx;
+            FarDist = Dist;
+        }
+    }
+
+    if(Far == 0) return Count;
+
+    auto Keep   = dynamic_array<sml_u8>(Count);
+    auto Ranges = stack<sml_loop_range>(16, true);
+
+    Keep[0]   = 1;
+    Keep[Far] = 1;
+
+    // Index Count stands for vertex 0 closing the loop.
+    sml_loop_range Chains[2] = {{0, Far}, {Far, Count}};
+    Ranges.Push(Chains[0]);
+    Ranges.Push(Chains[1]);
+
+    sml_f32 MaxErrorSq = MaxError * MaxError;
+    sml_u32 Widest     = 0;
+    sml_f32 WidestDist = 0.0f;
+
+    while(!Ranges.Empty())
+    {
+        sml_loop_range Range = Ranges.Pop();
+
+        sml_vector3 A = Positions[Loop[Range.First]];
+        sml_vector3 B = Positions[Loop[Range.Last % Count]];
+
+        sml_u32 Split     = Range.First;
+        sml_f32 SplitDist = 0.0f;
+
+        for(sml_u32 Idx = Range.First + 1; Idx < Range.Last; Idx++)
+        {
+            sml_f32 Dist = SmlInt_SegmentDistanceSq(Positions[Loop[Idx]], A, B);
+
+            if(Dist > SplitDist)
+            {
+                Split     = Idx;
+                SplitDist = Dist;
+            }
+        }
+
+        if(SplitDist > WidestDist)
+        {
+            Widest     = Split;
+            WidestDist = SplitDist;
+        }
+
+        if(SplitDist > MaxErrorSq)
+        {
+            Keep[Split] = 1;
+
+            sml_loop_range Before = {Range.First, Split};
+            sml_loop_range After  = {Split, Range.Last};
+            Ranges.Push(Before);
+            Ranges.Push(After);
+        }
+    }
+
+    // A sliver thinner than MaxError would collapse to a segment.
+    Keep[Widest] = 1;
+
+    sml_u32 Kept = 0;
+    for(sml_u32 Idx = 0; Idx < Count; Idx++)
+    {
+        if(Keep[Idx]) Loop[Kept++] = Loop[Idx];
+    }
+
+    Keep.Free();
+    Ranges.Free();
+
+    return Kept;
 }
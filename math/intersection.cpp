@@ -0,0 +1,830 @@
+// ===================================
+// Type Definitions
+// ===================================
+
+// NOTE:
+// 1) One ray against many triangles or boxes. Triangles are kept as a vertex
+//    plus two edges in structure-of-arrays, boxes reuse sml_box_bounds (center
+//    + half extents) from the frustum code.
+// 2) Closest queries keep the best hit per lane and reduce once at the end.
+//    Ties go to the lowest index on every path. Any queries (line of sight)
+//    return on the first group with a hit.
+// 3) Triangles are two sided. Hits at distance 0 are ignored so a ray cast
+//    from a surface does not hit it again.
+// 4) Same mul/add order on every path without FMA, so the SIMD results match
+//    the scalar reference.
+
+struct sml_ray
+{
+    sml_vector3 Origin;
+    sml_vector3 Direction;
+    sml_f32     MaxDistance;
+};
+
+struct sml_ray_hit
+{
+    sml_f32 Distance;
+    sml_u32 Index;
+
+    // Barycentrics of V1 and V2, 0 for boxes.
+    sml_f32 U;
+    sml_f32 V;
+
+    static constexpr sml_u32 Invalid = sml_u32(-1);
+};
+
+struct sml_triangle_soup
+{
+    sml_f32 *V0Xs, *V0Ys, *V0Zs;
+    sml_f32 *E1Xs, *E1Ys, *E1Zs;
+    sml_f32 *E2Xs, *E2Ys, *E2Zs;
+
+    sml_u32 Count;
+
+    sml_heap_block Heap;
+
+    sml_triangle_soup(){};
+    sml_triangle_soup(sml_u32 Count)
+    {
+        this->Count = Count;
+        this->Heap  = SmlMemory.Allocate((Count ? Count : 1) * 9 * sizeof(sml_f32));
+
+        sml_f32 *Data = (sml_f32*)this->Heap.Data;
+
+        this->V0Xs = Data + Count * 0; this->V0Ys = Data + Count * 1;
+        this->V0Zs = Data + Count * 2; this->E1Xs = Data + Count * 3;
+        this->E1Ys = Data + Count * 4; this->E1Zs = Data + Count * 5;
+        this->E2Xs = Data + Count * 6; this->E2Ys = Data + Count * 7;
+        this->E2Zs = Data + Count * 8;
+    }
+
+    sml_triangle_soup(sml_vector3 *Positions, sml_u32 *Indices, sml_u32 IdxCount)
+        : sml_triangle_soup(IdxCount / 3)
+    {
+        for(sml_u32 TriIdx = 0; TriIdx < this->Count; TriIdx++)
+        {
+            this->Set(TriIdx, Positions[Indices[TriIdx * 3 + 0]],
+                              Positions[Indices[TriIdx * 3 + 1]],
+                              Positions[Indices[TriIdx * 3 + 2]]);
+        }
+    }
+
+    // NOTE: Hit indices are walkable triangle indices.
+    sml_triangle_soup(sml_walkable_list *List)
+        : sml_triangle_soup(List->Walkable.Count)
+    {
+        for(sml_u32 TriIdx = 0; TriIdx < this->Count; TriIdx++)
+        {
+            sml_point *Points = List->Walkable[TriIdx].Points;
+
+            this->Set(TriIdx, List->Positions[Points[0]],
+                              List->Positions[Points[1]],
+                              List->Positions[Points[2]]);
+        }
+    }
+
+    void Set(sml_u32 Idx, sml_vector3 V0, sml_vector3 V1, sml_vector3 V2)
+    {
+        Sml_Assert(Idx < this->Count);
+
+        sml_vector3 E1 = V1 - V0;
+        sml_vector3 E2 = V2 - V0;
+
+        this->V0Xs[Idx] = V0.x; this->V0Ys[Idx] = V0.y; this->V0Zs[Idx] = V0.z;
+        this->E1Xs[Idx] = E1.x; this->E1Ys[Idx] = E1.y; this->E1Zs[Idx] = E1.z;
+        this->E2Xs[Idx] = E2.x; this->E2Ys[Idx] = E2.y; this->E2Zs[Idx] = E2.z;
+    }
+
+    void Free()
+    {
+        SmlMemory.Free(this->Heap);
+        this->Count = 0;
+    }
+};
+
+// ===================================
+// Internal Helpers
+// ===================================
+
+constexpr sml_f32 SmlInt_RayParallelEpsilon = 1e-8f;
+
+// NOTE: Same semantics as minps/maxps (second operand on NaN), so the scalar
+// slab test agrees with the SIMD one when 0 * inf shows up.
+
+static inline sml_f32
+SmlInt_MinSse(sml_f32 A, sml_f32 B)
+{
+    return A < B ? A : B;
+}
+
+static inline sml_f32
+SmlInt_MaxSse(sml_f32 A, sml_f32 B)
+{
+    return A > B ? A : B;
+}
+
+static inline sml_ray_hit
+SmlInt_RayMiss(const sml_ray &Ray)
+{
+    sml_ray_hit Result = {};
+    Result.Distance = Ray.MaxDistance;
+    Result.Index    = sml_ray_hit::Invalid;
+
+    return Result;
+}
+
+static inline void
+SmlInt_TakeCloserHit(sml_ray_hit *Best, sml_f32 Distance, sml_u32 Index,
+                     sml_f32 U, sml_f32 V)
+{
+    if(Distance < Best->Distance ||
+       (Distance == Best->Distance && Index < Best->Index))
+    {
+        Best->Distance = Distance;
+        Best->Index    = Index;
+        Best->U        = U;
+        Best->V        = V;
+    }
+}
+
+// ===================================
+// Scalar reference
+// ===================================
+
+// NOTE: Moller-Trumbore. Returns true and fills the outputs on a hit in
+// (0, MaxDistance).
+
+static inline bool
+SmlInt_RayTriangleScalar(const sml_ray &Ray, const sml_triangle_soup &Soup,
+                         sml_u32 Idx, sml_f32 MaxDistance,
+                         sml_f32 *OutDistance, sml_f32 *OutU, sml_f32 *OutV)
+{
+    const sml_vector3 &O = Ray.Origin;
+    const sml_vector3 &D = Ray.Direction;
+
+    sml_f32 E1X = Soup.E1Xs[Idx], E1Y = Soup.E1Ys[Idx], E1Z = Soup.E1Zs[Idx];
+    sml_f32 E2X = Soup.E2Xs[Idx], E2Y = Soup.E2Ys[Idx], E2Z = Soup.E2Zs[Idx];
+
+    sml_f32 PX = (D.y * E2Z) - (D.z * E2Y);
+    sml_f32 PY = (D.z * E2X) - (D.x * E2Z);
+    sml_f32 PZ = (D.x * E2Y) - (D.y * E2X);
+
+    sml_f32 Det = ((E1X * PX) + (E1Y * PY)) + (E1Z * PZ);
+    if(!(fabsf(Det) > SmlInt_RayParallelEpsilon)) return false;
+
+    sml_f32 InvDet = 1.0f / Det;
+
+    sml_f32 TX = O.x - Soup.V0Xs[Idx];
+    sml_f32 TY = O.y - Soup.V0Ys[Idx];
+    sml_f32 TZ = O.z - Soup.V0Zs[Idx];
+
+    sml_f32 U = (((TX * PX) + (TY * PY)) + (TZ * PZ)) * InvDet;
+    if(!(U >= 0.0f && U <= 1.0f)) return false;
+
+    sml_f32 QX = (TY * E1Z) - (TZ * E1Y);
+    sml_f32 QY = (TZ * E1X) - (TX * E1Z);
+    sml_f32 QZ = (TX * E1Y) - (TY * E1X);
+
+    sml_f32 V = (((D.x * QX) + (D.y * QY)) + (D.z * QZ)) * InvDet;
+    if(!(V >= 0.0f && (U + V) <= 1.0f)) return false;
+
+    sml_f32 Distance = (((E2X * QX) + (E2Y * QY)) + (E2Z * QZ)) * InvDet;
+    if(!(Distance > 0.0f && Distance < MaxDistance)) return false;
+
+    *OutDistance = Distance;
+    *OutU        = U;
+    *OutV        = V;
+
+    return true;
+}
+
+// NOTE: Entry distance of the ray in the box (0 when the origin is inside).
+
+static inline bool
+SmlInt_RayBoxScalar(const sml_ray &Ray, sml_vector3 InvDir, const sml_box_bounds &Boxes,
+                    sml_u32 Idx, sml_f32 MaxDistance, sml_f32 *OutDistance)
+{
+    const sml_vector3 &O = Ray.Origin;
+
+    sml_f32 MinX = Boxes.Xs[Idx] - Boxes.ExtentXs[Idx];
+    sml_f32 MinY = Boxes.Ys[Idx] - Boxes.ExtentYs[Idx];
+    sml_f32 MinZ = Boxes.Zs[Idx] - Boxes.ExtentZs[Idx];
+    sml_f32 MaxX = Boxes.Xs[Idx] + Boxes.ExtentXs[Idx];
+    sml_f32 MaxY = Boxes.Ys[Idx] + Boxes.ExtentYs[Idx];
+    sml_f32 MaxZ = Boxes.Zs[Idx] + Boxes.ExtentZs[Idx];
+
+    sml_f32 T0X = (MinX - O.x) * InvDir.x, T1X = (MaxX - O.x) * InvDir.x;
+    sml_f32 T0Y = (MinY - O.y) * InvDir.y, T1Y = (MaxY - O.y) * InvDir.y;
+    sml_f32 T0Z = (MinZ - O.z) * InvDir.z, T1Z = (MaxZ - O.z) * InvDir.z;
+
+    sml_f32 Enter = SmlInt_MaxSse(SmlInt_MinSse(T0X, T1X), 0.0f);
+    Enter = SmlInt_MaxSse(SmlInt_MinSse(T0Y, T1Y), Enter);
+    Enter = SmlInt_MaxSse(SmlInt_MinSse(T0Z, T1Z), Enter);
+
+    sml_f32 Exit = SmlInt_MinSse(SmlInt_MaxSse(T0X, T1X), MaxDistance);
+    Exit = SmlInt_MinSse(SmlInt_MaxSse(T0Y, T1Y), Exit);
+    Exit = SmlInt_MinSse(SmlInt_MaxSse(T0Z, T1Z), Exit);
+
+    if(!(Enter <= Exit && Enter < MaxDistance)) return false;
+
+    *OutDistance = Enter;
+
+    return true;
+}
+
+static sml_u32
+SmlInt_RayTrianglesScalar(const sml_ray &Ray, const sml_triangle_soup &Soup,
+                          sml_u32 Start, sml_u32 Count, sml_ray_hit *Best)
+{
+    for(sml_u32 Idx = Start; Idx < Count; Idx++)
+    {
+        sml_f32 Distance, U, V;
+        if(SmlInt_RayTriangleScalar(Ray, Soup, Idx, Best->Distance, &Distance, &U, &V))
+        {
+            SmlInt_TakeCloserHit(Best, Distance, Idx, U, V);
+        }
+    }
+
+    return Count;
+}
+
+static sml_u32
+SmlInt_RayBoxesScalar(const sml_ray &Ray, sml_vector3 InvDir, const sml_box_bounds &Boxes,
+                      sml_u32 Start, sml_u32 Count, sml_ray_hit *Best)
+{
+    for(sml_u32 Idx = Start; Idx < Count; Idx++)
+    {
+        sml_f32 Distance;
+        if(SmlInt_RayBoxScalar(Ray, InvDir, Boxes, Idx, Best->Distance, &Distance))
+        {
+            SmlInt_TakeCloserHit(Best, Distance, Idx, 0.0f, 0.0f);
+        }
+    }
+
+    return Count;
+}
+
+static sml_ray_hit
+SmlRay_IntersectTrianglesScalar(const sml_ray &Ray, const sml_triangle_soup &Soup)
+{
+    sml_ray_hit Best = SmlInt_RayMiss(Ray);
+    SmlInt_RayTrianglesScalar(Ray, Soup, 0, Soup.Count, &Best);
+
+    return Best;
+}
+
+static sml_ray_hit
+SmlRay_IntersectBoxesScalar(const sml_ray &Ray, const sml_box_bounds &Boxes,
+                            sml_u32 Count)
+{
+    sml_vector3 InvDir = sml_vector3(1.0f / Ray.Direction.x, 1.0f / Ray.Direction.y,
+                                     1.0f / Ray.Direction.z);
+
+    sml_ray_hit Best = SmlInt_RayMiss(Ray);
+    SmlInt_RayBoxesScalar(Ray, InvDir, Boxes, 0, Count, &Best);
+
+    return Best;
+}
+
+// ===================================
+// SSE (4 wide)
+// ===================================
+
+static inline __m128
+SmlInt_Select4(__m128 Mask, __m128 IfTrue, __m128 IfFalse)
+{
+    return _mm_or_ps(_mm_and_ps(Mask, IfTrue), _mm_andnot_ps(Mask, IfFalse));
+}
+
+// NOTE: Folds the per-lane bests into Best.
+
+static void
+SmlInt_ReduceHits4(__m128 Distances, __m128i Indices, __m128 Us, __m128 Vs,
+                   sml_ray_hit *Best)
+{
+    alignas(16) sml_f32 LaneDistances[4], LaneUs[4], LaneVs[4];
+    alignas(16) sml_u32 LaneIndices[4];
+
+    _mm_store_ps(LaneDistances, Distances);
+    _mm_store_ps(LaneUs, Us);
+    _mm_store_ps(LaneVs, Vs);
+    _mm_store_si128((__m128i*)LaneIndices, Indices);
+
+    for(sml_u32 Lane = 0; Lane < 4; Lane++)
+    {
+        if(LaneIndices[Lane] == sml_ray_hit::Invalid) continue;
+
+        SmlInt_TakeCloserHit(Best, LaneDistances[Lane], LaneIndices[Lane],
+                             LaneUs[Lane], LaneVs[Lane]);
+    }
+}
+
+// NOTE: Returns the lane hit mask of one group of 4 triangles, and skips the
+// rest of the math as soon as every lane failed.
+
+static inline __m128
+SmlInt_RayTriangleGroup4(const sml_ray &Ray, const sml_triangle_soup &Soup, sml_u32 Idx,
+                         __m128 MaxDistance, __m128 *OutDistance, __m128 *OutU,
+                         __m128 *OutV)
+{
+    __m128 DX = _mm_set1_ps(Ray.Direction.x);
+    __m128 DY = _mm_set1_ps(Ray.Direction.y);
+    __m128 DZ = _mm_set1_ps(Ray.Direction.z);
+
+    __m128 E1X = _mm_loadu_ps(Soup.E1Xs + Idx);
+    __m128 E1Y = _mm_loadu_ps(Soup.E1Ys + Idx);
+    __m128 E1Z = _mm_loadu_ps(Soup.E1Zs + Idx);
+    __m128 E2X = _mm_loadu_ps(Soup.E2Xs + Idx);
+    __m128 E2Y = _mm_loadu_ps(Soup.E2Ys + Idx);
+    __m128 E2Z = _mm_loadu_ps(Soup.E2Zs + Idx);
+
+    __m128 PX = _mm_sub_ps(_mm_mul_ps(DY, E2Z), _mm_mul_ps(DZ, E2Y));
+    __m128 PY = _mm_sub_ps(_mm_mul_ps(DZ, E2X), _mm_mul_ps(DX, E2Z));
+    __m128 PZ = _mm_sub_ps(_mm_mul_ps(DX, E2Y), _mm_mul_ps(DY, E2X));
+
+    __m128 Det = _mm_mul_ps(E1X, PX);
+    Det        = _mm_add_ps(Det, _mm_mul_ps(E1Y, PY));
+    Det        = _mm_add_ps(Det, _mm_mul_ps(E1Z, PZ));
+
+    __m128 AbsDet = _mm_andnot_ps(_mm_set1_ps(-0.0f), Det);
+    __m128 Hit    = _mm_cmpgt_ps(AbsDet, _mm_set1_ps(SmlInt_RayParallelEpsilon));
+    if(!_mm_movemask_ps(Hit)) return Hit;
+
+    __m128 InvDet = _mm_div_ps(_mm_set1_ps(1.0f), Det);
+
+    __m128 TX = _mm_sub_ps(_mm_set1_ps(Ray.Origin.x), _mm_loadu_ps(Soup.V0Xs + Idx));
+    __m128 TY = _mm_sub_ps(_mm_set1_ps(Ray.Origin.y), _mm_loadu_ps(Soup.V0Ys + Idx));
+    __m128 TZ = _mm_sub_ps(_mm_set1_ps(Ray.Origin.z), _mm_loadu_ps(Soup.V0Zs + Idx));
+
+    __m128 U = _mm_mul_ps(TX, PX);
+    U        = _mm_add_ps(U, _mm_mul_ps(TY, PY));
+    U        = _mm_add_ps(U, _mm_mul_ps(TZ, PZ));
+    U        = _mm_mul_ps(U, InvDet);
+
+    __m128 One  = _mm_set1_ps(1.0f);
+    __m128 Zero = _mm_setzero_ps();
+
+    Hit = _mm_and_ps(Hit, _mm_and_ps(_mm_cmpge_ps(U, Zero), _mm_cmple_ps(U, One)));
+    if(!_mm_movemask_ps(Hit)) return Hit;
+
+    __m128 QX = _mm_sub_ps(_mm_mul_ps(TY, E1Z), _mm_mul_ps(TZ, E1Y));
+    __m128 QY = _mm_sub_ps(_mm_mul_ps(TZ, E1X), _mm_mul_ps(TX, E1Z));
+    __m128 QZ = _mm_sub_ps(_mm_mul_ps(TX, E1Y), _mm_mul_ps(TY, E1X));
+
+    __m128 V = _mm_mul_ps(DX, QX);
+    V        = _mm_add_ps(V, _mm_mul_ps(DY, QY));
+    V        = _mm_add_ps(V, _mm_mul_ps(DZ, QZ));
+    V        = _mm_mul_ps(V, InvDet);
+
+    __m128 Distance = _mm_mul_ps(E2X, QX);
+    Distance        = _mm_add_ps(Distance, _mm_mul_ps(E2Y, QY));
+    Distance        = _mm_add_ps(Distance, _mm_mul_ps(E2Z, QZ));
+    Distance        = _mm_mul_ps(Distance, InvDet);
+
+    Hit = _mm_and_ps(Hit, _mm_cmpge_ps(V, Zero));
+    Hit = _mm_and_ps(Hit, _mm_cmple_ps(_mm_add_ps(U, V), One));
+    Hit = _mm_and_ps(Hit, _mm_cmpgt_ps(Distance, Zero));
+    Hit = _mm_and_ps(Hit, _mm_cmplt_ps(Distance, MaxDistance));
+
+    *OutDistance = Distance;
+    *OutU        = U;
+    *OutV        = V;
+
+    return Hit;
+}
+
+static sml_u32
+SmlInt_RayTriangles4(const sml_ray &Ray, const sml_triangle_soup &Soup,
+                     sml_u32 Start, sml_u32 Count, sml_ray_hit *Best)
+{
+    __m128  BestDistance = _mm_set1_ps(Best->Distance);
+    __m128i BestIndex    = _mm_set1_epi32(-1);
+    __m128  BestU        = _mm_setzero_ps();
+    __m128  BestV        = _mm_setzero_ps();
+
+    __m128i LaneOffsets = _mm_setr_epi32(0, 1, 2, 3);
+
+    sml_u32 Idx = Start;
+    for(; Idx + 4 <= Count; Idx += 4)
+    {
+        __m128 Distance, U, V;
+
+        __m128 Hit = SmlInt_RayTriangleGroup4(Ray, Soup, Idx, BestDistance,
+                                              &Distance, &U, &V);
+        if(!_mm_movemask_ps(Hit)) continue;
+
+        // Lanes only ever see increasing indices, so strictly closer is enough
+        // to keep the lowest index on ties.
+
+        __m128i Index = _mm_add_epi32(_mm_set1_epi32((int)Idx), LaneOffsets);
+
+        BestDistance = SmlInt_Select4(Hit, Distance, BestDistance);
+        BestU        = SmlInt_Select4(Hit, U, BestU);
+        BestV        = SmlInt_Select4(Hit, V, BestV);
+        BestIndex    = _mm_castps_si128(SmlInt_Select4(Hit, _mm_castsi128_ps(Index),
+                                                       _mm_castsi128_ps(BestIndex)));
+    }
+
+    SmlInt_ReduceHits4(BestDistance, BestIndex, BestU, BestV, Best);
+
+    return Idx;
+}
+
+static inline __m128
+SmlInt_RayBoxGroup4(const sml_ray &Ray, __m128 InvDX, __m128 InvDY, __m128 InvDZ,
+                    const sml_box_bounds &Boxes, sml_u32 Idx, __m128 MaxDistance,
+                    __m128 *OutDistance)
+{
+    __m128 CX = _mm_loadu_ps(Boxes.Xs + Idx);
+    __m128 CY = _mm_loadu_ps(Boxes.Ys + Idx);
+    __m128 CZ = _mm_loadu_ps(Boxes.Zs + Idx);
+    __m128 EX = _mm_loadu_ps(Boxes.ExtentXs + Idx);
+    __m128 EY = _mm_loadu_ps(Boxes.ExtentYs + Idx);
+    __m128 EZ = _mm_loadu_ps(Boxes.ExtentZs + Idx);
+
+    __m128 OX = _mm_set1_ps(Ray.Origin.x);
+    __m128 OY = _mm_set1_ps(Ray.Origin.y);
+    __m128 OZ = _mm_set1_ps(Ray.Origin.z);
+
+    __m128 T0X = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(CX, EX), OX), InvDX);
+    __m128 T1X = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(CX, EX), OX), InvDX);
+    __m128 T0Y = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(CY, EY), OY), InvDY);
+    __m128 T1Y = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(CY, EY), OY), InvDY);
+    __m128 T0Z = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(CZ, EZ), OZ), InvDZ);
+    __m128 T1Z = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(CZ, EZ), OZ), InvDZ);
+
+    __m128 Enter = _mm_max_ps(_mm_min_ps(T0X, T1X), _mm_setzero_ps());
+    Enter        = _mm_max_ps(_mm_min_ps(T0Y, T1Y), Enter);
+    Enter        = _mm_max_ps(_mm_min_ps(T0Z, T1Z), Enter);
+
+    __m128 Exit = _mm_min_ps(_mm_max_ps(T0X, T1X), MaxDistance);
+    Exit        = _mm_min_ps(_mm_max_ps(T0Y, T1Y), Exit);
+    Exit        = _mm_min_ps(_mm_max_ps(T0Z, T1Z), Exit);
+
+    __m128 Hit = _mm_and_ps(_mm_cmple_ps(Enter, Exit), _mm_cmplt_ps(Enter, MaxDistance));
+
+    *OutDistance = Enter;
+
+    return Hit;
+}
+
+static sml_u32
+SmlInt_RayBoxes4(const sml_ray &Ray, sml_vector3 InvDir, const sml_box_bounds &Boxes,
+                 sml_u32 Start, sml_u32 Count, sml_ray_hit *Best)
+{
+    __m128 InvDX = _mm_set1_ps(InvDir.x);
+    __m128 InvDY = _mm_set1_ps(InvDir.y);
+    __m128 InvDZ = _mm_set1_ps(InvDir.z);
+
+    __m128  BestDistance = _mm_set1_ps(Best->Distance);
+    __m128i BestIndex    = _mm_set1_epi32(-1);
+
+    __m128i LaneOffsets = _mm_setr_epi32(0, 1, 2, 3);
+
+    sml_u32 Idx = Start;
+    for(; Idx + 4 <= Count; Idx += 4)
+    {
+        __m128 Distance;
+
+        __m128 Hit = SmlInt_RayBoxGroup4(Ray, InvDX, InvDY, InvDZ, Boxes, Idx,
+                                         BestDistance, &Distance);
+        if(!_mm_movemask_ps(Hit)) continue;
+
+        __m128i Index = _mm_add_epi32(_mm_set1_epi32((int)Idx), LaneOffsets);
+
+        BestDistance = SmlInt_Select4(Hit, Distance, BestDistance);
+        BestIndex    = _mm_castps_si128(SmlInt_Select4(Hit, _mm_castsi128_ps(Index),
+                                                       _mm_castsi128_ps(BestIndex)));
+    }
+
+    __m128 Zero = _mm_setzero_ps();
+    SmlInt_ReduceHits4(BestDistance, BestIndex, Zero, Zero, Best);
+
+    return Idx;
+}
+
+// ===================================
+// AVX2 (8 wide)
+// ===================================
+
+SML_TARGET_AVX2 static void
+SmlInt_ReduceHits8(__m256 Distances, __m256i Indices, __m256 Us, __m256 Vs,
+                   sml_ray_hit *Best)
+{
+    SmlInt_ReduceHits4(_mm256_castps256_ps128(Distances), _mm256_castsi256_si128(Indices),
+                       _mm256_castps256_ps128(Us), _mm256_castps256_ps128(Vs), Best);
+
+    SmlInt_ReduceHits4(_mm256_extractf128_ps(Distances, 1),
+                       _mm256_extracti128_si256(Indices, 1),
+                       _mm256_extractf128_ps(Us, 1), _mm256_extractf128_ps(Vs, 1), Best);
+}
+
+SML_TARGET_AVX2 static sml_u32
+SmlInt_RayTriangles8(const sml_ray &Ray, const sml_triangle_soup &Soup,
+                     sml_u32 Start, sml_u32 Count, sml_ray_hit *Best)
+{
+    __m256 DX = _mm256_set1_ps(Ray.Direction.x);
+    __m256 DY = _mm256_set1_ps(Ray.Direction.y);
+    __m256 DZ = _mm256_set1_ps(Ray.Direction.z);
+
+    __m256 OX = _mm256_set1_ps(Ray.Origin.x);
+    __m256 OY = _mm256_set1_ps(Ray.Origin.y);
+    __m256 OZ = _mm256_set1_ps(Ray.Origin.z);
+
+    __m256 One     = _mm256_set1_ps(1.0f);
+    __m256 Zero    = _mm256_setzero_ps();
+    __m256 SignBit = _mm256_set1_ps(-0.0f);
+    __m256 Epsilon = _mm256_set1_ps(SmlInt_RayParallelEpsilon);
+
+    __m256  BestDistance = _mm256_set1_ps(Best->Distance);
+    __m256i BestIndex    = _mm256_set1_epi32(-1);
+    __m256  BestU        = Zero;
+    __m256  BestV        = Zero;
+
+    __m256i LaneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    sml_u32 Idx = Start;
+    for(; Idx + 8 <= Count; Idx += 8)
+    {
+        __m256 E1X = _mm256_loadu_ps(Soup.E1Xs + Idx);
+        __m256 E1Y = _mm256_loadu_ps(Soup.E1Ys + Idx);
+        __m256 E1Z = _mm256_loadu_ps(Soup.E1Zs + Idx);
+        __m256 E2X = _mm256_loadu_ps(Soup.E2Xs + Idx);
+        __m256 E2Y = _mm256_loadu_ps(Soup.E2Ys + Idx);
+        __m256 E2Z = _mm256_loadu_ps(Soup.E2Zs + Idx);
+
+        __m256 PX = _mm256_sub_ps(_mm256_mul_ps(DY, E2Z), _mm256_mul_ps(DZ, E2Y));
+        __m256 PY = _mm256_sub_ps(_mm256_mul_ps(DZ, E2X), _mm256_mul_ps(DX, E2Z));
+        __m256 PZ = _mm256_sub_ps(_mm256_mul_ps(DX, E2Y), _mm256_mul_ps(DY, E2X));
+
+        __m256 Det = _mm256_mul_ps(E1X, PX);
+        Det        = _mm256_add_ps(Det, _mm256_mul_ps(E1Y, PY));
+        Det        = _mm256_add_ps(Det, _mm256_mul_ps(E1Z, PZ));
+
+        __m256 Hit = _mm256_cmp_ps(_mm256_andnot_ps(SignBit, Det), Epsilon, _CMP_GT_OQ);
+        if(!_mm256_movemask_ps(Hit)) continue;
+
+        __m256 InvDet = _mm256_div_ps(One, Det);
+
+        __m256 TX = _mm256_sub_ps(OX, _mm256_loadu_ps(Soup.V0Xs + Idx));
+        __m256 TY = _mm256_sub_ps(OY, _mm256_loadu_ps(Soup.V0Ys + Idx));
+        __m256 TZ = _mm256_sub_ps(OZ, _mm256_loadu_ps(Soup.V0Zs + Idx));
+
+        __m256 U = _mm256_mul_ps(TX, PX);
+        U        = _mm256_add_ps(U, _mm256_mul_ps(TY, PY));
+        U        = _mm256_add_ps(U, _mm256_mul_ps(TZ, PZ));
+        U        = _mm256_mul_ps(U, InvDet);
+
+        Hit = _mm256_and_ps(Hit, _mm256_cmp_ps(U, Zero, _CMP_GE_OQ));
+        Hit = _mm256_and_ps(Hit, _mm256_cmp_ps(U, One, _CMP_LE_OQ));
+        if(!_mm256_movemask_ps(Hit)) continue;
+
+        __m256 QX = _mm256_sub_ps(_mm256_mul_ps(TY, E1Z), _mm256_mul_ps(TZ, E1Y));
+        __m256 QY = _mm256_sub_ps(_mm256_mul_ps(TZ, E1X), _mm256_mul_ps(TX, E1Z));
+        __m256 QZ = _mm256_sub_ps(_mm256_mul_ps(TX, E1Y), _mm256_mul_ps(TY, E1X));
+
+        __m256 V = _mm256_mul_ps(DX, QX);
+        V        = _mm256_add_ps(V, _mm256_mul_ps(DY, QY));
+        V        = _mm256_add_ps(V, _mm256_mul_ps(DZ, QZ));
+        V        = _mm256_mul_ps(V, InvDet);
+
+        __m256 Distance = _mm256_mul_ps(E2X, QX);
+        Distance        = _mm256_add_ps(Distance, _mm256_mul_ps(E2Y, QY));
+        Distance        = _mm256_add_ps(Distance, _mm256_mul_ps(E2Z, QZ));
+        Distance        = _mm256_mul_ps(Distance, InvDet);
+
+        Hit = _mm256_and_ps(Hit, _mm256_cmp_ps(V, Zero, _CMP_GE_OQ));
+        Hit = _mm256_and_ps(Hit, _mm256_cmp_ps(_mm256_add_ps(U, V), One, _CMP_LE_OQ));
+        Hit = _mm256_and_ps(Hit, _mm256_cmp_ps(Distance, Zero, _CMP_GT_OQ));
+        Hit = _mm256_and_ps(Hit, _mm256_cmp_ps(Distance, BestDistance, _CMP_LT_OQ));
+        if(!_mm256_movemask_ps(Hit)) continue;
+
+        __m256i Index = _mm256_add_epi32(_mm256_set1_epi32((int)Idx), LaneOffsets);
+
+        BestDistance = _mm256_blendv_ps(BestDistance, Distance, Hit);
+        BestU        = _mm256_blendv_ps(BestU, U, Hit);
+        BestV        = _mm256_blendv_ps(BestV, V, Hit);
+
+        __m256 OldIndex = _mm256_castsi256_ps(BestIndex);
+        __m256 NewIndex = _mm256_castsi256_ps(Index);
+        BestIndex       = _mm256_castps_si256(_mm256_blendv_ps(OldIndex, NewIndex, Hit));
+    }
+
+    SmlInt_ReduceHits8(BestDistance, BestIndex, BestU, BestV, Best);
+
+    return Idx;
+}
+
+SML_TARGET_AVX2 static sml_u32
+SmlInt_RayBoxes8(const sml_ray &Ray, sml_vector3 InvDir, const sml_box_bounds &Boxes,
+                 sml_u32 Start, sml_u32 Count, sml_ray_hit *Best)
+{
+    __m256 InvDX = _mm256_set1_ps(InvDir.x);
+    __m256 InvDY = _mm256_set1_ps(InvDir.y);
+    __m256 InvDZ = _mm256_set1_ps(InvDir.z);
+
+    __m256 OX = _mm256_set1_ps(Ray.Origin.x);
+    __m256 OY = _mm256_set1_ps(Ray.Origin.y);
+    __m256 OZ = _mm256_set1_ps(Ray.Origin.z);
+
+    __m256  Zero         = _mm256_setzero_ps();
+    __m256  BestDistance = _mm256_set1_ps(Best->Distance);
+    __m256i BestIndex    = _mm256_set1_epi32(-1);
+
+    __m256i LaneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    sml_u32 Idx = Start;
+    for(; Idx + 8 <= Count; Idx += 8)
+    {
+        __m256 CX = _mm256_loadu_ps(Boxes.Xs + Idx);
+        __m256 CY = _mm256_loadu_ps(Boxes.Ys + Idx);
+        __m256 CZ = _mm256_loadu_ps(Boxes.Zs + Idx);
+        __m256 EX = _mm256_loadu_ps(Boxes.ExtentXs + Idx);
+        __m256 EY = _mm256_loadu_ps(Boxes.ExtentYs + Idx);
+        __m256 EZ = _mm256_loadu_ps(Boxes.ExtentZs + Idx);
+
+        __m256 T0X = _mm256_mul_ps(_mm256_sub_ps(_mm256_sub_ps(CX, EX), OX), InvDX);
+        __m256 T1X = _mm256_mul_ps(_mm256_sub_ps(_mm256_add_ps(CX, EX), OX), InvDX);
+        __m256 T0Y = _mm256_mul_ps(_mm256_sub_ps(_mm256_sub_ps(CY, EY), OY), InvDY);
+        __m256 T1Y = _mm256_mul_ps(_mm256_sub_ps(_mm256_add_ps(CY, EY), OY), InvDY);
+        __m256 T0Z = _mm256_mul_ps(_mm256_sub_ps(_mm256_sub_ps(CZ, EZ), OZ), InvDZ);
+        __m256 T1Z = _mm256_mul_ps(_mm256_sub_ps(_mm256_add_ps(CZ, EZ), OZ), InvDZ);
+
+        __m256 Enter = _mm256_max_ps(_mm256_min_ps(T0X, T1X), Zero);
+        Enter        = _mm256_max_ps(_mm256_min_ps(T0Y, T1Y), Enter);
+        Enter        = _mm256_max_ps(_mm256_min_ps(T0Z, T1Z), Enter);
+
+        __m256 Exit = _mm256_min_ps(_mm256_max_ps(T0X, T1X), BestDistance);
+        Exit        = _mm256_min_ps(_mm256_max_ps(T0Y, T1Y), Exit);
+        Exit        = _mm256_min_ps(_mm256_max_ps(T0Z, T1Z), Exit);
+
+        __m256 Hit = _mm256_and_ps(_mm256_cmp_ps(Enter, Exit, _CMP_LE_OQ),
+                                   _mm256_cmp_ps(Enter, BestDistance, _CMP_LT_OQ));
+        if(!_mm256_movemask_ps(Hit)) continue;
+
+        __m256i Index = _mm256_add_epi32(_mm256_set1_epi32((int)Idx), LaneOffsets);
+
+        BestDistance = _mm256_blendv_ps(BestDistance, Enter, Hit);
+
+        __m256 OldIndex = _mm256_castsi256_ps(BestIndex);
+        __m256 NewIndex = _mm256_castsi256_ps(Index);
+        BestIndex       = _mm256_castps_si256(_mm256_blendv_ps(OldIndex, NewIndex, Hit));
+    }
+
+    SmlInt_ReduceHits8(BestDistance, BestIndex, Zero, Zero, Best);
+
+    return Idx;
+}
+
+// ===================================
+// Dispatch
+// ===================================
+
+using sml_ray_triangles_kernel = sml_u32 (*)(const sml_ray &Ray,
+                                             const sml_triangle_soup &Soup,
+                                             sml_u32 Start, sml_u32 Count,
+                                             sml_ray_hit *Best);
+
+using sml_ray_boxes_kernel = sml_u32 (*)(const sml_ray &Ray, sml_vector3 InvDir,
+                                         const sml_box_bounds &Boxes,
+                                         sml_u32 Start, sml_u32 Count,
+                                         sml_ray_hit *Best);
+
+struct sml_ray_kernels
+{
+    sml_ray_triangles_kernel Triangles;
+    sml_ray_boxes_kernel     Boxes;
+};
+
+static sml_ray_kernels
+SmlInt_BindRayKernels(Sml_Isa Isa)
+{
+    sml_ray_kernels Kernels = {};
+
+    if(Isa >= SmlIsa_AVX2)
+    {
+        Kernels.Triangles = SmlInt_RayTriangles8;
+        Kernels.Boxes     = SmlInt_RayBoxes8;
+    }
+    else if(Isa >= SmlIsa_SSE2)
+    {
+        Kernels.Triangles = SmlInt_RayTriangles4;
+        Kernels.Boxes     = SmlInt_RayBoxes4;
+    }
+    else
+    {
+        Kernels.Triangles = SmlInt_RayTrianglesScalar;
+        Kernels.Boxes     = SmlInt_RayBoxesScalar;
+    }
+
+    return Kernels;
+}
+
+static auto SmlRayKernels = SmlInt_BindRayKernels(SmlCpu.Isa);
+
+// ===================================
+// User API
+// ===================================
+
+// NOTE: Index is sml_ray_hit::Invalid on a miss.
+
+static sml_ray_hit
+SmlRay_IntersectTriangles(const sml_ray &Ray, const sml_triangle_soup &Soup)
+{
+    sml_ray_hit Best = SmlInt_RayMiss(Ray);
+    sml_u32     Idx  = SmlRayKernels.Triangles(Ray, Soup, 0, Soup.Count, &Best);
+
+    SmlInt_RayTrianglesScalar(Ray, Soup, Idx, Soup.Count, &Best);
+
+    return Best;
+}
+
+static sml_ray_hit
+SmlRay_IntersectBoxes(const sml_ray &Ray, const sml_box_bounds &Boxes, sml_u32 Count)
+{
+    sml_vector3 InvDir = sml_vector3(1.0f / Ray.Direction.x, 1.0f / Ray.Direction.y,
+                                     1.0f / Ray.Direction.z);
+
+    sml_ray_hit Best = SmlInt_RayMiss(Ray);
+    sml_u32     Idx  = SmlRayKernels.Boxes(Ray, InvDir, Boxes, 0, Count, &Best);
+
+    SmlInt_RayBoxesScalar(Ray, InvDir, Boxes, Idx, Count, &Best);
+
+    return Best;
+}
+
+// NOTE: Line of sight, true as soon as any triangle blocks the segment
+// [Origin, Origin + Direction * MaxDistance).
+
+static bool
+SmlRay_AnyTriangle(const sml_ray &Ray, const sml_triangle_soup &Soup)
+{
+    sml_u32 Idx = 0;
+
+    // NOTE: One hit ends the query, so 4 wide is enough on every SIMD ISA.
+    if(SmlCpu.Isa >= SmlIsa_SSE2)
+    {
+        __m128 MaxDistance = _mm_set1_ps(Ray.MaxDistance);
+
+        for(; Idx + 4 <= Soup.Count; Idx += 4)
+        {
+            __m128 Distance, U, V;
+            __m128 Hit = SmlInt_RayTriangleGroup4(Ray, Soup, Idx, MaxDistance,
+                                                  &Distance, &U, &V);
+            if(_mm_movemask_ps(Hit))
+            {
+                return true;
+            }
+        }
+    }
+
+    for(; Idx < Soup.Count; Idx++)
+    {
+        sml_f32 Distance, U, V;
+        if(SmlInt_RayTriangleScalar(Ray, Soup, Idx, Ray.MaxDistance, &Distance, &U, &V))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool
+SmlRay_AnyBox(const sml_ray &Ray, const sml_box_bounds &Boxes, sml_u32 Count)
+{
+    sml_vector3 InvDir = sml_vector3(1.0f / Ray.Direction.x, 1.0f / Ray.Direction.y,
+                                     1.0f / Ray.Direction.z);
+
+    sml_u32 Idx = 0;
+
+    if(SmlCpu.Isa >= SmlIsa_SSE2)
+    {
+        __m128 InvDX       = _mm_set1_ps(InvDir.x);
+        __m128 InvDY       = _mm_set1_ps(InvDir.y);
+        __m128 InvDZ       = _mm_set1_ps(InvDir.z);
+        __m128 MaxDistance = _mm_set1_ps(Ray.MaxDistance);
+
+        for(; Idx + 4 <= Count; Idx += 4)
+        {
+            __m128 Distance;
+            __m128 Hit = SmlInt_RayBoxGroup4(Ray, InvDX, InvDY, InvDZ, Boxes, Idx,
+                                             MaxDistance, &Distance);
+            if(_mm_movemask_ps(Hit))
+            {
+                return true;
+            }
+        }
+    }
+
+    for(; Idx < Count; Idx++)
+    {
+        sml_f32 Distance;
+        if(SmlInt_RayBoxScalar(Ray, InvDir, Boxes, Idx, Ray.MaxDistance, &Distance))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,462 @@
+// ===================================
+// Type Definitions
+// ===================================
+
+// NOTE:
+// 1) Unit quaternions only, (x, y, z) is the axis part and w the angle part.
+//    Same layout as sml_vector4, so the SIMD helpers work on both.
+// 2) Matrices composed here are T * R * S applied to column vectors, which is
+//    how SmlMat4_Translation and the instance constant buffers use them.
+
+union alignas(16) sml_quaternion
+{
+    struct
+    {
+        sml_f32 x, y, z, w;
+    };
+
+    __m128 Lanes;
+
+    sml_quaternion(){};
+
+    sml_quaternion(sml_f32 x_, sml_f32 y_, sml_f32 z_, sml_f32 w_)
+    {
+        Lanes = _mm_setr_ps(x_, y_, z_, w_);
+    }
+
+    explicit sml_quaternion(__m128 Lanes_)
+    {
+        Lanes = Lanes_;
+    }
+};
+
+// NOTE: w of Translation and Scale is ignored.
+
+struct sml_transform
+{
+    sml_vector4    Translation;
+    sml_quaternion Rotation;
+    sml_vector4    Scale;
+};
+
+// ===================================
+// Internal Helpers
+// ===================================
+
+static inline __m128
+SmlInt_FlipSigns(__m128 V, sml_f32 X, sml_f32 Y, sml_f32 Z, sml_f32 W)
+{
+    return _mm_xor_ps(V, _mm_setr_ps(X, Y, Z, W));
+}
+
+// NOTE: Shepperd's method, picks the largest diagonal term to stay precise.
+// The columns must be orthonormal.
+
+static sml_quaternion
+SmlInt_QuatFromBasis(const __m128 Basis[3])
+{
+    sml_vector4 C0 = sml_vector4(Basis[0]);
+    sml_vector4 C1 = sml_vector4(Basis[1]);
+    sml_vector4 C2 = sml_vector4(Basis[2]);
+
+    sml_f32 Trace = C0.x + C1.y + C2.z;
+
+    sml_quaternion Result;
+
+    if(Trace > 0.0f)
+    {
+        sml_f32 S = sqrtf(Trace + 1.0f) * 2.0f;
+        Result = sml_quaternion((C1.z - C2.y) / S, (C2.x - C0.z) / S,
+                                (C0.y - C1.x) / S, 0.25f * S);
+    }
+    else if(C0.x > C1.y && C0.x > C2.z)
+    {
+        sml_f32 S = sqrtf(1.0f + C0.x - C1.y - C2.z) * 2.0f;
+        Result = sml_quaternion(0.25f * S, (C1.x + C0.y) / S,
+                                (C2.x + C0.z) / S, (C1.z - C2.y) / S);
+    }
+    else if(C1.y > C2.z)
+    {
+        sml_f32 S = sqrtf(1.0f + C1.y - C0.x - C2.z) * 2.0f;
+        Result = sml_quaternion((C1.x + C0.y) / S, 0.25f * S,
+                                (C2.y + C1.z) / S, (C2.x - C0.z) / S);
+    }
+    else
+    {
+        sml_f32 S = sqrtf(1.0f + C2.z - C0.x - C1.y) * 2.0f;
+        Result = sml_quaternion((C2.x + C0.z) / S, (C2.y + C1.z) / S,
+                                0.25f * S, (C0.y - C1.x) / S);
+    }
+
+    return Result;
+}
+
+// ===================================
+// Quaternion
+// ===================================
+
+static inline sml_quaternion
+SmlQuat_Identity()
+{
+    return sml_quaternion(0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+static sml_quaternion
+SmlQuat_FromAxisAngle(sml_vector3 Axis, sml_f32 Radians)
+{
+    sml_vector3 Unit = SmlVec3_Normalize(Axis);
+    sml_f32     Sin  = sinf(Radians * 0.5f);
+
+    return sml_quaternion(Unit.x * Sin, Unit.y * Sin, Unit.z * Sin, cosf(Radians * 0.5f));
+}
+
+static inline sml_f32
+SmlQuat_Dot(const sml_quaternion &A, const sml_quaternion &B)
+{
+    return _mm_cvtss_f32(SmlInt_HorizontalAdd(_mm_mul_ps(A.Lanes, B.Lanes)));
+}
+
+static inline sml_quaternion
+SmlQuat_Conjugate(const sml_quaternion &Q)
+{
+    return sml_quaternion(SmlInt_FlipSigns(Q.Lanes, -0.0f, -0.0f, -0.0f, 0.0f));
+}
+
+static inline sml_quaternion
+SmlQuat_Normalize(const sml_quaternion &Q)
+{
+    return sml_quaternion(SmlVec4_Normalize(sml_vector4(Q.Lanes)).Lanes);
+}
+
+static sml_quaternion
+SmlQuat_MultiplyScalar(const sml_quaternion &A, const sml_quaternion &B)
+{
+    sml_quaternion Result;
+
+    Result.x = (A.w * B.x) + (A.x * B.w) + (A.y * B.z) - (A.z * B.y);
+    Result.y = (A.w * B.y) - (A.x * B.z) + (A.y * B.w) + (A.z * B.x);
+    Result.z = (A.w * B.z) + (A.x * B.y) - (A.y * B.x) + (A.z * B.w);
+    Result.w = (A.w * B.w) - (A.x * B.x) - (A.y * B.y) - (A.z * B.z);
+
+    return Result;
+}
+
+// NOTE: Hamilton product, A * B applies B first then A.
+
+static sml_quaternion
+SmlQuat_Multiply(const sml_quaternion &A, const sml_quaternion &B)
+{
+#if defined(SML_MATH_SCALAR)
+    return SmlQuat_MultiplyScalar(A, B);
+#else
+    __m128 AX = _mm_shuffle_ps(A.Lanes, A.Lanes, _MM_SHUFFLE(0, 0, 0, 0));
+    __m128 AY = _mm_shuffle_ps(A.Lanes, A.Lanes, _MM_SHUFFLE(1, 1, 1, 1));
+    __m128 AZ = _mm_shuffle_ps(A.Lanes, A.Lanes, _MM_SHUFFLE(2, 2, 2, 2));
+    __m128 AW = _mm_shuffle_ps(A.Lanes, A.Lanes, _MM_SHUFFLE(3, 3, 3, 3));
+
+    // (w, z, y, x), (z, w, x, y) and (y, x, w, z) of B with the product signs.
+    __m128 BWZYX = _mm_shuffle_ps(B.Lanes, B.Lanes, _MM_SHUFFLE(0, 1, 2, 3));
+    __m128 BZWXY = _mm_shuffle_ps(B.Lanes, B.Lanes, _MM_SHUFFLE(1, 0, 3, 2));
+    __m128 BYXWZ = _mm_shuffle_ps(B.Lanes, B.Lanes, _MM_SHUFFLE(2, 3, 0, 1));
+
+    BWZYX = SmlInt_FlipSigns(BWZYX,  0.0f, -0.0f,  0.0f, -0.0f);
+    BZWXY = SmlInt_FlipSigns(BZWXY,  0.0f,  0.0f, -0.0f, -0.0f);
+    BYXWZ = SmlInt_FlipSigns(BYXWZ, -0.0f,  0.0f,  0.0f, -0.0f);
+
+    __m128 Result = _mm_mul_ps(AW, B.Lanes);
+    Result        = _mm_add_ps(Result, _mm_mul_ps(AX, BWZYX));
+    Result        = _mm_add_ps(Result, _mm_mul_ps(AY, BZWXY));
+    Result        = _mm_add_ps(Result, _mm_mul_ps(AZ, BYXWZ));
+
+    return sml_quaternion(Result);
+#endif
+}
+
+// NOTE: v' = v + w * t + q x t with t = 2 * (q x v), no matrix needed.
+
+static sml_vector3
+SmlQuat_Rotate(const sml_quaternion &Q, sml_vector3 V)
+{
+    sml_vector4 Axis = sml_vector4(Q.Lanes);
+    sml_vector4 Vec  = SmlVec4_FromVec3(V, 0.0f);
+
+    sml_vector4 T      = SmlVec4_Scale(SmlVec4_Cross(Axis, Vec), 2.0f);
+    sml_vector4 Result = Vec + SmlVec4_Scale(T, Q.w) + SmlVec4_Cross(Axis, T);
+
+    return SmlVec4_ToVec3(Result);
+}
+
+// NOTE: Takes the shortest arc. Nearly parallel inputs fall back to a
+// normalized lerp, where sin(theta) would divide by ~0.
+
+static sml_quaternion
+SmlQuat_Slerp(const sml_quaternion &A, const sml_quaternion &B, sml_f32 T)
+{
+    sml_f32 Cos = SmlQuat_Dot(A, B);
+    __m128  To  = B.Lanes;
+
+    if(Cos < 0.0f)
+    {
+        Cos = -Cos;
+        To  = _mm_xor_ps(To, _mm_set1_ps(-0.0f));
+    }
+
+    sml_f32 WeightA = 1.0f - T;
+    sml_f32 WeightB = T;
+
+    if(Cos < 0.9995f)
+    {
+        sml_f32 Theta  = acosf(Cos);
+        sml_f32 InvSin = 1.0f / sinf(Theta);
+
+        WeightA = sinf(WeightA * Theta) * InvSin;
+        WeightB = sinf(WeightB * Theta) * InvSin;
+    }
+
+    __m128 Result = _mm_add_ps(_mm_mul_ps(A.Lanes, _mm_set1_ps(WeightA)),
+                               _mm_mul_ps(To     , _mm_set1_ps(WeightB)));
+
+    return SmlQuat_Normalize(sml_quaternion(Result));
+}
+
+// ===================================
+// Transform
+// ===================================
+
+static inline sml_transform
+SmlTransform_Identity()
+{
+    sml_transform Result;
+    Result.Translation = sml_vector4(0.0f, 0.0f, 0.0f, 0.0f);
+    Result.Rotation    = SmlQuat_Identity();
+    Result.Scale       = sml_vector4(1.0f, 1.0f, 1.0f, 0.0f);
+
+    return Result;
+}
+
+// NOTE: Same operations in the same order as the batch kernel below, so both
+// produce identical matrices.
+
+static sml_matrix4
+SmlMat4_ComposeTRS(const sml_transform &Transform)
+{
+    const sml_quaternion &Q = Transform.Rotation;
+
+    sml_f32 XX = Q.x * Q.x, YY = Q.y * Q.y, ZZ = Q.z * Q.z;
+    sml_f32 XY = Q.x * Q.y, XZ = Q.x * Q.z, YZ = Q.y * Q.z;
+    sml_f32 WX = Q.w * Q.x, WY = Q.w * Q.y, WZ = Q.w * Q.z;
+
+    __m128 Column0 = _mm_setr_ps(1.0f - 2.0f * (YY + ZZ), 2.0f * (XY + WZ),
+                                 2.0f * (XZ - WY), 0.0f);
+    __m128 Column1 = _mm_setr_ps(2.0f * (XY - WZ), 1.0f - 2.0f * (XX + ZZ),
+                                 2.0f * (YZ + WX), 0.0f);
+    __m128 Column2 = _mm_setr_ps(2.0f * (XZ + WY), 2.0f * (YZ - WX),
+                                 1.0f - 2.0f * (XX + YY), 0.0f);
+
+    const sml_vector4 &S = Transform.Scale;
+    const sml_vector4 &T = Transform.Translation;
+
+    // NOTE: w lane of 1 keeps m12..m14 at +0 for negative scales.
+    sml_matrix4 Result;
+    Result.Columns[0] = _mm_mul_ps(Column0, _mm_setr_ps(S.x, S.x, S.x, 1.0f));
+    Result.Columns[1] = _mm_mul_ps(Column1, _mm_setr_ps(S.y, S.y, S.y, 1.0f));
+    Result.Columns[2] = _mm_mul_ps(Column2, _mm_setr_ps(S.z, S.z, S.z, 1.0f));
+    Result.Columns[3] = _mm_setr_ps(T.x, T.y, T.z, 1.0f);
+
+    return Result;
+}
+
+// NOTE:
+// 1) Only valid for T * R * S matrices without shear (what ComposeTRS makes).
+// 2) A negative determinant is folded into Scale.x.
+// 3) A zero scale axis leaves the rotation as identity.
+
+static sml_transform
+SmlMat4_DecomposeTRS(const sml_matrix4 &M)
+{
+    sml_transform Result;
+
+    sml_vector4 C0 = sml_vector4(M.Columns[0]);
+    sml_vector4 C1 = sml_vector4(M.Columns[1]);
+    sml_vector4 C2 = sml_vector4(M.Columns[2]);
+
+    Result.Translation = sml_vector4(M.m3, M.m7, M.m11, 0.0f);
+
+    sml_f32 ScaleX = sqrtf(SmlVec4_Dot(C0, C0));
+    sml_f32 ScaleY = sqrtf(SmlVec4_Dot(C1, C1));
+    sml_f32 ScaleZ = sqrtf(SmlVec4_Dot(C2, C2));
+
+    if(SmlVec4_Dot(C0, SmlVec4_Cross(C1, C2)) < 0.0f) ScaleX = -ScaleX;
+
+    Result.Scale = sml_vector4(ScaleX, ScaleY, ScaleZ, 0.0f);
+
+    if(ScaleX == 0.0f || ScaleY == 0.0f || ScaleZ == 0.0f)
+    {
+        Result.Rotation = SmlQuat_Identity();
+    }
+    else
+    {
+        __m128 Basis[3];
+        Basis[0] = _mm_div_ps(C0.Lanes, _mm_set1_ps(ScaleX));
+        Basis[1] = _mm_div_ps(C1.Lanes, _mm_set1_ps(ScaleY));
+        Basis[2] = _mm_div_ps(C2.Lanes, _mm_set1_ps(ScaleZ));
+
+        Result.Rotation = SmlQuat_Normalize(SmlInt_QuatFromBasis(Basis));
+    }
+
+    return Result;
+}
+
+static inline sml_matrix4
+SmlQuat_ToMatrix(const sml_quaternion &Q)
+{
+    sml_transform Transform = SmlTransform_Identity();
+    Transform.Rotation = Q;
+
+    return SmlMat4_ComposeTRS(Transform);
+}
+
+// NOTE: Rows of the inverse of the upper 3x3, from the cross products of its
+// columns. Returns false for singular matrices (Rows is left untouched).
+
+static bool
+SmlInt_InverseRows3x3(const sml_matrix4 &M, __m128 Rows[3])
+{
+    sml_vector4 C0 = sml_vector4(M.Columns[0]);
+    sml_vector4 C1 = sml_vector4(M.Columns[1]);
+    sml_vector4 C2 = sml_vector4(M.Columns[2]);
+
+    sml_vector4 R0 = SmlVec4_Cross(C1, C2);
+    sml_vector4 R1 = SmlVec4_Cross(C2, C0);
+    sml_vector4 R2 = SmlVec4_Cross(C0, C1);
+
+    sml_f32 Determinant = SmlVec4_Dot(C0, R0);
+    if(Determinant == 0.0f) return false;
+
+    __m128 InvDeterminant = _mm_set1_ps(1.0f / Determinant);
+
+    Rows[0] = _mm_mul_ps(R0.Lanes, InvDeterminant);
+    Rows[1] = _mm_mul_ps(R1.Lanes, InvDeterminant);
+    Rows[2] = _mm_mul_ps(R2.Lanes, InvDeterminant);
+
+    return true;
+}
+
+// NOTE: Inverse of [A t; 0 1] is [A^-1  -A^-1 t; 0 1]. Handles scale and
+// shear, unlike a transpose. Singular matrices return the identity.
+
+static sml_matrix4
+SmlMat4_InverseAffine(const sml_matrix4 &M)
+{
+    __m128 Rows[3];
+    if(!SmlInt_InverseRows3x3(M, Rows)) return SmlMat4_Identity();
+
+    sml_vector4 Translation = sml_vector4(M.m3, M.m7, M.m11, 0.0f);
+
+    sml_matrix4 Result;
+    Result.Columns[0] = Rows[0];
+    Result.Columns[1] = Rows[1];
+    Result.Columns[2] = Rows[2];
+    Result.Columns[3] = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+
+    // Rows were stored as columns, flip them back.
+    Result = SmlMat4_Transpose(Result);
+
+    Result.m3  = -SmlVec4_Dot(sml_vector4(Rows[0]), Translation);
+    Result.m7  = -SmlVec4_Dot(sml_vector4(Rows[1]), Translation);
+    Result.m11 = -SmlVec4_Dot(sml_vector4(Rows[2]), Translation);
+
+    return Result;
+}
+
+// NOTE: Inverse transpose of the upper 3x3, whose columns are the rows of the
+// inverse. Normals transformed by it stay perpendicular under non-uniform
+// scale. Feed it to SmlMat4_TransformNormals.
+
+static sml_matrix4
+SmlMat4_NormalMatrix(const sml_matrix4 &M)
+{
+    __m128 Rows[3];
+    if(!SmlInt_InverseRows3x3(M, Rows)) return SmlMat4_Identity();
+
+    sml_matrix4 Result;
+    Result.Columns[0] = Rows[0];
+    Result.Columns[1] = Rows[1];
+    Result.Columns[2] = Rows[2];
+    Result.Columns[3] = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+
+    return Result;
+}
+
+// ===================================
+// Batch
+// ===================================
+
+// NOTE: Composes Count world matrices for instance buffers. 4 transforms are
+// transposed into SoA registers, composed lane-wise, and each output column is
+// transposed back. The tail uses SmlMat4_ComposeTRS, which matches bit for bit.
+
+static void
+SmlMat4_ComposeTRSBatch(const sml_transform *Transforms, sml_matrix4 *Out, sml_u32 Count)
+{
+    sml_u32 Idx = 0;
+
+#if !defined(SML_MATH_SCALAR)
+    __m128 One  = _mm_set1_ps(1.0f);
+    __m128 Two  = _mm_set1_ps(2.0f);
+    __m128 Zero = _mm_setzero_ps();
+
+    for(; Idx + 4 <= Count; Idx += 4)
+    {
+        const sml_transform *In = Transforms + Idx;
+
+        __m128 X = In[0].Rotation.Lanes, Y = In[1].Rotation.Lanes;
+        __m128 Z = In[2].Rotation.Lanes, W = In[3].Rotation.Lanes;
+        _MM_TRANSPOSE4_PS(X, Y, Z, W);
+
+        __m128 SX = In[0].Scale.Lanes, SY = In[1].Scale.Lanes;
+        __m128 SZ = In[2].Scale.Lanes, SW = In[3].Scale.Lanes;
+        _MM_TRANSPOSE4_PS(SX, SY, SZ, SW);
+
+        __m128 TX = In[0].Translation.Lanes, TY = In[1].Translation.Lanes;
+        __m128 TZ = In[2].Translation.Lanes, TW = In[3].Translation.Lanes;
+        _MM_TRANSPOSE4_PS(TX, TY, TZ, TW);
+
+        __m128 XX = _mm_mul_ps(X, X), YY = _mm_mul_ps(Y, Y), ZZ = _mm_mul_ps(Z, Z);
+        __m128 XY = _mm_mul_ps(X, Y), XZ = _mm_mul_ps(X, Z), YZ = _mm_mul_ps(Y, Z);
+        __m128 WX = _mm_mul_ps(W, X), WY = _mm_mul_ps(W, Y), WZ = _mm_mul_ps(W, Z);
+
+        // mN of the 4 matrices, one register each.
+        __m128 M0  = _mm_sub_ps(One, _mm_mul_ps(Two, _mm_add_ps(YY, ZZ)));
+        __m128 M4  = _mm_mul_ps(Two, _mm_add_ps(XY, WZ));
+        __m128 M8  = _mm_mul_ps(Two, _mm_sub_ps(XZ, WY));
+        __m128 M1  = _mm_mul_ps(Two, _mm_sub_ps(XY, WZ));
+        __m128 M5  = _mm_sub_ps(One, _mm_mul_ps(Two, _mm_add_ps(XX, ZZ)));
+        __m128 M9  = _mm_mul_ps(Two, _mm_add_ps(YZ, WX));
+        __m128 M2  = _mm_mul_ps(Two, _mm_add_ps(XZ, WY));
+        __m128 M6  = _mm_mul_ps(Two, _mm_sub_ps(YZ, WX));
+        __m128 M10 = _mm_sub_ps(One, _mm_mul_ps(Two, _mm_add_ps(XX, YY)));
+
+        M0 = _mm_mul_ps(M0, SX); M4 = _mm_mul_ps(M4, SX); M8  = _mm_mul_ps(M8 , SX);
+        M1 = _mm_mul_ps(M1, SY); M5 = _mm_mul_ps(M5, SY); M9  = _mm_mul_ps(M9 , SY);
+        M2 = _mm_mul_ps(M2, SZ); M6 = _mm_mul_ps(M6, SZ); M10 = _mm_mul_ps(M10, SZ);
+
+        __m128 Z0 = Zero, Z1 = Zero, Z2 = Zero, W1 = One;
+        _MM_TRANSPOSE4_PS(M0, M4, M8 , Z0);
+        _MM_TRANSPOSE4_PS(M1, M5, M9 , Z1);
+        _MM_TRANSPOSE4_PS(M2, M6, M10, Z2);
+        _MM_TRANSPOSE4_PS(TX, TY, TZ , W1);
+
+        __m128 *Column = Out[Idx].Columns;
+        Column[ 0] = M0; Column[ 1] = M1; Column[ 2] = M2;  Column[ 3] = TX;
+        Column[ 4] = M4; Column[ 5] = M5; Column[ 6] = M6;  Column[ 7] = TY;
+        Column[ 8] = M8; Column[ 9] = M9; Column[10] = M10; Column[11] = TZ;
+        Column[12] = Z0; Column[13] = Z1; Column[14] = Z2;  Column[15] = W1;
+    }
+#endif
+
+    for(; Idx < Count; Idx++)
+    {
+        Out[Idx] = SmlMat4_ComposeTRS(Transforms[Idx]);
+    }
+}
@@ -1,25 +1,44 @@
-struct sml_vector4
+// ===================================
+// Type Definitions
+// ===================================
+
+// NOTE:
+// 1) sml_vector4 is one SSE register. The x/y/z/w view and the Lanes view
+//    share storage, so callers keep using the named fields.
+// 2) sml_vector3 stays 3 packed floats: vertex layouts and mesh positions
+//    depend on its 12 byte size.
+// 3) Defining SML_MATH_SCALAR routes every SIMD function to its scalar
+//    reference (the *Scalar functions), which is handy to bisect math bugs.
+
+union alignas(16) sml_vector4
 {
-    f32 x, y, z, w;
+    struct
+    {
+        sml_f32 x, y, z, w;
+    };
+
+    __m128 Lanes;
 
     sml_vector4(){};
 
-    sml_vector4(f32 x_, f32 y_, f32 z_, f32 w_)
+    sml_vector4(sml_f32 x_, sml_f32 y_, sml_f32 z_, sml_f32 w_)
     {
-        x = x_;
-        y = y_;
-        z = z_;
-        w = w_;
+        Lanes = _mm_setr_ps(x_, y_, z_, w_);
+    }
+
+    explicit sml_vector4(__m128 Lanes_)
+    {
+        Lanes = Lanes_;
     }
 };
 
 struct sml_vector3
 {
-    f32 x, y, z;
+    sml_f32 x, y, z;
 
     sml_vector3(){};
 
-    sml_vector3(f32 x_, f32 y_, f32 z_)
+    sml_vector3(sml_f32 x_, sml_f32 y_, sml_f32 z_)
     {
         x = x_;
         y = y_;
@@ -29,17 +48,38 @@ struct sml_vector3
 
 struct sml_vector2
 {
-    f32 x, y;
+    sml_f32 x, y;
 
     sml_vector2(){};
 
-    sml_vector2(f32 x_, f32 y_)
+    sml_vector2(sml_f32 x_, sml_f32 y_)
     {
         x = x_;
         y = y_;
     }
 };
 
+// ===================================
+// Internal Helpers
+// ===================================
+
+// NOTE: Sum of the 4 lanes, broadcast to every lane.
+
+static inline __m128
+SmlInt_HorizontalAdd(__m128 V)
+{
+    __m128 Swapped = _mm_shuffle_ps(V, V, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 Pairs   = _mm_add_ps(V, Swapped);
+    __m128 Halves  = _mm_shuffle_ps(Pairs, Pairs, _MM_SHUFFLE(1, 0, 3, 2));
+    __m128 Sum     = _mm_add_ps(Pairs, Halves);
+
+    return Sum;
+}
+
+// ===================================
+// Vector3
+// ===================================
+
 inline sml_vector3 operator+(const sml_vector3 &A, const sml_vector3 &B)
 {
     sml_vector3 Result;
@@ -70,10 +110,10 @@ inline sml_vector3 operator-(const sml_vector3 &A, const sml_vector3 &B)
     return Result;
 }
 
-static f32
+static sml_f32
 SmlVec3_Dot(sml_vector3 A, sml_vector3 B)
 {
-    f32 Result = 0;
+    sml_f32 Result = 0;
 
     Result += A.x * B.x;
     Result += A.y * B.y;
@@ -83,7 +123,7 @@ SmlVec3_Dot(sml_vector3 A, sml_vector3 B)
 }
 
 static sml_vector3
-SmlVec3_Scale(const sml_vector3 &A, f32 Scalar)
+SmlVec3_Scale(const sml_vector3 &A, sml_f32 Scalar)
 {
     sml_vector3 Result;
 
@@ -113,17 +153,19 @@ SmlVec3_VectorProduct(sml_vector3 A, sml_vector3 B)
     return Result;
 }
 
+// NOTE: The zero vector normalizes to itself.
+
 static sml_vector3
 SmlVec3_Normalize(sml_vector3 A)
 {
-    sml_vector3 Result;
+    sml_vector3 Result = sml_vector3(0.0f, 0.0f, 0.0f);
 
-    f32 LengthSquared = SmlVec3_Dot(A, A);
+    sml_f32 LengthSquared = SmlVec3_Dot(A, A);
 
     if(LengthSquared > 0.0f)
     {
-        f32 Length    = sqrtf(LengthSquared);
-        f32 InvLength = 1.0f/Length;
+        sml_f32 Length    = sqrtf(LengthSquared);
+        sml_f32 InvLength = 1.0f/Length;
 
         Result.x = A.x * InvLength;
         Result.y = A.y * InvLength;
@@ -132,3 +174,131 @@ SmlVec3_Normalize(sml_vector3 A)
 
     return Result;
 }
+
+// ===================================
+// Vector4 (scalar reference)
+// ===================================
+
+static sml_f32
+SmlVec4_DotScalar(const sml_vector4 &A, const sml_vector4 &B)
+{
+    sml_f32 Result = (A.x * B.x) + (A.y * B.y) + (A.z * B.z) + (A.w * B.w);
+    return Result;
+}
+
+static sml_vector4
+SmlVec4_CrossScalar(const sml_vector4 &A, const sml_vector4 &B)
+{
+    sml_vector4 Result;
+
+    Result.x = (A.y * B.z) - (A.z * B.y);
+    Result.y = (A.z * B.x) - (A.x * B.z);
+    Result.z = (A.x * B.y) - (A.y * B.x);
+    Result.w = 0.0f;
+
+    return Result;
+}
+
+static sml_vector4
+SmlVec4_NormalizeScalar(const sml_vector4 &A)
+{
+    sml_vector4 Result = sml_vector4(0.0f, 0.0f, 0.0f, 0.0f);
+
+    sml_f32 LengthSquared = SmlVec4_DotScalar(A, A);
+
+    if(LengthSquared > 0.0f)
+    {
+        sml_f32 Length = sqrtf(LengthSquared);
+
+        Result.x = A.x / Length;
+        Result.y = A.y / Length;
+        Result.z = A.z / Length;
+        Result.w = A.w / Length;
+    }
+
+    return Result;
+}
+
+// ===================================
+// Vector4
+// ===================================
+
+inline sml_vector4 operator+(const sml_vector4 &A, const sml_vector4 &B)
+{
+    return sml_vector4(_mm_add_ps(A.Lanes, B.Lanes));
+}
+
+inline sml_vector4 operator-(const sml_vector4 &A, const sml_vector4 &B)
+{
+    return sml_vector4(_mm_sub_ps(A.Lanes, B.Lanes));
+}
+
+inline sml_vector4 operator*(const sml_vector4 &A, const sml_vector4 &B)
+{
+    return sml_vector4(_mm_mul_ps(A.Lanes, B.Lanes));
+}
+
+static inline sml_vector4
+SmlVec4_FromVec3(const sml_vector3 &A, sml_f32 w)
+{
+    return sml_vector4(A.x, A.y, A.z, w);
+}
+
+static inline sml_vector3
+SmlVec4_ToVec3(const sml_vector4 &A)
+{
+    return sml_vector3(A.x, A.y, A.z);
+}
+
+static inline sml_vector4
+SmlVec4_Scale(const sml_vector4 &A, sml_f32 Scalar)
+{
+    return sml_vector4(_mm_mul_ps(A.Lanes, _mm_set1_ps(Scalar)));
+}
+
+static inline sml_f32
+SmlVec4_Dot(const sml_vector4 &A, const sml_vector4 &B)
+{
+#if defined(SML_MATH_SCALAR)
+    return SmlVec4_DotScalar(A, B);
+#else
+    return _mm_cvtss_f32(SmlInt_HorizontalAdd(_mm_mul_ps(A.Lanes, B.Lanes)));
+#endif
+}
+
+// NOTE: 3D cross product of the xyz lanes, w is set to 0.
+
+static inline sml_vector4
+SmlVec4_Cross(const sml_vector4 &A, const sml_vector4 &B)
+{
+#if defined(SML_MATH_SCALAR)
+    return SmlVec4_CrossScalar(A, B);
+#else
+    __m128 AYZX = _mm_shuffle_ps(A.Lanes, A.Lanes, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 BYZX = _mm_shuffle_ps(B.Lanes, B.Lanes, _MM_SHUFFLE(3, 0, 2, 1));
+
+    // (z, x, y) of the result, rotated back in place below.
+    __m128 ZXY = _mm_sub_ps(_mm_mul_ps(A.Lanes, BYZX), _mm_mul_ps(AYZX, B.Lanes));
+    __m128 XYZ = _mm_shuffle_ps(ZXY, ZXY, _MM_SHUFFLE(3, 0, 2, 1));
+
+    __m128 MaskW = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+
+    return sml_vector4(_mm_and_ps(XYZ, MaskW));
+#endif
+}
+
+static inline sml_vector4
+SmlVec4_Normalize(const sml_vector4 &A)
+{
+#if defined(SML_MATH_SCALAR)
+    return SmlVec4_NormalizeScalar(A);
+#else
+    __m128 LengthSquared = SmlInt_HorizontalAdd(_mm_mul_ps(A.Lanes, A.Lanes));
+    __m128 NonZero       = _mm_cmpgt_ps(LengthSquared, _mm_setzero_ps());
+
+    // NOTE: sqrt + div rather than rsqrt, to match the scalar reference.
+    __m128 Result = _mm_div_ps(A.Lanes, _mm_sqrt_ps(LengthSquared));
+
+    return sml_vector4(_mm_and_ps(Result, NonZero));
+#endif
+}
@@ -1,4 +1,6 @@
-// TODO: Simplify this code | Add coalescing
+// TODO: Simplify this code
+
+#include <atomic> // Allocation lock
 
 struct sml_heap_block
 {
@@ -18,6 +20,7 @@ struct sml_memory
     // Free-list
     sml_heap_block *FreeList;
     sml_u32         FreeCount;
+    sml_u32         FreeCapacity;
     sml_u32         NextIdx;
 
     sml_u32 *NextArray;
@@ -25,11 +28,32 @@ struct sml_memory
     sml_u32  Head;
     sml_u32  Tail;
 
+    // Indices given up by merged blocks, taken before NextIdx grows
+    sml_u32 *Released;
+    sml_u32  ReleasedCount;
+
     // Meta-data
     bool ResizeOnFull;
 
+    // NOTE: Allocate, Free and Reallocate take one global spin lock, so jobs on
+    // worker threads (see Sml_ParallelFor) can allocate. Every call is
+    // serialized, and both the first-fit search and the sorted insert in
+    // FreeBlock walk the free list, so the time held grows with the number of
+    // free blocks. Hot parallel loops should allocate per job, not per item.
+    // SML_MEMORY_STATS counts the locks taken, those that had to spin and the
+    // TSC cycles held, the navmesh bench reports them next to its scaling.
+    std::atomic<bool> Locked{false};
+
+#ifdef SML_MEMORY_STATS
+    sml_u64 Locks{0};
+    sml_u64 Contended{0};
+    sml_u64 HeldCycles{0};
+    sml_u64 LockedAt{0};
+#endif
+
     static constexpr sml_u32 Invalid      = sml_u32(-1);
     static constexpr sml_u32 FreeListSize = 1000;
+    static constexpr size_t  Alignment    = 16;
 
     sml_memory(){};
     sml_memory(size_t HeapSize, bool ResizeOnFull = false)
@@ -38,15 +62,19 @@ struct sml_memory
         this->PushSize     = 0;
         this->PushCapacity = HeapSize;
 
-        this->FreeCount = 0;
-        this->FreeList  =
+        this->FreeCount    = 0;
+        this->FreeCapacity = this->FreeListSize;
+        this->FreeList     =
             (sml_heap_block*)malloc(this->FreeListSize * sizeof(sml_heap_block));
 
-        this->NextArray = (sml_u32*)malloc(this->FreeListSize * sizeof(sml_u32) * 2);
+        this->NextArray = (sml_u32*)malloc(this->FreeListSize * sizeof(sml_u32) * 3);
         this->PrevArray = this->NextArray + this->FreeListSize;
+        this->Released  = this->PrevArray + this->FreeListSize;
         this->Head      = this->Invalid;
         this->Tail      = this->Invalid;
 
+        this->ReleasedCount = 0;
+
         this->ResizeOnFull = ResizeOnFull;
         this->NextIdx = 0;
 
@@ -59,12 +87,76 @@ struct sml_memory
         }
     }
 
+    // NOTE: Blocks start on a 16 byte boundary so SIMD types (sml_vector4,
+    // sml_matrix4) can live in them. Block.Size stays the requested size since
+    // callers derive element counts from it, the padding is implied.
+
     sml_heap_block Allocate(size_t RequestedSize)
+    {
+        this->Lock();
+        sml_heap_block Block = this->AllocateBlock(RequestedSize);
+        this->Unlock();
+
+        return Block;
+    }
+
+    void Free(sml_heap_block Block)
+    {
+        this->Lock();
+        this->FreeBlock(Block);
+        this->Unlock();
+    }
+
+    sml_heap_block Reallocate(sml_heap_block OldBlock, sml_u32 Growth)
+    {
+        this->Lock();
+
+        auto NewBlock = this->AllocateBlock(OldBlock.Size * Growth);
+        memcpy(NewBlock.Data, OldBlock.Data, OldBlock.Size);
+
+        this->FreeBlock(OldBlock);
+
+        this->Unlock();
+
+        return NewBlock;
+    }
+
+    inline void Lock()
+    {
+        bool Spun = false;
+
+        while(this->Locked.exchange(true, std::memory_order_acquire))
+        {
+            while(this->Locked.load(std::memory_order_relaxed)) _mm_pause();
+            Spun = true;
+        }
+
+#ifdef SML_MEMORY_STATS
+        this->Locks     += 1;
+        this->Contended += Spun;
+        this->LockedAt   = __rdtsc();
+#else
+        (void)Spun;
+#endif
+    }
+
+    inline void Unlock()
+    {
+#ifdef SML_MEMORY_STATS
+        this->HeldCycles += __rdtsc() - this->LockedAt;
+#endif
+
+        this->Locked.store(false, std::memory_order_release);
+    }
+
+    sml_heap_block AllocateBlock(size_t RequestedSize)
     {
         Sml_Assert(this->PushBase  && this->FreeList &&
                    this->NextArray && this->PrevArray);
 
-        if(this->PushSize + RequestedSize > this->PushCapacity)
+        size_t AlignedSize = this->AlignSize(RequestedSize);
+
+        if(this->PushSize + AlignedSize > this->PushCapacity)
         {
             if(this->ResizeOnFull)
             {
@@ -84,7 +176,7 @@ struct sml_memory
         {
             sml_heap_block *Block = this->FreeList + Idx;
 
-            if(Block->Size >= RequestedSize)
+            if(Block->Size >= AlignedSize)
             {
                 FreeBlock = Block;
                 break;
@@ -95,41 +187,7 @@ struct sml_memory
 
         if (FreeBlock)
         {
-            sml_u32 Prev = this->PrevArray[Idx];
-            sml_u32 Next = this->NextArray[Idx];
-
-            if (Prev == this->Invalid)
-            {
-                this->Head = Next;
-                if (this->Head != this->Invalid)
-                {
-                    this->PrevArray[this->Head] = this->Invalid;
-                }
-                else
-                {
-                    this->Tail = this->Invalid;
-                }
-            }
-            else if (Next == this->Invalid)
-            {
-                this->Tail = Prev;
-                if (this->Tail != this->Invalid)
-                {
-                    this->NextArray[this->Tail] = this->Invalid;
-                }
-                else
-                {
-                    this->Head = this->Invalid;
-                }
-            }
-            else
-            {
-                this->NextArray[Prev] = Next;
-                this->PrevArray[Next] = Prev;
-
-                this->NextArray[Idx] = this->Invalid;
-                this->PrevArray[Idx] = this->Invalid;
-            }
+            this->UnlinkFree(Idx);
 
             sml_heap_block Result = {};
             Result.Data   = (sml_u8*)this->PushBase + FreeBlock->At;
@@ -137,20 +195,18 @@ struct sml_memory
             Result.At     = FreeBlock->At;
             Result.IntIdx = FreeBlock->IntIdx;
 
-            size_t SizeDiff = FreeBlock->Size - RequestedSize;
+            size_t SizeDiff = FreeBlock->Size - AlignedSize;
             if (SizeDiff > 0)
             {
                 sml_heap_block Extra = {};
-                Extra.Data   = (sml_u8*)this->PushBase + FreeBlock->At + RequestedSize;
+                Extra.Data   = (sml_u8*)this->PushBase + FreeBlock->At + AlignedSize;
                 Extra.Size   = SizeDiff;
-                Extra.At     = FreeBlock->At + RequestedSize;
-                Extra.IntIdx = this->NextIdx++;
+                Extra.At     = FreeBlock->At + AlignedSize;
+                Extra.IntIdx = this->TakeIndex();
 
-                this->Free(Extra);
+                this->FreeBlock(Extra);
             }
 
-            --this->FreeCount;
-
             return Result;
         }    
         else
@@ -159,76 +215,169 @@ struct sml_memory
             Block.Data   = (sml_u8*)this->PushBase + this->PushSize;
             Block.Size   = RequestedSize;
             Block.At     = this->PushSize;
-            Block.IntIdx = this->NextIdx++;
+            Block.IntIdx = this->TakeIndex();
 
-            this->PushSize += RequestedSize;
+            this->PushSize += AlignedSize;
 
             return Block;
         }
     }
 
-    void Free(sml_heap_block Block)
-    {
-        Sml_Assert(Block.IntIdx < this->FreeListSize);
+    // NOTE: The free list is sorted by At, so the neighbours in memory are the
+    // neighbours in the list. A block is merged with the free blocks right
+    // before and after it, and handed back to the push area when it ends at
+    // PushSize. Merged blocks give up their IntIdx.
 
-        this->FreeList[Block.IntIdx] = Block;
+    void FreeBlock(sml_heap_block Block)
+    {
+        Block.Size = this->AlignSize(Block.Size);
 
-        if (this->Head == this->Invalid)
+        sml_u32 Next = this->Head;
+        while (Next != this->Invalid && this->FreeList[Next].At < Block.At)
         {
-            this->Head = Block.IntIdx;
-            this->Tail = Block.IntIdx;
+            Next = this->NextArray[Next];
         }
-        else
+
+        Sml_Assert(Next == this->Invalid || this->FreeList[Next].At != Block.At);
+
+        sml_u32 Prev = Next == this->Invalid ? this->Tail : this->PrevArray[Next];
+
+        if (Prev != this->Invalid &&
+            this->FreeList[Prev].At + this->FreeList[Prev].Size == Block.At)
         {
-            sml_u32 InsertAt = this->Head;
-            while (InsertAt != this->Invalid && Block.At > this->FreeList[InsertAt].At)
-            {
-                InsertAt = this->NextArray[InsertAt];
-            }
+            sml_u32 Before = this->PrevArray[Prev];
 
-            if (InsertAt == this->Head)
-            {
-                Sml_Assert(this->FreeList[InsertAt].At > Block.At);
+            this->ReleaseIndex(Block.IntIdx);
+            this->UnlinkFree(Prev);
 
-                this->NextArray[Block.IntIdx] = this->Head;
-                this->PrevArray[Block.IntIdx] = this->Invalid;
+            Block.At     = this->FreeList[Prev].At;
+            Block.Size  += this->FreeList[Prev].Size;
+            Block.IntIdx = Prev;
 
-                this->PrevArray[this->Head] = Block.IntIdx;
+            Prev = Before;
+        }
 
-                this->Head = Block.IntIdx;
-            }
-            else if (InsertAt == this->Invalid)
-            {
-                this->NextArray[Block.IntIdx] = this->Invalid;
-                this->PrevArray[Block.IntIdx] = this->Tail;
+        if (Next != this->Invalid && Block.At + Block.Size == this->FreeList[Next].At)
+        {
+            Block.Size += this->FreeList[Next].Size;
 
-                this->NextArray[this->Tail] = Block.IntIdx;
+            sml_u32 After = this->NextArray[Next];
 
-                this->Tail = Block.IntIdx;
-            }
-            else
-            {
-                this->NextArray[Block.IntIdx] = InsertAt;
-                this->PrevArray[Block.IntIdx] = this->PrevArray[InsertAt];
+            this->UnlinkFree(Next);
+            this->ReleaseIndex(Next);
 
-                this->PrevArray[InsertAt] = Block.IntIdx;
+            Next = After;
+        }
 
-                this->NextArray[this->PrevArray[Block.IntIdx]] = Block.IntIdx;
-            }
+        if (Block.At + Block.Size == this->PushSize)
+        {
+            this->PushSize = Block.At;
+            this->ReleaseIndex(Block.IntIdx);
+
+            return;
         }
 
+        Block.Data = (sml_u8*)this->PushBase + Block.At;
+
+        this->FreeList[Block.IntIdx]  = Block;
+        this->NextArray[Block.IntIdx] = Next;
+        this->PrevArray[Block.IntIdx] = Prev;
+
+        if (Prev == this->Invalid) this->Head = Block.IntIdx;
+        else                       this->NextArray[Prev] = Block.IntIdx;
+
+        if (Next == this->Invalid) this->Tail = Block.IntIdx;
+        else                       this->PrevArray[Next] = Block.IntIdx;
+
         ++this->FreeCount;
     }
 
-    sml_heap_block Reallocate(sml_heap_block OldBlock, sml_u32 Growth)
+    void UnlinkFree(sml_u32 Idx)
     {
-        auto NewBlock = this->Allocate(OldBlock.Size * Growth);
-        memcpy(NewBlock.Data, OldBlock.Data, OldBlock.Size);
+        sml_u32 Prev = this->PrevArray[Idx];
+        sml_u32 Next = this->NextArray[Idx];
 
-        this->Free(OldBlock);
+        if (Prev == this->Invalid) this->Head = Next;
+        else                       this->NextArray[Prev] = Next;
 
-        return NewBlock;
+        if (Next == this->Invalid) this->Tail = Prev;
+        else                       this->PrevArray[Next] = Prev;
+
+        this->NextArray[Idx] = this->Invalid;
+        this->PrevArray[Idx] = this->Invalid;
+
+        --this->FreeCount;
+    }
+
+    // NOTE: Every block, handed out or free, owns an IntIdx. With merging their
+    // number follows the peak block count, so the free-list arrays only grow
+    // when that peak does.
+
+    sml_u32 TakeIndex()
+    {
+        if (this->ReleasedCount) return this->Released[--this->ReleasedCount];
+
+        if (this->NextIdx == this->FreeCapacity) this->GrowFreeList();
+
+        return this->NextIdx++;
+    }
+
+    inline void ReleaseIndex(sml_u32 Idx)
+    {
+        this->Released[this->ReleasedCount++] = Idx;
+    }
+
+    void GrowFreeList()
+    {
+        sml_u32 NewCapacity = this->FreeCapacity * 2;
+
+        this->FreeList = (sml_heap_block*)realloc(this->FreeList,
+                                                  NewCapacity * sizeof(sml_heap_block));
+        memset(this->FreeList + this->FreeCapacity, 0,
+               (NewCapacity - this->FreeCapacity) * sizeof(sml_heap_block));
+
+        sml_u32 *NewNext     = (sml_u32*)malloc(NewCapacity * sizeof(sml_u32) * 3);
+        sml_u32 *NewPrev     = NewNext + NewCapacity;
+        sml_u32 *NewReleased = NewPrev + NewCapacity;
+
+        memcpy(NewNext, this->NextArray, this->FreeCapacity * sizeof(sml_u32));
+        memcpy(NewPrev, this->PrevArray, this->FreeCapacity * sizeof(sml_u32));
+        memcpy(NewReleased, this->Released, this->ReleasedCount * sizeof(sml_u32));
+
+        for(sml_u32 Idx = this->FreeCapacity; Idx < NewCapacity; Idx++)
+        {
+            NewNext[Idx] = NewPrev[Idx] = this->Invalid;
+        }
+
+        free(this->NextArray);
+
+        this->NextArray    = NewNext;
+        this->PrevArray    = NewPrev;
+        this->Released     = NewReleased;
+        this->FreeCapacity = NewCapacity;
+    }
+
+    inline size_t AlignSize(size_t Size)
+    {
+        return (Size + (this->Alignment - 1)) & ~(this->Alignment - 1);
     }
 };
 
-static auto SmlMemory = sml_memory(Sml_Megabytes(50));
\ No newline at end of file
+// NOTE: Tools like the benchmark runner need a bigger heap than the editor.
+#ifndef SML_HEAP_SIZE
+#define SML_HEAP_SIZE Sml_Megabytes(50)
+#endif
+
+static auto SmlMemory = sml_memory(SML_HEAP_SIZE);
+
+// NOTE: Callers over-allocate by Alignment - 1 bytes and keep the original
+// block around to free it.
+
+static inline void*
+Sml_AlignPointer(void *Pointer, size_t Alignment)
+{
+    uintptr_t Address = (uintptr_t)Pointer;
+    uintptr_t Aligned = (Address + (Alignment - 1)) & ~(uintptr_t)(Alignment - 1);
+
+    return (void*)Aligned;
+}
\ No newline at end of file
@@ -0,0 +1,191 @@
+// ===================================
+// Type Definitions
+// ===================================
+
+// NOTE:
+// 1) SIMD kernels are compiled for every ISA in the same binary and bound to
+//    function pointers once, when the globals are initialized. The unity build
+//    keeps that in definition order, so SmlCpu is ready before any kernel table.
+// 2) SML_FORCE_ISA=scalar|sse2|sse4.1|avx2|avx512 selects a lower path, to
+//    benchmark and test every kernel on one machine. Asking for more than the
+//    CPU has is clamped to the best supported ISA.
+// 3) Kernels needing more than SSE2 (the x64 baseline) are tagged with
+//    SML_TARGET_*. MSVC emits any intrinsic without flags, GCC and Clang need
+//    the target attribute.
+// 4) SML_MATH_SCALAR forces the scalar ISA.
+
+#if defined(_MSC_VER)
+#define SML_TARGET_SSE41
+#define SML_TARGET_AVX2
+#define SML_TARGET_AVX512
+#else
+#include <cpuid.h>
+#define SML_TARGET_SSE41  __attribute__((target("sse4.1")))
+#define SML_TARGET_AVX2   __attribute__((target("avx2")))
+#define SML_TARGET_AVX512 __attribute__((target("avx512f,avx512vl,avx512bw")))
+#endif
+
+enum Sml_Isa
+{
+    SmlIsa_Scalar,
+    SmlIsa_SSE2,
+    SmlIsa_SSE41,
+    SmlIsa_AVX2,
+    SmlIsa_AVX512,
+
+    SmlIsa_Count,
+};
+
+static const char *SmlIsaNames[SmlIsa_Count] =
+{
+    "scalar", "sse2", "sse4.1", "avx2", "avx512",
+};
+
+struct sml_cpu_features
+{
+    bool SSE2;
+    bool SSE41;
+    bool AVX;
+    bool AVX2;
+    bool FMA;
+    bool AVX512;
+
+    // Highest ISA the CPU and the OS support.
+    Sml_Isa Best;
+
+    // ISA the kernels are bound to, Best unless forced lower.
+    Sml_Isa Isa;
+};
+
+// ===================================
+// Internal Helpers
+// ===================================
+
+static void
+SmlInt_Cpuid(sml_u32 Leaf, sml_u32 SubLeaf, sml_u32 Registers[4])
+{
+#if defined(_MSC_VER)
+    __cpuidex((int*)Registers, (int)Leaf, (int)SubLeaf);
+#else
+    __cpuid_count(Leaf, SubLeaf, Registers[0], Registers[1], Registers[2], Registers[3]);
+#endif
+}
+
+// NOTE: XCR0, which register states the OS saves on context switches. Only
+// valid when CPUID reports OSXSAVE.
+
+static sml_u64
+SmlInt_ReadXcr0()
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    sml_u32 Low, High;
+    __asm__ volatile("xgetbv" : "=a"(Low), "=d"(High) : "c"(0));
+
+    return ((sml_u64)High << 32) | Low;
+#endif
+}
+
+static Sml_Isa
+SmlInt_ParseIsa(const char *Name)
+{
+    for(sml_u32 Idx = 0; Idx < SmlIsa_Count; Idx++)
+    {
+        if(strcmp(Name, SmlIsaNames[Idx]) == 0) return (Sml_Isa)Idx;
+    }
+
+    if(strcmp(Name, "sse41") == 0) return SmlIsa_SSE41;
+
+    return SmlIsa_Count;
+}
+
+// ===================================
+// User API
+// ===================================
+
+static sml_cpu_features
+Sml_DetectCpu()
+{
+    sml_cpu_features Features = {};
+
+    sml_u32 Registers[4] = {};
+    SmlInt_Cpuid(0, 0, Registers);
+
+    sml_u32 MaxLeaf = Registers[0];
+
+    if(MaxLeaf >= 1)
+    {
+        SmlInt_Cpuid(1, 0, Registers);
+
+        sml_u32 ECX = Registers[2];
+        sml_u32 EDX = Registers[3];
+
+        Features.SSE2  = (EDX & (1u << 26)) != 0;
+        Features.SSE41 = (ECX & (1u << 19)) != 0;
+
+        bool OSXSave = (ECX & (1u << 27)) != 0;
+        bool CpuAVX  = (ECX & (1u << 28)) != 0;
+        bool CpuFMA  = (ECX & (1u << 12)) != 0;
+
+        sml_u64 Xcr0 = OSXSave ? SmlInt_ReadXcr0() : 0;
+
+        // SSE and AVX state, then opmask and both halves of zmm0-31.
+        bool OSAvx    = (Xcr0 & 0x06) == 0x06;
+        bool OSAvx512 = (Xcr0 & 0xe6) == 0xe6;
+
+        Features.AVX = CpuAVX && OSAvx;
+        Features.FMA = CpuFMA && OSAvx;
+
+        if(MaxLeaf >= 7)
+        {
+            SmlInt_Cpuid(7, 0, Registers);
+
+            sml_u32 EBX = Registers[1];
+
+            // AVX-512 F, BW and VL.
+            sml_u32 AVX512Bits = (1u << 16) | (1u << 30) | (1u << 31);
+            bool    CpuAVX512  = (EBX & AVX512Bits) == AVX512Bits;
+
+            Features.AVX2   = Features.AVX && (EBX & (1u << 5)) != 0;
+            Features.AVX512 = Features.AVX2 && OSAvx512 && CpuAVX512;
+        }
+    }
+
+    Features.Best = SmlIsa_Scalar;
+    if(Features.SSE2)   Features.Best = SmlIsa_SSE2;
+    if(Features.SSE41)  Features.Best = SmlIsa_SSE41;
+    if(Features.AVX2)   Features.Best = SmlIsa_AVX2;
+    if(Features.AVX512) Features.Best = SmlIsa_AVX512;
+
+    Features.Isa = Features.Best;
+
+#if defined(SML_MATH_SCALAR)
+    Features.Isa = SmlIsa_Scalar;
+#else
+    const char *Forced = getenv("SML_FORCE_ISA");
+    if(Forced && Forced[0])
+    {
+        Sml_Isa Isa = SmlInt_ParseIsa(Forced);
+
+        if(Isa == SmlIsa_Count)
+        {
+            fprintf(stderr, "SML_FORCE_ISA: unknown ISA '%s', using %s.\n", Forced,
+                    SmlIsaNames[Features.Best]);
+        }
+        else if(Isa > Features.Best)
+        {
+            fprintf(stderr, "SML_FORCE_ISA: %s is not supported, using %s.\n", Forced,
+                    SmlIsaNames[Features.Best]);
+        }
+        else
+        {
+            Features.Isa = Isa;
+        }
+    }
+#endif
+
+    return Features;
+}
+
+static auto SmlCpu = Sml_DetectCpu();
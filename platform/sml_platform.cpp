@@ -30,8 +30,8 @@ struct sml_game_controller_input
 
 struct platform_file
 {
-    char                   Name[MaxNameLength];
-    char                   FullPath[MaxPathLength];
+    sml_atom               Name;
+    sml_atom               FullPath;
     bool                   IsDir;
     sml_u32                Parent;
     dynamic_array<sml_u32> Children;
@@ -215,8 +215,8 @@ Platform_BuildFileTree(const char *RootUTF8)
     Root.Parent   = sml_u32(-1);
     Root.IsDir    = true;
     Root.Children = dynamic_array<sml_u32>(0);
-    strncpy_s(Root.Name    , MaxNameLength, "Root"  , _TRUNCATE);
-    strncpy_s(Root.FullPath, MaxPathLength, RootUTF8, _TRUNCATE);
+    Root.Name     = SmlAtom_Intern("Root");
+    Root.FullPath = SmlAtom_Intern(RootUTF8);
 
     FileTree.Push(Root);
 
@@ -229,7 +229,7 @@ Platform_BuildFileTree(const char *RootUTF8)
         }
 
         wchar_t WidePath[MaxPathLength];
-        SmlWin32_UTF8ToWide(Parent->FullPath, WidePath, MaxPathLength);
+        SmlWin32_UTF8ToWide(SmlAtom_String(Parent->FullPath), WidePath, MaxPathLength);
         wcscat_s(WidePath, MaxPathLength, L"/*");
 
         WIN32_FIND_DATAW Data;
@@ -257,10 +257,15 @@ Platform_BuildFileTree(const char *RootUTF8)
                 Entry.Children = dynamic_array<sml_u32>(16);
             }
 
-            SmlWin32_WideToUTF8(Data.cFileName, Entry.Name, MaxNameLength);
+            char Name[MaxNameLength] = {};
+            SmlWin32_WideToUTF8(Data.cFileName, Name, MaxNameLength);
 
-            snprintf(Entry.FullPath, MaxPathLength, "%s/%s",
-                     Parent->FullPath, Entry.Name);
+            char FullPath[MaxPathLength] = {};
+            snprintf(FullPath, MaxPathLength, "%s/%s",
+                     SmlAtom_String(Parent->FullPath), Name);
+
+            Entry.Name     = SmlAtom_Intern(Name);
+            Entry.FullPath = SmlAtom_Intern(FullPath);
 
             Parent->Children.Push(FileTree.Count);
             FileTree.Push(Entry);
@@ -76,7 +76,7 @@ DebugNavmesh()
     while (Idx != slot_map<mesh_record, u32>::Invalid)
     {
         auto* Rec = SmlMeshes.Data + Idx;
-        if (ImGui::Selectable(Rec->Name, false))
+        if (ImGui::Selectable(SmlAtom_String(Rec->Name), false))
         {
             Manager.ActiveMesh = SmlMeshes.Data + Idx;
         }
@@ -101,7 +101,7 @@ DebugNavmesh()
         ImGui::TableSetColumnIndex(0);
             ImGui::Text("Name");
         ImGui::TableSetColumnIndex(1);
-            ImGui::Text(Act->Name);
+            ImGui::TextUnformatted(SmlAtom_String(Act->Name));
 
         ImGui::TableNextRow();
         ImGui::TableSetColumnIndex(0);
@@ -393,7 +393,7 @@ Dx11_UpdateInstance(update_command_instance *Payload)
         }
     }
 
-    sml_matrix4 World = SmlMat4_Translation(Payload->Position);
+    sml_matrix4 World = SmlMat4_ComposeTRS(Payload->Transform);
 
     D3D11_MAPPED_SUBRESOURCE Mapped = {};
     Dx11.Context->Map(Instance->PerObject, 0, D3D11_MAP_WRITE_DISCARD, 0, &Mapped);
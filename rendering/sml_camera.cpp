@@ -11,6 +11,10 @@ struct camera_perspective
 {
     sml_matrix4 View;
     sml_matrix4 Projection;
+    sml_matrix4 ViewProjection;
+
+    // NOTE: World space planes of the last update, for CPU culling.
+    sml_frustum Frustum;
 
     sml_vector3 Position;
     sml_vector3 Target;
@@ -100,7 +104,8 @@ UpdateCamera(camera_perspective *Camera, sml_window Window,
 
     Camera->View        = SmlMat4_LookAt(Camera->Position, Right, Camera->Up,Forward);
     Camera->Projection  = SmlMat4_Perspective(Camera->FovY, Camera->Aspect);
-    auto ViewProjection = SmlMat4_Multiply(Camera->Projection, Camera->View);
+    Camera->ViewProjection = SmlMat4_Multiply(Camera->Projection, Camera->View);
+    Camera->Frustum        = SmlFrustum_FromMatrix(Camera->ViewProjection);
 
-    UpdateCamera(ViewProjection);
+    UpdateCamera(Camera->ViewProjection);
 }
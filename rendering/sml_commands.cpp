@@ -25,7 +25,10 @@ enum RenderCommand_Flag
     RenderCommand_DebugShader = 1 << 1,
 };
 
-struct command_header
+// NOTE: Payloads are read in place by the backends and some hold SIMD types,
+// so headers and payloads both take a multiple of 16 bytes.
+
+struct alignas(16) command_header
 {
     RenderCommand_Type Type;
     sml_u32            Size;
@@ -54,7 +57,7 @@ struct update_command_instance
     sml_heap_block VtxHeap;
     sml_heap_block IdxHeap;
     sml_u32        IdxCount;
-    sml_vector3    Position;
+    sml_transform  Transform;
 
     sml_bit_field Flags;
 
@@ -83,7 +86,11 @@ struct draw_command_instance
 static void
 PushRenderCommand(command_header *Header, void *Payload, sml_u32 PayloadSize)
 {
-    size_t NeededSize = sizeof(command_header) + PayloadSize;
+    // Playback skips Header->Size bytes, so the padding goes into it.
+    Header->Size = (PayloadSize + (alignof(command_header) - 1)) &
+                   ~sml_u32(alignof(command_header) - 1);
+
+    size_t NeededSize = sizeof(command_header) + Header->Size;
     if(Renderer->CommandPushSize + NeededSize <= Renderer->CommandPushCapacity)
     {
         sml_u8 *WritePointer = 
@@ -143,8 +150,23 @@ UpdateInstance(instance Instance, sml_vector3 Position)
     Header.Size = sizeof(update_command_instance);
 
     update_command_instance Payload = {};
-    Payload.Position = Position;
-    Payload.Instance = Instance;
+    Payload.Transform             = SmlTransform_Identity();
+    Payload.Transform.Translation = SmlVec4_FromVec3(Position, 0.0f);
+    Payload.Instance              = Instance;
+
+    PushRenderCommand(&Header, &Payload, Header.Size);
+}
+
+static void
+UpdateInstance(instance Instance, const sml_transform &Transform)
+{
+    command_header Header = {};
+    Header.Type = UpdateCommand_Instance;
+    Header.Size = sizeof(update_command_instance);
+
+    update_command_instance Payload = {};
+    Payload.Transform = Transform;
+    Payload.Instance  = Instance;
 
     PushRenderCommand(&Header, &Payload, Header.Size);
 }
@@ -160,10 +182,11 @@ UpdateInstance(instance Instance, sml_heap_block VtxHeap, sml_heap_block IdxHeap
     update_command_instance Payload = {};
     Payload.VtxHeap  = VtxHeap;
     Payload.IdxHeap  = IdxHeap;
-    Payload.IdxCount = IdxCount;
-    Payload.Material = Material;
-    Payload.Flags    = Flags;
-    Payload.Instance = Instance;
+    Payload.IdxCount  = IdxCount;
+    Payload.Material  = Material;
+    Payload.Transform = SmlTransform_Identity();
+    Payload.Flags     = Flags;
+    Payload.Instance  = Instance;
 
     PushRenderCommand(&Header, &Payload, Header.Size);
 }
@@ -178,13 +201,14 @@ UpdateInstance(instance Instance, sml_heap_block VtxHeap, sml_heap_block IdxHeap
     Header.Size = sizeof(update_command_instance);
 
     update_command_instance Payload = {};
-    Payload.VtxHeap  = VtxHeap;
-    Payload.IdxHeap  = IdxHeap;
-    Payload.IdxCount = IdxCount;
-    Payload.Material = Material;
-    Payload.Position = Position;
-    Payload.Flags    = Flags;
-    Payload.Instance = Instance;
+    Payload.VtxHeap               = VtxHeap;
+    Payload.IdxHeap               = IdxHeap;
+    Payload.IdxCount              = IdxCount;
+    Payload.Material              = Material;
+    Payload.Transform             = SmlTransform_Identity();
+    Payload.Transform.Translation = SmlVec4_FromVec3(Position, 0.0f);
+    Payload.Flags                 = Flags;
+    Payload.Instance              = Instance;
 
     PushRenderCommand(&Header, &Payload, Header.Size);
 }
@@ -44,18 +44,41 @@ struct mesh
         this->IdxData = (I*)this->IdxHeap.Data;
     }
 
+    // NOTE: Writes straight into the array instead of Push, the count is known.
+    // Meshes without vertices used to read past the vertex data (Capacity 8).
+
     inline dynamic_array<sml_vector3> PackPositions()
     {
-        auto Positions = 
-            dynamic_array<sml_vector3>(sml_u32(this->VtxHeap.Size / sizeof(V)));
+        sml_u32 VtxCount  = this->VertexCount();
+        auto    Positions = dynamic_array<sml_vector3>(VtxCount, false);
 
-        for(sml_u32 Idx = 0; Idx < Positions.Capacity; Idx++)
+        sml_vector3 *Out = Positions.Values;
+        for(sml_u32 Idx = 0; Idx < VtxCount; Idx++)
         {
-            Positions.Push(this->VtxData[Idx].Position);
+            Out[Idx] = this->VtxData[Idx].Position;
         }
 
+        Positions.Count = VtxCount;
+
         return Positions;
-    } 
+    }
+
+    // NOTE: Splits positions into 3 arrays of VertexCount() floats, the layout
+    // the SmlMat4_TransformPoints kernels take.
+
+    inline void PackPositionsSoA(sml_f32 *Xs, sml_f32 *Ys, sml_f32 *Zs)
+    {
+        sml_u32 VtxCount = this->VertexCount();
+
+        for(sml_u32 Idx = 0; Idx < VtxCount; Idx++)
+        {
+            sml_vector3 Position = this->VtxData[Idx].Position;
+
+            Xs[Idx] = Position.x;
+            Ys[Idx] = Position.y;
+            Zs[Idx] = Position.z;
+        }
+    }
 
     inline sml_u32 VertexCount()
     {
@@ -71,7 +94,7 @@ struct mesh
 struct mesh_record
 {
     // Meta-data
-    char Name[32];
+    sml_atom Name;
 
     // Mesh-data
     sml_heap_block VtxHeap;
@@ -99,13 +122,10 @@ RecordMesh(mesh<V, I> Mesh, const char* Name)
     }
 
     mesh_record Record = {};
+    Record.Name    = SmlAtom_Intern(Name);
     Record.VtxHeap = Mesh.VtxHeap;
     Record.IdxHeap = Mesh.IdxHeap;
 
-    size_t NameLength = strlen(Name);
-    if(NameLength > 31) NameLength = 31;
-    memcpy(Record.Name, Name, NameLength);
-
     mesh_id Id = mesh_id(SmlMeshes.Emplace(Record));
 
     return Id;
@@ -0,0 +1,36 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define Sml_DebugBreak() __debugbreak()
+#else
+#include <x86intrin.h>
+#define Sml_DebugBreak() __builtin_trap()
+#endif
+
+typedef uint8_t  sml_u8;
+typedef uint32_t sml_u32;
+typedef uint64_t sml_u64;
+
+typedef int sml_i32;
+
+typedef float  sml_f32;
+typedef double sml_f64;
+
+#define Sml_Unused(x) (void)(x)
+#define Sml_Assert(cond) do { if (!(cond)) Sml_DebugBreak(); } while (0)
+
+#define Sml_Kilobytes(Amount) ((Amount) * 1024)
+#define Sml_Megabytes(Amount) (Sml_Kilobytes(Amount) * 1024)
+#define Sml_Gigabytes(Amount) (Sml_Megabytes((size_t)(Amount)) * 1024)
+
+#define SML_CACHE_LINE_SIZE 64
+
+#define XXH_STATIC_LINKING_ONLY
+#define XXH_IMPLEMENTATION
+#include "third_party/xxhash.h"
@@ -1,22 +1,4 @@
-#include <stdint.h>
-#include <stdbool.h>
-#include <intrin.h>
-
-typedef uint8_t  sml_u8;
-typedef uint32_t sml_u32;
-typedef uint64_t sml_u64;
-
-typedef int sml_i32;
-
-typedef float  sml_f32;
-typedef double sml_f64;
-
-#define Sml_Unused(x) (void)(x)
-#define Sml_Assert(cond) do { if (!(cond)) __debugbreak(); } while (0)
-
-#define Sml_Kilobytes(Amount) ((Amount) * 1024)
-#define Sml_Megabytes(Amount) (Kilobytes(Amount) * 1024)
-#define Sml_Gigabytes(Amount) (Megabytes(Amount) * 1024)
+#include "sml_base.cpp"
 
 #define STB_IMAGE_IMPLEMENTATION
 #define STBI_NO_PSD
@@ -30,12 +12,12 @@ typedef double sml_f64;
 #define IMGUI_DISABLE_CHECKVERSION
 #include "third_party/imgui/imgui.h"
 
-#define XXH_STATIC_LINKING_ONLY
-#define XXH_IMPLEMENTATION
-#include "third_party/xxhash.h"
-
 #pragma warning(push)
 #pragma warning(disable: 4505 4996) // Unreferenced functions | Unsafe functions
+#pragma warning(disable: 4201)      // Nameless struct in the SIMD math unions
+
+// CPU features
+#include "platform/sml_cpu.cpp"
 
 // Memory
 #include "memory/sml_stack_memory.cpp"
@@ -45,11 +27,22 @@ typedef double sml_f64;
 #include "data_structures/sml_stack.cpp"
 #include "data_structures/sml_hashmap.cpp"
 #include "data_structures/sml_slot_map.cpp"
+#include "data_structures/sml_atom_table.cpp"
+#include "data_structures/sml_lru_cache.cpp"
+
+// Threading
+#include "threading/sml_mpmc_queue.cpp"
+#include "threading/sml_spsc_queue.cpp"
+#include "threading/sml_parallel_for.cpp"
 
 // Math
 #include "math/vector.cpp"
 #include "math/matrix.cpp"
+#include "math/batch_transform.cpp"
+#include "math/quaternion.cpp"
+#include "math/frustum.cpp"
 #include "math/geometry.cpp"
+#include "math/intersection.cpp"
 
 // Rendering
 #include "platform/sml_platform.cpp"
@@ -57,6 +50,10 @@ typedef double sml_f64;
 
 // Spatial
 #include "spatial/sml_nav_mesh.cpp"
+#include "spatial/sml_nav_corridor.cpp"
+#include "spatial/sml_nav_path_service.cpp"
+#include "spatial/sml_nav_path_cache.cpp"
+#include "spatial/sml_nav_mesh_debug.cpp"
 #include "spatial/entity_test.cpp"
 
 // Editor
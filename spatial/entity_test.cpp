@@ -20,7 +20,7 @@ struct sml_entity
     sml_u32     Material;
 
     // Meta-data
-    char Name[64];
+    sml_atom Name;
     bool Alive;
 
     // Backend-specific data
@@ -100,7 +100,7 @@ Sml_CreateEntity(sml_heap_block VtxHeap, sml_heap_block IdxHeap, sml_u32 IdxCoun
     E->Material = Material;
     E->Alive    = true;
 
-    strncpy(E->Name, Identifier, 63);
+    E->Name = SmlAtom_Intern(Identifier);
 
     return Id;
 }
@@ -169,7 +169,7 @@ SmlDebug_ShowEntityUI()
         if (!E->Alive) continue;
 
         char Header[32];
-        sprintf_s(Header, 32, "%s##%u", E->Name, Index);
+        sprintf_s(Header, 32, "%s##%u", SmlAtom_String(E->Name), Index);
 
         if (ImGui::CollapsingHeader(Header, ImGuiTreeNodeFlags_DefaultOpen))
         {
@@ -177,7 +177,7 @@ SmlDebug_ShowEntityUI()
             ImGui::SetColumnWidth(0, 80);
 
             ImGui::Text("Name");    ImGui::NextColumn();
-            ImGui::Text(E->Name);   ImGui::NextColumn();
+            ImGui::TextUnformatted(SmlAtom_String(E->Name)); ImGui::NextColumn();
 
             ImGui::Text("Position");ImGui::NextColumn();
             ImGui::PushItemWidth(-1);
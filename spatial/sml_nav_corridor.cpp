@@ -0,0 +1,241 @@
+namespace SML
+{
+
+// ===================================
+// Type Definitions
+// ===================================
+
+// NOTE:
+// 1) A corridor is the piece path an agent follows, kept from frame to frame.
+//    UpdateNavCorridor trims the pieces the agent has left behind and follows
+//    a moving target without searching from scratch:
+//    - Target still on its piece: nothing to do.
+//    - Target moved back onto the corridor: the corridor is cut there.
+//    - Otherwise: a search of at most NavCorridorRepairNodes pieces runs from
+//      the old target to the new one and is appended. A loop back into the
+//      corridor is cut off.
+// 2) The full search only runs when the corridor is invalid: the agent left it,
+//    one of its pieces is blocked by the filter, or the repair failed.
+// 3) Repairs keep the corridor valid but not always shortest. Callers wanting
+//    the best path again can clear the corridor (Path.Count = 0) now and then.
+
+constexpr sml_u32 NavCorridorRepairNodes = 64;
+constexpr sml_u32 NavCorridorLookahead   = 8;
+
+enum NavCorridor_Update
+{
+    NavCorridor_Kept,
+    NavCorridor_Repaired,
+    NavCorridor_Replanned,
+    NavCorridor_Lost,
+};
+
+struct nav_corridor
+{
+    nav_path       Path;
+    NavPath_Status Status;
+
+    sml_vector3 Position;
+    sml_vector3 Target;
+    sml_u32     TargetPoly;
+
+    sml_heap_block Heap;
+
+    void Free()
+    {
+        SmlMemory.Free(this->Heap);
+
+        this->Path = {};
+    }
+};
+
+// ===================================
+// Internal Helpers
+// ===================================
+
+// NOTE: The agent is usually on the first pieces, the whole corridor is only
+// scanned when it is not.
+
+static bool
+NavCorridorTrim(nav_corridor *Corridor, nav_query *Query, sml_vector3 Position)
+{
+    nav_path *Path  = &Corridor->Path;
+    sml_u32   Count = Path->Count;
+    sml_u32   Ahead = Count < NavCorridorLookahead ? Count : NavCorridorLookahead;
+    sml_u32   Found = NavInvalidPoly;
+
+    for(sml_u32 Idx = 0; Idx < Ahead && Found == NavInvalidPoly; Idx++)
+    {
+        if(ConvexPolyContains(Query->Mesh, Path->Polys[Idx], Position)) Found = Idx;
+    }
+
+    if(Found == NavInvalidPoly)
+    {
+        sml_u32 Poly = FindNavPoly(Query, Position);
+        if(Poly == NavInvalidPoly) return false;
+
+        for(sml_u32 Idx = Ahead; Idx < Count && Found == NavInvalidPoly; Idx++)
+        {
+            if(Path->Polys[Idx] == Poly) Found = Idx;
+        }
+
+        if(Found == NavInvalidPoly) return false;
+    }
+
+    memmove(Path->Polys, Path->Polys + Found, (Count - Found) * sizeof(sml_u32));
+    Path->Count = Count - Found;
+
+    return true;
+}
+
+static bool
+NavCorridorPassable(nav_convex_mesh *Mesh, nav_path *Path, nav_query_filter *Filter)
+{
+    for(sml_u32 Idx = 0; Idx < Path->Count; Idx++)
+    {
+        if(Filter->AreaCosts[Mesh->Polys[Path->Polys[Idx]].Area] <= 0.0f) return false;
+    }
+
+    return true;
+}
+
+// NOTE: The pieces after Joint were just appended. When the latest of them is
+// already in the corridor at or before Joint, the path in between is a loop.
+
+static void
+NavCorridorCutLoop(nav_path *Path, sml_u32 Joint)
+{
+    sml_u32 *Polys = Path->Polys;
+
+    for(sml_u32 Idx = Path->Count - 1; Idx > Joint; Idx--)
+    {
+        for(sml_u32 Earlier = 0; Earlier <= Joint; Earlier++)
+        {
+            if(Polys[Earlier] != Polys[Idx]) continue;
+
+            sml_u32 Rest = Path->Count - Idx - 1;
+
+            memmove(Polys + Earlier + 1, Polys + Idx + 1, Rest * sizeof(sml_u32));
+            Path->Count = Earlier + 1 + Rest;
+
+            return;
+        }
+    }
+}
+
+static NavCorridor_Update
+NavCorridorReplan(nav_corridor *Corridor, nav_query *Query, nav_query_filter *Filter)
+{
+    sml_vector3 Start = Corridor->Position;
+    sml_vector3 End   = Corridor->Target;
+
+    sml_u32 StartPoly = FindNavPoly(Query, Start);
+    sml_u32 EndPoly   = FindNavPoly(Query, End);
+
+    nav_path *Path = &Corridor->Path;
+
+    if(Query->Hierarchy)
+    {
+        Corridor->Status = NavPathHierarchical(Query, Filter, StartPoly, Start, EndPoly,
+                                               End, Path);
+    }
+    else
+    {
+        Corridor->Status = NavPathBetween(Query, Filter, StartPoly, Start, EndPoly, End,
+                                          nullptr, Path);
+    }
+
+    Corridor->TargetPoly = EndPoly;
+
+    return Corridor->Status == NavPath_NoPoly ? NavCorridor_Lost : NavCorridor_Replanned;
+}
+
+// ===================================
+// User API
+// ===================================
+
+// NOTE: Empty until the first UpdateNavCorridor plans it.
+
+static nav_corridor
+CreateNavCorridor(sml_u32 Capacity)
+{
+    Sml_Assert(Capacity > 0);
+
+    nav_corridor Corridor = {};
+    Corridor.Heap          = SmlMemory.Allocate(Capacity * sizeof(sml_u32));
+    Corridor.Path.Polys    = (sml_u32*)Corridor.Heap.Data;
+    Corridor.Path.Capacity = Capacity;
+    Corridor.Status        = NavPath_NoPoly;
+    Corridor.TargetPoly    = NavInvalidPoly;
+
+    return Corridor;
+}
+
+// NOTE: Call every frame with the agent position and the current target. The
+// corridor then runs from the agent's piece to the target's, Path.Cost is only
+// meaningful right after a replan.
+
+static NavCorridor_Update
+UpdateNavCorridor(nav_corridor *Corridor, nav_query *Query, sml_vector3 Position,
+                  sml_vector3 Target, nav_query_filter *Filter)
+{
+    nav_path   *Path      = &Corridor->Path;
+    sml_vector3 OldTarget = Corridor->Target;
+
+    bool Valid = Path->Count > 0 && NavCorridorTrim(Corridor, Query, Position) &&
+                 NavCorridorPassable(Query->Mesh, Path, Filter);
+
+    Corridor->Position = Position;
+    Corridor->Target   = Target;
+
+    if(!Valid) return NavCorridorReplan(Corridor, Query, Filter);
+
+    sml_u32 TargetPoly = FindNavPoly(Query, Target);
+
+    if(TargetPoly == Corridor->TargetPoly) return NavCorridor_Kept;
+
+    // Target moved off the mesh, or back onto the corridor.
+    if(TargetPoly == NavInvalidPoly) return NavCorridorReplan(Corridor, Query, Filter);
+
+    for(sml_u32 Idx = 0; Idx < Path->Count; Idx++)
+    {
+        if(Path->Polys[Idx] != TargetPoly) continue;
+
+        Path->Count          = Idx + 1;
+        Corridor->Status     = NavPath_Found;
+        Corridor->TargetPoly = TargetPoly;
+
+        return NavCorridor_Kept;
+    }
+
+    // Local repair from the old target. A partial corridor does not end there.
+    if(Corridor->Status != NavPath_Found)
+    {
+        return NavCorridorReplan(Corridor, Query, Filter);
+    }
+
+    sml_u32 Joint = Path->Count - 1;
+
+    nav_path Tail = {};
+    Tail.Polys    = Path->Polys + Joint;
+    Tail.Capacity = Path->Capacity - Joint;
+
+    NavPath_Status Status = NavPathBetween(Query, Filter, Path->Polys[Joint], OldTarget,
+                                           TargetPoly, Target, nullptr, &Tail,
+                                           NavCorridorRepairNodes);
+
+    if(Status != NavPath_Found)
+    {
+        Path->Count = Joint + 1;
+        return NavCorridorReplan(Corridor, Query, Filter);
+    }
+
+    Path->Count          = Joint + Tail.Count;
+    Corridor->TargetPoly = TargetPoly;
+
+    NavCorridorCutLoop(Path, Joint);
+
+    return NavCorridor_Repaired;
+}
+
+} // namespace SML
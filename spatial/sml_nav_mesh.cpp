@@ -1,3 +1,5 @@
+#include <atomic> // Mesh revisions
+
 namespace SML
 {
 
@@ -5,190 +7,2324 @@ namespace SML
 // Type Definitions
 // ===================================
 
+// NOTE: One simple polygon per walkable cluster, counter-clockwise seen from
+// above. Holes are joined to the outline by a cut, so the two cut end points
+// appear twice in Verts. The convex mesh turns every cut into a portal.
+
 struct nav_poly
 {
     dynamic_array<sml_vector3> Verts;
 };
 
+// NOTE:
+// 1) Convex pieces of the nav polygons, counter-clockwise seen from above
+//    (x right, z up). Polygon Idx uses Indices[FirstIndex .. FirstIndex + Count).
+// 2) Neighbors runs parallel to Indices: the polygon across the edge starting at
+//    that vertex, NavInvalidPoly on the outline.
+// 3) A portal is an edge shared by two pieces of the same nav polygon.
+//    Verts[0] -> Verts[1] runs counter-clockwise around Polys[0].
+// 4) Area picks the cost of a piece in a nav_query_filter. Every piece starts
+//    in NavAreaDefault, callers mark the others after the build.
+// 5) Revision is unique across meshes and changes whenever the mesh is built or
+//    SetNavPolyArea changes a piece. Caches of results compare it to know they
+//    are stale.
+
+constexpr sml_u32 NavInvalidPoly = 0xFFFFFFFF;
+
+constexpr sml_u32 NavMaxAreas    = 32;
+constexpr sml_u32 NavAreaDefault = 0;
+
+struct nav_convex_poly
+{
+    sml_u32 FirstIndex;
+    sml_u32 Count;
+    sml_u32 Source;
+    sml_u32 Area;
+};
+
+struct nav_portal
+{
+    sml_u32 Polys[2];
+    sml_u32 Verts[2];
+};
+
+struct nav_convex_mesh
+{
+    dynamic_array<sml_vector3>     Verts;
+    dynamic_array<sml_u32>         Indices;
+    dynamic_array<sml_u32>         Neighbors;
+    dynamic_array<nav_convex_poly> Polys;
+    dynamic_array<nav_portal>      Portals;
+    sml_u32                        Revision;
+
+    void Free()
+    {
+        this->Verts.Free();
+        this->Indices.Free();
+        this->Neighbors.Free();
+        this->Polys.Free();
+        this->Portals.Free();
+    }
+};
+
+static std::atomic<sml_u32> NavMeshRevisions;
+
+// NOTE: Cost per world unit travelled through a piece of each area. A cost of
+// zero or less blocks the area.
+
+struct nav_query_filter
+{
+    sml_f32 AreaCosts[NavMaxAreas];
+};
+
+// NOTE:
+// 1) Partial: End cannot be reached, the path leads to the piece closest to it.
+// 2) Truncated: the path did not fit, Polys holds its first Capacity pieces.
+// 3) NoPoly: Start or End is not on a piece, or on a blocked one.
+
+enum NavPath_Status
+{
+    NavPath_Found,
+    NavPath_Partial,
+    NavPath_Truncated,
+    NavPath_NoPoly,
+};
+
+constexpr sml_u32 NavNoNodeLimit = 0xFFFFFFFF;
+
+// NOTE: Polys is owned by the caller and receives the pieces from Start to End.
+
+struct nav_path
+{
+    sml_u32 *Polys;
+    sml_u32  Capacity;
+    sml_u32  Count;
+    sml_f32  Cost;
+};
+
+// NOTE:
+// 1) One node per convex piece. A node belongs to the running search only when
+//    its Generation matches the query's, so nothing is cleared between queries.
+// 2) Position is where the search entered the piece: the middle of the portal
+//    it came through, or the start point.
+
+struct nav_node
+{
+    sml_vector3 Position;
+    sml_f32     Cost;
+    sml_f32     Total;
+    sml_u32     Parent;
+    sml_u32     HeapSlot;
+    sml_u32     Generation;
+    bool        Closed;
+};
+
+// NOTE: A 4-ary min heap of node indices on Total, every node knows its slot
+// so a cheaper path moves it up in place.
+
+struct nav_heap
+{
+    nav_node *Nodes;
+    sml_u32  *Slots;
+    sml_u32   Count;
+};
+
+struct nav_poly_bounds
+{
+    sml_f32 MinX, MinZ;
+    sml_f32 MaxX, MaxZ;
+    sml_f32 Height;
+};
+
+// NOTE:
+// 1) Regions are grown breadth first from a free piece until they hold
+//    PiecesPerRegion pieces or run out of neighbors, so a region is always
+//    connected and about as wide as it is long.
+// 2) An entrance is a portal between two regions, placed at the portal middle.
+//    Entrances are the nodes of the abstract graph: each links to the other
+//    entrances of its two regions at the cost of the cheapest path between them
+//    inside the shared region. A region keeps these as an EntranceCount x
+//    EntranceCount matrix in Costs, negative when there is no path.
+// 3) Link costs use the filter given to BuildNavHierarchy. SetNavPolyArea only
+//    marks the region of the piece dirty, UpdateNavHierarchy then recomputes
+//    the dirty regions alone.
+// 4) BuildNavHierarchy costs NavRegionChunkSize regions per job.
+// 5) Revision is the mesh revision the hierarchy matches, SetNavPolyArea keeps
+//    both in step. Any other change to the mesh, like a rebuild in the same
+//    storage, leaves them apart: searches and CreateNavQuery assert, and
+//    UpdateNavHierarchy rebuilds the hierarchy and its query.
+
+constexpr sml_u32 NavRegionChunkSize = 256;
+
+struct nav_entrance
+{
+    sml_vector3 Position;
+    sml_u32     Polys[2];
+    sml_u32     Regions[2];
+    sml_u32     Slots[2];
+};
+
+struct nav_region
+{
+    sml_u32 FirstEntrance;
+    sml_u32 EntranceCount;
+    sml_u32 FirstCost;
+    bool    Dirty;
+};
+
+struct nav_hierarchy
+{
+    nav_convex_mesh  *Mesh;
+    nav_query_filter  Filter;
+    sml_u32           Revision;
+    sml_u32           PiecesPerRegion;
+
+    dynamic_array<sml_u32>      PolyRegions;
+    dynamic_array<nav_region>   Regions;
+    dynamic_array<nav_entrance> Entrances;
+    dynamic_array<sml_u32>      RegionEntrances;
+    dynamic_array<sml_f32>      Costs;
+
+    sml_u32 MaxEntrances;
+
+    void Free()
+    {
+        this->PolyRegions.Free();
+        this->Regions.Free();
+        this->Entrances.Free();
+        this->RegionEntrances.Free();
+        this->Costs.Free();
+    }
+};
+
+// NOTE:
+// 1) Everything a search needs is allocated by CreateNavQuery, FindPath does
+//    not allocate. The open list is a nav_heap over Nodes.
+// 2) Points are located through a uniform grid over the mesh, seen from above,
+//    with about one cell per piece. Cell C lists the pieces whose bounds touch
+//    it in CellPolys[CellStarts[C] .. CellStarts[C + 1]).
+// 3) A query reads the mesh and writes its nodes, use one query per thread.
+//    The mesh must outlive the query.
+// 4) Created with a hierarchy, a query also gets one node per entrance plus
+//    one for End, for FindPathHierarchical. A search only enters the regions
+//    whose RegionStamps entry matches RegionStamp.
+
+struct nav_query
+{
+    nav_convex_mesh *Mesh;
+    nav_hierarchy   *Hierarchy;
+
+    dynamic_array<nav_node>        Nodes;
+    dynamic_array<sml_u32>         Heap;
+    dynamic_array<nav_poly_bounds> Bounds;
+
+    sml_u32 Generation;
+
+    // Abstract graph
+    dynamic_array<nav_node> EntranceNodes;
+    dynamic_array<sml_u32>  EntranceHeap;
+    dynamic_array<sml_f32>  ExitCosts;
+    dynamic_array<sml_u32>  RegionStamps;
+
+    sml_u32 EntranceGeneration;
+    sml_u32 RegionStamp;
+
+    // Point location grid
+    dynamic_array<sml_u32> CellStarts;
+    dynamic_array<sml_u32> CellPolys;
+
+    sml_f32 GridMinX, GridMinZ;
+    sml_f32 InvCellSize;
+    sml_u32 GridWidth, GridHeight;
+
+    void Free()
+    {
+        this->Nodes.Free();
+        this->Heap.Free();
+        this->Bounds.Free();
+        this->CellStarts.Free();
+        this->CellPolys.Free();
+
+        if(this->Hierarchy)
+        {
+            this->EntranceNodes.Free();
+            this->EntranceHeap.Free();
+            this->ExitCosts.Free();
+            this->RegionStamps.Free();
+        }
+    }
+};
+
+// NOTE: Bit-exact, the copies of a cut end point come from the same position.
+
+struct nav_vert_key
+{
+    sml_f32 X, Y, Z;
+
+    bool operator==(const nav_vert_key &Key) const noexcept
+    {
+        return Key.X == X && Key.Y == Y && Key.Z == Z;
+    }
+};
+
+struct nav_diagonal
+{
+    sml_tri_edge Edge;
+    sml_f32      LengthSq;
+};
+
+struct nav_cluster_order
+{
+    sml_u32 Count;
+    sml_u32 Cluster;
+};
+
 // ===================================
 // Internal Helpers
 // ===================================
 
 
-// WARN: 
-// 1) Leaks a lot of memory!
+// NOTE: Boundary edges run the way their triangle winds them, so the walkable
+// side is always on the same side and every loop can be followed head to tail.
 
-static dynamic_array<nav_poly>
-BuildNavPolygons(dynamic_array<dynamic_array<sml_u32>> &Clusters,
-                 sml_walkable_list *List)
+static sml_f32
+LoopArea(sml_vector3 *Positions, sml_point *Loop, sml_u32 Count)
 {
-    auto NavPolygons  = dynamic_array<nav_poly>(Clusters.Count);
-    auto Boundary     = dynamic_array<sml_tri_edge>(0);
-    auto LoopVertices = dynamic_array<sml_point>(0);
+    sml_f32 Area = 0.0f;
 
-    for(sml_u32 ClusterIdx = 0; ClusterIdx < Clusters.Count; ClusterIdx++)
+    for(sml_u32 Idx = 0; Idx < Count; Idx++)
     {
-        auto Cluster  = Clusters[ClusterIdx];
+        sml_vector3 A = Positions[Loop[Idx]];
+        sml_vector3 B = Positions[Loop[(Idx + 1) % Count]];
 
-        for(sml_u32 TriIdx = 0; TriIdx < Cluster.Count; TriIdx++)
+        Area += A.x * B.z - B.x * A.z;
+    }
+
+    return Area;
+}
+
+static void
+ReverseLoop(sml_point *Loop, sml_u32 Count)
+{
+    for(sml_u32 Idx = 0; Idx < Count / 2; Idx++)
+    {
+        sml_point Temp        = Loop[Idx];
+        Loop[Idx]             = Loop[Count - 1 - Idx];
+        Loop[Count - 1 - Idx] = Temp;
+    }
+}
+
+// NOTE: Connects a clockwise hole to the counter-clockwise outline with a zero
+// width cut (Eberly), so the result is one loop the triangulators accept. The
+// cut goes from the rightmost hole vertex to the outline vertex it can see
+// first looking along +x, the cut end points appear twice in the result.
+
+static bool
+BridgeHole(sml_vector3 *Positions, dynamic_array<sml_point> *Outline, sml_point *Hole,
+           sml_u32 HoleCount)
+{
+    sml_point *Outer = Outline->Values;
+    sml_u32    Count = Outline->Count;
+
+    sml_u32 Right = 0;
+    for(sml_u32 Idx = 1; Idx < HoleCount; Idx++)
+    {
+        if(Positions[Hole[Idx]].x > Positions[Hole[Right]].x) Right = Idx;
+    }
+
+    sml_vector2 M = sml_vector2(Positions[Hole[Right]].x, Positions[Hole[Right]].z);
+
+    // Closest outline edge crossed by the ray from M along +x.
+    sml_u32 Hit  = Count;
+    sml_f32 HitX = 0.0f;
+
+    for(sml_u32 Idx = 0; Idx < Count; Idx++)
+    {
+        sml_vector3 A = Positions[Outer[Idx]];
+        sml_vector3 B = Positions[Outer[(Idx + 1) % Count]];
+
+        if((A.z > M.y) == (B.z > M.y)) continue;
+
+        sml_f32 X = A.x + (M.y - A.z) * (B.x - A.x) / (B.z - A.z);
+
+        if(X >= M.x && (Hit == Count || X < HitX))
         {
-            sml_neighbor_tris Neighbors = List->Neighbors[TriIdx];
+            Hit  = Idx;
+            HitX = X;
+        }
+    }
 
-            if(Neighbors.Count < 3)
-            {
-                sml_walkable_tri Tri = List->Walkable[TriIdx];
+    if(Hit == Count) return false;
 
-                for(sml_u32 EdgeIdx = 0; EdgeIdx < 3; EdgeIdx++)
-                {
-                    sml_tri_edge Edge = SmlInt_MakeEdgeKey(EdgeIdx, Tri.Points);
+    sml_u32 Visible = Hit;
+    if(Positions[Outer[(Hit + 1) % Count]].x > Positions[Outer[Hit]].x)
+    {
+        Visible = (Hit + 1) % Count;
+    }
 
-                    auto &Triangles = List->EdgeToTris.Get(Edge);
-                    if(Triangles.Count == 1)
-                    {
-                        Boundary.Push(Edge);
-                    }
-                }
-            }
+    // Reflex outline vertices inside triangle M, I, P can block the cut, the
+    // one closest in angle to the ray is visible instead. A ray through a
+    // vertex sees it directly.
+    sml_vector2 I = sml_vector2(HitX, M.y);
+    sml_vector2 P = sml_vector2(Positions[Outer[Visible]].x, Positions[Outer[Visible]].z);
+
+    sml_f32 BestCos  = -2.0f;
+    sml_f32 BestDist = 0.0f;
+    bool    OnVertex = P.x == I.x && P.y == I.y;
+
+    for(sml_u32 Idx = 0; Idx < Count && !OnVertex; Idx++)
+    {
+        sml_vector3 Prev3 = Positions[Outer[(Idx + Count - 1) % Count]];
+        sml_vector3 This3 = Positions[Outer[Idx]];
+        sml_vector3 Next3 = Positions[Outer[(Idx + 1) % Count]];
+
+        sml_vector2 Prev = sml_vector2(Prev3.x, Prev3.z);
+        sml_vector2 R    = sml_vector2(This3.x, This3.z);
+        sml_vector2 Next = sml_vector2(Next3.x, Next3.z);
+
+        if(Idx == Visible || SmlInt_SignedArea(&Prev, &R, &Next) > 0.0f) continue;
+
+        sml_f32 Side0 = SmlInt_SignedArea(&M, &I, &R);
+        sml_f32 Side1 = SmlInt_SignedArea(&I, &P, &R);
+        sml_f32 Side2 = SmlInt_SignedArea(&P, &M, &R);
+
+        bool Inside = (Side0 >= 0.0f && Side1 >= 0.0f && Side2 >= 0.0f) ||
+                      (Side0 <= 0.0f && Side1 <= 0.0f && Side2 <= 0.0f);
+
+        if(!Inside || R.x < M.x) continue;
+
+        sml_f32 DX   = R.x - M.x;
+        sml_f32 DZ   = R.y - M.y;
+        sml_f32 Dist = sqrtf(DX * DX + DZ * DZ);
+        sml_f32 Cos  = DX / fmaxf(Dist, 1e-12f);
+
+        if(Cos > BestCos || (Cos == BestCos && Dist < BestDist))
+        {
+            BestCos  = Cos;
+            BestDist = Dist;
+            Visible  = Idx;
         }
+    }
+
+    // Earlier cuts repeat their end points, the cut has to leave from the copy
+    // whose corner opens towards M.
+    for(sml_u32 Idx = 0; Idx < Count; Idx++)
+    {
+        if(Outer[Idx] != Outer[Visible]) continue;
 
-        Sml_Assert(Boundary.Count > 0);
+        sml_vector3 Prev3 = Positions[Outer[(Idx + Count - 1) % Count]];
+        sml_vector3 This3 = Positions[Outer[Idx]];
+        sml_vector3 Next3 = Positions[Outer[(Idx + 1) % Count]];
 
-        auto CurrentPoint  = Boundary[0].Point0;
-        auto CurrentCorner = Boundary[0].Point1;
+        sml_vector2 Prev = sml_vector2(Prev3.x, Prev3.z);
+        sml_vector2 R    = sml_vector2(This3.x, This3.z);
+        sml_vector2 Next = sml_vector2(Next3.x, Next3.z);
 
-        LoopVertices.Push(CurrentPoint);
-        LoopVertices.Push(CurrentCorner);
+        bool Convex = SmlInt_SignedArea(&Prev, &R, &Next) >= 0.0f;
+        bool Left   = SmlInt_SignedArea(&R, &Next, &M) >= 0.0f;
+        bool After  = SmlInt_SignedArea(&Prev, &R, &M) >= 0.0f;
 
-        while(true)
+        if(Convex ? (Left && After) : (Left || After))
         {
-            sml_point NextPoint = {};
-            bool      Found     = false;
+            Visible = Idx;
+            break;
+        }
+    }
 
-            for(sml_u32 Idx = 0; Idx < Boundary.Count; Idx++)
-            {
-                auto Edge = Boundary[Idx];
+    // Outline up to P, around the hole from M back to M, then P again.
+    auto Bridged = dynamic_array<sml_point>(Count + HoleCount + 2);
 
-                if(Edge.Point0 == CurrentPoint && Edge.Point1 == CurrentCorner)
-                {
-                    continue;
-                }
+    for(sml_u32 Idx = 0; Idx <= Visible; Idx++) Bridged.Push(Outer[Idx]);
 
-                if(Edge.Point0 == CurrentCorner || Edge.Point1 == CurrentCorner)
-                {
-                    NextPoint = (Edge.Point0 == CurrentCorner) ? Edge.Point1 :
-                                                                 Edge.Point0;
-                    Found = true;
-                    break;
-                }
+    for(sml_u32 Idx = 0; Idx <= HoleCount; Idx++)
+    {
+        Bridged.Push(Hole[(Right + Idx) % HoleCount]);
+    }
+
+    for(sml_u32 Idx = Visible; Idx < Count; Idx++) Bridged.Push(Outer[Idx]);
+
+    Outline->Free();
+    *Outline = Bridged;
+
+    return true;
+}
+
+static int
+CompareClusterOrder(const void *Left, const void *Right)
+{
+    const nav_cluster_order *A = (const nav_cluster_order*)Left;
+    const nav_cluster_order *B = (const nav_cluster_order*)Right;
+
+    if(A->Count != B->Count) return A->Count > B->Count ? -1 : 1;
+
+    return A->Cluster < B->Cluster ? -1 : (A->Cluster > B->Cluster);
+}
+
+// NOTE:
+// 1) Boundary edges are the edges of a cluster without a triangle of the same
+//    cluster across. They are chained per start vertex in a hashmap, so every
+//    loop is followed in O(E).
+// 2) A cluster can have several loops, the largest one is the outline and the
+//    others are holes, bridged into the outline. Each loop is simplified first,
+//    see SmlInt_SimplifyLoop for MaxError.
+// 3) Polygons are counter-clockwise seen from above.
+// 4) A hole BridgeHole cannot connect leaves the polygon without vertices, so
+//    the cluster is not walkable at all.
+
+static nav_poly
+BuildClusterPolygon(sml_walkable_list *List, dynamic_array<sml_u32> &ClusterOf,
+                    dynamic_array<sml_tri> &Cluster, sml_u32 ClusterIdx, sml_f32 MaxError)
+{
+    auto Boundary   = dynamic_array<sml_tri_edge>(Cluster.Count);
+    auto NextEdge   = dynamic_array<sml_u32>(Cluster.Count);
+    auto Taken      = dynamic_array<bool>(Cluster.Count);
+    auto Loops      = dynamic_array<sml_point>(Cluster.Count);
+    auto LoopStarts = dynamic_array<sml_u32>(0);
+    auto LoopCounts = dynamic_array<sml_u32>(0);
+
+    for(sml_u32 TriIdx = 0; TriIdx < Cluster.Count; TriIdx++)
+    {
+        sml_tri          Current = Cluster[TriIdx];
+        sml_walkable_tri Tri     = List->Walkable[Current];
+
+        for(sml_u32 EdgeIdx = 0; EdgeIdx < 3; EdgeIdx++)
+        {
+            sml_tri Other    = List->Across[Current * 3 + EdgeIdx];
+            bool    Interior = Other != SmlInvalidTri && ClusterOf[Other] == ClusterIdx;
+
+            if(!Interior)
+            {
+                sml_tri_edge Edge = {};
+                Edge.Point0 = Tri.Points[EdgeIdx];
+                Edge.Point1 = Tri.Points[(EdgeIdx + 1) % 3];
+
+                Boundary.Push(Edge);
             }
+        }
+    }
+
+    Sml_Assert(Boundary.Count > 0);
+
+    // Start vertex -> first edge leaving it, NextEdge chains the others.
+    auto Heads = sml_hashmap<sml_point, sml_u32>(Boundary.Count / 14 + 1);
+
+    for(sml_u32 Idx = 0; Idx < Boundary.Count; Idx++)
+    {
+        sml_u32 *Head = Heads.Find(Boundary[Idx].Point0);
+
+        NextEdge.Push(Head ? *Head : NavInvalidPoly);
+        Taken.Push(false);
+
+        if(Head) *Head = Idx;
+        else     Heads.Insert(Boundary[Idx].Point0, Idx);
+    }
+
+    for(sml_u32 First = 0; First < Boundary.Count; First++)
+    {
+        if(Taken[First]) continue;
+
+        sml_point Origin = Boundary[First].Point0;
+        sml_point Vertex = Boundary[First].Point1;
+
+        Taken[First] = true;
+
+        LoopStarts.Push(Loops.Count);
+        Loops.Push(Origin);
+
+        while(Vertex != Origin)
+        {
+            sml_u32 *Head = Heads.Find(Vertex);
 
-            if(!Found)
+            // Edges taken as the first edge of a loop are skipped here.
+            while(Head && *Head != NavInvalidPoly && Taken[*Head])
             {
-                Sml_Assert(!"Should not happen!");
-                break;
+                *Head = NextEdge[*Head];
             }
 
-            if(NextPoint == LoopVertices[0])
+            if(!Head || *Head == NavInvalidPoly)
             {
+                Sml_Assert(!"Boundary loop is not closed.");
                 break;
             }
 
-            LoopVertices.Push(NextPoint);
+            sml_u32 Edge = *Head;
+            *Head        = NextEdge[Edge];
+            Taken[Edge]  = true;
 
-            CurrentPoint  = CurrentCorner;
-            CurrentCorner = NextPoint;
+            Loops.Push(Vertex);
+            Vertex = Boundary[Edge].Point1;
         }
+    }
+
+    LoopStarts.Push(Loops.Count);
+
+    // Simplify each loop in place, then find the outline.
+    sml_u32 Outline     = 0;
+    sml_f32 OutlineArea = 0.0f;
+
+    for(sml_u32 LoopIdx = 0; LoopIdx + 1 < LoopStarts.Count; LoopIdx++)
+    {
+        sml_point *Loop  = Loops.Values + LoopStarts[LoopIdx];
+        sml_u32    Count = LoopStarts[LoopIdx + 1] - LoopStarts[LoopIdx];
+
+        Count = SmlInt_SimplifyLoop(List->Positions, Loop, Count, MaxError);
 
-        nav_poly NavPoly = {};
-        NavPoly.Verts = dynamic_array<sml_vector3>(LoopVertices.Count);
+        LoopCounts.Push(Count);
 
-        for(sml_u32 LoopIdx = 0; LoopIdx < LoopVertices.Count; LoopIdx++)
+        sml_f32 Area = fabsf(LoopArea(List->Positions, Loop, Count));
+        if(Area > OutlineArea)
         {
-            sml_point PointIdx = LoopVertices[LoopIdx];
-            NavPoly.Verts.Push(List->Positions[PointIdx]);
+            Outline     = LoopIdx;
+            OutlineArea = Area;
         }
+    }
 
-        NavPolygons.Push(NavPoly);
+    sml_u32 LoopCount = LoopStarts.Count - 1;
 
-        LoopVertices.Reset();
-        Boundary.Reset();
+    auto Merged = dynamic_array<sml_point>(LoopCounts[Outline] + 8);
+    for(sml_u32 Idx = 0; Idx < LoopCounts[Outline]; Idx++)
+    {
+        Merged.Push(Loops[LoopStarts[Outline] + Idx]);
     }
 
-    LoopVertices.Free();
-    Boundary.Free();
+    if(LoopArea(List->Positions, Merged.Values, Merged.Count) < 0.0f)
+    {
+        ReverseLoop(Merged.Values, Merged.Count);
+    }
 
-    return NavPolygons;
-}
+    // Holes clockwise, rightmost first so earlier cuts do not block later ones.
+    for(sml_u32 Pass = 1; Pass < LoopCount; Pass++)
+    {
+        sml_u32 Hole  = LoopCount;
+        sml_f32 HoleX = 0.0f;
 
-static instance 
-CreateNavMeshDebugInstance(nav_poly *NavPolygons, sml_u32 Count)
-{
-    auto DebugVtx = dynamic_array<vertex_color>(0);
-    auto DebugIdx = dynamic_array<sml_u32>(0);
+        for(sml_u32 LoopIdx = 0; LoopIdx < LoopCount; LoopIdx++)
+        {
+            if(LoopIdx == Outline || LoopCounts[LoopIdx] < 3) continue;
 
-    for(sml_u32 PolyIdx = 0; PolyIdx < Count; PolyIdx++)
-    { 
-        auto   *Poly = NavPolygons + PolyIdx;
-        sml_u32 Base = DebugVtx.Count;
+            sml_point *Loop = Loops.Values + LoopStarts[LoopIdx];
 
-        for(sml_u32 VtxIdx = 0; VtxIdx < Poly->Verts.Count; VtxIdx++)
-        {
-            vertex_color Vertex;
-            Vertex.Position = Poly->Verts[VtxIdx];
-            Vertex.Normal   = sml_vector3(0.0f, 0.0f, 0.0f);
-            Vertex.Color    = sml_vector3(0.0f, 1.0f, 0.0f);
+            sml_f32 MaxX = List->Positions[Loop[0]].x;
+            for(sml_u32 Idx = 1; Idx < LoopCounts[LoopIdx]; Idx++)
+            {
+                MaxX = fmaxf(MaxX, List->Positions[Loop[Idx]].x);
+            }
 
-            DebugVtx.Push(Vertex);
+            if(Hole == LoopCount || MaxX > HoleX)
+            {
+                Hole  = LoopIdx;
+                HoleX = MaxX;
+            }
         }
 
-        auto Poly2D = dynamic_array<sml_vector2>(Poly->Verts.Count);
-        for(sml_u32 VtxIdx = 0; VtxIdx < Poly->Verts.Count; VtxIdx++)
+        if(Hole == LoopCount) break;
+
+        sml_point *Loop  = Loops.Values + LoopStarts[Hole];
+        sml_u32    Count = LoopCounts[Hole];
+
+        if(LoopArea(List->Positions, Loop, Count) > 0.0f) ReverseLoop(Loop, Count);
+
+        // Without its hole the polygon would lead straight through the
+        // obstacle, the cluster is dropped instead.
+        if(!BridgeHole(List->Positions, &Merged, Loop, Count))
         {
-            auto Pos2D = sml_vector2(Poly->Verts[VtxIdx].x, Poly->Verts[VtxIdx].z);
-            Poly2D.Push(Pos2D);
+            Sml_Assert(!"Hole cannot be bridged to the outline.");
+
+            Merged.Count = 0;
+            break;
         }
 
-        auto Indices = SmlInt_Triangulate(Poly2D, SmlTriangulate_Fan);
-        for(sml_u32 Idx = 0; Idx < Indices.Count; Idx++)
+        LoopCounts[Hole] = 0;
+    }
+
+    nav_poly NavPoly = {};
+    NavPoly.Verts = dynamic_array<sml_vector3>(Merged.Count);
+
+    for(sml_u32 LoopIdx = 0; LoopIdx < Merged.Count; LoopIdx++)
+    {
+        sml_point PointIdx = Merged[LoopIdx];
+        NavPoly.Verts.Push(List->Positions[PointIdx]);
+    }
+
+    Merged.Free();
+    Heads.Free();
+    Loops.Free();
+    LoopStarts.Free();
+    LoopCounts.Free();
+    NextEdge.Free();
+    Taken.Free();
+    Boundary.Free();
+
+    return NavPoly;
+}
+
+// NOTE: Clusters are independent, they are traced on ThreadCount threads,
+// largest first so one big cluster does not end up last.
+
+static dynamic_array<nav_poly>
+BuildNavPolygons(dynamic_array<dynamic_array<sml_tri>> &Clusters,
+                 sml_walkable_list *List, sml_f32 MaxError, sml_u32 ThreadCount = 1)
+{
+    auto ClusterOf = dynamic_array<sml_u32>(List->Walkable.Count, false);
+    auto Order     = dynamic_array<nav_cluster_order>(Clusters.Count);
+
+    for(sml_u32 ClusterIdx = 0; ClusterIdx < Clusters.Count; ClusterIdx++)
+    {
+        auto Cluster = Clusters[ClusterIdx];
+
+        for(sml_u32 TriIdx = 0; TriIdx < Cluster.Count; TriIdx++)
         {
-            DebugIdx.Push(Base + Indices[Idx]);
+            ClusterOf[Cluster[TriIdx]] = ClusterIdx;
         }
 
-        Poly2D.Free();
+        Order[ClusterIdx] = {Cluster.Count, ClusterIdx};
     }
 
-    auto DebugMesh = mesh<vertex_color, sml_u32>(DebugVtx.Count, DebugIdx.Count);
+    qsort(Order.Values, Clusters.Count, sizeof(nav_cluster_order), CompareClusterOrder);
+
+    auto NavPolygons = dynamic_array<nav_poly>(Clusters.Count);
+
+    Sml_ParallelFor(Clusters.Count, 1, ThreadCount,
+    [&](sml_u32 Job, sml_u32, sml_u32)
+    {
+        sml_u32 ClusterIdx = Order[Job].Cluster;
+        auto   &Cluster    = Clusters[ClusterIdx];
+
+        NavPolygons[ClusterIdx] =
+            BuildClusterPolygon(List, ClusterOf, Cluster, ClusterIdx, MaxError);
+    });
 
-    memcpy(DebugMesh.VtxData, DebugVtx.Values, DebugMesh.VtxHeap.Size);
-    memcpy(DebugMesh.IdxData, DebugIdx.Values, DebugMesh.IdxHeap.Size);
+    NavPolygons.Count = Clusters.Count;
 
-    // WARN: Use new API to create the instance.
+    ClusterOf.Free();
+    Order.Free();
 
-    return instance(0);
+    return NavPolygons;
 }
 
-// ===================================
-// User API
-// ===================================
+static int
+CompareDiagonals(const void *Left, const void *Right)
+{
+    const nav_diagonal *A = (const nav_diagonal*)Left;
+    const nav_diagonal *B = (const nav_diagonal*)Right;
 
-// WARN:
-// 1) This leaks quite a large amount of data (List, Clusters)
-// 2) Code is really ugly
+    if(A->LengthSq != B->LengthSq) return A->LengthSq > B->LengthSq ? -1 : 1;
+    if(A->Edge.Point0 != B->Edge.Point0) return A->Edge.Point0 < B->Edge.Point0 ? -1 : 1;
 
-static dynamic_array<nav_poly>
-BuildNavMesh(sml_vector3 *Points, sml_u32 *Indices, sml_u32 IdxCount,
-             sml_f32 SlopeDegree)
+    return A->Edge.Point1 < B->Edge.Point1 ? -1 : (A->Edge.Point1 > B->Edge.Point1);
+}
+
+static inline sml_u32
+FindPiece(sml_u32 *Parents, sml_u32 Piece)
 {
-    sml_walkable_list List = SmlInt_BuildWalkableList(Points, Indices, IdxCount,
-                                                      SlopeDegree);
+    while(Parents[Piece] != Piece)
+    {
+        Parents[Piece] = Parents[Parents[Piece]];
+        Piece          = Parents[Piece];
+    }
 
-    dynamic_array<dynamic_array<sml_tri>> 
-    Clusters = SmlInt_BuildPolygonClusters(&List);
+    return Piece;
+}
 
-    dynamic_array<nav_poly> 
-    NavPolygons = BuildNavPolygons(Clusters, &List);
+// NOTE: Removes the diagonal U, V shared by pieces A and B when the union stays
+// convex at U and V and has at most MaxVerts vertices. The union goes in A.
 
-    return NavPolygons;
+static bool
+MergePieces(sml_u32 *A, sml_u32 *ACount, sml_u32 *B, sml_u32 BCount, sml_u32 U,
+            sml_u32 V, const sml_vector2 *Points, sml_u32 MaxVerts, sml_u32 *Merged)
+{
+    sml_u32 Count = *ACount;
+
+    if(Count + BCount - 2 > MaxVerts) return false;
+
+    // A walks U -> V, B walks V -> U.
+    sml_u32 AtA = Count;
+    for(sml_u32 Idx = 0; Idx < Count; Idx++)
+    {
+        if(A[Idx] == U && A[(Idx + 1) % Count] == V) AtA = Idx;
+        if(A[Idx] == V && A[(Idx + 1) % Count] == U) AtA = Idx;
+    }
+
+    if(AtA == Count) return false;
+
+    U = A[AtA];
+    V = A[(AtA + 1) % Count];
+
+    sml_u32 AtB = BCount;
+    for(sml_u32 Idx = 0; Idx < BCount; Idx++)
+    {
+        if(B[Idx] == V && B[(Idx + 1) % BCount] == U) AtB = Idx;
+    }
+
+    if(AtB == BCount) return false;
+
+    sml_u32 BeforeU = A[(AtA + Count - 1) % Count];
+    sml_u32 AfterU  = B[(AtB + 2) % BCount];
+    sml_u32 BeforeV = B[(AtB + BCount - 1) % BCount];
+    sml_u32 AfterV  = A[(AtA + 2) % Count];
+
+    sml_vector2 *P = (sml_vector2*)Points;
+
+    if(SmlInt_SignedArea(P + BeforeU, P + U, P + AfterU) <= 0.0f) return false;
+    if(SmlInt_SignedArea(P + BeforeV, P + V, P + AfterV) <= 0.0f) return false;
+
+    // V and the rest of A up to U, then B between U and V.
+    sml_u32 MergedCount = 0;
+    for(sml_u32 Idx = 0; Idx < Count; Idx++)
+    {
+        Merged[MergedCount++] = A[(AtA + 1 + Idx) % Count];
+    }
+
+    for(sml_u32 Idx = 2; Idx < BCount; Idx++)
+    {
+        Merged[MergedCount++] = B[(AtB + Idx) % BCount];
+    }
+
+    memcpy(A, Merged, MergedCount * sizeof(sml_u32));
+    *ACount = MergedCount;
+
+    return true;
+}
+
+// NOTE: Hertel-Mehlhorn. Each nav polygon is triangulated, then diagonals are
+// removed longest first while both pieces stay convex. The diagonals left are
+// the portals. At most 4 times the optimal piece count without a vertex limit.
+
+static void
+DecomposeNavPolygon(nav_convex_mesh *Mesh, nav_poly *Poly, sml_u32 Source,
+                    sml_u32 MaxVerts)
+{
+    sml_u32 Count = Poly->Verts.Count;
+    if(Count < 3) return;
+
+    sml_f32 Area = 0.0f;
+    for(sml_u32 Idx = 0; Idx < Count; Idx++)
+    {
+        sml_vector3 A = Poly->Verts[Idx];
+        sml_vector3 B = Poly->Verts[(Idx + 1) % Count];
+
+        Area += A.x * B.z - B.x * A.z;
+    }
+
+    // Local vertex Idx is pool vertex Base + Idx, stored counter-clockwise.
+    bool    Flip   = Area < 0.0f;
+    sml_u32 Base   = Mesh->Verts.Count;
+    auto    Points = dynamic_array<sml_vector2>(Count);
+
+    for(sml_u32 Idx = 0; Idx < Count; Idx++)
+    {
+        sml_vector3 Vert = Poly->Verts[Flip ? Count - 1 - Idx : Idx];
+
+        Mesh->Verts.Push(Vert);
+        Points[Idx] = sml_vector2(Vert.x, Vert.z);
+    }
+
+    sml_u32 TriCount  = Count - 2;
+    auto    Triangles = dynamic_array<sml_u32>(TriCount * 3);
+    Triangles.Count   = SmlInt_Triangulate(Points.Values, Count, Triangles.Values,
+                                           SmlTriangulate_Monotone);
+
+    // A hole cut lists its end points twice. Corners use the first copy, so the
+    // two sides of the cut share their edge and it becomes a portal instead of
+    // a wall. Triangles left with a corner twice span the cut and are dropped.
+    auto Canon = dynamic_array<sml_u32>(Count);
+    auto Seen  = sml_hashmap<nav_vert_key, sml_u32>(Count / 14 + 1);
+
+    for(sml_u32 Idx = 0; Idx < Count; Idx++)
+    {
+        sml_vector3  Vert  = Mesh->Verts[Base + Idx];
+        nav_vert_key Key   = {Vert.x, Vert.y, Vert.z};
+        sml_u32     *First = Seen.Find(Key);
+
+        Canon[Idx] = First ? *First : Idx;
+
+        if(!First) Seen.Insert(Key, Idx);
+    }
+
+    TriCount = 0;
+
+    for(sml_u32 Idx = 0; Idx < Triangles.Count; Idx += 3)
+    {
+        sml_u32 A = Canon[Triangles[Idx + 0]];
+        sml_u32 B = Canon[Triangles[Idx + 1]];
+        sml_u32 C = Canon[Triangles[Idx + 2]];
+
+        if(A == B || B == C || C == A) continue;
+
+        Triangles[TriCount * 3 + 0] = A;
+        Triangles[TriCount * 3 + 1] = B;
+        Triangles[TriCount * 3 + 2] = C;
+        TriCount++;
+    }
+
+    Triangles.Count = TriCount * 3;
+
+    auto Pieces    = dynamic_array<sml_u32>(TriCount * MaxVerts);
+    auto Counts    = dynamic_array<sml_u32>(TriCount);
+    auto Parents   = dynamic_array<sml_u32>(TriCount);
+    auto Diagonals = dynamic_array<nav_diagonal>(Count);
+    auto Merged    = dynamic_array<sml_u32>(MaxVerts);
+
+    // 3 edges per triangle, in groups of 16 buckets filled up to 7/8.
+    auto  EdgeMap = sml_hashmap<sml_tri_edge, sml_edge_tris>((TriCount * 3) / 14 + 1);
+    auto *Edges   = &EdgeMap;
+
+    for(sml_u32 Tri = 0; Tri < TriCount; Tri++)
+    {
+        sml_point *Corners = Triangles.Values + Tri * 3;
+
+        memcpy(Pieces.Values + Tri * MaxVerts, Corners, 3 * sizeof(sml_u32));
+        Counts[Tri]  = 3;
+        Parents[Tri] = Tri;
+
+        for(sml_u32 EdgeIdx = 0; EdgeIdx < 3; EdgeIdx++)
+        {
+            sml_tri_edge Edge = SmlInt_MakeEdgeKey(EdgeIdx, Corners);
+
+            auto &Shared = Edges->Get(Edge);
+            if(Shared.Count == 2) continue;
+
+            Shared.Tris[Shared.Count++] = Tri;
+
+            if(Shared.Count == 2)
+            {
+                sml_vector2 A = Points[Edge.Point0];
+                sml_vector2 B = Points[Edge.Point1];
+
+                nav_diagonal Diagonal = {};
+                Diagonal.Edge     = Edge;
+                Diagonal.LengthSq = (B.x - A.x) * (B.x - A.x) + (B.y - A.y) * (B.y - A.y);
+
+                Diagonals.Push(Diagonal);
+            }
+        }
+    }
+
+    qsort(Diagonals.Values, Diagonals.Count, sizeof(nav_diagonal), CompareDiagonals);
+
+    for(sml_u32 Idx = 0; Idx < Diagonals.Count; Idx++)
+    {
+        sml_tri_edge   Edge   = Diagonals[Idx].Edge;
+        sml_edge_tris *Shared = Edges->Find(Edge);
+
+        sml_u32 A = FindPiece(Parents.Values, Shared->Tris[0]);
+        sml_u32 B = FindPiece(Parents.Values, Shared->Tris[1]);
+
+        if(A == B) continue;
+
+        bool Removed = MergePieces(Pieces.Values + A * MaxVerts, &Counts[A],
+                                   Pieces.Values + B * MaxVerts, Counts[B],
+                                   Edge.Point0, Edge.Point1, Points.Values, MaxVerts,
+                                   Merged.Values);
+        if(Removed) Parents[B] = A;
+    }
+
+    // Pieces still standing become polygons, Counts of a root is reused for
+    // its polygon id.
+    sml_u32 FirstPoly = Mesh->Polys.Count;
+
+    for(sml_u32 Tri = 0; Tri < TriCount; Tri++)
+    {
+        if(FindPiece(Parents.Values, Tri) != Tri) continue;
+
+        nav_convex_poly Convex = {};
+        Convex.FirstIndex = Mesh->Indices.Count;
+        Convex.Count      = Counts[Tri];
+        Convex.Source     = Source;
+
+        for(sml_u32 Idx = 0; Idx < Counts[Tri]; Idx++)
+        {
+            Mesh->Indices.Push(Base + Pieces[Tri * MaxVerts + Idx]);
+        }
+
+        Counts[Tri] = Mesh->Polys.Count;
+        Mesh->Polys.Push(Convex);
+    }
+
+    for(sml_u32 PolyIdx = FirstPoly; PolyIdx < Mesh->Polys.Count; PolyIdx++)
+    {
+        nav_convex_poly Convex = Mesh->Polys[PolyIdx];
+
+        for(sml_u32 Idx = 0; Idx < Convex.Count; Idx++)
+        {
+            sml_point Corners[2] =
+            {
+                Mesh->Indices[Convex.FirstIndex + Idx] - Base,
+                Mesh->Indices[Convex.FirstIndex + (Idx + 1) % Convex.Count] - Base,
+            };
+
+            sml_u32        Neighbor = NavInvalidPoly;
+            sml_edge_tris *Shared   = Edges->Find(SmlInt_MakeEdgeKey(0, Corners));
+
+            if(Shared && Shared->Count == 2)
+            {
+                sml_u32 A = Counts[FindPiece(Parents.Values, Shared->Tris[0])];
+                sml_u32 B = Counts[FindPiece(Parents.Values, Shared->Tris[1])];
+
+                Neighbor = (A == PolyIdx) ? B : A;
+            }
+
+            Mesh->Neighbors.Push(Neighbor);
+
+            if(Neighbor != NavInvalidPoly && PolyIdx < Neighbor)
+            {
+                nav_portal Portal = {};
+                Portal.Polys[0] = PolyIdx;
+                Portal.Polys[1] = Neighbor;
+                Portal.Verts[0] = Base + Corners[0];
+                Portal.Verts[1] = Base + Corners[1];
+
+                Mesh->Portals.Push(Portal);
+            }
+        }
+    }
+
+    Points.Free();
+    Triangles.Free();
+    Canon.Free();
+    Seen.Free();
+    Pieces.Free();
+    Counts.Free();
+    Parents.Free();
+    Diagonals.Free();
+    Merged.Free();
+    EdgeMap.Free();
+}
+
+// 4-ary heap
+// ===================================
+
+static inline void
+NavHeapPlace(nav_heap *Heap, sml_u32 Slot, sml_u32 NodeIdx)
+{
+    Heap->Slots[Slot]             = NodeIdx;
+    Heap->Nodes[NodeIdx].HeapSlot = Slot;
+}
+
+static void
+NavHeapSiftUp(nav_heap *Heap, sml_u32 Slot)
+{
+    nav_node *Nodes   = Heap->Nodes;
+    sml_u32  *Slots   = Heap->Slots;
+    sml_u32   NodeIdx = Slots[Slot];
+    sml_f32   Total   = Nodes[NodeIdx].Total;
+
+    while(Slot > 0)
+    {
+        sml_u32 Parent = (Slot - 1) / 4;
+        if(Nodes[Slots[Parent]].Total <= Total) break;
+
+        NavHeapPlace(Heap, Slot, Slots[Parent]);
+        Slot = Parent;
+    }
+
+    NavHeapPlace(Heap, Slot, NodeIdx);
+}
+
+static void
+NavHeapPush(nav_heap *Heap, sml_u32 NodeIdx)
+{
+    sml_u32 Slot = Heap->Count++;
+
+    NavHeapPlace(Heap, Slot, NodeIdx);
+    NavHeapSiftUp(Heap, Slot);
+}
+
+static sml_u32
+NavHeapPop(nav_heap *Heap)
+{
+    nav_node *Nodes = Heap->Nodes;
+    sml_u32  *Slots = Heap->Slots;
+    sml_u32   Top   = Slots[0];
+    sml_u32   Last  = Slots[--Heap->Count];
+    sml_u32   Count = Heap->Count;
+
+    if(Count == 0) return Top;
+
+    sml_f32 Total = Nodes[Last].Total;
+    sml_u32 Slot  = 0;
+
+    for(;;)
+    {
+        sml_u32 First = Slot * 4 + 1;
+        if(First >= Count) break;
+
+        sml_u32 End  = Count - First < 4 ? Count : First + 4;
+        sml_u32 Best = First;
+
+        for(sml_u32 Child = First + 1; Child < End; Child++)
+        {
+            if(Nodes[Slots[Child]].Total < Nodes[Slots[Best]].Total) Best = Child;
+        }
+
+        if(Nodes[Slots[Best]].Total >= Total) break;
+
+        NavHeapPlace(Heap, Slot, Slots[Best]);
+        Slot = Best;
+    }
+
+    NavHeapPlace(Heap, Slot, Last);
+
+    return Top;
+}
+
+// NOTE: Opens a node, or reopens it when Total beats the path it was reached
+// by. Returns whether the node changed.
+
+static bool
+NavHeapRelax(nav_heap *Heap, sml_u32 Generation, sml_u32 NodeIdx, sml_u32 Parent,
+             sml_vector3 Position, sml_f32 Cost, sml_f32 Total)
+{
+    nav_node *Node  = Heap->Nodes + NodeIdx;
+    bool      Fresh = Node->Generation != Generation;
+
+    if(!Fresh && Total >= Node->Total) return false;
+
+    bool Queued = !Fresh && !Node->Closed;
+
+    Node->Position   = Position;
+    Node->Cost       = Cost;
+    Node->Total      = Total;
+    Node->Parent     = Parent;
+    Node->Generation = Generation;
+    Node->Closed     = false;
+
+    if(Queued) NavHeapSiftUp(Heap, Node->HeapSlot);
+    else       NavHeapPush(Heap, NodeIdx);
+
+    return true;
+}
+
+static inline sml_f32
+NavDistance(sml_vector3 A, sml_vector3 B)
+{
+    sml_vector3 Delta = A - B;
+    return sqrtf(SmlVec3_Dot(Delta, Delta));
+}
+
+// NOTE: Twice the signed area of A, B, C seen from above, positive when C is
+// left of A -> B (counter-clockwise).
+
+static inline sml_f32
+NavSignedArea(sml_vector3 A, sml_vector3 B, sml_vector3 C)
+{
+    return (B.x - A.x) * (C.z - A.z) - (C.x - A.x) * (B.z - A.z);
+}
+
+static inline bool
+NavSamePoint(sml_vector3 A, sml_vector3 B)
+{
+    sml_vector3 Delta = A - B;
+    return SmlVec3_Dot(Delta, Delta) < 1e-12f;
+}
+
+// NOTE: Edges run counter-clockwise around From, so looking from From into To
+// the edge start is on the right and its end on the left.
+
+static bool
+NavPortalPoints(nav_convex_mesh *Mesh, sml_u32 From, sml_u32 To, sml_vector3 *Left,
+                sml_vector3 *Right)
+{
+    nav_convex_poly Convex = Mesh->Polys[From];
+
+    for(sml_u32 Idx = 0; Idx < Convex.Count; Idx++)
+    {
+        if(Mesh->Neighbors[Convex.FirstIndex + Idx] != To) continue;
+
+        sml_u32 Next = Idx + 1 < Convex.Count ? Idx + 1 : 0;
+
+        *Right = Mesh->Verts[Mesh->Indices[Convex.FirstIndex + Idx]];
+        *Left  = Mesh->Verts[Mesh->Indices[Convex.FirstIndex + Next]];
+
+        return true;
+    }
+
+    return false;
+}
+
+// NOTE: Same sums as NavSearch: from Start through the portal midpoints to
+// End, each leg at the cost of the piece it crosses. Gives the cost of a found
+// corridor for other points in its first and last pieces.
+
+static sml_f32
+NavPathCost(nav_convex_mesh *Mesh, nav_query_filter *Filter, sml_u32 *Polys,
+            sml_u32 Count, sml_vector3 Start, sml_vector3 End)
+{
+    sml_vector3 Position = Start;
+    sml_f32     Cost     = 0.0f;
+
+    for(sml_u32 Idx = 0; Idx + 1 < Count; Idx++)
+    {
+        sml_vector3 Left, Right;
+        NavPortalPoints(Mesh, Polys[Idx], Polys[Idx + 1], &Left, &Right);
+
+        sml_vector3 Mid      = SmlVec3_Scale(Right + Left, 0.5f);
+        sml_f32     AreaCost = Filter->AreaCosts[Mesh->Polys[Polys[Idx]].Area];
+
+        Cost    += NavDistance(Position, Mid) * AreaCost;
+        Position = Mid;
+    }
+
+    sml_f32 EndCost = Filter->AreaCosts[Mesh->Polys[Polys[Count - 1]].Area];
+
+    return Cost + NavDistance(Position, End) * EndCost;
+}
+
+// NOTE: Closest point on the outline of a piece seen from above, the height is
+// interpolated along the edge.
+
+static sml_vector3
+NavClosestOnOutline(nav_convex_mesh *Mesh, sml_u32 PolyIdx, sml_vector3 Point)
+{
+    nav_convex_poly Convex = Mesh->Polys[PolyIdx];
+
+    sml_vector3 Best     = Point;
+    sml_f32     BestDist = -1.0f;
+
+    for(sml_u32 Idx = 0; Idx < Convex.Count; Idx++)
+    {
+        sml_u32 Next = Idx + 1 < Convex.Count ? Idx + 1 : 0;
+
+        sml_vector3 A = Mesh->Verts[Mesh->Indices[Convex.FirstIndex + Idx]];
+        sml_vector3 B = Mesh->Verts[Mesh->Indices[Convex.FirstIndex + Next]];
+
+        sml_f32 DX = B.x - A.x, DZ = B.z - A.z;
+        sml_f32 LengthSq = DX * DX + DZ * DZ;
+        sml_f32 T        = 0.0f;
+
+        if(LengthSq > 0.0f)
+        {
+            T = ((Point.x - A.x) * DX + (Point.z - A.z) * DZ) / LengthSq;
+            T = T < 0.0f ? 0.0f : T > 1.0f ? 1.0f : T;
+        }
+
+        sml_vector3 OnEdge = A + SmlVec3_Scale(B - A, T);
+
+        sml_f32 EX = OnEdge.x - Point.x, EZ = OnEdge.z - Point.z;
+        sml_f32 Dist = EX * EX + EZ * EZ;
+
+        if(BestDist < 0.0f || Dist < BestDist)
+        {
+            Best     = OnEdge;
+            BestDist = Dist;
+        }
+    }
+
+    return Best;
+}
+
+// NOTE: Clamped, points off the grid use the border cells.
+
+static inline sml_u32
+NavGridCoord(sml_f32 Value, sml_f32 Min, sml_f32 InvCellSize, sml_u32 Count)
+{
+    sml_f32 Cell = (Value - Min) * InvCellSize;
+
+    if(!(Cell > 0.0f))          return 0;
+    if(Cell >= (sml_f32)Count)  return Count - 1;
+
+    return (sml_u32)Cell;
+}
+
+// Search
+// ===================================
+
+// NOTE: Cheapest allowed area cost, it scales the heuristic. Zero when every
+// area is blocked.
+
+static sml_f32
+NavMinCost(nav_query_filter *Filter)
+{
+    sml_f32 MinCost = 0.0f;
+
+    for(sml_u32 Area = 0; Area < NavMaxAreas; Area++)
+    {
+        sml_f32 Cost = Filter->AreaCosts[Area];
+        if(Cost > 0.0f && (MinCost == 0.0f || Cost < MinCost)) MinCost = Cost;
+    }
+
+    return MinCost;
+}
+
+// NOTE: A new generation retires every node of the previous search.
+
+static sml_u32
+NavNextGeneration(sml_u32 *Generation, dynamic_array<nav_node> &Nodes)
+{
+    if(++*Generation == 0)
+    {
+        for(sml_u32 Idx = 0; Idx < Nodes.Count; Idx++) Nodes.Values[Idx].Generation = 0;
+
+        *Generation = 1;
+    }
+
+    return *Generation;
+}
+
+// NOTE: Same for region stamps, the caller then stamps the regions to open.
+
+static sml_u32
+NavNextRegionStamp(nav_query *Query)
+{
+    if(++Query->RegionStamp == 0)
+    {
+        for(sml_u32 Idx = 0; Idx < Query->RegionStamps.Count; Idx++)
+        {
+            Query->RegionStamps.Values[Idx] = 0;
+        }
+
+        Query->RegionStamp = 1;
+    }
+
+    return Query->RegionStamp;
+}
+
+// NOTE:
+// 1) A* over the convex pieces. Moving from the entry point of a piece to one
+//    of its portals costs the distance times the area cost of the piece,
+//    reaching EndPoly adds the distance to End.
+// 2) The heuristic is the straight distance to End times the cheapest allowed
+//    area cost, it never overestimates. A piece keeps only its cheapest way in,
+//    so across long portals the path can cost more than the best corridor.
+//    With EndPoly NavInvalidPoly there is no heuristic and every reachable
+//    piece is visited.
+// 3) With Regions set, only pieces of the regions stamped with the current
+//    RegionStamp are entered.
+// 4) Returns whether EndPoly was reached. *Closest is the last piece of the
+//    path: EndPoly, or the visited piece closest to End.
+// 5) The search gives up after closing MaxNodes pieces.
+
+static bool
+NavSearch(nav_query *Query, nav_query_filter *Filter, sml_u32 StartPoly,
+          sml_vector3 Start, sml_u32 EndPoly, sml_vector3 End, const sml_u32 *Regions,
+          sml_u32 *Closest, sml_u32 MaxNodes = NavNoNodeLimit)
+{
+    nav_convex_mesh *Mesh = Query->Mesh;
+
+    sml_f32 MinCost = EndPoly != NavInvalidPoly ? NavMinCost(Filter) : 0.0f;
+
+    nav_node *Nodes      = Query->Nodes.Values;
+    sml_u32   Generation = NavNextGeneration(&Query->Generation, Query->Nodes);
+    sml_u32  *Stamps     = Query->RegionStamps.Values;
+    sml_u32   Stamp      = Query->RegionStamp;
+
+    nav_heap Open = {Nodes, Query->Heap.Values, 0};
+
+    NavHeapRelax(&Open, Generation, StartPoly, NavInvalidPoly, Start, 0.0f,
+                 NavDistance(Start, End) * MinCost);
+
+    sml_f32 ClosestDist = NavDistance(Start, End);
+    sml_u32 Visited     = 0;
+    *Closest            = StartPoly;
+
+    while(Open.Count && Visited++ < MaxNodes)
+    {
+        sml_u32   Current = NavHeapPop(&Open);
+        nav_node *Node    = Nodes + Current;
+
+        Node->Closed = true;
+
+        if(Current == EndPoly)
+        {
+            *Closest = Current;
+            return true;
+        }
+
+        nav_convex_poly Convex   = Mesh->Polys[Current];
+        sml_f32         AreaCost = Filter->AreaCosts[Convex.Area];
+
+        sml_u32     *Corners = Mesh->Indices.Values + Convex.FirstIndex;
+        sml_u32     *Across  = Mesh->Neighbors.Values + Convex.FirstIndex;
+        sml_vector3 *Verts   = Mesh->Verts.Values;
+
+        for(sml_u32 Idx = 0; Idx < Convex.Count; Idx++)
+        {
+            sml_u32 Neighbor = Across[Idx];
+            if(Neighbor == NavInvalidPoly || Neighbor == Node->Parent) continue;
+            if(Regions && Stamps[Regions[Neighbor]] != Stamp)           continue;
+
+            sml_f32 NeighborCost = Filter->AreaCosts[Mesh->Polys.Values[Neighbor].Area];
+            if(NeighborCost <= 0.0f) continue;
+
+            sml_u32     Next = Idx + 1 < Convex.Count ? Idx + 1 : 0;
+            sml_vector3 Edge = Verts[Corners[Idx]] + Verts[Corners[Next]];
+            sml_vector3 Mid  = SmlVec3_Scale(Edge, 0.5f);
+
+            sml_f32 ToEnd = NavDistance(Mid, End);
+            sml_f32 Cost  = Node->Cost + NavDistance(Node->Position, Mid) * AreaCost;
+            sml_f32 Total = Cost + ToEnd * MinCost;
+
+            if(Neighbor == EndPoly)
+            {
+                Cost += ToEnd * NeighborCost;
+                Total = Cost;
+            }
+
+            if(!NavHeapRelax(&Open, Generation, Neighbor, Current, Mid, Cost, Total))
+            {
+                continue;
+            }
+
+            if(ToEnd < ClosestDist)
+            {
+                *Closest    = Neighbor;
+                ClosestDist = ToEnd;
+            }
+        }
+    }
+
+    return false;
+}
+
+// NOTE: Checks the end pieces, searches, then walks back from the last piece
+// skipping what does not fit in Path.
+
+static NavPath_Status
+NavPathBetween(nav_query *Query, nav_query_filter *Filter, sml_u32 StartPoly,
+               sml_vector3 Start, sml_u32 EndPoly, sml_vector3 End,
+               const sml_u32 *Regions, nav_path *Path, sml_u32 MaxNodes = NavNoNodeLimit)
+{
+    nav_convex_mesh *Mesh = Query->Mesh;
+
+    Path->Count = 0;
+    Path->Cost  = 0.0f;
+
+    if(StartPoly == NavInvalidPoly || EndPoly == NavInvalidPoly) return NavPath_NoPoly;
+
+    sml_f32 StartCost = Filter->AreaCosts[Mesh->Polys[StartPoly].Area];
+    sml_f32 EndCost   = Filter->AreaCosts[Mesh->Polys[EndPoly].Area];
+
+    if(StartCost <= 0.0f || EndCost <= 0.0f) return NavPath_NoPoly;
+
+    if(StartPoly == EndPoly)
+    {
+        Path->Polys[0] = StartPoly;
+        Path->Count    = 1;
+        Path->Cost     = NavDistance(Start, End) * StartCost;
+
+        return NavPath_Found;
+    }
+
+    sml_u32 Closest = NavInvalidPoly;
+    bool    Found   = NavSearch(Query, Filter, StartPoly, Start, EndPoly, End, Regions,
+                                &Closest, MaxNodes);
+
+    nav_node *Nodes  = Query->Nodes.Values;
+    sml_u32   Length = 0;
+
+    for(sml_u32 Poly = Closest; Poly != NavInvalidPoly; Poly = Nodes[Poly].Parent)
+    {
+        Length++;
+    }
+
+    sml_u32 Kept = Length < Path->Capacity ? Length : Path->Capacity;
+    sml_u32 Poly = Closest;
+
+    for(sml_u32 Skip = Length; Skip > Kept; Skip--) Poly = Nodes[Poly].Parent;
+
+    for(sml_u32 Idx = Kept; Idx > 0; Idx--)
+    {
+        Path->Polys[Idx - 1] = Poly;
+        Poly                 = Nodes[Poly].Parent;
+    }
+
+    Path->Count = Kept;
+    Path->Cost  = Nodes[Closest].Cost;
+
+    if(!Found)        return NavPath_Partial;
+    if(Kept < Length) return NavPath_Truncated;
+
+    return NavPath_Found;
+}
+
+// Hierarchy
+// ===================================
+
+static inline sml_u32
+NavEntranceSide(nav_entrance *Entrance, sml_u32 RegionIdx)
+{
+    return Entrance->Regions[0] == RegionIdx ? 0 : 1;
+}
+
+// NOTE: Cost from the searched point to an entrance of the region, read from
+// the nodes of the last NavSearch. Negative when the search did not get there.
+
+static sml_f32
+NavEntranceCost(nav_query *Query, nav_query_filter *Filter, nav_entrance *Entrance,
+                sml_u32 RegionIdx)
+{
+    sml_u32   Poly = Entrance->Polys[NavEntranceSide(Entrance, RegionIdx)];
+    nav_node *Node = Query->Nodes.Values + Poly;
+
+    if(Node->Generation != Query->Generation) return -1.0f;
+
+    sml_f32 AreaCost = Filter->AreaCosts[Query->Mesh->Polys[Poly].Area];
+    if(AreaCost <= 0.0f) return -1.0f;
+
+    return Node->Cost + NavDistance(Node->Position, Entrance->Position) * AreaCost;
+}
+
+// NOTE: One search per entrance of the region, each flooding the region alone.
+
+static void
+NavRegionCosts(nav_hierarchy *Hierarchy, nav_query *Query, sml_u32 RegionIdx)
+{
+    nav_region *Region  = Hierarchy->Regions.Values + RegionIdx;
+    sml_u32    *List    = Hierarchy->RegionEntrances.Values + Region->FirstEntrance;
+    sml_f32    *Costs   = Hierarchy->Costs.Values + Region->FirstCost;
+    sml_u32     Count   = Region->EntranceCount;
+    sml_u32    *Regions = Hierarchy->PolyRegions.Values;
+
+    nav_query_filter *Filter = &Hierarchy->Filter;
+
+    Query->RegionStamps[RegionIdx] = NavNextRegionStamp(Query);
+
+    for(sml_u32 From = 0; From < Count; From++)
+    {
+        nav_entrance *Entrance = Hierarchy->Entrances.Values + List[From];
+        sml_u32       Poly     = Entrance->Polys[NavEntranceSide(Entrance, RegionIdx)];
+        sml_u32       Area     = Hierarchy->Mesh->Polys[Poly].Area;
+        bool          Open     = Filter->AreaCosts[Area] > 0.0f;
+
+        if(Open)
+        {
+            sml_u32 Closest;
+            NavSearch(Query, Filter, Poly, Entrance->Position, NavInvalidPoly,
+                      Entrance->Position, Regions, &Closest);
+        }
+
+        for(sml_u32 To = 0; To < Count; To++)
+        {
+            nav_entrance *Other = Hierarchy->Entrances.Values + List[To];
+            sml_f32       Cost  = Open ? NavEntranceCost(Query, Filter, Other, RegionIdx)
+                                       : -1.0f;
+
+            Costs[From * Count + To] = To != From ? Cost : 0.0f;
+        }
+    }
+
+    Region->Dirty = false;
+}
+
+// NOTE:
+// 1) Plans over the entrances first. Two searches limited to one region give
+//    the cost from Start to the entrances of its region and from the entrances
+//    of End's region to End, then A* runs over the abstract graph. The piece
+//    search only enters the regions along the abstract path.
+// 2) Start and End in one region, or no abstract path, fall back to FindPath,
+//    as does a corridor the query filter cannot cross.
+// 3) The path is the one NavSearch finds inside the corridor, which may cost
+//    a little more or less than the one FindPath finds.
+
+static NavPath_Status
+NavPathHierarchical(nav_query *Query, nav_query_filter *Filter, sml_u32 StartPoly,
+                    sml_vector3 Start, sml_u32 EndPoly, sml_vector3 End, nav_path *Path)
+{
+    nav_hierarchy *Hierarchy = Query->Hierarchy;
+    Sml_Assert(Hierarchy && Hierarchy->Revision == Query->Mesh->Revision);
+    Sml_Assert(Query->EntranceNodes.Count == Hierarchy->Entrances.Count + 1);
+
+    nav_convex_mesh *Mesh    = Query->Mesh;
+    sml_u32         *Regions = Hierarchy->PolyRegions.Values;
+
+    bool Flat = StartPoly == NavInvalidPoly || EndPoly == NavInvalidPoly ||
+                Regions[StartPoly] == Regions[EndPoly];
+
+    if(!Flat)
+    {
+        sml_f32 StartCost = Filter->AreaCosts[Mesh->Polys[StartPoly].Area];
+        sml_f32 EndCost   = Filter->AreaCosts[Mesh->Polys[EndPoly].Area];
+
+        Flat = StartCost <= 0.0f || EndCost <= 0.0f;
+    }
+
+    if(Flat)
+    {
+        return NavPathBetween(Query, Filter, StartPoly, Start, EndPoly, End, nullptr,
+                              Path);
+    }
+
+    sml_u32 StartRegion = Regions[StartPoly];
+    sml_u32 EndRegion   = Regions[EndPoly];
+
+    nav_entrance *Entrances = Hierarchy->Entrances.Values;
+    nav_region    Entry     = Hierarchy->Regions[StartRegion];
+    nav_region    Exit      = Hierarchy->Regions[EndRegion];
+    sml_u32      *EntryList = Hierarchy->RegionEntrances.Values + Entry.FirstEntrance;
+    sml_u32      *ExitList  = Hierarchy->RegionEntrances.Values + Exit.FirstEntrance;
+    sml_f32      *ExitCosts = Query->ExitCosts.Values;
+    sml_u32       Closest;
+
+    // Entrances of End's region to End, searched from End: costs are the same
+    // both ways.
+    Query->RegionStamps[EndRegion] = NavNextRegionStamp(Query);
+    NavSearch(Query, Filter, EndPoly, End, NavInvalidPoly, End, Regions, &Closest);
+
+    for(sml_u32 Slot = 0; Slot < Exit.EntranceCount; Slot++)
+    {
+        ExitCosts[Slot] = NavEntranceCost(Query, Filter, Entrances + ExitList[Slot],
+                                          EndRegion);
+    }
+
+    // Start to the entrances of its region seeds the abstract search.
+    Query->RegionStamps[StartRegion] = NavNextRegionStamp(Query);
+    NavSearch(Query, Filter, StartPoly, Start, NavInvalidPoly, Start, Regions, &Closest);
+
+    sml_u32   EndNode    = Hierarchy->Entrances.Count;
+    nav_node *Nodes      = Query->EntranceNodes.Values;
+    sml_u32   Generation = NavNextGeneration(&Query->EntranceGeneration,
+                                             Query->EntranceNodes);
+    sml_f32   MinCost    = NavMinCost(Filter);
+
+    nav_heap Open = {Nodes, Query->EntranceHeap.Values, 0};
+
+    for(sml_u32 Slot = 0; Slot < Entry.EntranceCount; Slot++)
+    {
+        nav_entrance *Entrance = Entrances + EntryList[Slot];
+
+        sml_f32 Cost = NavEntranceCost(Query, Filter, Entrance, StartRegion);
+        if(Cost < 0.0f) continue;
+
+        sml_f32 Total = Cost + NavDistance(Entrance->Position, End) * MinCost;
+        NavHeapRelax(&Open, Generation, EntryList[Slot], NavInvalidPoly,
+                     Entrance->Position, Cost, Total);
+    }
+
+    bool Found = false;
+
+    while(Open.Count)
+    {
+        sml_u32   Current = NavHeapPop(&Open);
+        nav_node *Node    = Nodes + Current;
+
+        Node->Closed = true;
+
+        if(Current == EndNode)
+        {
+            Found = true;
+            break;
+        }
+
+        nav_entrance *Entrance = Entrances + Current;
+
+        for(sml_u32 Side = 0; Side < 2; Side++)
+        {
+            sml_u32    RegionIdx = Entrance->Regions[Side];
+            nav_region Region    = Hierarchy->Regions[RegionIdx];
+            sml_u32    Count     = Region.EntranceCount;
+
+            sml_u32 *List = Hierarchy->RegionEntrances.Values + Region.FirstEntrance;
+            sml_f32 *Row  = Hierarchy->Costs.Values + Region.FirstCost +
+                            Entrance->Slots[Side] * Count;
+
+            for(sml_u32 To = 0; To < Count; To++)
+            {
+                if(Row[To] < 0.0f || List[To] == Current) continue;
+
+                nav_entrance *Other = Entrances + List[To];
+
+                sml_f32 Cost  = Node->Cost + Row[To];
+                sml_f32 Total = Cost + NavDistance(Other->Position, End) * MinCost;
+
+                NavHeapRelax(&Open, Generation, List[To], Current, Other->Position, Cost,
+                             Total);
+            }
+
+            sml_f32 ExitCost = ExitCosts[Entrance->Slots[Side]];
+
+            if(RegionIdx == EndRegion && ExitCost >= 0.0f)
+            {
+                sml_f32 Cost = Node->Cost + ExitCost;
+                NavHeapRelax(&Open, Generation, EndNode, Current, End, Cost, Cost);
+            }
+        }
+    }
+
+    if(!Found)
+    {
+        return NavPathBetween(Query, Filter, StartPoly, Start, EndPoly, End, nullptr,
+                              Path);
+    }
+
+    // The corridor: both regions of every entrance on the abstract path.
+    sml_u32  Stamp  = NavNextRegionStamp(Query);
+    sml_u32 *Stamps = Query->RegionStamps.Values;
+
+    for(sml_u32 Idx = Nodes[EndNode].Parent; Idx != NavInvalidPoly;
+        Idx = Nodes[Idx].Parent)
+    {
+        Stamps[Entrances[Idx].Regions[0]] = Stamp;
+        Stamps[Entrances[Idx].Regions[1]] = Stamp;
+    }
+
+    NavPath_Status Status = NavPathBetween(Query, Filter, StartPoly, Start, EndPoly, End,
+                                           Regions, Path);
+
+    if(Status == NavPath_Partial)
+    {
+        Status = NavPathBetween(Query, Filter, StartPoly, Start, EndPoly, End, nullptr,
+                                Path);
+    }
+
+    return Status;
+}
+
+// ===================================
+// User API
+// ===================================
+
+// NOTE:
+// 1) Optional pass before BuildNavMesh. Adjacency is found through point
+//    indices, so points split at UV or normal seams cut the walkable area
+//    apart. Every index is replaced by the lowest point index at the same
+//    position, within WeldDistance (see SmlInt_WeldPoints). Points is not
+//    modified.
+// 2) OutIndices may be Indices. Returns how many of the PointCount points are
+//    left after welding.
+
+static sml_u32
+WeldNavMeshVertices(sml_vector3 *Points, sml_u32 PointCount, sml_u32 *Indices,
+                    sml_u32 IdxCount, sml_u32 *OutIndices, sml_f32 WeldDistance = 0.0f,
+                    sml_u32 ThreadCount = 0)
+{
+    sml_heap_block RemapHeap = SmlMemory.Allocate(PointCount * sizeof(sml_point));
+    sml_point     *Remap     = (sml_point*)RemapHeap.Data;
+
+    sml_u32 Unique = SmlInt_WeldPoints(Points, PointCount, WeldDistance, Remap,
+                                       ThreadCount);
+
+    Sml_ParallelFor(IdxCount, SmlNavChunkSize * 3, ThreadCount,
+    [&](sml_u32 Begin, sml_u32 End, sml_u32)
+    {
+        for(sml_u32 Idx = Begin; Idx < End; Idx++)
+        {
+            Sml_Assert(Indices[Idx] < PointCount);
+
+            OutIndices[Idx] = Remap[Indices[Idx]];
+        }
+    });
+
+    SmlMemory.Free(RemapHeap);
+
+    return Unique;
+}
+
+// WARN:
+// 1) Code is really ugly
+
+// NOTE:
+// 1) MaxError is how far (world units) polygon outlines may move from the
+//    walkable boundary. Zero only drops collinear boundary vertices.
+// 2) Every stage runs on ThreadCount threads (0 = all hardware threads), the
+//    polygons are the same for any thread count.
+
+static dynamic_array<nav_poly>
+BuildNavMesh(sml_vector3 *Points, sml_u32 *Indices, sml_u32 IdxCount,
+             sml_f32 SlopeDegree, sml_f32 MaxError = 0.0f, sml_u32 ThreadCount = 0)
+{
+    sml_walkable_list List = SmlInt_BuildWalkableList(Points, Indices, IdxCount,
+                                                      SlopeDegree, ThreadCount);
+
+    dynamic_array<dynamic_array<sml_tri>> 
+    Clusters = SmlInt_BuildPolygonClusters(&List, ThreadCount);
+
+    dynamic_array<nav_poly> 
+    NavPolygons = BuildNavPolygons(Clusters, &List, MaxError, ThreadCount);
+
+    for(sml_u32 Idx = 0; Idx < Clusters.Count; Idx++) Clusters[Idx].Free();
+
+    Clusters.Free();
+    SmlInt_FreeWalkableList(&List);
+
+    return NavPolygons;
+}
+
+// NOTE: Optional stage after BuildNavMesh, splits every nav polygon into convex
+// pieces of at most MaxVerts vertices and links them through portals.
+
+static nav_convex_mesh
+BuildConvexNavMesh(nav_poly *NavPolygons, sml_u32 Count, sml_u32 MaxVerts = 6)
+{
+    Sml_Assert(MaxVerts >= 3);
+
+    nav_convex_mesh Mesh = {};
+    sml_u32         All  = 0;
+
+    for(sml_u32 PolyIdx = 0; PolyIdx < Count; PolyIdx++)
+    {
+        All += NavPolygons[PolyIdx].Verts.Count;
+    }
+
+    Mesh.Verts     = dynamic_array<sml_vector3>(All);
+    Mesh.Indices   = dynamic_array<sml_u32>(All * 2);
+    Mesh.Neighbors = dynamic_array<sml_u32>(All * 2);
+    Mesh.Polys     = dynamic_array<nav_convex_poly>(All);
+    Mesh.Portals   = dynamic_array<nav_portal>(All);
+
+    for(sml_u32 PolyIdx = 0; PolyIdx < Count; PolyIdx++)
+    {
+        DecomposeNavPolygon(&Mesh, NavPolygons + PolyIdx, PolyIdx, MaxVerts);
+    }
+
+    Mesh.Revision = ++NavMeshRevisions;
+
+    return Mesh;
+}
+
+// NOTE: Half-plane tests against the edges of a convex piece, seen from above.
+
+static bool
+ConvexPolyContains(nav_convex_mesh *Mesh, sml_u32 PolyIdx, sml_vector3 Point)
+{
+    nav_convex_poly Convex = Mesh->Polys[PolyIdx];
+
+    sml_vector2 P = sml_vector2(Point.x, Point.z);
+
+    for(sml_u32 Idx = 0; Idx < Convex.Count; Idx++)
+    {
+        sml_vector3 A3 = Mesh->Verts[Mesh->Indices[Convex.FirstIndex + Idx]];
+        sml_vector3 B3 = Mesh->Verts[Mesh->Indices[Convex.FirstIndex +
+                                                   (Idx + 1) % Convex.Count]];
+
+        sml_vector2 A = sml_vector2(A3.x, A3.z);
+        sml_vector2 B = sml_vector2(B3.x, B3.z);
+
+        if(SmlInt_SignedArea(&A, &B, &P) < 0.0f) return false;
+    }
+
+    return true;
+}
+
+static nav_query_filter
+DefaultNavQueryFilter()
+{
+    nav_query_filter Filter;
+
+    for(sml_u32 Area = 0; Area < NavMaxAreas; Area++) Filter.AreaCosts[Area] = 1.0f;
+
+    return Filter;
+}
+
+// NOTE: Hierarchy is optional, FindPathHierarchical needs it. It must be built
+// for the same mesh and outlive the query.
+
+static nav_query
+CreateNavQuery(nav_convex_mesh *Mesh, nav_hierarchy *Hierarchy = nullptr)
+{
+    sml_u32 PolyCount = Mesh->Polys.Count;
+
+    nav_query Query = {};
+    Query.Mesh      = Mesh;
+    Query.Hierarchy = Hierarchy;
+    Query.Nodes  = dynamic_array<nav_node>(PolyCount);
+    Query.Heap   = dynamic_array<sml_u32>(PolyCount, false);
+    Query.Bounds = dynamic_array<nav_poly_bounds>(PolyCount, false);
+
+    Query.Nodes.Count = PolyCount;
+
+    for(sml_u32 PolyIdx = 0; PolyIdx < PolyCount; PolyIdx++)
+    {
+        nav_convex_poly Convex = Mesh->Polys[PolyIdx];
+        nav_poly_bounds Bounds = {};
+
+        sml_vector3 First = Mesh->Verts[Mesh->Indices[Convex.FirstIndex]];
+        Bounds.MinX = Bounds.MaxX = First.x;
+        Bounds.MinZ = Bounds.MaxZ = First.z;
+
+        for(sml_u32 Idx = 0; Idx < Convex.Count; Idx++)
+        {
+            sml_vector3 Vert = Mesh->Verts[Mesh->Indices[Convex.FirstIndex + Idx]];
+
+            if(Vert.x < Bounds.MinX) Bounds.MinX = Vert.x;
+            if(Vert.x > Bounds.MaxX) Bounds.MaxX = Vert.x;
+            if(Vert.z < Bounds.MinZ) Bounds.MinZ = Vert.z;
+            if(Vert.z > Bounds.MaxZ) Bounds.MaxZ = Vert.z;
+
+            Bounds.Height += Vert.y;
+        }
+
+        Bounds.Height /= (sml_f32)Convex.Count;
+        Query.Bounds[PolyIdx] = Bounds;
+    }
+
+    Query.Bounds.Count = PolyCount;
+
+    sml_f32 MinX = 0.0f, MinZ = 0.0f, MaxX = 0.0f, MaxZ = 0.0f;
+
+    for(sml_u32 PolyIdx = 0; PolyIdx < PolyCount; PolyIdx++)
+    {
+        nav_poly_bounds Bounds = Query.Bounds[PolyIdx];
+
+        if(PolyIdx == 0 || Bounds.MinX < MinX) MinX = Bounds.MinX;
+        if(PolyIdx == 0 || Bounds.MinZ < MinZ) MinZ = Bounds.MinZ;
+        if(PolyIdx == 0 || Bounds.MaxX > MaxX) MaxX = Bounds.MaxX;
+        if(PolyIdx == 0 || Bounds.MaxZ > MaxZ) MaxZ = Bounds.MaxZ;
+    }
+
+    // Square cells, about one per piece.
+    sml_f32 Area     = (MaxX - MinX) * (MaxZ - MinZ);
+    sml_f32 CellSize = Area > 0.0f ? sqrtf(Area / (sml_f32)(PolyCount + 1)) : 1.0f;
+
+    Query.GridMinX    = MinX;
+    Query.GridMinZ    = MinZ;
+    Query.InvCellSize = 1.0f / CellSize;
+    Query.GridWidth   = (sml_u32)((MaxX - MinX) * Query.InvCellSize) + 1;
+    Query.GridHeight  = (sml_u32)((MaxZ - MinZ) * Query.InvCellSize) + 1;
+
+    sml_f32 InvCellSize = Query.InvCellSize;
+    sml_u32 Width       = Query.GridWidth;
+    sml_u32 Height      = Query.GridHeight;
+    sml_u32 CellCount   = Width * Height;
+
+    Query.CellStarts = dynamic_array<sml_u32>(CellCount + 1);
+
+    // Count, prefix sum, then fill, walking the cells of every piece twice.
+    for(sml_u32 Pass = 0; Pass < 2; Pass++)
+    {
+        for(sml_u32 PolyIdx = 0; PolyIdx < PolyCount; PolyIdx++)
+        {
+            nav_poly_bounds Bounds = Query.Bounds[PolyIdx];
+
+            sml_u32 X0 = NavGridCoord(Bounds.MinX, MinX, InvCellSize, Width);
+            sml_u32 X1 = NavGridCoord(Bounds.MaxX, MinX, InvCellSize, Width);
+            sml_u32 Z0 = NavGridCoord(Bounds.MinZ, MinZ, InvCellSize, Height);
+            sml_u32 Z1 = NavGridCoord(Bounds.MaxZ, MinZ, InvCellSize, Height);
+
+            for(sml_u32 Z = Z0; Z <= Z1; Z++)
+            {
+                for(sml_u32 X = X0; X <= X1; X++)
+                {
+                    sml_u32 Cell = Z * Width + X;
+
+                    if(Pass == 0) Query.CellStarts[Cell + 1]++;
+                    else          Query.CellPolys[Query.CellStarts[Cell]++] = PolyIdx;
+                }
+            }
+        }
+
+        if(Pass == 0)
+        {
+            for(sml_u32 Cell = 0; Cell < CellCount; Cell++)
+            {
+                Query.CellStarts[Cell + 1] += Query.CellStarts[Cell];
+            }
+
+            sml_u32 Entries = Query.CellStarts[CellCount];
+            Query.CellPolys = dynamic_array<sml_u32>(Entries + 1, false);
+        }
+    }
+
+    // The fill moved every start to the next cell's start.
+    for(sml_u32 Cell = CellCount; Cell > 0; Cell--)
+    {
+        Query.CellStarts[Cell] = Query.CellStarts[Cell - 1];
+    }
+
+    Query.CellStarts[0] = 0;
+
+    if(Hierarchy)
+    {
+        Sml_Assert(Hierarchy->Mesh == Mesh && Hierarchy->Revision == Mesh->Revision);
+
+        sml_u32 NodeCount   = Hierarchy->Entrances.Count + 1;
+        sml_u32 RegionCount = Hierarchy->Regions.Count;
+
+        Query.EntranceNodes = dynamic_array<nav_node>(NodeCount);
+        Query.EntranceHeap  = dynamic_array<sml_u32>(NodeCount, false);
+        Query.ExitCosts     = dynamic_array<sml_f32>(Hierarchy->MaxEntrances + 1, false);
+        Query.RegionStamps  = dynamic_array<sml_u32>(RegionCount + 1);
+
+        Query.EntranceNodes.Count = NodeCount;
+        Query.RegionStamps.Count  = RegionCount;
+    }
+
+    return Query;
+}
+
+// NOTE: Pieces are tested from above, only those listed in the point's grid
+// cell. Where several contain the point (bridges, stacked floors) the one with
+// the closest average height wins.
+
+static sml_u32
+FindNavPoly(nav_query *Query, sml_vector3 Point)
+{
+    sml_u32 Best       = NavInvalidPoly;
+    sml_f32 BestHeight = 0.0f;
+
+    if(Query->Bounds.Count == 0) return Best;
+
+    sml_u32 X    = NavGridCoord(Point.x, Query->GridMinX, Query->InvCellSize,
+                                Query->GridWidth);
+    sml_u32 Z    = NavGridCoord(Point.z, Query->GridMinZ, Query->InvCellSize,
+                                Query->GridHeight);
+    sml_u32 Cell = Z * Query->GridWidth + X;
+
+    for(sml_u32 Idx = Query->CellStarts[Cell]; Idx < Query->CellStarts[Cell + 1]; Idx++)
+    {
+        sml_u32          PolyIdx = Query->CellPolys.Values[Idx];
+        nav_poly_bounds &Bounds  = Query->Bounds.Values[PolyIdx];
+
+        if(Point.x < Bounds.MinX || Point.x > Bounds.MaxX) continue;
+        if(Point.z < Bounds.MinZ || Point.z > Bounds.MaxZ) continue;
+
+        sml_f32 Height = fabsf(Bounds.Height - Point.y);
+        if(Best != NavInvalidPoly && Height >= BestHeight) continue;
+
+        if(ConvexPolyContains(Query->Mesh, PolyIdx, Point))
+        {
+            Best       = PolyIdx;
+            BestHeight = Height;
+        }
+    }
+
+    return Best;
+}
+
+// NOTE:
+// 1) A* over the convex pieces, see NavSearch.
+// 2) Path->Polys must hold at least one piece.
+
+static NavPath_Status
+FindPath(nav_query *Query, sml_vector3 Start, sml_vector3 End, nav_query_filter *Filter,
+         nav_path *Path)
+{
+    Sml_Assert(Path->Capacity > 0);
+
+    sml_u32 StartPoly = FindNavPoly(Query, Start);
+    sml_u32 EndPoly   = FindNavPoly(Query, End);
+
+    return NavPathBetween(Query, Filter, StartPoly, Start, EndPoly, End, nullptr, Path);
+}
+
+// NOTE:
+// 1) Simple stupid funnel algorithm (Mononen) over a corridor from FindPath.
+//    The funnel starts at Start and narrows portal by portal. When one side
+//    crosses the other, that corner becomes a waypoint and the scan restarts
+//    from it. Portals are read straight from the mesh, so nothing is allocated.
+// 2) Writes Start, the corners and End to OutPoints and returns the count, at
+//    most MaxPoints. When the list is cut short it ends on the last corner
+//    that fit.
+// 3) End is moved onto the last piece when it lies outside it, as with a
+//    NavPath_Partial corridor.
+
+static sml_u32
+FindStraightPath(nav_convex_mesh *Mesh, nav_path *Corridor, sml_vector3 Start,
+                 sml_vector3 End, sml_vector3 *OutPoints, sml_u32 MaxPoints)
+{
+    if(Corridor->Count == 0 || MaxPoints == 0) return 0;
+
+    sml_u32 PortalCount = Corridor->Count + 1;
+    sml_u32 LastPoly    = Corridor->Polys[Corridor->Count - 1];
+
+    if(!ConvexPolyContains(Mesh, LastPoly, End))
+    {
+        End = NavClosestOnOutline(Mesh, LastPoly, End);
+    }
+
+    sml_u32 Count = 0;
+    OutPoints[Count++] = Start;
+
+    sml_vector3 Apex     = Start;
+    sml_vector3 FunnelL  = Start;
+    sml_vector3 FunnelR  = Start;
+    sml_u32     LeftIdx  = 0;
+    sml_u32     RightIdx = 0;
+
+    // Portal 0 is Start, portal I joins Polys[I - 1] and Polys[I], the last
+    // one is End.
+    for(sml_u32 Idx = 1; Idx < PortalCount && Count < MaxPoints; Idx++)
+    {
+        sml_vector3 Left  = End;
+        sml_vector3 Right = End;
+
+        if(Idx < Corridor->Count)
+        {
+            bool Linked = NavPortalPoints(Mesh, Corridor->Polys[Idx - 1],
+                                          Corridor->Polys[Idx], &Left, &Right);
+            Sml_Assert(Linked);
+        }
+
+        sml_vector3 Corner  = Apex;
+        sml_u32     Restart = 0;
+        bool        Crossed = false;
+
+        // Right side moves in, unless it crosses the left side.
+        if(NavSignedArea(Apex, FunnelR, Right) >= 0.0f)
+        {
+            if(NavSamePoint(Apex, FunnelR) || NavSignedArea(Apex, FunnelL, Right) < 0.0f)
+            {
+                FunnelR  = Right;
+                RightIdx = Idx;
+            }
+            else
+            {
+                Corner  = FunnelL;
+                Restart = LeftIdx;
+                Crossed = true;
+            }
+        }
+
+        // Left side moves in, unless it crosses the right side.
+        if(!Crossed && NavSignedArea(Apex, FunnelL, Left) <= 0.0f)
+        {
+            if(NavSamePoint(Apex, FunnelL) || NavSignedArea(Apex, FunnelR, Left) > 0.0f)
+            {
+                FunnelL = Left;
+                LeftIdx = Idx;
+            }
+            else
+            {
+                Corner  = FunnelR;
+                Restart = RightIdx;
+                Crossed = true;
+            }
+        }
+
+        if(!Crossed) continue;
+
+        if(!NavSamePoint(OutPoints[Count - 1], Corner)) OutPoints[Count++] = Corner;
+
+        Apex     = Corner;
+        FunnelL  = Corner;
+        FunnelR  = Corner;
+        LeftIdx  = Restart;
+        RightIdx = Restart;
+        Idx      = Restart;
+    }
+
+    if(Count < MaxPoints && !NavSamePoint(OutPoints[Count - 1], End))
+    {
+        OutPoints[Count++] = End;
+    }
+
+    return Count;
+}
+
+// NOTE:
+// 1) Regions and entrances as described at nav_hierarchy, then the link costs
+//    of every region. Regions are independent, they are costed on ThreadCount
+//    threads with a query per chunk of regions.
+// 2) Filter gives the link costs, FindPathHierarchical may use another filter
+//    but the corridor is then only as good as the links.
+
+static nav_hierarchy
+BuildNavHierarchy(nav_convex_mesh *Mesh, nav_query_filter *Filter,
+                  sml_u32 PiecesPerRegion = 16, sml_u32 ThreadCount = 0)
+{
+    Sml_Assert(PiecesPerRegion > 0);
+
+    sml_u32 PolyCount = Mesh->Polys.Count;
+
+    nav_hierarchy Hierarchy = {};
+    Hierarchy.Mesh            = Mesh;
+    Hierarchy.Filter          = *Filter;
+    Hierarchy.Revision        = Mesh->Revision;
+    Hierarchy.PiecesPerRegion = PiecesPerRegion;
+
+    Hierarchy.PolyRegions = dynamic_array<sml_u32>(PolyCount + 1, false);
+    Hierarchy.Regions     = dynamic_array<nav_region>(PolyCount / PiecesPerRegion + 1);
+    Hierarchy.Entrances   = dynamic_array<nav_entrance>(Mesh->Portals.Count + 1, false);
+
+    Hierarchy.PolyRegions.Count = PolyCount;
+
+    dynamic_array<sml_u32> Queue(PolyCount + 1, false);
+
+    for(sml_u32 PolyIdx = 0; PolyIdx < PolyCount; PolyIdx++)
+    {
+        Hierarchy.PolyRegions[PolyIdx] = NavInvalidPoly;
+    }
+
+    // Breadth first growth from the first free piece, up to PiecesPerRegion.
+    for(sml_u32 Seed = 0; Seed < PolyCount; Seed++)
+    {
+        if(Hierarchy.PolyRegions[Seed] != NavInvalidPoly) continue;
+
+        sml_u32 RegionIdx = Hierarchy.Regions.Count;
+        Hierarchy.Regions.Push({});
+
+        sml_u32 Head = 0, Tail = 0;
+
+        Queue[Tail++]               = Seed;
+        Hierarchy.PolyRegions[Seed] = RegionIdx;
+
+        while(Head < Tail && Tail < PiecesPerRegion)
+        {
+            nav_convex_poly Convex = Mesh->Polys[Queue[Head++]];
+
+            for(sml_u32 Idx = 0; Idx < Convex.Count && Tail < PiecesPerRegion; Idx++)
+            {
+                sml_u32 Neighbor = Mesh->Neighbors[Convex.FirstIndex + Idx];
+
+                if(Neighbor == NavInvalidPoly)                        continue;
+                if(Hierarchy.PolyRegions[Neighbor] != NavInvalidPoly) continue;
+
+                Queue[Tail++]                   = Neighbor;
+                Hierarchy.PolyRegions[Neighbor] = RegionIdx;
+            }
+        }
+    }
+
+    // Portals between two regions become entrances.
+    for(sml_u32 PortalIdx = 0; PortalIdx < Mesh->Portals.Count; PortalIdx++)
+    {
+        nav_portal Portal = Mesh->Portals[PortalIdx];
+
+        sml_u32 RegionA = Hierarchy.PolyRegions[Portal.Polys[0]];
+        sml_u32 RegionB = Hierarchy.PolyRegions[Portal.Polys[1]];
+
+        if(RegionA == RegionB) continue;
+
+        sml_vector3 Edge = Mesh->Verts[Portal.Verts[0]] + Mesh->Verts[Portal.Verts[1]];
+
+        nav_entrance Entrance = {};
+        Entrance.Position   = SmlVec3_Scale(Edge, 0.5f);
+        Entrance.Polys[0]   = Portal.Polys[0];
+        Entrance.Polys[1]   = Portal.Polys[1];
+        Entrance.Regions[0] = RegionA;
+        Entrance.Regions[1] = RegionB;
+
+        Hierarchy.Entrances.Push(Entrance);
+
+        Hierarchy.Regions[RegionA].EntranceCount++;
+        Hierarchy.Regions[RegionB].EntranceCount++;
+    }
+
+    // Entrance lists and cost matrices, packed region after region.
+    sml_u32 RegionCount   = Hierarchy.Regions.Count;
+    sml_u32 EntranceCount = Hierarchy.Entrances.Count;
+    sml_u32 ListSize      = 0;
+    sml_u32 CostSize      = 0;
+
+    for(sml_u32 RegionIdx = 0; RegionIdx < RegionCount; RegionIdx++)
+    {
+        nav_region *Region = Hierarchy.Regions.Values + RegionIdx;
+
+        Region->FirstEntrance = ListSize;
+        Region->FirstCost     = CostSize;
+        Region->Dirty         = true;
+
+        ListSize += Region->EntranceCount;
+        CostSize += Region->EntranceCount * Region->EntranceCount;
+
+        if(Region->EntranceCount > Hierarchy.MaxEntrances)
+        {
+            Hierarchy.MaxEntrances = Region->EntranceCount;
+        }
+
+        Region->EntranceCount = 0;
+    }
+
+    Hierarchy.RegionEntrances = dynamic_array<sml_u32>(ListSize + 1, false);
+    Hierarchy.Costs           = dynamic_array<sml_f32>(CostSize + 1, false);
+
+    Hierarchy.RegionEntrances.Count = ListSize;
+    Hierarchy.Costs.Count           = CostSize;
+
+    for(sml_u32 EntranceIdx = 0; EntranceIdx < EntranceCount; EntranceIdx++)
+    {
+        nav_entrance *Entrance = Hierarchy.Entrances.Values + EntranceIdx;
+
+        for(sml_u32 Side = 0; Side < 2; Side++)
+        {
+            nav_region *Region = Hierarchy.Regions.Values + Entrance->Regions[Side];
+            sml_u32     Slot   = Region->EntranceCount++;
+
+            Hierarchy.RegionEntrances[Region->FirstEntrance + Slot] = EntranceIdx;
+            Entrance->Slots[Side]                                   = Slot;
+        }
+    }
+
+    Sml_ParallelFor(RegionCount, NavRegionChunkSize, ThreadCount,
+    [&](sml_u32 Begin, sml_u32 End, sml_u32)
+    {
+        nav_query Query = CreateNavQuery(Mesh, &Hierarchy);
+
+        for(sml_u32 RegionIdx = Begin; RegionIdx < End; RegionIdx++)
+        {
+            NavRegionCosts(&Hierarchy, &Query, RegionIdx);
+        }
+
+        Query.Free();
+    });
+
+    Queue.Free();
+
+    return Hierarchy;
+}
+
+// NOTE: The mesh sees the new area right away and takes a new revision, the
+// links of the piece's region wait for UpdateNavHierarchy.
+
+static void
+SetNavPolyArea(nav_hierarchy *Hierarchy, sml_u32 PolyIdx, sml_u32 Area)
+{
+    Sml_Assert(PolyIdx < Hierarchy->Mesh->Polys.Count && Area < NavMaxAreas);
+
+    nav_convex_poly *Convex = Hierarchy->Mesh->Polys.Values + PolyIdx;
+    if(Convex->Area == Area) return;
+
+    bool InStep = Hierarchy->Revision == Hierarchy->Mesh->Revision;
+
+    Convex->Area = Area;
+    Hierarchy->Mesh->Revision = ++NavMeshRevisions;
+
+    // A hierarchy already behind may not even know the piece, UpdateNavHierarchy
+    // rebuilds it whole.
+    if(!InStep) return;
+
+    Hierarchy->Regions[Hierarchy->PolyRegions[PolyIdx]].Dirty = true;
+    Hierarchy->Revision = Hierarchy->Mesh->Revision;
+}
+
+// NOTE: Recomputes the links of the dirty regions with Query, which must be
+// created with the hierarchy. A hierarchy behind its mesh is built again, and
+// Query with it. Returns how many regions were updated.
+
+static sml_u32
+UpdateNavHierarchy(nav_hierarchy *Hierarchy, nav_query *Query)
+{
+    Sml_Assert(Query->Hierarchy == Hierarchy && Query->Mesh == Hierarchy->Mesh);
+
+    nav_convex_mesh *Mesh = Hierarchy->Mesh;
+
+    if(Hierarchy->Revision != Mesh->Revision)
+    {
+        nav_hierarchy Rebuilt = BuildNavHierarchy(Mesh, &Hierarchy->Filter,
+                                                  Hierarchy->PiecesPerRegion);
+        Hierarchy->Free();
+        *Hierarchy = Rebuilt;
+
+        Query->Free();
+        *Query = CreateNavQuery(Mesh, Hierarchy);
+
+        return Hierarchy->Regions.Count;
+    }
+
+    sml_u32 Updated = 0;
+
+    for(sml_u32 RegionIdx = 0; RegionIdx < Hierarchy->Regions.Count; RegionIdx++)
+    {
+        if(!Hierarchy->Regions[RegionIdx].Dirty) continue;
+
+        NavRegionCosts(Hierarchy, Query, RegionIdx);
+        Updated++;
+    }
+
+    return Updated;
+}
+
+// NOTE: Path->Polys must hold at least one piece, see NavPathHierarchical.
+
+static NavPath_Status
+FindPathHierarchical(nav_query *Query, sml_vector3 Start, sml_vector3 End,
+                     nav_query_filter *Filter, nav_path *Path)
+{
+    Sml_Assert(Path->Capacity > 0);
+
+    sml_u32 StartPoly = FindNavPoly(Query, Start);
+    sml_u32 EndPoly   = FindNavPoly(Query, End);
+
+    return NavPathHierarchical(Query, Filter, StartPoly, Start, EndPoly, End, Path);
 }
 
 } // namespace SML
@@ -0,0 +1,70 @@
+namespace SML
+{
+
+// ===================================
+// User API
+// ===================================
+
+static instance 
+CreateNavMeshDebugInstance(nav_poly *NavPolygons, sml_u32 Count)
+{
+    sml_u32 VtxCount = 0;
+    sml_u32 IdxCount = 0;
+
+    for(sml_u32 PolyIdx = 0; PolyIdx < Count; PolyIdx++)
+    {
+        VtxCount += NavPolygons[PolyIdx].Verts.Count;
+        IdxCount += SmlInt_TriangulateIndexCount(NavPolygons[PolyIdx].Verts.Count);
+    }
+
+    auto DebugVtx = dynamic_array<vertex_color>(VtxCount);
+    auto DebugIdx = dynamic_array<sml_u32>(IdxCount);
+
+    for(sml_u32 PolyIdx = 0; PolyIdx < Count; PolyIdx++)
+    { 
+        auto   *Poly = NavPolygons + PolyIdx;
+        sml_u32 Base = DebugVtx.Count;
+
+        for(sml_u32 VtxIdx = 0; VtxIdx < Poly->Verts.Count; VtxIdx++)
+        {
+            vertex_color Vertex;
+            Vertex.Position = Poly->Verts[VtxIdx];
+            Vertex.Normal   = sml_vector3(0.0f, 0.0f, 0.0f);
+            Vertex.Color    = sml_vector3(0.0f, 1.0f, 0.0f);
+
+            DebugVtx.Push(Vertex);
+        }
+
+        auto Poly2D = dynamic_array<sml_vector2>(Poly->Verts.Count);
+        for(sml_u32 VtxIdx = 0; VtxIdx < Poly->Verts.Count; VtxIdx++)
+        {
+            auto Pos2D = sml_vector2(Poly->Verts[VtxIdx].x, Poly->Verts[VtxIdx].z);
+            Poly2D.Push(Pos2D);
+        }
+
+        // Boundary loops are concave, the fan would cover area outside them.
+        sml_u32 *Indices = DebugIdx.Values + DebugIdx.Count;
+        sml_u32  Written = SmlInt_Triangulate(Poly2D.Values, Poly2D.Count, Indices,
+                                              SmlTriangulate_Monotone);
+
+        for(sml_u32 Idx = 0; Idx < Written; Idx++)
+        {
+            Indices[Idx] += Base;
+        }
+
+        DebugIdx.Count += Written;
+
+        Poly2D.Free();
+    }
+
+    auto DebugMesh = mesh<vertex_color, sml_u32>(DebugVtx.Count, DebugIdx.Count);
+
+    memcpy(DebugMesh.VtxData, DebugVtx.Values, DebugMesh.VtxHeap.Size);
+    memcpy(DebugMesh.IdxData, DebugIdx.Values, DebugMesh.IdxHeap.Size);
+
+    // WARN: Use new API to create the instance.
+
+    return instance(0);
+}
+
+} // namespace SML
@@ -0,0 +1,164 @@
+namespace SML
+{
+
+// ===================================
+// Type Definitions
+// ===================================
+
+// NOTE:
+// 1) Keeps the corridors of recent queries, keyed like the path service by start
+//    piece, end piece and filter costs. A repeated query is then a hash lookup
+//    and a copy, the caller runs FindStraightPath on the corridor as usual.
+// 2) A cached corridor was searched between the points of the first query.
+//    Later queries between other points of the same pieces get the same
+//    corridor, which is valid but may be slightly longer than their own. Its
+//    cost is recomputed for their points, the way the search adds it up.
+// 3) Only NavPath_Found corridors of two pieces or more are kept. A partial one
+//    depends on where End lies in its piece, a truncated one is incomplete,
+//    and a single piece is answered without a search anyway.
+// 4) Bounded by MaxPaths and by ByteBudget bytes of pieces (0: count only),
+//    least recently used first out. Hits and Misses come from the lru_cache.
+// 5) Every lookup compares the mesh and its Revision, so the cache empties
+//    itself after a rebuild or SetNavPolyArea. Areas written straight into
+//    Mesh->Polys do not change the revision, call InvalidateNavPathCache then.
+
+struct nav_cached_path
+{
+    sml_heap_block Heap;
+    sml_u32        Count;
+};
+
+struct nav_path_cache
+{
+    lru_cache<nav_path_key, nav_cached_path> Entries;
+
+    nav_convex_mesh *Mesh;
+    sml_u32          Revision;
+
+    // Stats
+    sml_u64 Invalidations;
+
+    void Free()
+    {
+        this->Entries.Free();
+        this->Mesh = nullptr;
+    }
+};
+
+// ===================================
+// Internal Helpers
+// ===================================
+
+static void
+NavCacheEvict(nav_path_key &Key, nav_cached_path &Value, void *UserData)
+{
+    (void)Key;
+    (void)UserData;
+
+    SmlMemory.Free(Value.Heap);
+}
+
+static void
+NavCacheCheckMesh(nav_path_cache *Cache, nav_convex_mesh *Mesh)
+{
+    if(Cache->Mesh == Mesh && Cache->Revision == Mesh->Revision) return;
+
+    if(Cache->Entries.Count) Cache->Invalidations++;
+
+    Cache->Entries.Clear();
+    Cache->Mesh     = Mesh;
+    Cache->Revision = Mesh->Revision;
+}
+
+// ===================================
+// User API
+// ===================================
+
+static nav_path_cache
+CreateNavPathCache(sml_u32 MaxPaths, size_t ByteBudget = 0)
+{
+    Sml_Assert(MaxPaths > 0);
+
+    nav_path_cache Cache = {};
+    Cache.Entries = lru_cache<nav_path_key, nav_cached_path>(MaxPaths, ByteBudget,
+                                                             NavCacheEvict);
+
+    return Cache;
+}
+
+static void
+InvalidateNavPathCache(nav_path_cache *Cache)
+{
+    if(Cache->Entries.Count) Cache->Invalidations++;
+
+    Cache->Entries.Clear();
+}
+
+// NOTE: Same contract as FindPath, Path->Cost is the corridor's cost between
+// Start and End. Misses are searched with the hierarchy when Query has one,
+// like a nav_corridor replan.
+
+static NavPath_Status
+FindPathCached(nav_path_cache *Cache, nav_query *Query, sml_vector3 Start,
+               sml_vector3 End, nav_query_filter *Filter, nav_path *Path)
+{
+    Sml_Assert(Path->Capacity > 0);
+
+    sml_u32 StartPoly = FindNavPoly(Query, Start);
+    sml_u32 EndPoly   = FindNavPoly(Query, End);
+
+    if(StartPoly == NavInvalidPoly || EndPoly == NavInvalidPoly || StartPoly == EndPoly)
+    {
+        return NavPathBetween(Query, Filter, StartPoly, Start, EndPoly, End, nullptr,
+                              Path);
+    }
+
+    NavCacheCheckMesh(Cache, Query->Mesh);
+
+    nav_path_key Key = {};
+    Key.StartPoly  = StartPoly;
+    Key.EndPoly    = EndPoly;
+    Key.FilterHash = NavFilterHash(Filter);
+
+    nav_cached_path *Cached = Cache->Entries.Get(Key);
+    if(Cached)
+    {
+        sml_u32 Count = Cached->Count < Path->Capacity ? Cached->Count : Path->Capacity;
+
+        sml_u32 *Polys = (sml_u32*)Cached->Heap.Data;
+
+        memcpy(Path->Polys, Polys, Count * sizeof(sml_u32));
+        Path->Count = Count;
+        Path->Cost  = NavPathCost(Query->Mesh, Filter, Polys, Cached->Count, Start, End);
+
+        return Count == Cached->Count ? NavPath_Found : NavPath_Truncated;
+    }
+
+    NavPath_Status Status;
+
+    if(Query->Hierarchy)
+    {
+        Status = NavPathHierarchical(Query, Filter, StartPoly, Start, EndPoly, End, Path);
+    }
+    else
+    {
+        Status = NavPathBetween(Query, Filter, StartPoly, Start, EndPoly, End, nullptr,
+                                Path);
+    }
+
+    if(Status != NavPath_Found) return Status;
+
+    size_t Size = Path->Count * sizeof(sml_u32);
+
+    nav_cached_path Entry = {};
+    Entry.Heap  = SmlMemory.Allocate(Size);
+    Entry.Count = Path->Count;
+
+    memcpy(Entry.Heap.Data, Path->Polys, Size);
+
+    Cache->Entries.Put(Key, Entry, Size);
+
+    return Status;
+}
+
+} // namespace SML
@@ -0,0 +1,504 @@
+#include <atomic>             // Request completion
+#include <chrono>             // Frame budget
+#include <condition_variable> // Frame wake up
+#include <mutex>              // Frame wake up
+#include <thread>             // Workers
+
+namespace SML
+{
+
+// ===================================
+// Type Definitions
+// ===================================
+
+// NOTE:
+// 1) Gameplay code queues path requests on the main thread, worker threads
+//    search them, each with its own nav_query. Results are read through
+//    handles, usually polled the frame after the request.
+// 2) There is one mpmc_queue per priority, workers drain the higher ones first.
+// 3) UpdateNavPathService starts a frame. Each worker then searches until it
+//    has spent FrameBudgetNs, what is left waits for the next frame. The main
+//    thread only locates the end points, it never searches.
+// 4) A request with the same start piece, end piece and filter costs as one
+//    still in flight joins it. Both handles read the same corridor, searched
+//    between the points of the first request. Each handle keeps its own points,
+//    the cost of a found corridor is recomputed for them.
+// 5) Request, Poll, Release and Update belong to the main thread. The mesh, the
+//    hierarchy and the filters must not change while requests are in flight.
+
+constexpr sml_u32 NavInvalidRequest = 0xFFFFFFFF;
+
+enum NavRequest_Priority
+{
+    NavPriority_High,
+    NavPriority_Normal,
+    NavPriority_Low,
+
+    NavPriority_Count,
+};
+
+enum NavRequest_State
+{
+    NavRequest_Invalid,
+    NavRequest_Pending,
+    NavRequest_Done,
+};
+
+struct nav_path_handle
+{
+    sml_u32     Slot;
+    sml_u32     Generation;
+    sml_vector3 Start;
+    sml_vector3 End;
+};
+
+// NOTE: Filters are compared by their costs, FilterHash is XXH64 over them.
+
+struct nav_path_key
+{
+    sml_u32 StartPoly;
+    sml_u32 EndPoly;
+    sml_u64 FilterHash;
+
+    bool operator==(const nav_path_key &Other) const
+    {
+        return this->StartPoly  == Other.StartPoly &&
+               this->EndPoly    == Other.EndPoly   &&
+               this->FilterHash == Other.FilterHash;
+    }
+};
+
+// NOTE: A worker writes Status, Count and Cost, then sets Done. The rest is
+// owned by the main thread.
+
+struct nav_path_request
+{
+    std::atomic<bool> Done;
+
+    nav_path_key      Key;
+    nav_query_filter *Filter;
+    sml_vector3       Start;
+    sml_vector3       End;
+
+    NavPath_Status Status;
+    sml_u32        Count;
+    sml_f32        Cost;
+
+    sml_u32 Generation;
+    sml_u32 Refs;
+    bool    InFlight;
+};
+
+// NOTE: Created in place, the workers keep a pointer to the service.
+
+struct nav_path_service
+{
+    nav_convex_mesh *Mesh;
+    nav_hierarchy   *Hierarchy;
+    nav_query        Locator;
+
+    // Requests, slot Idx owns Polys[Idx * PathCapacity .. + PathCapacity)
+    nav_path_request *Requests;
+    sml_u32          *Polys;
+    sml_u32          *FreeSlots;
+    sml_u32           FreeCount;
+    sml_u32           MaxRequests;
+    sml_u32           PathCapacity;
+
+    // In flight
+    mpmc_queue<sml_u32>                Queues[NavPriority_Count];
+    sml_hashmap<nav_path_key, sml_u32> Joinable;
+    dynamic_array<sml_u32>             InFlight;
+
+    // Workers
+    std::thread Workers[SmlMaxThreads];
+    nav_query   Queries[SmlMaxThreads];
+    sml_u32     WorkerCount;
+    sml_u64     FrameBudgetNs;
+
+    std::mutex              Lock;
+    std::condition_variable Wake;
+    sml_u64                 Frame;
+    bool                    Stop;
+
+    // Heap
+    sml_heap_block RequestHeap;
+    sml_heap_block PolyHeap;
+    sml_heap_block FreeHeap;
+
+    // Stats
+    std::atomic<sml_u64> Searches;
+    sml_u64              Requested;
+    sml_u64              Joined;
+};
+
+// ===================================
+// Internal Helpers
+// ===================================
+
+static inline sml_u64
+NavFilterHash(nav_query_filter *Filter)
+{
+    return XXH64(Filter->AreaCosts, sizeof(Filter->AreaCosts), 0);
+}
+
+static bool
+NavServicePop(nav_path_service *Service, sml_u32 *Slot)
+{
+    for(sml_u32 Priority = 0; Priority < NavPriority_Count; Priority++)
+    {
+        if(Service->Queues[Priority].Pop(Slot)) return true;
+    }
+
+    return false;
+}
+
+static void
+NavServiceSearch(nav_path_service *Service, nav_query *Query, sml_u32 Slot)
+{
+    nav_path_request *Request = Service->Requests + Slot;
+
+    nav_path Path = {};
+    Path.Polys    = Service->Polys + (size_t)Slot * Service->PathCapacity;
+    Path.Capacity = Service->PathCapacity;
+
+    sml_u32 StartPoly = Request->Key.StartPoly;
+    sml_u32 EndPoly   = Request->Key.EndPoly;
+
+    if(Service->Hierarchy)
+    {
+        Request->Status = NavPathHierarchical(Query, Request->Filter, StartPoly,
+                                              Request->Start, EndPoly, Request->End,
+                                              &Path);
+    }
+    else
+    {
+        Request->Status = NavPathBetween(Query, Request->Filter, StartPoly,
+                                         Request->Start, EndPoly, Request->End, nullptr,
+                                         &Path);
+    }
+
+    Request->Count = Path.Count;
+    Request->Cost  = Path.Cost;
+
+    Service->Searches.fetch_add(1, std::memory_order_relaxed);
+    Request->Done.store(true, std::memory_order_release);
+}
+
+static void
+NavServiceWorker(nav_path_service *Service, sml_u32 WorkerIdx)
+{
+    using sml_clock = std::chrono::steady_clock;
+
+    nav_query *Query = Service->Queries + WorkerIdx;
+    sml_u64    Seen  = 0;
+
+    for(;;)
+    {
+        {
+            std::unique_lock<std::mutex> Guard(Service->Lock);
+
+            Service->Wake.wait(Guard, [&]()
+            {
+                return Service->Stop || Service->Frame != Seen;
+            });
+
+            if(Service->Stop) return;
+
+            Seen = Service->Frame;
+        }
+
+        sml_clock::time_point Begin = sml_clock::now();
+        sml_u32               Slot  = 0;
+
+        while(NavServicePop(Service, &Slot))
+        {
+            NavServiceSearch(Service, Query, Slot);
+
+            auto Spent = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             sml_clock::now() - Begin);
+
+            if((sml_u64)Spent.count() >= Service->FrameBudgetNs) break;
+        }
+    }
+}
+
+static inline nav_path_request*
+NavServiceRequest(nav_path_service *Service, nav_path_handle Handle)
+{
+    if(Handle.Slot >= Service->MaxRequests) return nullptr;
+
+    nav_path_request *Request = Service->Requests + Handle.Slot;
+
+    if(Request->Refs == 0 || Request->Generation != Handle.Generation) return nullptr;
+
+    return Request;
+}
+
+// NOTE: The generation bump turns every handle to the slot stale.
+
+static inline void
+NavServiceRecycle(nav_path_service *Service, sml_u32 Slot)
+{
+    Service->Requests[Slot].Generation++;
+    Service->FreeSlots[Service->FreeCount++] = Slot;
+}
+
+// ===================================
+// User API
+// ===================================
+
+// NOTE:
+// 1) Hierarchy is optional, with it the workers use FindPathHierarchical.
+// 2) At most MaxRequests handles are alive at once, a path keeps its first
+//    PathCapacity pieces.
+// 3) ThreadCount 0 uses every hardware thread but the main one, at least one.
+
+static void
+CreateNavPathService(nav_path_service *Service, nav_convex_mesh *Mesh,
+                     nav_hierarchy *Hierarchy, sml_u32 MaxRequests, sml_u32 PathCapacity,
+                     sml_u64 FrameBudgetNs, sml_u32 ThreadCount = 0)
+{
+    Sml_Assert(MaxRequests > 0 && PathCapacity > 0);
+    Sml_Assert(!Hierarchy || Hierarchy->Mesh == Mesh);
+
+    Service->Mesh          = Mesh;
+    Service->Hierarchy     = Hierarchy;
+    Service->Locator       = CreateNavQuery(Mesh);
+    Service->MaxRequests   = MaxRequests;
+    Service->PathCapacity  = PathCapacity;
+    Service->FrameBudgetNs = FrameBudgetNs;
+
+    size_t RequestsSize = MaxRequests * sizeof(nav_path_request);
+    size_t PolysSize    = (size_t)MaxRequests * PathCapacity * sizeof(sml_u32);
+
+    Service->RequestHeap = SmlMemory.Allocate(RequestsSize);
+    Service->PolyHeap    = SmlMemory.Allocate(PolysSize);
+    Service->FreeHeap    = SmlMemory.Allocate(MaxRequests * sizeof(sml_u32));
+    Service->Requests    = (nav_path_request*)Service->RequestHeap.Data;
+    Service->Polys       = (sml_u32*)Service->PolyHeap.Data;
+    Service->FreeSlots   = (sml_u32*)Service->FreeHeap.Data;
+
+    memset((void*)Service->Requests, 0, RequestsSize);
+
+    for(sml_u32 Idx = 0; Idx < MaxRequests; Idx++)
+    {
+        Service->FreeSlots[Idx] = MaxRequests - 1 - Idx;
+    }
+
+    Service->FreeCount = MaxRequests;
+
+    for(sml_u32 Priority = 0; Priority < NavPriority_Count; Priority++)
+    {
+        Service->Queues[Priority] = mpmc_queue<sml_u32>(MaxRequests);
+    }
+
+    // NOTE: Keeps the map at most half full with every request in flight.
+    Service->Joinable = sml_hashmap<nav_path_key, sml_u32>((MaxRequests * 2) / 16);
+    Service->InFlight = dynamic_array<sml_u32>(MaxRequests, false);
+
+    Service->Frame     = 0;
+    Service->Stop      = false;
+    Service->Requested = 0;
+    Service->Joined    = 0;
+    Service->Searches.store(0, std::memory_order_relaxed);
+
+    sml_u32 Threads = ThreadCount ? Sml_ResolveThreads(ThreadCount)
+                                  : Sml_HardwareThreads() - 1;
+
+    Service->WorkerCount = Threads ? Threads : 1;
+
+    for(sml_u32 Idx = 0; Idx < Service->WorkerCount; Idx++)
+    {
+        Service->Queries[Idx] = CreateNavQuery(Mesh, Hierarchy);
+        Service->Workers[Idx] = std::thread(NavServiceWorker, Service, Idx);
+    }
+}
+
+// NOTE: Drops whatever is still queued, handles are invalid afterwards.
+
+static void
+FreeNavPathService(nav_path_service *Service)
+{
+    {
+        std::lock_guard<std::mutex> Guard(Service->Lock);
+        Service->Stop = true;
+    }
+
+    Service->Wake.notify_all();
+
+    for(sml_u32 Idx = 0; Idx < Service->WorkerCount; Idx++)
+    {
+        Service->Workers[Idx].join();
+        Service->Queries[Idx].Free();
+    }
+
+    for(sml_u32 Priority = 0; Priority < NavPriority_Count; Priority++)
+    {
+        Service->Queues[Priority].Free();
+    }
+
+    Service->Locator.Free();
+    Service->Joinable.Free();
+    Service->InFlight.Free();
+
+    SmlMemory.Free(Service->RequestHeap);
+    SmlMemory.Free(Service->PolyHeap);
+    SmlMemory.Free(Service->FreeHeap);
+
+    Service->Requests    = nullptr;
+    Service->WorkerCount = 0;
+}
+
+// NOTE: Returns a handle with Slot NavInvalidRequest when every slot is taken.
+// Points off the mesh get a handle that is done at once, with NavPath_NoPoly.
+
+static nav_path_handle
+RequestNavPath(nav_path_service *Service, sml_vector3 Start, sml_vector3 End,
+               nav_query_filter *Filter,
+               NavRequest_Priority Priority = NavPriority_Normal)
+{
+    Sml_Assert(Priority < NavPriority_Count);
+
+    nav_path_handle Handle = {NavInvalidRequest, 0, Start, End};
+
+    nav_path_key Key = {};
+    Key.StartPoly  = FindNavPoly(&Service->Locator, Start);
+    Key.EndPoly    = FindNavPoly(&Service->Locator, End);
+    Key.FilterHash = NavFilterHash(Filter);
+
+    Service->Requested++;
+
+    sml_u32 *Leader = Service->Joinable.Find(Key);
+    if(Leader)
+    {
+        nav_path_request *Request = Service->Requests + *Leader;
+        Request->Refs++;
+
+        Handle.Slot       = *Leader;
+        Handle.Generation = Request->Generation;
+
+        Service->Joined++;
+
+        return Handle;
+    }
+
+    if(Service->FreeCount == 0) return Handle;
+
+    sml_u32           Slot    = Service->FreeSlots[--Service->FreeCount];
+    nav_path_request *Request = Service->Requests + Slot;
+
+    Request->Key      = Key;
+    Request->Filter   = Filter;
+    Request->Start    = Start;
+    Request->End      = End;
+    Request->Status   = NavPath_NoPoly;
+    Request->Count    = 0;
+    Request->Cost     = 0.0f;
+    Request->Refs     = 1;
+    Request->InFlight = false;
+
+    Handle.Slot       = Slot;
+    Handle.Generation = Request->Generation;
+
+    if(Key.StartPoly == NavInvalidPoly || Key.EndPoly == NavInvalidPoly)
+    {
+        Request->Done.store(true, std::memory_order_relaxed);
+        return Handle;
+    }
+
+    Request->Done.store(false, std::memory_order_relaxed);
+    Request->InFlight = true;
+
+    Service->Joinable.Insert(Key, Slot);
+    Service->InFlight.Push(Slot);
+
+    bool Queued = Service->Queues[Priority].Push(Slot);
+    Sml_Assert(Queued);
+
+    return Handle;
+}
+
+// NOTE: Once done, Path points into the service and stays valid until the
+// handle is released. Path->Cost is the cost between the handle's points, like
+// FindPath for the same corridor. Partial and truncated paths of a joined
+// handle keep the first request's cost, their last leg is not known.
+
+static NavRequest_State
+PollNavPath(nav_path_service *Service, nav_path_handle Handle, nav_path *Path,
+            NavPath_Status *Status)
+{
+    nav_path_request *Request = NavServiceRequest(Service, Handle);
+
+    if(!Request)                                        return NavRequest_Invalid;
+    if(!Request->Done.load(std::memory_order_acquire)) return NavRequest_Pending;
+
+    Path->Polys    = Service->Polys + (size_t)Handle.Slot * Service->PathCapacity;
+    Path->Capacity = Service->PathCapacity;
+    Path->Count    = Request->Count;
+    Path->Cost     = Request->Cost;
+
+    bool Joined = memcmp(&Handle.Start, &Request->Start, sizeof(sml_vector3)) ||
+                  memcmp(&Handle.End, &Request->End, sizeof(sml_vector3));
+
+    if(Joined && Request->Status == NavPath_Found)
+    {
+        Path->Cost = NavPathCost(Service->Mesh, Request->Filter, Path->Polys, Path->Count,
+                                 Handle.Start, Handle.End);
+    }
+
+    *Status = Request->Status;
+
+    return NavRequest_Done;
+}
+
+// NOTE: A released request still in flight finishes its search, its slot is
+// recycled by the next UpdateNavPathService.
+
+static void
+ReleaseNavPath(nav_path_service *Service, nav_path_handle Handle)
+{
+    nav_path_request *Request = NavServiceRequest(Service, Handle);
+    if(!Request) return;
+
+    if(--Request->Refs) return;
+
+    if(!Request->InFlight) NavServiceRecycle(Service, Handle.Slot);
+}
+
+// NOTE: Call once per frame. Finished searches stop taking joiners and
+// released ones give their slot back, then the workers get a new budget.
+
+static void
+UpdateNavPathService(nav_path_service *Service)
+{
+    dynamic_array<sml_u32> &InFlight = Service->InFlight;
+
+    for(sml_u32 Idx = 0; Idx < InFlight.Count;)
+    {
+        sml_u32           Slot    = InFlight[Idx];
+        nav_path_request *Request = Service->Requests + Slot;
+
+        if(!Request->Done.load(std::memory_order_acquire))
+        {
+            Idx++;
+            continue;
+        }
+
+        Service->Joinable.Remove(Request->Key);
+        Request->InFlight = false;
+
+        if(Request->Refs == 0) NavServiceRecycle(Service, Slot);
+
+        InFlight[Idx] = InFlight[--InFlight.Count];
+    }
+
+    {
+        std::lock_guard<std::mutex> Guard(Service->Lock);
+        Service->Frame++;
+    }
+
+    Service->Wake.notify_all();
+}
+
+} // namespace SML
@@ -0,0 +1,180 @@
+#include <atomic>      // Sequence counters
+#include <type_traits> // static type checking
+
+// ===================================
+// Type Definitions
+// ===================================
+
+template<typename T>
+struct mpmc_queue_cell
+{
+    std::atomic<size_t> Sequence;
+    T                   Data;
+};
+
+// NOTE:
+// 1) Bounded multi-producer multi-consumer ring (Vyukov). Every cell carries a
+//    sequence number telling producers and consumers whose turn it is, so Push
+//    and Pop are a single CAS on their position in the common case.
+// 2) The two positions sit on their own cache lines so producers and consumers
+//    do not false share.
+// 3) Create and free the queue on one thread. Copying is only valid before the
+//    queue is shared.
+
+template<typename T>
+struct mpmc_queue
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "mpmc_queue<T> requires T to be trivially copyable");
+
+    // Core-data
+    mpmc_queue_cell<T> *Cells;
+    size_t              Mask;
+
+    // Positions
+    alignas(SML_CACHE_LINE_SIZE) std::atomic<size_t> EnqueuePos;
+    alignas(SML_CACHE_LINE_SIZE) std::atomic<size_t> DequeuePos;
+
+    // Heap
+    alignas(SML_CACHE_LINE_SIZE) sml_heap_block Heap;
+
+    mpmc_queue(){};
+    mpmc_queue(sml_u32 Capacity)
+    {
+        if(Capacity < 2) Capacity = 2;
+
+        size_t Pow2 = 1;
+        while(Pow2 < Capacity) Pow2 <<= 1;
+
+        size_t CellsSize = Pow2 * sizeof(mpmc_queue_cell<T>);
+
+        this->Heap  = SmlMemory.Allocate(CellsSize + SML_CACHE_LINE_SIZE);
+        this->Cells =
+            (mpmc_queue_cell<T>*)Sml_AlignPointer(this->Heap.Data, SML_CACHE_LINE_SIZE);
+        this->Mask  = Pow2 - 1;
+
+        memset((void*)this->Cells, 0, CellsSize);
+
+        for(size_t Idx = 0; Idx < Pow2; Idx++)
+        {
+            this->Cells[Idx].Sequence.store(Idx, std::memory_order_relaxed);
+        }
+
+        this->EnqueuePos.store(0, std::memory_order_relaxed);
+        this->DequeuePos.store(0, std::memory_order_relaxed);
+    }
+
+    mpmc_queue(const mpmc_queue &Other)
+    {
+        *this = Other;
+    }
+
+    mpmc_queue& operator=(const mpmc_queue &Other)
+    {
+        this->Cells = Other.Cells;
+        this->Mask  = Other.Mask;
+        this->Heap  = Other.Heap;
+
+        this->EnqueuePos.store(Other.EnqueuePos.load(std::memory_order_relaxed),
+                               std::memory_order_relaxed);
+        this->DequeuePos.store(Other.DequeuePos.load(std::memory_order_relaxed),
+                               std::memory_order_relaxed);
+
+        return *this;
+    }
+
+    // Returns false when the queue is full.
+    bool Push(const T &Value)
+    {
+        mpmc_queue_cell<T> *Cell = nullptr;
+        size_t              Pos  = this->EnqueuePos.load(std::memory_order_relaxed);
+
+        while(true)
+        {
+            Cell = this->Cells + (Pos & this->Mask);
+
+            size_t   Sequence = Cell->Sequence.load(std::memory_order_acquire);
+            intptr_t Diff     = (intptr_t)Sequence - (intptr_t)Pos;
+
+            if(Diff == 0)
+            {
+                if(this->EnqueuePos.compare_exchange_weak(Pos, Pos + 1,
+                                                          std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if(Diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                Pos = this->EnqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        Cell->Data = Value;
+        Cell->Sequence.store(Pos + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Returns false when the queue is empty.
+    bool Pop(T *Out)
+    {
+        mpmc_queue_cell<T> *Cell = nullptr;
+        size_t              Pos  = this->DequeuePos.load(std::memory_order_relaxed);
+
+        while(true)
+        {
+            Cell = this->Cells + (Pos & this->Mask);
+
+            size_t   Sequence = Cell->Sequence.load(std::memory_order_acquire);
+            intptr_t Diff     = (intptr_t)Sequence - (intptr_t)(Pos + 1);
+
+            if(Diff == 0)
+            {
+                if(this->DequeuePos.compare_exchange_weak(Pos, Pos + 1,
+                                                          std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if(Diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                Pos = this->DequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        *Out = Cell->Data;
+        Cell->Sequence.store(Pos + this->Mask + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // NOTE: Only a snapshot, other threads may change it right after.
+    size_t ApproxCount()
+    {
+        size_t Enqueue = this->EnqueuePos.load(std::memory_order_relaxed);
+        size_t Dequeue = this->DequeuePos.load(std::memory_order_relaxed);
+
+        return Enqueue > Dequeue ? Enqueue - Dequeue : 0;
+    }
+
+    size_t Capacity()
+    {
+        return this->Mask + 1;
+    }
+
+    void Free()
+    {
+        SmlMemory.Free(this->Heap);
+
+        this->Cells = nullptr;
+    }
+};
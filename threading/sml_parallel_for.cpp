@@ -0,0 +1,93 @@
+#include <atomic> // Chunk counter
+#include <thread> // Workers
+
+// ===================================
+// Type Definitions
+// ===================================
+
+// NOTE:
+// 1) Sml_ParallelFor splits [0, Count) in chunks of ChunkSize and runs
+//    Job(Begin, End, ChunkIdx) on ThreadCount threads, the caller included.
+//    Chunks are handed out through an atomic counter, so a job that only
+//    writes data owned by its chunk gives the same result on any thread count.
+// 2) Threads are started per call. This is meant for bake style work (nav
+//    meshes) where a call runs for milliseconds, not for per frame jobs.
+// 3) ThreadCount 0 uses every hardware thread.
+
+constexpr sml_u32 SmlMaxThreads = 64;
+
+// ===================================
+// Internal Helpers
+// ===================================
+
+static inline sml_u32
+SmlInt_ChunkCount(sml_u32 Count, sml_u32 ChunkSize)
+{
+    return (Count + ChunkSize - 1) / ChunkSize;
+}
+
+// ===================================
+// User API
+// ===================================
+
+static sml_u32
+Sml_HardwareThreads()
+{
+    sml_u32 Count = (sml_u32)std::thread::hardware_concurrency();
+
+    if(Count == 0)             Count = 1;
+    if(Count > SmlMaxThreads)  Count = SmlMaxThreads;
+
+    return Count;
+}
+
+static sml_u32
+Sml_ResolveThreads(sml_u32 ThreadCount)
+{
+    if(ThreadCount == 0)            return Sml_HardwareThreads();
+    if(ThreadCount > SmlMaxThreads) return SmlMaxThreads;
+
+    return ThreadCount;
+}
+
+template<typename F>
+static void
+Sml_ParallelFor(sml_u32 Count, sml_u32 ChunkSize, sml_u32 ThreadCount, F Job)
+{
+    Sml_Assert(ChunkSize > 0);
+
+    sml_u32 ChunkCount = SmlInt_ChunkCount(Count, ChunkSize);
+    sml_u32 Threads    = Sml_ResolveThreads(ThreadCount);
+
+    if(Threads > ChunkCount) Threads = ChunkCount;
+
+    std::atomic<sml_u32> NextChunk{0};
+
+    auto Worker = [&]()
+    {
+        for(;;)
+        {
+            sml_u32 ChunkIdx = NextChunk.fetch_add(1, std::memory_order_relaxed);
+            if(ChunkIdx >= ChunkCount) break;
+
+            sml_u32 Begin = ChunkIdx * ChunkSize;
+            sml_u32 End   = Count - Begin < ChunkSize ? Count : Begin + ChunkSize;
+
+            Job(Begin, End, ChunkIdx);
+        }
+    };
+
+    if(Threads <= 1)
+    {
+        Worker();
+        return;
+    }
+
+    std::thread Workers[SmlMaxThreads];
+
+    for(sml_u32 Idx = 1; Idx < Threads; Idx++) Workers[Idx] = std::thread(Worker);
+
+    Worker();
+
+    for(sml_u32 Idx = 1; Idx < Threads; Idx++) Workers[Idx].join();
+}
@@ -0,0 +1,126 @@
+#include <atomic>      // Head/Tail positions
+#include <type_traits> // static type checking
+
+// ===================================
+// Type Definitions
+// ===================================
+
+// NOTE:
+// 1) Bounded single-producer single-consumer ring. Each side owns one position
+//    and caches the other side's position, so the shared cache line is only
+//    touched when the cached value says the ring looks full (or empty).
+// 2) Exactly one thread may Push and exactly one thread may Pop.
+// 3) Same allocation rules as mpmc_queue: create and free on one thread.
+
+template<typename T>
+struct spsc_queue
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "spsc_queue<T> requires T to be trivially copyable");
+
+    // Core-data
+    T     *Values;
+    size_t Mask;
+
+    // Consumer side
+    alignas(SML_CACHE_LINE_SIZE) std::atomic<size_t> Head;
+    size_t CachedTail;
+
+    // Producer side
+    alignas(SML_CACHE_LINE_SIZE) std::atomic<size_t> Tail;
+    size_t CachedHead;
+
+    // Heap
+    alignas(SML_CACHE_LINE_SIZE) sml_heap_block Heap;
+
+    spsc_queue(){};
+    spsc_queue(sml_u32 Capacity)
+    {
+        if(Capacity < 2) Capacity = 2;
+
+        size_t Pow2 = 1;
+        while(Pow2 < Capacity) Pow2 <<= 1;
+
+        this->Heap   = SmlMemory.Allocate(Pow2 * sizeof(T) + SML_CACHE_LINE_SIZE);
+        this->Values = (T*)Sml_AlignPointer(this->Heap.Data, SML_CACHE_LINE_SIZE);
+        this->Mask   = Pow2 - 1;
+
+        this->Head.store(0, std::memory_order_relaxed);
+        this->Tail.store(0, std::memory_order_relaxed);
+        this->CachedHead = 0;
+        this->CachedTail = 0;
+    }
+
+    spsc_queue(const spsc_queue &Other)
+    {
+        *this = Other;
+    }
+
+    spsc_queue& operator=(const spsc_queue &Other)
+    {
+        this->Values     = Other.Values;
+        this->Mask       = Other.Mask;
+        this->Heap       = Other.Heap;
+        this->CachedHead = Other.CachedHead;
+        this->CachedTail = Other.CachedTail;
+
+        this->Head.store(Other.Head.load(std::memory_order_relaxed),
+                         std::memory_order_relaxed);
+        this->Tail.store(Other.Tail.load(std::memory_order_relaxed),
+                         std::memory_order_relaxed);
+
+        return *this;
+    }
+
+    // Producer only. Returns false when the queue is full.
+    bool Push(const T &Value)
+    {
+        size_t Tail = this->Tail.load(std::memory_order_relaxed);
+
+        if(Tail - this->CachedHead > this->Mask)
+        {
+            this->CachedHead = this->Head.load(std::memory_order_acquire);
+            if(Tail - this->CachedHead > this->Mask)
+            {
+                return false;
+            }
+        }
+
+        this->Values[Tail & this->Mask] = Value;
+        this->Tail.store(Tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Consumer only. Returns false when the queue is empty.
+    bool Pop(T *Out)
+    {
+        size_t Head = this->Head.load(std::memory_order_relaxed);
+
+        if(Head == this->CachedTail)
+        {
+            this->CachedTail = this->Tail.load(std::memory_order_acquire);
+            if(Head == this->CachedTail)
+            {
+                return false;
+            }
+        }
+
+        *Out = this->Values[Head & this->Mask];
+        this->Head.store(Head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    size_t Capacity()
+    {
+        return this->Mask + 1;
+    }
+
+    void Free()
+    {
+        SmlMemory.Free(this->Heap);
+
+        this->Values = nullptr;
+    }
+};